@@ -29,7 +29,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define DOUGLASPEUCKER_H_
 
 #include "../DataStructures/Coordinate.h"
-#include "../DataStructures/SegmentInformation.h"
 
 #include <boost/assert.hpp>
 
@@ -39,12 +38,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stack>
 #include <vector>
 
-/*This class object computes the bitvector of indicating generalized input points
- * according to the (Ramer-)Douglas-Peucker algorithm.
+/*This class object computes for each point of a polyline the smallest zoom
+ * level at which the (Ramer-)Douglas-Peucker generalization keeps the point.
  *
- * Input is vector of pairs. Each pair consists of the point information and a bit
- * indicating if the points is present in the generalization.
- * Note: points may also be pre-selected*/
+ * The farthest point of a range does not depend on the threshold, only the
+ * decision to keep it does. Hence a point is kept at a zoom level iff its own
+ * distance and the distances of the points that split its enclosing ranges
+ * exceed the threshold of that level. Keeping all points with a minimum zoom
+ * level not larger than the requested one gives the same result as running
+ * the generalization for that level. First and last point are always kept.*/
 
 class DouglasPeucker {
 private:
@@ -62,8 +64,13 @@ private:
         const FixedPointCoordinate& segB
     ) const;
 public:
-    void Run(std::vector<SegmentInformation> & input_geometry, const unsigned zoom_level);
+    //points that are kept at none of the zoom levels get this value
+    static const unsigned char NUMBER_OF_ZOOM_LEVELS = 19;
 
+    void ComputeMinZoomLevels(
+        const std::vector<FixedPointCoordinate> & input_geometry,
+        std::vector<unsigned char> & min_zoom_levels
+    );
 };
 
 #endif /* DOUGLASPEUCKER_H_ */
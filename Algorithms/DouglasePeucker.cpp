@@ -27,8 +27,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "DouglasPeucker.h"
 
+#include <algorithm>
+
+const unsigned char DouglasPeucker::NUMBER_OF_ZOOM_LEVELS;
+
 //These thresholds are more or less heuristically chosen.
-static double DouglasPeuckerThresholds[19] = {
+static double DouglasPeuckerThresholds[DouglasPeucker::NUMBER_OF_ZOOM_LEVELS] = {
     32000000., //z0
     16240000., //z1
      8240000., //z2
@@ -82,45 +86,23 @@ int DouglasPeucker::fastDistance(
     return dist;
 }
 
-void DouglasPeucker::Run(
-    std::vector<SegmentInformation> & input_geometry,
-    const unsigned zoom_level
+void DouglasPeucker::ComputeMinZoomLevels(
+    const std::vector<FixedPointCoordinate> & input_geometry,
+    std::vector<unsigned char> & min_zoom_levels
 ) {
-    {
-        BOOST_ASSERT_MSG(zoom_level < 19, "unsupported zoom level");
-        BOOST_ASSERT_MSG(1 < input_geometry.size(), "geometry invalid");
-        std::size_t left_border = 0;
-        std::size_t right_border = 1;
-        //Sweep linerarily over array and identify those ranges that need to be checked
-        do {
-            BOOST_ASSERT_MSG(
-                input_geometry[left_border].necessary,
-                "left border must be necessary"
-            );
-            BOOST_ASSERT_MSG(
-                input_geometry.back().necessary,
-                "right border must be necessary"
-            );
-
-            if(input_geometry[right_border].necessary) {
-                recursion_stack.push(std::make_pair(left_border, right_border));
-                left_border = right_border;
-            }
-            ++right_border;
-        } while( right_border < input_geometry.size());
+    min_zoom_levels.assign(input_geometry.size(), NUMBER_OF_ZOOM_LEVELS);
+    if( input_geometry.empty() ) {
+        return;
+    }
+    min_zoom_levels.front() = 0;
+    min_zoom_levels.back() = 0;
+    if( 2 < input_geometry.size() ) {
+        recursion_stack.push(std::make_pair(0, input_geometry.size()-1));
     }
     while(!recursion_stack.empty()) {
         //pop next element
         const PairOfPoints pair = recursion_stack.top();
         recursion_stack.pop();
-        BOOST_ASSERT_MSG(
-            input_geometry[pair.first].necessary,
-            "left border mus be necessary"
-        );
-        BOOST_ASSERT_MSG(
-            input_geometry[pair.second].necessary,
-            "right border must be necessary"
-        );
         BOOST_ASSERT_MSG(
             pair.second < input_geometry.size(),
             "right border outside of geometry"
@@ -135,32 +117,42 @@ void DouglasPeucker::Run(
         //find index idx of element with max_distance
         for(std::size_t i = pair.first+1; i < pair.second; ++i){
             const int temp_dist = fastDistance(
-                                    input_geometry[i].location,
-                                    input_geometry[pair.first].location,
-                                    input_geometry[pair.second].location
+                                    input_geometry[i],
+                                    input_geometry[pair.first],
+                                    input_geometry[pair.second]
                                 );
             const double distance = std::fabs(temp_dist);
-            if(
-                distance > DouglasPeuckerThresholds[zoom_level] &&
-                distance > max_distance
-            ) {
+            if( distance > max_distance ) {
                 farthest_element_index = i;
                 max_distance = distance;
             }
         }
-        if (max_distance > DouglasPeuckerThresholds[zoom_level]) {
-            //  mark idx as necessary
-            input_geometry[farthest_element_index].necessary = true;
-            if (1 < (farthest_element_index - pair.first) ) {
-                recursion_stack.push(
-                    std::make_pair(pair.first, farthest_element_index)
-                );
-            }
-            if (1 < (pair.second - farthest_element_index) ) {
-                recursion_stack.push(
-                    std::make_pair(farthest_element_index, pair.second)
-                );
-            }
+
+        //the range exists from the zoom level of its later border on
+        unsigned char zoom_level = std::max(
+            min_zoom_levels[pair.first],
+            min_zoom_levels[pair.second]
+        );
+        while(
+            zoom_level < NUMBER_OF_ZOOM_LEVELS &&
+            max_distance <= DouglasPeuckerThresholds[zoom_level]
+        ) {
+            ++zoom_level;
+        }
+        if( NUMBER_OF_ZOOM_LEVELS == zoom_level ) {
+            //range is not split at any zoom level
+            continue;
+        }
+        min_zoom_levels[farthest_element_index] = zoom_level;
+        if (1 < (farthest_element_index - pair.first) ) {
+            recursion_stack.push(
+                std::make_pair(pair.first, farthest_element_index)
+            );
+        }
+        if (1 < (pair.second - farthest_element_index) ) {
+            recursion_stack.push(
+                std::make_pair(farthest_element_index, pair.second)
+            );
         }
     }
 }
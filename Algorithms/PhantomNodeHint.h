@@ -0,0 +1,265 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef PHANTOMNODEHINT_H_
+#define PHANTOMNODEHINT_H_
+
+#include "../DataStructures/PhantomNodes.h"
+
+#include <boost/assert.hpp>
+#include <boost/integer.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <climits>
+
+#include <string>
+
+//Compact, URL-safe encoding of a phantom node that is handed to clients as
+//a hint. The payload is
+//
+//  version           1 byte
+//  checksum tag      2 bytes, checksum folded to 16 bits
+//  edgeBasedNode     varint
+//  nameID            varint
+//  weight1           varint
+//  weight2           varint, 0 if not bidirected, weight2+1 otherwise
+//  ratio             varint, ratio in units of 1/65535
+//  lat, lon          zigzag varints
+//
+//and is written with the base64url alphabet without padding. Encoding and
+//decoding work on fixed-size buffers on the stack.
+
+class PhantomNodeHint : boost::noncopyable {
+public:
+    static void Encode(
+        const PhantomNode & phantom_node,
+        const unsigned checksum,
+        std::string & encoded
+    ) {
+        unsigned char payload[MAX_PAYLOAD_SIZE];
+        unsigned char * position = payload;
+        *position++ = HINT_VERSION;
+        const unsigned tag = GetChecksumTag(checksum);
+        *position++ = tag & 0xFF;
+        *position++ = tag >> 8;
+        WriteVarint(phantom_node.edgeBasedNode, position);
+        WriteVarint(phantom_node.nodeBasedEdgeNameID, position);
+        WriteVarint(phantom_node.weight1, position);
+        WriteVarint(
+            (INT_MAX == phantom_node.weight2 ? 0 : phantom_node.weight2+1),
+            position
+        );
+        WriteVarint(
+            static_cast<uint32_t>(RATIO_PRECISION*phantom_node.ratio + .5),
+            position
+        );
+        WriteVarint(ZigZag(phantom_node.location.lat), position);
+        WriteVarint(ZigZag(phantom_node.location.lon), position);
+        BOOST_ASSERT(position <= payload + MAX_PAYLOAD_SIZE);
+
+        char text[MAX_ENCODED_LENGTH];
+        const unsigned length = WriteBase64(payload, position, text);
+        encoded.assign(text, length);
+    }
+
+    //returns false if the hint is malformed or belongs to other data
+    static bool Decode(
+        const std::string & encoded,
+        const unsigned checksum,
+        PhantomNode & phantom_node
+    ) {
+        unsigned char payload[MAX_PAYLOAD_SIZE];
+        unsigned payload_size = 0;
+        if( !ReadBase64(encoded, payload, payload_size) ) {
+            return false;
+        }
+        if( 3 > payload_size || HINT_VERSION != payload[0] ) {
+            return false;
+        }
+        const unsigned tag = payload[1] | (payload[2] << 8);
+        if( GetChecksumTag(checksum) != tag ) {
+            return false;
+        }
+
+        const unsigned char * position = payload + 3;
+        const unsigned char * end = payload + payload_size;
+        uint32_t edge_based_node, name_id, weight1, weight2, ratio, lat, lon;
+        if(
+            !ReadVarint(position, end, edge_based_node) ||
+            !ReadVarint(position, end, name_id)         ||
+            !ReadVarint(position, end, weight1)         ||
+            !ReadVarint(position, end, weight2)         ||
+            !ReadVarint(position, end, ratio)           ||
+            !ReadVarint(position, end, lat)             ||
+            !ReadVarint(position, end, lon)             ||
+            position != end                             ||
+            INT_MAX < weight1                           ||
+            INT_MAX < weight2                           ||
+            RATIO_PRECISION < ratio
+        ) {
+            return false;
+        }
+        phantom_node.edgeBasedNode = edge_based_node;
+        phantom_node.nodeBasedEdgeNameID = name_id;
+        phantom_node.weight1 = weight1;
+        phantom_node.weight2 = (0 == weight2 ? INT_MAX : weight2-1);
+        phantom_node.ratio = ratio/double(RATIO_PRECISION);
+        phantom_node.location.lat = UnZigZag(lat);
+        phantom_node.location.lon = UnZigZag(lon);
+        return true;
+    }
+
+private:
+    static const unsigned char HINT_VERSION = 1;
+    static const uint32_t RATIO_PRECISION = 65535;
+    //version, tag and seven varints of at most five bytes each
+    static const unsigned MAX_PAYLOAD_SIZE = 3 + 7*5;
+    static const unsigned MAX_ENCODED_LENGTH = (4*MAX_PAYLOAD_SIZE + 2)/3;
+
+    static inline unsigned GetChecksumTag(const unsigned checksum) {
+        return (checksum ^ (checksum >> 16)) & 0xFFFF;
+    }
+
+    static inline uint32_t ZigZag(const int value) {
+        return (uint32_t(value) << 1) ^ uint32_t(value >> 31);
+    }
+
+    static inline int UnZigZag(const uint32_t value) {
+        return int(value >> 1) ^ -int(value & 1);
+    }
+
+    static inline void WriteVarint(uint32_t value, unsigned char * & position) {
+        while( 0x80 <= value ) {
+            *position++ = (value & 0x7F) | 0x80;
+            value >>= 7;
+        }
+        *position++ = value;
+    }
+
+    static inline bool ReadVarint(
+        const unsigned char * & position,
+        const unsigned char * end,
+        uint32_t & value
+    ) {
+        value = 0;
+        for(unsigned shift = 0; shift < 35; shift += 7) {
+            if( end == position ) {
+                return false;
+            }
+            const unsigned char byte = *position++;
+            //the fifth byte may only carry the four topmost bits
+            if( 28 == shift && 0x0F < byte ) {
+                return false;
+            }
+            value |= uint32_t(byte & 0x7F) << shift;
+            if( 0 == (byte & 0x80) ) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static inline unsigned WriteBase64(
+        const unsigned char * begin,
+        const unsigned char * end,
+        char * text
+    ) {
+        static const char alphabet[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+        char * position = text;
+        for(; begin + 3 <= end; begin += 3) {
+            const uint32_t triple = (begin[0] << 16) | (begin[1] << 8) | begin[2];
+            *position++ = alphabet[(triple >> 18) & 0x3F];
+            *position++ = alphabet[(triple >> 12) & 0x3F];
+            *position++ = alphabet[(triple >>  6) & 0x3F];
+            *position++ = alphabet[ triple        & 0x3F];
+        }
+        if( begin + 2 == end ) {
+            const uint32_t triple = (begin[0] << 16) | (begin[1] << 8);
+            *position++ = alphabet[(triple >> 18) & 0x3F];
+            *position++ = alphabet[(triple >> 12) & 0x3F];
+            *position++ = alphabet[(triple >>  6) & 0x3F];
+        } else if( begin + 1 == end ) {
+            const uint32_t triple = (begin[0] << 16);
+            *position++ = alphabet[(triple >> 18) & 0x3F];
+            *position++ = alphabet[(triple >> 12) & 0x3F];
+        }
+        return position - text;
+    }
+
+    static inline bool ReadBase64(
+        const std::string & text,
+        unsigned char * payload,
+        unsigned & payload_size
+    ) {
+        const unsigned length = text.length();
+        if( MAX_ENCODED_LENGTH < length || 1 == length % 4 ) {
+            return false;
+        }
+        payload_size = 0;
+        uint32_t buffer = 0;
+        unsigned bits_in_buffer = 0;
+        for(unsigned i = 0; i < length; ++i) {
+            const int sextet = DecodeCharacter(text[i]);
+            if( 0 > sextet ) {
+                return false;
+            }
+            buffer = (buffer << 6) | sextet;
+            bits_in_buffer += 6;
+            if( 8 <= bits_in_buffer ) {
+                bits_in_buffer -= 8;
+                payload[payload_size++] = (buffer >> bits_in_buffer) & 0xFF;
+            }
+        }
+        return true;
+    }
+
+    static inline int DecodeCharacter(const unsigned char character) {
+        static const signed char table[256] = {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1,
+        52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+        -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+        15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, 63,
+        -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+        41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+        };
+        return table[character];
+    }
+};
+
+#endif /* PHANTOMNODEHINT_H_ */
@@ -27,121 +27,126 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "PolylineCompressor.h"
 
-void PolylineCompressor::encodeVectorSignedNumber(
-    std::vector<int> & numbers,
-    std::string & output
+//coordinates are stored with six digits, five digit output rounds half away
+//from zero
+int PolylineCompressor::reducePrecision(
+    const int value,
+    const unsigned precision
 ) const {
-    for(unsigned i = 0; i < numbers.size(); ++i) {
-        numbers[i] <<= 1;
-        if (numbers[i] < 0) {
-            numbers[i] = ~(numbers[i]);
-        }
-    }
-    for(unsigned i = 0; i < numbers.size(); ++i) {
-        encodeNumber(numbers[i], output);
+    if( 5 == precision ) {
+        return ( value < 0 ? -((5 - value)/10) : (value + 5)/10 );
     }
+    return value;
 }
 
-void PolylineCompressor::encodeNumber(int number_to_encode, std::string & output) const {
-    while (number_to_encode >= 0x20) {
-        int nextValue = (0x20 | (number_to_encode & 0x1f)) + 63;
-        output += static_cast<char>(nextValue);
-        if(92 == nextValue) {
-            output += static_cast<char>(nextValue);
-        }
-        number_to_encode >>= 5;
+char * PolylineCompressor::encodeNumber(
+    const int number_to_encode,
+    char * output
+) const {
+    //zigzag, sign goes to the lowest bit
+    unsigned number = static_cast<unsigned>(number_to_encode) << 1;
+    if( number_to_encode < 0 ) {
+        number = ~number;
     }
-
-    number_to_encode += 63;
-    output += static_cast<char>(number_to_encode);
-    if(92 == number_to_encode) {
-        output += static_cast<char>(number_to_encode);
+    //all but the last chunk have 0x20 set and never hit the backslash
+    while( number >= 0x20 ) {
+        *output++ = static_cast<char>((0x20 | (number & 0x1f)) + 63);
+        number >>= 5;
     }
+    number += 63;
+    *output++ = static_cast<char>(number);
+    if( 92 == number ) {
+        *output++ = static_cast<char>(number);
+    }
+    return output;
 }
 
 void PolylineCompressor::printEncodedString(
     const std::vector<SegmentInformation> & polyline,
-    std::string & output
+    std::string & output,
+    const unsigned precision
 ) const {
-    std::vector<int> deltaNumbers;
-    output += "\"";
-    if(!polyline.empty()) {
-        FixedPointCoordinate lastCoordinate = polyline[0].location;
-        deltaNumbers.push_back( lastCoordinate.lat );
-        deltaNumbers.push_back( lastCoordinate.lon );
-        for(unsigned i = 1; i < polyline.size(); ++i) {
-            if(!polyline[i].necessary) {
-                continue;
-            }
-            deltaNumbers.push_back(polyline[i].location.lat - lastCoordinate.lat);
-            deltaNumbers.push_back(polyline[i].location.lon - lastCoordinate.lon);
-            lastCoordinate = polyline[i].location;
+    const std::string::size_type offset = output.size();
+    output.resize(offset + 2 + 2*MAX_ENCODED_NUMBER_LENGTH*polyline.size());
+    char * const begin = &output[offset];
+    char * current = begin;
+    *current++ = '"';
+    int last_lat = 0;
+    int last_lon = 0;
+    for(unsigned i = 0; i < polyline.size(); ++i) {
+        if( 0 != i && !polyline[i].necessary ) {
+            continue;
         }
-        encodeVectorSignedNumber(deltaNumbers, output);
+        const int lat = reducePrecision(polyline[i].location.lat, precision);
+        const int lon = reducePrecision(polyline[i].location.lon, precision);
+        current = encodeNumber(lat - last_lat, current);
+        current = encodeNumber(lon - last_lon, current);
+        last_lat = lat;
+        last_lon = lon;
     }
-    output += "\"";
-
+    *current++ = '"';
+    output.resize(offset + (current - begin));
 }
 
 void PolylineCompressor::printEncodedString(
     const std::vector<FixedPointCoordinate>& polyline,
-    std::string &output
+    std::string &output,
+    const unsigned precision
 ) const {
-    std::vector<int> deltaNumbers(2*polyline.size());
-    output += "\"";
-    if(!polyline.empty()) {
-        deltaNumbers[0] = polyline[0].lat;
-        deltaNumbers[1] = polyline[0].lon;
-        for(unsigned i = 1; i < polyline.size(); ++i) {
-            deltaNumbers[(2*i)]   = (polyline[i].lat - polyline[i-1].lat);
-            deltaNumbers[(2*i)+1] = (polyline[i].lon - polyline[i-1].lon);
-        }
-        encodeVectorSignedNumber(deltaNumbers, output);
+    const std::string::size_type offset = output.size();
+    output.resize(offset + 2 + 2*MAX_ENCODED_NUMBER_LENGTH*polyline.size());
+    char * const begin = &output[offset];
+    char * current = begin;
+    *current++ = '"';
+    int last_lat = 0;
+    int last_lon = 0;
+    for(unsigned i = 0; i < polyline.size(); ++i) {
+        const int lat = reducePrecision(polyline[i].lat, precision);
+        const int lon = reducePrecision(polyline[i].lon, precision);
+        current = encodeNumber(lat - last_lat, current);
+        current = encodeNumber(lon - last_lon, current);
+        last_lat = lat;
+        last_lon = lon;
     }
-    output += "\"";
+    *current++ = '"';
+    output.resize(offset + (current - begin));
 }
 
 void PolylineCompressor::printUnencodedString(
     const std::vector<FixedPointCoordinate> & polyline,
-    std::string & output
+    JSONWriter & writer
 ) const {
-    output += "[";
-    std::string tmp;
+    writer.Raw('[');
     for(unsigned i = 0; i < polyline.size(); i++) {
-        convertInternalLatLonToString(polyline[i].lat, tmp);
-        output += "[";
-        output += tmp;
-        convertInternalLatLonToString(polyline[i].lon, tmp);
-        output += ", ";
-        output += tmp;
-        output += "]";
+        writer.Raw('[');
+        writer.FixedPoint(polyline[i].lat);
+        writer.Raw(", ");
+        writer.FixedPoint(polyline[i].lon);
+        writer.Raw(']');
         if( i < polyline.size()-1 ) {
-            output += ",";
+            writer.Raw(',');
         }
     }
-    output += "]";
+    writer.Raw(']');
 }
 
 void PolylineCompressor::printUnencodedString(
     const std::vector<SegmentInformation> & polyline,
-    std::string & output
+    JSONWriter & writer
 ) const {
-    output += "[";
-    std::string tmp;
+    writer.Raw('[');
     for(unsigned i = 0; i < polyline.size(); i++) {
         if(!polyline[i].necessary) {
             continue;
         }
-        convertInternalLatLonToString(polyline[i].location.lat, tmp);
-        output += "[";
-        output += tmp;
-        convertInternalLatLonToString(polyline[i].location.lon, tmp);
-        output += ", ";
-        output += tmp;
-        output += "]";
+        writer.Raw('[');
+        writer.FixedPoint(polyline[i].location.lat);
+        writer.Raw(", ");
+        writer.FixedPoint(polyline[i].location.lon);
+        writer.Raw(']');
         if( i < polyline.size()-1 ) {
-            output += ",";
+            writer.Raw(',');
         }
     }
-    output += "]";
+    writer.Raw(']');
 }
@@ -29,39 +29,48 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define POLYLINECOMPRESSOR_H_
 
 #include "../DataStructures/SegmentInformation.h"
+#include "../Util/JSONWriter.h"
 #include "../Util/StringUtil.h"
 
 #include <string>
 #include <vector>
 
+//Encodes coordinates in the polyline format. Deltas, zigzag and the five bit
+//chunks are computed in a single pass that writes straight into the output
+//string, which is sized for the worst case up front.
 class PolylineCompressor {
 private:
-	void encodeVectorSignedNumber(
-        std::vector<int> & numbers,
-        std::string & output
-    ) const;
+    //seven chunks for 32 bits, only the last one can be a doubled backslash
+    static const unsigned MAX_ENCODED_NUMBER_LENGTH = 8;
+
+    int reducePrecision(const int value, const unsigned precision) const;
 
-	void encodeNumber(int number_to_encode, std::string & output) const;
+    char * encodeNumber(const int number_to_encode, char * output) const;
 
 public:
+    //digits after the decimal point, 5 is what most polyline decoders assume
+    static const unsigned DEFAULT_PRECISION = 6;
+
     void printEncodedString(
         const std::vector<SegmentInformation> & polyline,
-        std::string & output
+        std::string & output,
+        const unsigned precision = DEFAULT_PRECISION
     ) const;
 
     void printEncodedString(
         const std::vector<FixedPointCoordinate>& polyline,
-        std::string &output
+        std::string &output,
+        const unsigned precision = DEFAULT_PRECISION
     ) const;
 
     void printUnencodedString(
         const std::vector<FixedPointCoordinate> & polyline,
-        std::string & output
+        JSONWriter & writer
     ) const;
 
     void printUnencodedString(
         const std::vector<SegmentInformation> & polyline,
-        std::string & output
+        JSONWriter & writer
     ) const;
 
 };
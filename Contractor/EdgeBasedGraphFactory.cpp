@@ -138,6 +138,12 @@ void EdgeBasedGraphFactory::GetEdgeBasedNodes( std::vector<EdgeBasedNode> & node
     nodes.swap(m_edge_based_node_list);
 }
 
+void EdgeBasedGraphFactory::GetRestrictedEdges(
+    std::vector<bool> & restricted_edge_list
+) {
+    restricted_edge_list.swap(m_restricted_edge_list);
+}
+
 NodeID EdgeBasedGraphFactory::CheckForEmanatingIsOnlyTurn(
     const NodeID u,
     const NodeID v
@@ -215,10 +221,11 @@ void EdgeBasedGraphFactory::Run(
         std::ios::binary
     );
 
-    //writes a dummy value that is updated later
+    //writes a dummy header that is updated later
+    OriginalEdgeFileHeader edge_data_header;
     edge_data_file.write(
-        (char*)&original_edges_counter,
-        sizeof(unsigned)
+        (char*)&edge_data_header,
+        sizeof(OriginalEdgeFileHeader)
     );
 
     unsigned current_component = 0, current_component_size = 0;
@@ -351,6 +358,10 @@ void EdgeBasedGraphFactory::Run(
         0 == component_index_list.capacity(),
         "component index vector not deallocated"
     );
+    SimpleLogger().Write() << "computing zoom levels of way geometries";
+    std::vector<unsigned char> node_zoom_level_list;
+    ComputeGeometryZoomLevels(node_zoom_level_list);
+
     std::vector<OriginalEdgeData> original_edge_data_vector;
     original_edge_data_vector.reserve(10000);
 
@@ -427,7 +438,15 @@ void EdgeBasedGraphFactory::Run(
                             OriginalEdgeData(
                                 v,
                                 edge_data2.nameID,
-                                turnInstruction
+                                turnInstruction,
+                                node_zoom_level_list[v]
+                            )
+                        );
+                        //same test as the descriptors do on unpacked paths
+                        m_restricted_edge_list.push_back(
+                            0 != (
+                                turnInstruction &
+                                TurnInstructions.AccessRestrictionFlag
                             )
                         );
                         ++original_edges_counter;
@@ -463,9 +482,10 @@ void EdgeBasedGraphFactory::Run(
         original_edge_data_vector.size()*sizeof(OriginalEdgeData)
     );
     edge_data_file.seekp(std::ios::beg);
+    edge_data_header.number_of_edges = original_edges_counter;
     edge_data_file.write(
-        (char*)&original_edges_counter,
-        sizeof(unsigned)
+        (char*)&edge_data_header,
+        sizeof(OriginalEdgeFileHeader)
     );
     edge_data_file.close();
 
@@ -482,6 +502,111 @@ void EdgeBasedGraphFactory::Run(
         "defined by " << m_turn_restrictions_count << " restrictions";
 }
 
+//successor of current on its way when coming from previous, SPECIAL_NODEID
+//if the way cannot be followed in this direction
+NodeID EdgeBasedGraphFactory::GetNextNodeOnWay(
+    const NodeID previous,
+    const NodeID current
+) const {
+    for(
+        EdgeIterator e = m_node_based_graph->BeginEdges(current),
+            last_edge = m_node_based_graph->EndEdges(current);
+        e < last_edge;
+        ++e
+    ) {
+        const NodeID next = m_node_based_graph->GetTarget(e);
+        if( previous != next ) {
+            return next;
+        }
+    }
+    return SPECIAL_NODEID;
+}
+
+//Ways are chains of nodes with exactly two neighbors. Each way is generalized
+//once, its interior nodes get the smallest zoom level at which the polyline
+//keeps them. All other nodes end ways and are kept at every zoom level.
+void EdgeBasedGraphFactory::ComputeGeometryZoomLevels(
+    std::vector<unsigned char> & node_zoom_level_list
+) const {
+    const NodeID number_of_nodes = m_node_based_graph->GetNumberOfNodes();
+    //neighbors regardless of the direction of the edges, saturates at 3
+    std::vector<unsigned char> neighbor_count_list(number_of_nodes, 0);
+    for( NodeID u = 0; u < number_of_nodes; ++u ) {
+        for(
+            EdgeIterator e = m_node_based_graph->BeginEdges(u),
+                last_edge = m_node_based_graph->EndEdges(u);
+            e < last_edge;
+            ++e
+        ) {
+            const NodeID v = m_node_based_graph->GetTarget(e);
+            const bool has_reverse_edge = (
+                m_node_based_graph->FindEdge(v, u) !=
+                m_node_based_graph->EndEdges(v)
+            );
+            //count edges in both directions only once
+            if( has_reverse_edge && v < u ) {
+                continue;
+            }
+            neighbor_count_list[u] = std::min(3, neighbor_count_list[u]+1);
+            neighbor_count_list[v] = std::min(3, neighbor_count_list[v]+1);
+        }
+    }
+
+    node_zoom_level_list.assign(number_of_nodes, 0);
+    std::vector<bool> visited_node_list(number_of_nodes, false);
+    std::vector<NodeID> way;
+    std::vector<FixedPointCoordinate> way_geometry;
+    std::vector<unsigned char> way_zoom_levels;
+    DouglasPeucker polyline_generalizer;
+    for( NodeID s = 0; s < number_of_nodes; ++s ) {
+        if( 2 == neighbor_count_list[s] ) {
+            continue;
+        }
+        for(
+            EdgeIterator e = m_node_based_graph->BeginEdges(s),
+                last_edge = m_node_based_graph->EndEdges(s);
+            e < last_edge;
+            ++e
+        ) {
+            NodeID previous = s;
+            NodeID current = m_node_based_graph->GetTarget(e);
+            way.clear();
+            way.push_back(s);
+            while(
+                2 == neighbor_count_list[current] &&
+                !visited_node_list[current]
+            ) {
+                const NodeID next = GetNextNodeOnWay(previous, current);
+                if( SPECIAL_NODEID == next ) {
+                    break;
+                }
+                visited_node_list[current] = true;
+                way.push_back(current);
+                previous = current;
+                current = next;
+            }
+            way.push_back(current);
+            if( 3 > way.size() ) {
+                continue;
+            }
+
+            way_geometry.clear();
+            BOOST_FOREACH(const NodeID node, way) {
+                way_geometry.push_back(
+                    FixedPointCoordinate(
+                        m_node_info_list[node].lat,
+                        m_node_info_list[node].lon
+                    )
+                );
+            }
+            polyline_generalizer.ComputeMinZoomLevels(way_geometry, way_zoom_levels);
+            for( unsigned i = 1; i+1 < way.size(); ++i ) {
+                node_zoom_level_list[way[i]] = way_zoom_levels[i];
+            }
+        }
+    }
+}
+
 int EdgeBasedGraphFactory::GetTurnPenalty(
     const NodeID u,
     const NodeID v,
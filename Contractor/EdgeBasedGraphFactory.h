@@ -31,12 +31,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define EDGEBASEDGRAPHFACTORY_H_
 
 #include "../typedefs.h"
+#include "../Algorithms/DouglasPeucker.h"
 #include "../DataStructures/DeallocatingVector.h"
 #include "../DataStructures/DynamicGraph.h"
 #include "../DataStructures/EdgeBasedNode.h"
 #include "../Extractor/ExtractorStructs.h"
 #include "../DataStructures/HashTable.h"
 #include "../DataStructures/ImportEdge.h"
+#include "../DataStructures/OriginalEdgeFile.h"
 #include "../DataStructures/QueryEdge.h"
 #include "../DataStructures/Percent.h"
 #include "../DataStructures/TurnInstructions.h"
@@ -82,6 +84,8 @@ public:
     void Run(const char * originalEdgeDataFilename, lua_State *myLuaState);
     void GetEdgeBasedEdges( DeallocatingVector< EdgeBasedEdge >& edges );
     void GetEdgeBasedNodes( std::vector< EdgeBasedNode> & nodes);
+    //per original edge whether its turn enters a restricted area
+    void GetRestrictedEdges( std::vector<bool> & restricted_edge_list );
     void GetOriginalEdgeData( std::vector<OriginalEdgeData> & originalEdgeData);
     TurnInstruction AnalyzeTurn(
         const NodeID u,
@@ -137,6 +141,7 @@ private:
     std::vector<EmanatingRestrictionsVector>    m_restriction_bucket_list;
     std::vector<EdgeBasedNode>                  m_edge_based_node_list;
     DeallocatingVector<EdgeBasedEdge>           m_edge_based_edge_list;
+    std::vector<bool>                           m_restricted_edge_list;
 
     boost::shared_ptr<NodeBasedDynamicGraph>    m_node_based_graph;
     boost::unordered_set<NodeID>                m_barrier_nodes;
@@ -156,6 +161,15 @@ private:
         const NodeID w
     ) const;
 
+    NodeID GetNextNodeOnWay(
+        const NodeID previous,
+        const NodeID current
+    ) const;
+
+    void ComputeGeometryZoomLevels(
+        std::vector<unsigned char> & node_zoom_level_list
+    ) const;
+
     void InsertEdgeBasedNode(
             NodeBasedDynamicGraph::EdgeIterator e1,
             NodeBasedDynamicGraph::NodeIterator u,
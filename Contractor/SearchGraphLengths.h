@@ -0,0 +1,228 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SEARCH_GRAPH_LENGTHS_H
+#define SEARCH_GRAPH_LENGTHS_H
+
+//Geometric lengths of the nodes and edges of the contracted graph in
+//centimeters. They let queries sum up the length of a route on the packed
+//path without unpacking it.
+//
+//A node is a directed segment of the road network and is as long as that
+//segment. An original edge leads from the middle of its source segment to the
+//middle of its target segment, a shortcut is as long as the two edges it
+//replaces. Summed up along a path this gives the length between the middles of
+//its first and its last segment.
+//
+//Edges also count the restricted areas a route enters along them, which the
+//descriptors take from the access restriction flags of the unpacked path.
+//Nodes need no count, the turn into the first node of a path is not part of
+//it. Counts saturate at UCHAR_MAX.
+
+#include "../DataStructures/Coordinate.h"
+#include "../DataStructures/EdgeBasedNode.h"
+#include "../typedefs.h"
+
+#include <boost/assert.hpp>
+#include <boost/foreach.hpp>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <stack>
+#include <vector>
+
+class SearchGraphLengths {
+public:
+    static void ComputeNodeLengths(
+        const std::vector<EdgeBasedNode> & edge_based_node_list,
+        const unsigned number_of_nodes,
+        std::vector<unsigned> & node_length_list
+    ) {
+        node_length_list.clear();
+        node_length_list.resize(number_of_nodes, 0);
+        BOOST_FOREACH(const EdgeBasedNode & node, edge_based_node_list) {
+            if( node.id >= number_of_nodes ) {
+                continue;
+            }
+            //same distance measure as the route summaries of the descriptors
+            node_length_list[node.id] = (unsigned)std::floor(
+                100.*ApproximateEuclideanDistance(
+                    FixedPointCoordinate(node.lat1, node.lon1),
+                    FixedPointCoordinate(node.lat2, node.lon2)
+                ) + .5
+            );
+        }
+    }
+
+    //node_list and edge_list form the static graph written to .hsgr. The
+    //children of a shortcut are chosen like BasicRoutingInterface::UnpackPath
+    //does. Edges that hold both directions get the length of their forward
+    //direction. restricted_edge_list tells per original edge whether its turn
+    //enters a restricted area.
+    template<class NodeListT, class EdgeListT>
+    static void ComputeEdgeLengths(
+        const NodeListT & node_list,
+        const EdgeListT & edge_list,
+        const std::vector<unsigned> & node_length_list,
+        const std::vector<bool> & restricted_edge_list,
+        std::vector<unsigned> & edge_length_list,
+        std::vector<unsigned char> & edge_restriction_count_list
+    ) {
+        const unsigned number_of_edges = edge_list.size();
+        std::vector<NodeID> source_list(number_of_edges);
+        for(unsigned node = 0; node+1 < node_list.size(); ++node) {
+            for(
+                unsigned edge = node_list[node].firstEdge;
+                edge < node_list[node+1].firstEdge;
+                ++edge
+            ) {
+                source_list[edge] = node;
+            }
+        }
+
+        edge_length_list.clear();
+        edge_length_list.resize(number_of_edges, UINT_MAX);
+        edge_restriction_count_list.clear();
+        edge_restriction_count_list.resize(number_of_edges, 0);
+        std::stack<unsigned> edge_stack;
+        for(unsigned root = 0; root < number_of_edges; ++root) {
+            edge_stack.push(root);
+            while( !edge_stack.empty() ) {
+                const unsigned edge = edge_stack.top();
+                if( UINT_MAX != edge_length_list[edge] ) {
+                    edge_stack.pop();
+                    continue;
+                }
+                NodeID source = source_list[edge];
+                NodeID target = edge_list[edge].target;
+                if( !edge_list[edge].data.forward ) {
+                    std::swap(source, target);
+                }
+                if( !edge_list[edge].data.shortcut ) {
+                    edge_length_list[edge] = (
+                        node_length_list[source] +
+                        node_length_list[target] + 1
+                    )/2;
+                    const unsigned original_edge = edge_list[edge].data.id;
+                    edge_restriction_count_list[edge] = (
+                        original_edge < restricted_edge_list.size() &&
+                        restricted_edge_list[original_edge]
+                    );
+                    edge_stack.pop();
+                    continue;
+                }
+                const NodeID middle = edge_list[edge].data.id;
+                const unsigned first_child = FindUnpackedEdge(
+                    node_list,
+                    edge_list,
+                    source,
+                    middle
+                );
+                const unsigned second_child = FindUnpackedEdge(
+                    node_list,
+                    edge_list,
+                    middle,
+                    target
+                );
+                BOOST_ASSERT_MSG(
+                    UINT_MAX != first_child && UINT_MAX != second_child,
+                    "shortcut without children"
+                );
+                if( UINT_MAX == first_child || UINT_MAX == second_child ) {
+                    edge_length_list[edge] = 0;
+                    edge_stack.pop();
+                    continue;
+                }
+                if( UINT_MAX == edge_length_list[first_child] ) {
+                    edge_stack.push(first_child);
+                    continue;
+                }
+                if( UINT_MAX == edge_length_list[second_child] ) {
+                    edge_stack.push(second_child);
+                    continue;
+                }
+                edge_length_list[edge] =
+                    edge_length_list[first_child] +
+                    edge_length_list[second_child];
+                edge_restriction_count_list[edge] = std::min(
+                    unsigned(UCHAR_MAX),
+                    unsigned(edge_restriction_count_list[first_child]) +
+                    edge_restriction_count_list[second_child]
+                );
+                edge_stack.pop();
+            }
+        }
+    }
+
+private:
+    //the edge UnpackPath takes from 'from' to 'to', UINT_MAX if there is none
+    template<class NodeListT, class EdgeListT>
+    static unsigned FindUnpackedEdge(
+        const NodeListT & node_list,
+        const EdgeListT & edge_list,
+        const NodeID from,
+        const NodeID to
+    ) {
+        unsigned smallest_edge = UINT_MAX;
+        int smallest_distance = INT_MAX;
+        for(
+            unsigned edge = node_list[from].firstEdge;
+            edge < node_list[from+1].firstEdge;
+            ++edge
+        ) {
+            if(
+                to == edge_list[edge].target &&
+                edge_list[edge].data.forward &&
+                edge_list[edge].data.distance < smallest_distance
+            ) {
+                smallest_edge = edge;
+                smallest_distance = edge_list[edge].data.distance;
+            }
+        }
+        if( UINT_MAX != smallest_edge ) {
+            return smallest_edge;
+        }
+        for(
+            unsigned edge = node_list[to].firstEdge;
+            edge < node_list[to+1].firstEdge;
+            ++edge
+        ) {
+            if(
+                from == edge_list[edge].target &&
+                edge_list[edge].data.backward &&
+                edge_list[edge].data.distance < smallest_distance
+            ) {
+                smallest_edge = edge;
+                smallest_distance = edge_list[edge].data.distance;
+            }
+        }
+        return smallest_edge;
+    }
+};
+
+#endif //SEARCH_GRAPH_LENGTHS_H
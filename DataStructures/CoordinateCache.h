@@ -0,0 +1,123 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef COORDINATECACHE_H_
+#define COORDINATECACHE_H_
+
+#include "Coordinate.h"
+#include "LRUCache.h"
+
+#include <boost/assert.hpp>
+#include <boost/integer.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <climits>
+
+//Caches the snapping result of a query coordinate. Coordinates are
+//quantized to 1e-5 degrees (about a meter), so repeated requests for the
+//same place share an entry. The cache is split into shards with a mutex
+//and an LRU list each, which keeps lock contention between server threads
+//low. All entries are dropped when the data checksum changes. Callers only
+//insert coordinates that snapped, so failed lookups never evict good ones.
+
+template<typename ValueT>
+class CoordinateCache : boost::noncopyable {
+public:
+    CoordinateCache() {}
+
+    bool Fetch(
+        const FixedPointCoordinate & coordinate,
+        const unsigned zoom_level,
+        const unsigned checksum,
+        ValueT & result
+    ) {
+        const uint64_t key = GetKey(coordinate, zoom_level);
+        Shard & shard = GetShard(key);
+        boost::mutex::scoped_lock lock(shard.mutex);
+        if(checksum != shard.checksum) {
+            return false;
+        }
+        return shard.cache.Fetch(key, result);
+    }
+
+    void Insert(
+        const FixedPointCoordinate & coordinate,
+        const unsigned zoom_level,
+        const unsigned checksum,
+        const ValueT & value
+    ) {
+        const uint64_t key = GetKey(coordinate, zoom_level);
+        Shard & shard = GetShard(key);
+        boost::mutex::scoped_lock lock(shard.mutex);
+        if(checksum != shard.checksum) {
+            shard.cache.Clear();
+            shard.checksum = checksum;
+        }
+        shard.cache.Insert(key, value);
+    }
+
+private:
+    static const unsigned NUMBER_OF_SHARDS = 16;
+    static const unsigned ENTRIES_PER_SHARD = 4096;
+    //1e-5 degrees in fixed point units
+    static const uint64_t QUANTIZATION = 10;
+
+    struct Shard {
+        Shard() : checksum(UINT_MAX), cache(ENTRIES_PER_SHARD) {}
+        boost::mutex mutex;
+        unsigned checksum;
+        LRUCache<uint64_t, ValueT> cache;
+    };
+
+    //Packs zoom level (5 bits), latitude (25 bits) and longitude (26 bits)
+    //of a valid coordinate into a single key.
+    static inline uint64_t GetKey(
+        const FixedPointCoordinate & coordinate,
+        const unsigned zoom_level
+    ) {
+        BOOST_ASSERT(coordinate.isValid());
+        const uint64_t lat = static_cast<uint64_t>(
+            coordinate.lat +  90*COORDINATE_PRECISION
+        )/QUANTIZATION;
+        const uint64_t lon = static_cast<uint64_t>(
+            coordinate.lon + 180*COORDINATE_PRECISION
+        )/QUANTIZATION;
+        return (uint64_t(zoom_level & 0x1F) << 51) | (lat << 26) | lon;
+    }
+
+    inline Shard & GetShard(const uint64_t key) {
+        //multiplicative hashing spreads neighboring cells over all shards
+        const uint64_t hash = key*0x9E3779B97F4A7C15ULL;
+        return m_shards[(hash >> 32) % NUMBER_OF_SHARDS];
+    }
+
+    Shard m_shards[NUMBER_OF_SHARDS];
+};
+
+#endif /* COORDINATECACHE_H_ */
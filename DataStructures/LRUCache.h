@@ -53,6 +53,13 @@ public:
     }
 
     void Insert(const KeyT key, ValueT &value) {
+        if(Holds(key)) {
+            //an update is a use, move to front like Fetch does
+            typename std::list<CacheEntry>::iterator position = positionMap.find(key)->second;
+            position->value = value;
+            itemsInCache.splice(itemsInCache.begin(), itemsInCache, position);
+            return;
+        }
         itemsInCache.push_front(CacheEntry(key, value));
         positionMap.insert(std::make_pair(key, itemsInCache.begin()));
         if(itemsInCache.size() > capacity) {
@@ -62,6 +69,13 @@ public:
     }
 
     void Insert(const KeyT key, ValueT value) {
+        if(Holds(key)) {
+            //an update is a use, move to front like Fetch does
+            typename std::list<CacheEntry>::iterator position = positionMap.find(key)->second;
+            position->value = value;
+            itemsInCache.splice(itemsInCache.begin(), itemsInCache, position);
+            return;
+        }
         itemsInCache.push_front(CacheEntry(key, value));
         positionMap.insert(std::make_pair(key, itemsInCache.begin()));
         if(itemsInCache.size() > capacity) {
@@ -75,9 +89,8 @@ public:
             CacheEntry e = *(positionMap.find(key)->second);
             result = e.value;
 
-            //move to front
-            itemsInCache.splice(positionMap.find(key)->second, itemsInCache, itemsInCache.begin());
-            positionMap.find(key)->second = itemsInCache.begin();
+            //move to front, list iterators stay valid
+            itemsInCache.splice(itemsInCache.begin(), itemsInCache, positionMap.find(key)->second);
             return true;
         }
         return false;
@@ -85,5 +98,10 @@ public:
     unsigned Size() const {
         return itemsInCache.size();
     }
+
+    void Clear() {
+        itemsInCache.clear();
+        positionMap.clear();
+    }
 };
 #endif //LRUCACHE_H
@@ -0,0 +1,267 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef NAME_STORE_H_
+#define NAME_STORE_H_
+
+#include "SharedMemoryVectorWrapper.h"
+
+#include "../Util/OSRMException.h"
+#include "../Util/SimpleLogger.h"
+#include "../Util/StringUtil.h"
+
+#include <boost/assert.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/integer.hpp>
+
+#include <climits>
+#include <cstring>
+
+#include <string>
+#include <vector>
+
+// Street names are stored HTML escaped and back to back. Instead of one
+// 4 byte begin index per name, blocks of NAME_BLOCK_SIZE names share one
+// offset and keep a length byte per name, i.e. 20 bytes per 16 names.
+// Names of LONG_NAME_LENGTH bytes or more get that value as length byte and
+// their real length as 4 bytes in front of their chars. Names stay
+// contiguous, so they can be handed out without any copy.
+
+static const unsigned NAME_BLOCK_SIZE = 16;
+static const unsigned LONG_NAME_LENGTH = UCHAR_MAX;
+
+struct NameBlock {
+    uint32_t offset;
+    uint8_t  lengths[NAME_BLOCK_SIZE];
+};
+
+// Non-owning view of an escaped name. Valid as long as the store is.
+class NameView {
+public:
+    NameView() : m_begin(""), m_length(0) { }
+    NameView(const char * begin, const unsigned length) :
+        m_begin(begin),
+        m_length(length)
+    { }
+
+    const char * begin() const { return m_begin; }
+    const char * end() const { return m_begin + m_length; }
+    unsigned size() const { return m_length; }
+    bool empty() const { return 0 == m_length; }
+
+private:
+    const char * m_begin;
+    unsigned m_length;
+};
+
+template<bool UseSharedMemory = false>
+class NameStore {
+public:
+    //takes over blocks and chars that were loaded by the caller
+    void Swap(
+        typename ShM<NameBlock, UseSharedMemory>::vector & block_list,
+        typename ShM<char, UseSharedMemory>::vector & char_list
+    ) {
+        m_block_list.swap(block_list);
+        m_char_list.swap(char_list);
+    }
+
+    NameView GetName(const unsigned name_id) const {
+        const unsigned block_id = name_id / NAME_BLOCK_SIZE;
+        if( m_block_list.size() <= block_id ) {
+            //also covers UINT_MAX, i.e. edges without a name
+            return NameView();
+        }
+        const NameBlock & block = m_block_list[block_id];
+        const unsigned position = name_id % NAME_BLOCK_SIZE;
+        uint64_t begin_index = block.offset;
+        for(unsigned i = 0; i < position; ++i) {
+            if( LONG_NAME_LENGTH == block.lengths[i] ) {
+                begin_index += sizeof(uint32_t) + GetLongNameLength(begin_index);
+            } else {
+                begin_index += block.lengths[i];
+            }
+        }
+        unsigned length = block.lengths[position];
+        if( LONG_NAME_LENGTH == length ) {
+            length = GetLongNameLength(begin_index);
+            begin_index += sizeof(uint32_t);
+        }
+        if( 0 == length ) {
+            return NameView();
+        }
+        BOOST_ASSERT_MSG(
+            begin_index + length <= m_char_list.size(),
+            "end index of name too high"
+        );
+        return NameView(&m_char_list[begin_index], length);
+    }
+
+    // .names: #names+1, #chars, name begin indices incl. end, chars
+    static void LoadRawNames(
+        const boost::filesystem::path & names_file,
+        std::vector<NameBlock> & block_list,
+        std::vector<char> & char_list
+    ) {
+        boost::filesystem::ifstream name_stream(names_file, std::ios::binary);
+        if( !name_stream ) {
+            throw OSRMException("names file cannot be opened");
+        }
+        unsigned number_of_indices = 0;
+        unsigned number_of_chars = 0;
+        name_stream.read((char *)&number_of_indices, sizeof(unsigned));
+        name_stream.read((char *)&number_of_chars, sizeof(unsigned));
+
+        std::vector<unsigned> name_begin_indices(number_of_indices);
+        std::vector<char> raw_char_list(number_of_chars);
+        if( 0 != number_of_indices ) {
+            name_stream.read(
+                (char *)&name_begin_indices[0],
+                number_of_indices*sizeof(unsigned)
+            );
+        }
+        if( 0 != number_of_chars ) {
+            name_stream.read((char *)&raw_char_list[0], number_of_chars);
+        }
+        if( !name_stream ) {
+            throw OSRMException("names file is truncated");
+        }
+        Build(name_begin_indices, raw_char_list, block_list, char_list);
+    }
+
+    // Escapes all names and packs them into blocks. name_begin_indices has
+    // one more entry than there are names, its last one ends the last name.
+    static void Build(
+        const std::vector<unsigned> & name_begin_indices,
+        const std::vector<char> & raw_char_list,
+        std::vector<NameBlock> & block_list,
+        std::vector<char> & char_list
+    ) {
+        const unsigned number_of_names = (
+            name_begin_indices.empty() ? 0 : name_begin_indices.size()-1
+        );
+        block_list.clear();
+        block_list.resize(
+            (number_of_names + NAME_BLOCK_SIZE - 1) / NAME_BLOCK_SIZE
+        );
+        char_list.clear();
+        char_list.reserve(raw_char_list.size());
+
+        unsigned number_of_long_names = 0;
+        std::string escaped_name;
+        for(unsigned name_id = 0; name_id < number_of_names; ++name_id) {
+            const unsigned begin_index = name_begin_indices[name_id];
+            const unsigned end_index = name_begin_indices[name_id+1];
+            if(
+                end_index < begin_index ||
+                raw_char_list.size() < end_index
+            ) {
+                throw OSRMException("names file is broken");
+            }
+            EscapeName(
+                raw_char_list.begin() + begin_index,
+                raw_char_list.begin() + end_index,
+                escaped_name
+            );
+
+            NameBlock & block = block_list[name_id / NAME_BLOCK_SIZE];
+            if( 0 == name_id % NAME_BLOCK_SIZE ) {
+                if( UINT_MAX < char_list.size() ) {
+                    throw OSRMException("too many name characters");
+                }
+                block.offset = char_list.size();
+            }
+            if( LONG_NAME_LENGTH <= escaped_name.length() ) {
+                block.lengths[name_id % NAME_BLOCK_SIZE] = LONG_NAME_LENGTH;
+                const uint32_t length = escaped_name.length();
+                char_list.insert(
+                    char_list.end(),
+                    (const char *)&length,
+                    (const char *)&length + sizeof(uint32_t)
+                );
+                ++number_of_long_names;
+            } else {
+                block.lengths[name_id % NAME_BLOCK_SIZE] = escaped_name.length();
+            }
+            char_list.insert(
+                char_list.end(),
+                escaped_name.begin(),
+                escaped_name.end()
+            );
+        }
+        SimpleLogger().Write(logDEBUG) << number_of_names << " names in " <<
+            block_list.size() << " blocks, " << char_list.size() << " chars, " <<
+            number_of_long_names << " long names";
+    }
+
+    const typename ShM<NameBlock, UseSharedMemory>::vector & GetBlockList() const {
+        return m_block_list;
+    }
+
+    const typename ShM<char, UseSharedMemory>::vector & GetCharList() const {
+        return m_char_list;
+    }
+
+private:
+    //real length of a long name, stored in front of its chars
+    unsigned GetLongNameLength(const uint64_t index) const {
+        BOOST_ASSERT_MSG(
+            index + sizeof(uint32_t) <= m_char_list.size(),
+            "index of long name length too high"
+        );
+        uint32_t length;
+        std::memcpy(&length, &m_char_list[index], sizeof(uint32_t));
+        return length;
+    }
+
+    // HTML escapes a name like HTMLEntitize() does
+    static void EscapeName(
+        std::vector<char>::const_iterator begin,
+        const std::vector<char>::const_iterator end,
+        std::string & result
+    ) {
+        static const std::string special_characters("&\"<>'[]\\");
+        result.clear();
+        for(; begin != end; ++begin) {
+            const std::string::size_type entity_index =
+                special_characters.find(*begin);
+            const std::string piece = (
+                std::string::npos == entity_index ?
+                    std::string(1, *begin) :
+                    entities[entity_index]
+            );
+            result += piece;
+        }
+    }
+
+    typename ShM<NameBlock, UseSharedMemory>::vector m_block_list;
+    typename ShM<char, UseSharedMemory>::vector m_char_list;
+};
+
+#endif /* NAME_STORE_H_ */
@@ -0,0 +1,131 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef ORIGINAL_EDGE_FILE_H_
+#define ORIGINAL_EDGE_FILE_H_
+
+//.edges: header followed by OriginalEdgeData records. Files of builds before
+//the geometry zoom levels start with the number of records right away and
+//have uninitialized padding where the zoom levels are stored now.
+
+#include "QueryEdge.h"
+
+#include "../Util/OSRMException.h"
+#include "../Util/SimpleLogger.h"
+
+#include <boost/static_assert.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <string>
+
+struct OriginalEdgeFileHeader {
+    static const uint32_t VERSION = 1;
+
+    char     magic[8];
+    uint32_t version;
+    uint32_t number_of_edges;
+
+    explicit OriginalEdgeFileHeader(const uint32_t number_of_edges = 0) :
+        version(VERSION),
+        number_of_edges(number_of_edges)
+    {
+        std::memcpy(magic, "OSRMEDGE", sizeof(magic));
+    }
+};
+
+BOOST_STATIC_ASSERT(sizeof(OriginalEdgeFileHeader) == 16);
+
+//where the records of an .edges file start and whether their zoom levels
+//can be used
+struct OriginalEdgeFileLayout {
+    OriginalEdgeFileLayout() :
+        records_offset(0),
+        number_of_edges(0),
+        has_zoom_levels(false)
+    { }
+
+    //parses the first bytes of a file, at most the size of a header
+    static OriginalEdgeFileLayout Get(
+        const char * data,
+        const uint64_t size,
+        const std::string & file_name
+    ) {
+        OriginalEdgeFileLayout layout;
+        OriginalEdgeFileHeader header;
+        if(
+            sizeof(OriginalEdgeFileHeader) <= size &&
+            0 == std::memcmp(data, header.magic, sizeof(header.magic))
+        ) {
+            std::memcpy(&header, data, sizeof(OriginalEdgeFileHeader));
+            if( OriginalEdgeFileHeader::VERSION != header.version ) {
+                throw OSRMException(
+                    file_name + " has an unsupported version, reprocess it"
+                );
+            }
+            layout.records_offset = sizeof(OriginalEdgeFileHeader);
+            layout.number_of_edges = header.number_of_edges;
+            layout.has_zoom_levels = true;
+            return layout;
+        }
+        if( sizeof(unsigned) > size ) {
+            throw OSRMException(file_name + " is truncated");
+        }
+        SimpleLogger().Write(logWARNING) <<
+            file_name << " was written by an older osrm-prepare and has no "
+            "geometry zoom levels, route geometry is not generalized. "
+            "Reprocess to get rid of this warning.";
+        std::memcpy(&layout.number_of_edges, data, sizeof(unsigned));
+        layout.records_offset = sizeof(unsigned);
+        return layout;
+    }
+
+    //reads the header and leaves the stream at the first record
+    static OriginalEdgeFileLayout Read(
+        std::istream & input_stream,
+        const std::string & file_name
+    ) {
+        char data[sizeof(OriginalEdgeFileHeader)];
+        input_stream.read(data, sizeof(data));
+        const uint64_t size = std::max(
+            (std::streamsize)0,
+            input_stream.gcount()
+        );
+        input_stream.clear();
+        const OriginalEdgeFileLayout layout = Get(data, size, file_name);
+        input_stream.seekg(layout.records_offset);
+        return layout;
+    }
+
+    uint64_t records_offset;
+    unsigned number_of_edges;
+    bool has_zoom_levels;
+};
+
+#endif /* ORIGINAL_EDGE_FILE_H_ */
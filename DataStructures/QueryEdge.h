@@ -29,22 +29,100 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define QUERYEDGE_H_
 
 #include "TurnInstructions.h"
+#include "../Util/OSRMException.h"
 #include "../typedefs.h"
 
+#include <boost/static_assert.hpp>
+
 #include <climits>
 
+//minZoomLevel takes bytes that were padding before, records of .edges keep
+//their size
 struct OriginalEdgeData{
     explicit OriginalEdgeData(
         NodeID viaNode,
         unsigned nameID,
-        TurnInstruction turnInstruction
-    ) : viaNode(viaNode), nameID(nameID), turnInstruction(turnInstruction) {}
-    OriginalEdgeData() : viaNode(UINT_MAX), nameID(UINT_MAX), turnInstruction(UCHAR_MAX) {}
+        TurnInstruction turnInstruction,
+        unsigned char minZoomLevel
+    ) :
+        viaNode(viaNode),
+        nameID(nameID),
+        turnInstruction(turnInstruction),
+        minZoomLevel(minZoomLevel)
+    {}
+    OriginalEdgeData() : viaNode(UINT_MAX), nameID(UINT_MAX), turnInstruction(UCHAR_MAX), minZoomLevel(0) {}
     NodeID viaNode;
     unsigned nameID;
     TurnInstruction turnInstruction;
+    //smallest zoom level at which generalized geometry keeps the via node
+    unsigned char minZoomLevel;
+};
+
+BOOST_STATIC_ASSERT(sizeof(OriginalEdgeData) == 12);
+
+//OriginalEdgeData in eight bytes as kept by the facades. Name ids use 26 bits,
+//turn instructions 5 bits plus the access restriction flag. Invalid name ids
+//are stored as all ones. Zoom levels do not fit and are kept in a separate
+//byte array.
+struct PackedOriginalEdgeData {
+    static const unsigned NAME_ID_BITS = 26;
+    static const unsigned INVALID_NAME_ID = (1u << NAME_ID_BITS) - 1;
+    static const unsigned TURN_INSTRUCTION_MASK = 0x1f;
+    static const unsigned PACKED_RESTRICTION_FLAG = 0x20;
+
+    PackedOriginalEdgeData() :
+        viaNode(UINT_MAX),
+        nameID(INVALID_NAME_ID),
+        turnInstruction(0)
+    { }
+
+    explicit PackedOriginalEdgeData(const OriginalEdgeData & edge) :
+        viaNode(edge.viaNode),
+        nameID(INVALID_NAME_ID),
+        turnInstruction(
+            (edge.turnInstruction & TURN_INSTRUCTION_MASK) |
+            (
+                (edge.turnInstruction & TurnInstructionsClass::AccessRestrictionFlag) ?
+                PACKED_RESTRICTION_FLAG : 0
+            )
+        )
+    {
+        if( UINT_MAX != edge.nameID ) {
+            if( INVALID_NAME_ID <= edge.nameID ) {
+                throw OSRMException("name id exceeds range of packed edge data");
+            }
+            nameID = edge.nameID;
+        }
+        const unsigned unpacked_bits =
+            TurnInstructionsClass::AccessRestrictionFlag | TURN_INSTRUCTION_MASK;
+        if( edge.turnInstruction & ~unpacked_bits ) {
+            throw OSRMException("turn instruction exceeds range of packed edge data");
+        }
+    }
+
+    inline NodeID GetViaNode() const {
+        return viaNode;
+    }
+
+    inline unsigned GetNameID() const {
+        return (INVALID_NAME_ID == nameID ? UINT_MAX : nameID);
+    }
+
+    inline TurnInstruction GetTurnInstruction() const {
+        return (turnInstruction & TURN_INSTRUCTION_MASK) |
+            (
+                (turnInstruction & PACKED_RESTRICTION_FLAG) ?
+                TurnInstructionsClass::AccessRestrictionFlag : 0
+            );
+    }
+
+    NodeID viaNode;
+    unsigned nameID:NAME_ID_BITS;
+    unsigned turnInstruction:6;
 };
 
+BOOST_STATIC_ASSERT(sizeof(PackedOriginalEdgeData) == 8);
+
 struct QueryEdge {
     NodeID source;
     NodeID target;
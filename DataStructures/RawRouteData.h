@@ -35,11 +35,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 
 struct _PathData {
-    _PathData(NodeID no, unsigned na, unsigned tu, unsigned dur) : node(no), nameID(na), durationOfSegment(dur), turnInstruction(tu) { }
+    _PathData(NodeID no, unsigned na, unsigned tu, unsigned dur, unsigned char zo) : node(no), nameID(na), durationOfSegment(dur), turnInstruction(tu), minZoomLevel(zo) { }
     NodeID node;
     unsigned nameID;
     unsigned durationOfSegment;
     short turnInstruction;
+    unsigned char minZoomLevel;
 };
 
 struct RawRouteData {
@@ -50,7 +51,11 @@ struct RawRouteData {
     unsigned checkSum;
     int lengthOfShortestPath;
     int lengthOfAlternativePath;
-    RawRouteData() : checkSum(UINT_MAX), lengthOfShortestPath(INT_MAX), lengthOfAlternativePath(INT_MAX) {}
+    //meters and restricted areas entered, only set by searches that do not
+    //unpack the path
+    double geometricLengthOfShortestPath;
+    unsigned enteredRestrictedAreasOfShortestPath;
+    RawRouteData() : checkSum(UINT_MAX), lengthOfShortestPath(INT_MAX), lengthOfAlternativePath(INT_MAX), geometricLengthOfShortestPath(0.), enteredRestrictedAreasOfShortestPath(0) {}
 };
 
 #endif /* RAWROUTEDATA_H_ */
@@ -0,0 +1,115 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef SEARCH_GRAPH_TRAILER_H_
+#define SEARCH_GRAPH_TRAILER_H_
+
+//.hsgr: the geometric lengths of nodes and edges and the restriction counts
+//of the edges follow the edges of the search graph behind a header of their
+//own. Files of older builds end after the edges or hold some of the arrays
+//without a header, those are not used.
+
+#include "../Util/OSRMException.h"
+#include "../Util/SimpleLogger.h"
+
+#include <boost/integer.hpp>
+#include <boost/static_assert.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <string>
+
+struct SearchGraphTrailerHeader {
+    static const uint32_t VERSION = 1;
+
+    char     magic[8];
+    uint32_t version;
+    uint32_t number_of_edges;
+
+    explicit SearchGraphTrailerHeader(const uint32_t number_of_edges = 0) :
+        version(VERSION),
+        number_of_edges(number_of_edges)
+    {
+        std::memcpy(magic, "OSRMHSGT", sizeof(magic));
+    }
+
+    //parses the first bytes after the edges, at most the size of a header,
+    //and returns whether node lengths, edge lengths and restriction counts
+    //follow
+    static bool Check(
+        const char * data,
+        const uint64_t size,
+        const unsigned number_of_edges,
+        const std::string & file_name
+    ) {
+        SearchGraphTrailerHeader header;
+        if(
+            sizeof(SearchGraphTrailerHeader) > size ||
+            0 != std::memcmp(data, header.magic, sizeof(header.magic))
+        ) {
+            SimpleLogger().Write(logWARNING) <<
+                file_name << " was written by an older osrm-prepare and has "
+                "no shortcut lengths, route distances without unpacking are "
+                "zero and durations keep access restriction penalties. "
+                "Reprocess to get rid of this warning.";
+            return false;
+        }
+        std::memcpy(&header, data, sizeof(SearchGraphTrailerHeader));
+        if( VERSION != header.version ) {
+            throw OSRMException(
+                file_name + " has an unsupported version, reprocess it"
+            );
+        }
+        if( number_of_edges != header.number_of_edges ) {
+            throw OSRMException(
+                file_name + " holds lengths of a different graph, reprocess it"
+            );
+        }
+        return true;
+    }
+
+    //reads the header and leaves the stream at the node lengths if they follow
+    static bool Read(
+        std::istream & input_stream,
+        const unsigned number_of_edges,
+        const std::string & file_name
+    ) {
+        char data[sizeof(SearchGraphTrailerHeader)];
+        input_stream.read(data, sizeof(data));
+        const uint64_t size = std::max(
+            (std::streamsize)0,
+            input_stream.gcount()
+        );
+        input_stream.clear();
+        return Check(data, size, number_of_edges, file_name);
+    }
+};
+
+BOOST_STATIC_ASSERT(sizeof(SearchGraphTrailerHeader) == 16);
+
+#endif /* SEARCH_GRAPH_TRAILER_H_ */
@@ -40,10 +40,14 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #ifdef __linux__
 #include <sys/ipc.h>
+#include <sys/mman.h>
 #include <sys/shm.h>
 #endif
 
+#include <cerrno>
 #include <cstring>
+#include <fstream>
+#include <string>
 
 #include <algorithm>
 #include <exception>
@@ -118,10 +122,17 @@ public:
     		if( remove_prev ) {
 	    		Remove(key);
 	    	}
+			uint64_t segment_size = size;
+#ifdef __linux__
+			//large regions are backed by huge pages whenever the system has
+			//some reserved, random accesses into the graph then miss the
+			//TLB far less often. Readers inherit the page size on attach.
+			const bool uses_huge_pages = CreateHugePageSegment(key, segment_size);
+#endif
     		shm = boost::interprocess::xsi_shared_memory (
     			boost::interprocess::open_or_create,
     			key,
-    			size
+    			segment_size
     		);
 #ifdef __linux__
 			if( -1 == shmctl(shm.get_shmid(), SHM_LOCK, 0) ) {
@@ -135,6 +146,17 @@ public:
 		    	shm,
 		    	boost::interprocess::read_write
 	    	);
+#ifdef __linux__
+			if( !uses_huge_pages && GetHugePageSize() <= size ) {
+				//fall back to transparent huge pages, if shmem allows them
+				madvise(region.get_address(), region.get_size(), MADV_HUGEPAGE);
+			}
+			if( uses_huge_pages ) {
+				SimpleLogger().Write() <<
+					"shared memory of " << segment_size <<
+					" bytes is backed by huge pages";
+			}
+#endif
 
  			remover.SetID( shm.get_shmid() );
  			SimpleLogger().Write(logDEBUG) <<
@@ -167,6 +189,48 @@ public:
 	}
 
 private:
+#ifdef __linux__
+	//size of a huge page in bytes as reported by the kernel, 0 if unknown
+	static uint64_t GetHugePageSize() {
+		std::ifstream meminfo("/proc/meminfo");
+		std::string field;
+		uint64_t value = 0;
+		while( meminfo >> field ) {
+			if( "Hugepagesize:" == field && meminfo >> value ) {
+				return value*1024;
+			}
+		}
+		return 0;
+	}
+
+	//creates the segment with SHM_HUGETLB and rounds size up to a whole
+	//number of huge pages. Fails without reserved huge pages or permission.
+	static bool CreateHugePageSegment(
+		const boost::interprocess::xsi_key & key,
+		uint64_t & size
+	) {
+		const uint64_t huge_page_size = GetHugePageSize();
+		if( 0 == huge_page_size || size < huge_page_size ) {
+			return false;
+		}
+		const uint64_t rounded_size =
+			((size + huge_page_size - 1)/huge_page_size)*huge_page_size;
+		const int shmid = shmget(
+			key.get_key(),
+			rounded_size,
+			IPC_CREAT | IPC_EXCL | SHM_HUGETLB | 0644
+		);
+		if( -1 == shmid ) {
+			SimpleLogger().Write(logWARNING) <<
+				"no huge pages for shared memory (" << std::strerror(errno) <<
+				"), falling back to regular pages";
+			return false;
+		}
+		size = rounded_size;
+		return true;
+	}
+#endif
+
 	static bool RegionExists( const boost::interprocess::xsi_key &key ) {
 		bool result = true;
 	    try {
@@ -192,6 +192,15 @@ public:
         return tmp;
     }
 
+    //raw arrays, e.g. to prefault or lock them into memory
+    const typename ShM< _StrNode, UseSharedMemory >::vector & GetNodeArray() const {
+        return _nodes;
+    }
+
+    const typename ShM< _StrEdge, UseSharedMemory >::vector & GetEdgeArray() const {
+        return _edges;
+    }
+
 private:
 
     NodeIterator _numNodes;
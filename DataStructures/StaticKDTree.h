@@ -30,7 +30,11 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef STATICKDTREE_H_INCLUDED
 #define STATICKDTREE_H_INCLUDED
 
+#include "SharedMemoryVectorWrapper.h"
+
 #include <boost/assert.hpp>
+#include <climits>
+#include <ostream>
 #include <vector>
 #include <algorithm>
 #include <stack>
@@ -82,9 +86,46 @@ public:
     }
 };
 
-template < unsigned k, typename T, typename Data = NoData, typename Metric = EuclidianMetric< k, T > >
+// Euclidian metric with a per-dimension scale factor, e.g. to compress
+// longitudes by cos(lat) for an equirectangular projection
+template< unsigned k, typename T >
+class WeightedEuclidianMetric {
+public:
+    WeightedEuclidianMetric() {
+        for ( unsigned dim = 0; dim < k; ++dim ) {
+            weight[dim] = 1.;
+        }
+    }
+
+    double operator() ( const T left[k], const T right[k] ) {
+        double result = 0;
+        for ( unsigned i = 0; i < k; ++i ) {
+            double temp = weight[i] * ( (double)left[i] - (double)right[i] );
+            result += temp * temp;
+        }
+        return result;
+    }
+
+    double operator() ( const BoundingBox< k, T > &box, const T point[k] ) {
+        T nearest[k];
+        for ( unsigned dim = 0; dim < k; ++dim ) {
+            if ( point[dim] < box.min[dim] )
+                nearest[dim] = box.min[dim];
+            else if ( point[dim] > box.max[dim] )
+                nearest[dim] = box.max[dim];
+            else
+                nearest[dim] = point[dim];
+        }
+        return operator() ( point, nearest );
+    }
+
+    double weight[k];
+};
+
+template < unsigned k, typename T, typename Data = NoData, typename Metric = EuclidianMetric< k, T >, bool UseSharedMemory = false >
 class StaticKDTree {
 public:
+    typedef unsigned Iterator;
 
     struct InputPoint {
         T coordinates[k];
@@ -103,7 +144,7 @@ public:
         BOOST_ASSERT( k > 0 );
         BOOST_ASSERT ( points->size() > 0 );
         size = points->size();
-        kdtree = new InputPoint[size];
+        kdtree.resize( size );
         for ( Iterator i = 0; i != size; ++i ) {
             kdtree[i] = points->at(i);
             for ( unsigned dim = 0; dim < k; ++dim ) {
@@ -123,25 +164,41 @@ public:
                 continue;
 
             Iterator middle = tree.left + ( tree.right - tree.left ) / 2;
-            std::nth_element( kdtree + tree.left, kdtree + middle, kdtree + tree.right, Less( tree.dimension ) );
+            InputPoint * base = &kdtree[0];
+            std::nth_element( base + tree.left, base + middle, base + tree.right, Less( tree.dimension ) );
             s.push( Tree( tree.left, middle, ( tree.dimension + 1 ) % k ) );
             s.push( Tree( middle + 1, tree.right, ( tree.dimension + 1 ) % k ) );
         }
     }
 
-    ~StaticKDTree(){
-        delete[] kdtree;
+    // takes over points that are already in tree order, e.g. loaded from a
+    // file written by Serialize() or placed in shared memory
+    explicit StaticKDTree( typename ShM< InputPoint, UseSharedMemory >::vector & tree_points ){
+        BOOST_ASSERT( k > 0 );
+        BOOST_ASSERT ( tree_points.size() > 0 );
+        kdtree.swap( tree_points );
+        size = kdtree.size();
+    }
+
+    // writes the number of points followed by the points in tree order
+    void Serialize( std::ostream & out ) const {
+        out.write( (const char *)&size, sizeof( Iterator ) );
+        out.write( (const char *)&kdtree[0], size * sizeof( InputPoint ) );
+    }
+
+    Iterator GetNumberOfPoints() const {
+        return size;
     }
 
-    bool NearestNeighbor( InputPoint* result, const InputPoint& point ) {
-        Metric distance;
+    bool NearestNeighbor( InputPoint* result, const InputPoint& point, Metric distance = Metric() ) const {
         bool found = false;
-        double nearestDistance = std::numeric_limits< T >::max();
-        std::stack< NNTree > s;
-        s.push ( NNTree ( 0, size, 0, boundingBox ) );
-        while ( !s.empty() ) {
-            NNTree tree = s.top();
-            s.pop();
+        double nearestDistance = std::numeric_limits< double >::max();
+        // every level leaves at most one sibling on the stack
+        NNTree s[2 * sizeof( Iterator ) * CHAR_BIT];
+        unsigned stack_size = 0;
+        s[stack_size++] = NNTree ( 0, size, 0, boundingBox );
+        while ( 0 != stack_size ) {
+            NNTree tree = s[--stack_size];
 
             if ( distance( tree.box, point.coordinates ) >= nearestDistance )
                 continue;
@@ -173,23 +230,26 @@ public:
                 NNTree second( tree.left, middle, ( tree.dimension + 1 ) % k, tree.box );
                 first.box.min[tree.dimension] = kdtree[middle].coordinates[tree.dimension];
                 second.box.max[tree.dimension] = kdtree[middle].coordinates[tree.dimension];
-                s.push( second );
-                s.push( first );
+                s[stack_size++] = second;
+                s[stack_size++] = first;
             }
             else {
                 NNTree first( middle + 1, tree.right, ( tree.dimension + 1 ) % k, tree.box );
                 NNTree second( tree.left, middle, ( tree.dimension + 1 ) % k, tree.box );
                 first.box.min[tree.dimension] = kdtree[middle].coordinates[tree.dimension];
                 second.box.max[tree.dimension] = kdtree[middle].coordinates[tree.dimension];
-                s.push( first );
-                s.push( second );
+                s[stack_size++] = first;
+                s[stack_size++] = second;
             }
         }
         return found;
     }
 
+    const typename ShM< InputPoint, UseSharedMemory >::vector & GetTreePoints() const {
+        return kdtree;
+    }
+
 private:
-    typedef unsigned Iterator;
     struct Tree {
         Iterator left;
         Iterator right;
@@ -221,7 +281,7 @@ private:
     };
 
     BoundingBox< k, T > boundingBox;
-    InputPoint* kdtree;
+    typename ShM< InputPoint, UseSharedMemory >::vector kdtree;
     Iterator size;
 };
 
@@ -0,0 +1,181 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef STATICPOINTINDEX_H_
+#define STATICPOINTINDEX_H_
+
+#include "Coordinate.h"
+#include "SharedMemoryVectorWrapper.h"
+#include "StaticKDTree.h"
+
+#include "../Util/OSRMException.h"
+#include "../Util/SimpleLogger.h"
+#include "../typedefs.h"
+
+#include <boost/assert.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <cmath>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Static 2d-tree over the coordinates of all routable graph nodes. Answers
+// locate requests with a pure point nearest neighbor query instead of
+// scanning the edge segments stored in the r-tree leaves.
+
+template<bool UseSharedMemory = false>
+class StaticPointIndex : boost::noncopyable {
+public:
+    typedef KDTree::WeightedEuclidianMetric<2, int> MetricT;
+    typedef KDTree::StaticKDTree<
+        2,
+        int,
+        KDTree::NoData,
+        MetricT,
+        UseSharedMemory
+    > KDTreeT;
+    typedef typename KDTreeT::InputPoint PointT;
+
+    // Sorts out duplicates, builds the tree and writes it to disk
+    static void Build(
+        std::vector<FixedPointCoordinate> & coordinate_list,
+        const std::string & point_index_filename
+    ) {
+        std::sort(coordinate_list.begin(), coordinate_list.end(), CoordinateLess);
+        coordinate_list.erase(
+            std::unique(coordinate_list.begin(), coordinate_list.end()),
+            coordinate_list.end()
+        );
+        if( coordinate_list.empty() ) {
+            throw OSRMException("no coordinates to build point index from");
+        }
+
+        std::vector<PointT> input_point_list(coordinate_list.size());
+        for(unsigned i = 0; i < coordinate_list.size(); ++i) {
+            input_point_list[i].coordinates[0] = coordinate_list[i].lat;
+            input_point_list[i].coordinates[1] = coordinate_list[i].lon;
+        }
+        KDTree::StaticKDTree<2, int, KDTree::NoData, MetricT> kd_tree(
+            &input_point_list
+        );
+
+        boost::filesystem::ofstream point_index_file(
+            point_index_filename,
+            std::ios::binary
+        );
+        kd_tree.Serialize(point_index_file);
+        point_index_file.close();
+        SimpleLogger().Write() <<
+            "point index has " << coordinate_list.size() << " coordinates";
+    }
+
+    explicit StaticPointIndex(const boost::filesystem::path & point_index_file) {
+        if ( !boost::filesystem::exists( point_index_file ) ) {
+            throw OSRMException("point index file does not exist");
+        }
+        if ( 0 == boost::filesystem::file_size( point_index_file ) ) {
+            throw OSRMException("point index file is empty");
+        }
+        boost::filesystem::ifstream point_index_stream(
+            point_index_file,
+            std::ios::binary
+        );
+        typename KDTreeT::Iterator number_of_points = 0;
+        point_index_stream.read(
+            (char*)&number_of_points,
+            sizeof(typename KDTreeT::Iterator)
+        );
+        typename ShM<PointT, UseSharedMemory>::vector point_list(number_of_points);
+        point_index_stream.read(
+            (char*)&point_list[0],
+            number_of_points*sizeof(PointT)
+        );
+        point_index_stream.close();
+        m_kd_tree.reset( new KDTreeT(point_list) );
+    }
+
+    explicit StaticPointIndex(
+        PointT * point_ptr,
+        const uint64_t number_of_points
+    ) {
+        typename ShM<PointT, UseSharedMemory>::vector point_list(
+            point_ptr,
+            number_of_points
+        );
+        m_kd_tree.reset( new KDTreeT(point_list) );
+    }
+
+    //takes over points that were loaded by the caller
+    explicit StaticPointIndex(
+        typename ShM<PointT, UseSharedMemory>::vector & point_list
+    ) {
+        m_kd_tree.reset( new KDTreeT(point_list) );
+    }
+
+    bool LocateClosestPoint(
+        const FixedPointCoordinate & input_coordinate,
+        FixedPointCoordinate & result_coordinate
+    ) const {
+        //rank points in an equirectangular projection around the input
+        MetricT distance;
+        distance.weight[1] = std::cos(
+            (input_coordinate.lat/COORDINATE_PRECISION)*M_PI/180.
+        );
+        PointT query_point;
+        query_point.coordinates[0] = input_coordinate.lat;
+        query_point.coordinates[1] = input_coordinate.lon;
+        PointT nearest_point;
+        if( !m_kd_tree->NearestNeighbor(&nearest_point, query_point, distance) ) {
+            return false;
+        }
+        result_coordinate.lat = nearest_point.coordinates[0];
+        result_coordinate.lon = nearest_point.coordinates[1];
+        return true;
+    }
+
+    const typename ShM<PointT, UseSharedMemory>::vector & GetTreePoints() const {
+        return m_kd_tree->GetTreePoints();
+    }
+
+private:
+    static inline bool CoordinateLess(
+        const FixedPointCoordinate & a,
+        const FixedPointCoordinate & b
+    ) {
+        return (a.lat < b.lat) || (a.lat == b.lat && a.lon < b.lon);
+    }
+
+    boost::scoped_ptr<KDTreeT> m_kd_tree;
+};
+
+#endif /* STATICPOINTINDEX_H_ */
@@ -42,6 +42,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../typedefs.h"
 
 #include <boost/assert.hpp>
+#include <boost/atomic.hpp>
 #include <boost/bind.hpp>
 #include <boost/foreach.hpp>
 #include <boost/filesystem.hpp>
@@ -55,17 +56,28 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <algorithm>
 #include <limits>
-#include <queue>
+#include <functional>
 #include <string>
 #include <vector>
 
 //tuning parameters
 const static uint32_t RTREE_BRANCHING_FACTOR = 50;
 const static uint32_t RTREE_LEAF_NODE_SIZE = 1170;
+//a tree of this height indexes 50^15 leaves, i.e. far more than any data set
+const static uint32_t RTREE_MAX_HEIGHT = 16;
 
 // Implements a static, i.e. packed, R-tree
 
-static boost::thread_specific_ptr<boost::filesystem::ifstream> thread_local_rtree_stream;
+//leaf file stream of a thread and the tree it was opened for. A tree that
+//replaces another one, e.g. after a data reload, never reads through a
+//stream that still points to the file of its predecessor.
+struct RTreeLeafStream {
+    boost::filesystem::ifstream stream;
+    uint64_t tree_id;
+};
+
+static boost::thread_specific_ptr<RTreeLeafStream> thread_local_rtree_stream;
+static boost::atomic<uint64_t> rtree_instance_counter(0);
 
 template<class DataT, bool UseSharedMemory = false>
 class StaticRTree : boost::noncopyable {
@@ -131,92 +143,29 @@ public:
             );
         }
 
-        inline double GetMinDist(const FixedPointCoordinate & location) const {
-            bool is_contained = Contains(location);
-            if (is_contained) {
-                return 0.0;
+        //Lower bound on the squared distance in degrees from location to any
+        //point inside the rectangle. Longitudinal gaps are scaled by
+        //lon_scale, i.e. pass cos(lat) for an equirectangular metric or 1.
+        //for plain lat/lon space. Needs no trigonometry at all.
+        inline double GetMinSquaredDist(
+            const FixedPointCoordinate & location,
+            const double lon_scale
+        ) const {
+            int64_t lat_gap = 0;
+            if(location.lat < min_lat) {
+                lat_gap = int64_t(min_lat) - location.lat;
+            } else if(location.lat > max_lat) {
+                lat_gap = int64_t(location.lat) - max_lat;
             }
-
-            double min_dist = std::numeric_limits<double>::max();
-            min_dist = std::min(
-                    min_dist,
-                    ApproximateDistance(
-                            location.lat,
-                            location.lon,
-                            max_lat,
-                            min_lon
-                    )
-            );
-            min_dist = std::min(
-                    min_dist,
-                    ApproximateDistance(
-                            location.lat,
-                            location.lon,
-                            max_lat,
-                            max_lon
-                    )
-            );
-            min_dist = std::min(
-                    min_dist,
-                    ApproximateDistance(
-                            location.lat,
-                            location.lon,
-                            min_lat,
-                            max_lon
-                    )
-            );
-            min_dist = std::min(
-                    min_dist,
-                    ApproximateDistance(
-                            location.lat,
-                            location.lon,
-                            min_lat,
-                            min_lon
-                    )
-            );
-            return min_dist;
-        }
-
-        inline double GetMinMaxDist(const FixedPointCoordinate & location) const {
-            double min_max_dist = std::numeric_limits<double>::max();
-            //Get minmax distance to each of the four sides
-            FixedPointCoordinate upper_left (max_lat, min_lon);
-            FixedPointCoordinate upper_right(max_lat, max_lon);
-            FixedPointCoordinate lower_right(min_lat, max_lon);
-            FixedPointCoordinate lower_left (min_lat, min_lon);
-
-            min_max_dist = std::min(
-                    min_max_dist,
-                    std::max(
-                            ApproximateDistance(location, upper_left ),
-                            ApproximateDistance(location, upper_right)
-                    )
-            );
-
-            min_max_dist = std::min(
-                    min_max_dist,
-                    std::max(
-                            ApproximateDistance(location, upper_right),
-                            ApproximateDistance(location, lower_right)
-                    )
-            );
-
-            min_max_dist = std::min(
-                    min_max_dist,
-                    std::max(
-                            ApproximateDistance(location, lower_right),
-                            ApproximateDistance(location, lower_left )
-                    )
-            );
-
-            min_max_dist = std::min(
-                    min_max_dist,
-                    std::max(
-                            ApproximateDistance(location, lower_left ),
-                            ApproximateDistance(location, upper_left )
-                    )
-            );
-            return min_max_dist;
+            int64_t lon_gap = 0;
+            if(location.lon < min_lon) {
+                lon_gap = int64_t(min_lon) - location.lon;
+            } else if(location.lon > max_lon) {
+                lon_gap = int64_t(location.lon) - max_lon;
+            }
+            const double y = lat_gap/COORDINATE_PRECISION;
+            const double x = (lon_gap/COORDINATE_PRECISION)*lon_scale;
+            return x*x + y*y;
         }
 
         inline bool Contains(const FixedPointCoordinate & location) const {
@@ -249,6 +198,12 @@ public:
         uint32_t children[RTREE_BRANCHING_FACTOR];
     };
 
+    struct LeafNode {
+        LeafNode() : object_count(0) {}
+        uint32_t object_count;
+        DataT objects[RTREE_LEAF_NODE_SIZE];
+    };
+
 private:
 
     struct WrappedInputElement {
@@ -267,12 +222,6 @@ private:
         }
     };
 
-    struct LeafNode {
-        LeafNode() : object_count(0) {}
-        uint32_t object_count;
-        DataT objects[RTREE_LEAF_NODE_SIZE];
-    };
-
     struct QueryCandidate {
         explicit QueryCandidate(
             const uint32_t n_id,
@@ -284,12 +233,60 @@ private:
         inline bool operator<(const QueryCandidate & other) const {
             return min_dist < other.min_dist;
         }
+        inline bool operator>(const QueryCandidate & other) const {
+            return min_dist > other.min_dist;
+        }
+    };
+
+    //Pending tree nodes of the depth-first branch-and-bound search [2].
+    //Children are pushed farthest first, so the closest one is expanded
+    //next. Every level on the current path holds at most one node's
+    //children, which bounds the capacity and keeps queries off the heap.
+    class CandidateStack {
+    public:
+        CandidateStack() : m_size(0) {}
+
+        inline bool Empty() const {
+            return 0 == m_size;
+        }
+
+        inline void Push(const QueryCandidate & candidate) {
+            BOOST_ASSERT_MSG(m_size < CAPACITY, "candidate stack overflow");
+            m_candidates[m_size] = candidate;
+            ++m_size;
+        }
+
+        inline QueryCandidate Pop() {
+            BOOST_ASSERT_MSG(0 < m_size, "candidate stack underflow");
+            --m_size;
+            return m_candidates[m_size];
+        }
+
+        inline void PushClosestLast(
+            QueryCandidate * first,
+            QueryCandidate * last
+        ) {
+            std::sort(first, last, std::greater<QueryCandidate>());
+            for(; first != last; ++first) {
+                Push(*first);
+            }
+        }
+
+    private:
+        static const uint32_t CAPACITY =
+            RTREE_MAX_HEIGHT*RTREE_BRANCHING_FACTOR;
+        QueryCandidate m_candidates[CAPACITY];
+        uint32_t m_size;
     };
 
     typename ShM<TreeNode, UseSharedMemory>::vector m_search_tree;
     uint64_t m_element_count;
 
     const std::string m_leaf_node_filename;
+    //leaf data may be embedded into a larger file, e.g. a data container
+    const uint64_t m_leaf_file_offset;
+    //identifies the thread local leaf streams opened for this tree
+    const uint64_t m_tree_id;
 public:
     //Construct a packed Hilbert-R-Tree with Kamel-Faloutsos algorithm [1]
     explicit StaticRTree(
@@ -298,7 +295,9 @@ public:
         const std::string leaf_node_filename
     )
      :  m_element_count(input_data_vector.size()),
-        m_leaf_node_filename(leaf_node_filename)
+        m_leaf_node_filename(leaf_node_filename),
+        m_leaf_file_offset(0),
+        m_tree_id(++rtree_instance_counter)
     {
         SimpleLogger().Write() <<
             "constructing r-tree of " << m_element_count <<
@@ -422,7 +421,10 @@ public:
     explicit StaticRTree(
             const boost::filesystem::path & node_file,
             const boost::filesystem::path & leaf_file
-    ) : m_leaf_node_filename(leaf_file.string()) {
+    ) : m_leaf_node_filename(leaf_file.string()),
+        m_leaf_file_offset(0),
+        m_tree_id(++rtree_instance_counter)
+    {
         //open tree node file and load into RAM.
 
         if ( !boost::filesystem::exists( node_file ) ) {
@@ -450,6 +452,7 @@ public:
         boost::filesystem::ifstream leaf_node_file( leaf_file, std::ios::binary );
         leaf_node_file.read((char*)&m_element_count, sizeof(uint64_t));
         leaf_node_file.close();
+        CheckTreeHeight();
 
         //SimpleLogger().Write() << tree_size << " nodes in search tree";
         //SimpleLogger().Write() << m_element_count << " elements in leafs";
@@ -458,28 +461,27 @@ public:
     explicit StaticRTree(
             TreeNode * tree_node_ptr,
             const uint32_t number_of_nodes,
-            const boost::filesystem::path & leaf_file
+            const boost::filesystem::path & leaf_file,
+            const uint64_t leaf_file_offset = 0
     ) : m_search_tree(tree_node_ptr, number_of_nodes),
-        m_leaf_node_filename(leaf_file.string())
+        m_leaf_node_filename(leaf_file.string()),
+        m_leaf_file_offset(leaf_file_offset),
+        m_tree_id(++rtree_instance_counter)
     {
-        //open leaf node file and store thread specific pointer
-        if ( !boost::filesystem::exists( leaf_file ) ) {
-            throw OSRMException("mem index file does not exist");
-        }
-        if ( 0 == boost::filesystem::file_size( leaf_file ) ) {
-            throw OSRMException("mem index file is empty");
-        }
-
-        boost::filesystem::ifstream leaf_node_file( leaf_file, std::ios::binary );
-        leaf_node_file.read((char*)&m_element_count, sizeof(uint64_t));
-        leaf_node_file.close();
-
-        if( thread_local_rtree_stream.get() ) {
-            thread_local_rtree_stream->close();
-        }
+        OpenLeafFile(leaf_file);
+    }
 
-        //SimpleLogger().Write() << tree_size << " nodes in search tree";
-        //SimpleLogger().Write() << m_element_count << " elements in leafs";
+    //takes over tree nodes that were loaded by the caller
+    explicit StaticRTree(
+            typename ShM<TreeNode, UseSharedMemory>::vector & tree_nodes,
+            const boost::filesystem::path & leaf_file,
+            const uint64_t leaf_file_offset = 0
+    ) : m_leaf_node_filename(leaf_file.string()),
+        m_leaf_file_offset(leaf_file_offset),
+        m_tree_id(++rtree_instance_counter)
+    {
+        m_search_tree.swap(tree_nodes);
+        OpenLeafFile(leaf_file);
     }
     //Read-only operation for queries
 /*
@@ -635,236 +637,128 @@ public:
             FixedPointCoordinate & result_coordinate,
             const unsigned zoom_level
     ) {
-        bool ignore_tiny_components = (zoom_level <= 14);
-        DataT nearest_edge;
-        double min_dist = std::numeric_limits<double>::max();
-        double min_max_dist = std::numeric_limits<double>::max();
-        bool found_a_nearest_edge = false;
-
-        //initialize queue with root element
-        std::priority_queue<QueryCandidate> traversal_queue;
-        double current_min_dist = m_search_tree[0].minimum_bounding_rectangle.GetMinDist(input_coordinate);
-        traversal_queue.push(
-            QueryCandidate(0, current_min_dist)
+        //endpoints are ranked in an equirectangular projection around the
+        //input coordinate, which needs a single cosine per query.
+        const double lon_scale = std::cos(
+            (input_coordinate.lat/COORDINATE_PRECISION)*M_PI/180.
         );
-
-        BOOST_ASSERT_MSG(
-            std::numeric_limits<double>::epsilon() > (0. - traversal_queue.top().min_dist),
-            "Root element in NN Search has min dist != 0."
+        EndPointLeafProcessor leaf_processor(
+            input_coordinate,
+            result_coordinate,
+            lon_scale,
+            (zoom_level <= 14)
         );
+        SearchNearestFirst(input_coordinate, lon_scale, leaf_processor);
+        return leaf_processor.found_a_nearest_edge;
+    }
 
-        while(!traversal_queue.empty()) {
-            const QueryCandidate current_query_node = traversal_queue.top();
-            traversal_queue.pop();
-
-            const bool prune_downward = (current_query_node.min_dist >= min_max_dist);
-            const bool prune_upward = (current_query_node.min_dist >= min_dist);
-            if( !prune_downward && !prune_upward ) { //downward pruning
-                TreeNode & current_tree_node = m_search_tree[current_query_node.node_id];
-                if (current_tree_node.child_is_on_disk) {
-                    LeafNode current_leaf_node;
-                    LoadLeafFromDisk(
-                        current_tree_node.children[0],
-                        current_leaf_node
-                    );
-                    for(uint32_t i = 0; i < current_leaf_node.object_count; ++i) {
-                        const DataT & current_edge = current_leaf_node.objects[i];
-                        if(
-                            ignore_tiny_components &&
-                            current_edge.belongsToTinyComponent
-                        ) {
-                            continue;
-                        }
-                        if(current_edge.isIgnored()) {
-                            continue;
-                        }
+    bool FindPhantomNodeForCoordinate(
+            const FixedPointCoordinate & input_coordinate,
+            PhantomNode & result_phantom_node,
+            const unsigned zoom_level
+    ) {
+        return FindPhantomNodeForCoordinate(
+            input_coordinate,
+            result_phantom_node,
+            zoom_level,
+            NULL
+        );
+    }
 
-                        double current_minimum_distance = ApproximateDistance(
-                                input_coordinate.lat,
-                                input_coordinate.lon,
-                                current_edge.lat1,
-                                current_edge.lon1
-                            );
-                        if( current_minimum_distance < min_dist ) {
-                            //found a new minimum
-                            min_dist = current_minimum_distance;
-                            result_coordinate.lat = current_edge.lat1;
-                            result_coordinate.lon = current_edge.lon1;
-                            found_a_nearest_edge = true;
-                        }
+    //Answers a batch of nearest queries in input order. The queries are
+    //processed in Hilbert order, so that consecutive searches descend
+    //through the same tree nodes and mostly hit leaves that an earlier
+    //query of the batch has already read from disk.
+    void FindPhantomNodesForCoordinates(
+            const std::vector<FixedPointCoordinate> & input_coordinates,
+            std::vector<PhantomNode> & result_phantom_nodes,
+            const unsigned zoom_level
+    ) {
+        const uint32_t number_of_queries = input_coordinates.size();
+        std::vector<WrappedInputElement> query_order(number_of_queries);
+        for(uint32_t i = 0; i < number_of_queries; ++i) {
+            //same mercator projection as the bulk loader, so that the query
+            //order follows the order in which the leaves were packed
+            FixedPointCoordinate projected_coordinate = input_coordinates[i];
+            projected_coordinate.lat = COORDINATE_PRECISION*lat2y(
+                projected_coordinate.lat/COORDINATE_PRECISION
+            );
+            query_order[i] = WrappedInputElement(
+                i,
+                HilbertCode::GetHilbertNumberForCoordinate(projected_coordinate)
+            );
+        }
+        std::sort(query_order.begin(), query_order.end());
+
+        result_phantom_nodes.clear();
+        result_phantom_nodes.resize(number_of_queries);
+        LeafNodeCache leaf_cache;
+        BOOST_FOREACH(const WrappedInputElement & query, query_order) {
+            FindPhantomNodeForCoordinate(
+                input_coordinates[query.m_array_index],
+                result_phantom_nodes[query.m_array_index],
+                zoom_level,
+                &leaf_cache
+            );
+        }
+    }
 
-                        current_minimum_distance = ApproximateDistance(
-                                input_coordinate.lat,
-                                input_coordinate.lon,
-                                current_edge.lat2,
-                                current_edge.lon2
-                            );
+    //inner nodes, the leaves are read from disk
+    const typename ShM<TreeNode, UseSharedMemory>::vector & GetSearchTree() const {
+        return m_search_tree;
+    }
 
-                        if( current_minimum_distance < min_dist ) {
-                            //found a new minimum
-                            min_dist = current_minimum_distance;
-                            result_coordinate.lat = current_edge.lat2;
-                            result_coordinate.lon = current_edge.lon2;
-                            found_a_nearest_edge = true;
-                        }
-                    }
-                } else {
-                    //traverse children, prune if global mindist is smaller than local one
-                    for (uint32_t i = 0; i < current_tree_node.child_count; ++i) {
-                        const int32_t child_id = current_tree_node.children[i];
-                        const TreeNode & child_tree_node = m_search_tree[child_id];
-                        const RectangleT & child_rectangle = child_tree_node.minimum_bounding_rectangle;
-                        const double current_min_dist = child_rectangle.GetMinDist(input_coordinate);
-                        const double current_min_max_dist = child_rectangle.GetMinMaxDist(input_coordinate);
-                        if( current_min_max_dist < min_max_dist ) {
-                            min_max_dist = current_min_max_dist;
-                        }
-                        if (current_min_dist > min_max_dist) {
-                            continue;
-                        }
-                        if (current_min_dist > min_dist) { //upward pruning
-                            continue;
-                        }
-                        traversal_queue.push(
-                            QueryCandidate(child_id, current_min_dist)
-                        );
-                    }
-                }
+private:
+    //Recently read leaves of a batch query. Slots are direct-mapped by leaf
+    //id, which matches the Hilbert order in which leaves are packed.
+    class LeafNodeCache : boost::noncopyable {
+    public:
+        LeafNodeCache() :
+            m_leaves(NUMBER_OF_SLOTS),
+            m_leaf_ids(NUMBER_OF_SLOTS, UINT_MAX)
+        { }
+
+        inline const LeafNode * Find(const uint32_t leaf_id) const {
+            const uint32_t slot = leaf_id % NUMBER_OF_SLOTS;
+            if(leaf_id != m_leaf_ids[slot]) {
+                return NULL;
             }
+            return &m_leaves[slot];
         }
 
-        return found_a_nearest_edge;
-    }
+        inline LeafNode & Insert(const uint32_t leaf_id) {
+            const uint32_t slot = leaf_id % NUMBER_OF_SLOTS;
+            m_leaf_ids[slot] = leaf_id;
+            return m_leaves[slot];
+        }
 
+    private:
+        static const uint32_t NUMBER_OF_SLOTS = 8;
+        std::vector<LeafNode> m_leaves;
+        std::vector<uint32_t> m_leaf_ids;
+    };
 
     bool FindPhantomNodeForCoordinate(
             const FixedPointCoordinate & input_coordinate,
             PhantomNode & result_phantom_node,
-            const unsigned zoom_level
+            const unsigned zoom_level,
+            LeafNodeCache * leaf_cache
     ) {
-
-        bool ignore_tiny_components = (zoom_level <= 14);
-        DataT nearest_edge;
-
-        uint32_t io_count = 0;
-        uint32_t explored_tree_nodes_count = 0;
-        //SimpleLogger().Write() << "searching for coordinate " << input_coordinate;
-        double min_dist = std::numeric_limits<double>::max();
-        double min_max_dist = std::numeric_limits<double>::max();
-        bool found_a_nearest_edge = false;
-
-        FixedPointCoordinate nearest, current_start_coordinate, current_end_coordinate;
-
-        //initialize queue with root element
-        std::priority_queue<QueryCandidate> traversal_queue;
-        double current_min_dist = m_search_tree[0].minimum_bounding_rectangle.GetMinDist(input_coordinate);
-        traversal_queue.push(
-                             QueryCandidate(0, current_min_dist)
+        PhantomNodeLeafProcessor leaf_processor(
+            input_coordinate,
+            result_phantom_node,
+            (zoom_level <= 14)
         );
+        //perpendicular distances are measured in plain lat/lon space
+        SearchNearestFirst(input_coordinate, 1., leaf_processor, leaf_cache);
 
-        BOOST_ASSERT_MSG(
-            std::numeric_limits<double>::epsilon() > (0. - traversal_queue.top().min_dist),
-            "Root element in NN Search has min dist != 0."
-        );
-
-        while(!traversal_queue.empty()) {
-            const QueryCandidate current_query_node = traversal_queue.top(); traversal_queue.pop();
-
-            ++explored_tree_nodes_count;
-            bool prune_downward = (current_query_node.min_dist >= min_max_dist);
-            bool prune_upward    = (current_query_node.min_dist >= min_dist);
-            if( !prune_downward && !prune_upward ) { //downward pruning
-                TreeNode & current_tree_node = m_search_tree[current_query_node.node_id];
-                if (current_tree_node.child_is_on_disk) {
-                    LeafNode current_leaf_node;
-                    LoadLeafFromDisk(current_tree_node.children[0], current_leaf_node);
-                    ++io_count;
-                    for(uint32_t i = 0; i < current_leaf_node.object_count; ++i) {
-                        DataT & current_edge = current_leaf_node.objects[i];
-                        if(ignore_tiny_components && current_edge.belongsToTinyComponent) {
-                            continue;
-                        }
-                        if(current_edge.isIgnored()) {
-                            continue;
-                        }
-
-                       double current_ratio = 0.;
-                       double current_perpendicular_distance = ComputePerpendicularDistance(
-                                input_coordinate,
-                                FixedPointCoordinate(current_edge.lat1, current_edge.lon1),
-                                FixedPointCoordinate(current_edge.lat2, current_edge.lon2),
-                                nearest,
-                                &current_ratio
-                        );
-
-                        if(
-                                current_perpendicular_distance < min_dist
-                                && !DoubleEpsilonCompare(
-                                        current_perpendicular_distance,
-                                        min_dist
-                                )
-                        ) { //found a new minimum
-                            min_dist = current_perpendicular_distance;
-                            result_phantom_node.edgeBasedNode = current_edge.id;
-                            result_phantom_node.nodeBasedEdgeNameID = current_edge.nameID;
-                            result_phantom_node.weight1 = current_edge.weight;
-                            result_phantom_node.weight2 = INT_MAX;
-                            result_phantom_node.location = nearest;
-                            current_start_coordinate.lat = current_edge.lat1;
-                            current_start_coordinate.lon = current_edge.lon1;
-                            current_end_coordinate.lat = current_edge.lat2;
-                            current_end_coordinate.lon = current_edge.lon2;
-                            nearest_edge = current_edge;
-                            found_a_nearest_edge = true;
-                        } else if(
-                                DoubleEpsilonCompare(current_perpendicular_distance, min_dist) &&
-                                1 == abs(current_edge.id - result_phantom_node.edgeBasedNode )
-                        && CoordinatesAreEquivalent(
-                                current_start_coordinate,
-                                FixedPointCoordinate(
-                                        current_edge.lat1,
-                                        current_edge.lon1
-                                ),
-                                FixedPointCoordinate(
-                                        current_edge.lat2,
-                                        current_edge.lon2
-                                ),
-                                current_end_coordinate
-                            )
-                        ) {
-
-                            BOOST_ASSERT_MSG(current_edge.id != result_phantom_node.edgeBasedNode, "IDs not different");
-                            result_phantom_node.weight2 = current_edge.weight;
-                            if(current_edge.id < result_phantom_node.edgeBasedNode) {
-                                result_phantom_node.edgeBasedNode = current_edge.id;
-                                std::swap(result_phantom_node.weight1, result_phantom_node.weight2);
-                                std::swap(current_end_coordinate, current_start_coordinate);
-                            }
-                        }
-                    }
-                } else {
-                    //traverse children, prune if global mindist is smaller than local one
-                    for (uint32_t i = 0; i < current_tree_node.child_count; ++i) {
-                        const int32_t child_id = current_tree_node.children[i];
-                        TreeNode & child_tree_node = m_search_tree[child_id];
-                        RectangleT & child_rectangle = child_tree_node.minimum_bounding_rectangle;
-                        const double current_min_dist = child_rectangle.GetMinDist(input_coordinate);
-                        const double current_min_max_dist = child_rectangle.GetMinMaxDist(input_coordinate);
-                        if( current_min_max_dist < min_max_dist ) {
-                            min_max_dist = current_min_max_dist;
-                        }
-                        if (current_min_dist > min_max_dist) {
-                            continue;
-                        }
-                        if (current_min_dist > min_dist) { //upward pruning
-                            continue;
-                        }
-                        traversal_queue.push(QueryCandidate(child_id, current_min_dist));
-                    }
-                }
-            }
-        }
+        const bool found_a_nearest_edge = leaf_processor.found_a_nearest_edge;
+        const FixedPointCoordinate & current_start_coordinate =
+            leaf_processor.current_start_coordinate;
+        const FixedPointCoordinate & current_end_coordinate =
+            leaf_processor.current_end_coordinate;
 
+        //exact distances are only computed for the final candidate
         const double ratio = (found_a_nearest_edge ?
             std::min(1., ApproximateDistance(current_start_coordinate,
                 result_phantom_node.location)/ApproximateDistance(current_start_coordinate, current_end_coordinate)
@@ -888,33 +782,272 @@ public:
 
     }
 
-private:
+    //Scans a leaf for the closest end point of any edge. Distances are
+    //squared degrees in an equirectangular projection.
+    struct EndPointLeafProcessor {
+        EndPointLeafProcessor(
+            const FixedPointCoordinate & input_coordinate,
+            FixedPointCoordinate & result_coordinate,
+            const double lon_scale,
+            const bool ignore_tiny_components
+        ) :
+            input_coordinate(input_coordinate),
+            result_coordinate(result_coordinate),
+            lon_scale(lon_scale),
+            ignore_tiny_components(ignore_tiny_components),
+            min_dist(std::numeric_limits<double>::max()),
+            found_a_nearest_edge(false)
+        { }
+
+        inline void operator()(const LeafNode & current_leaf_node) {
+            for(uint32_t i = 0; i < current_leaf_node.object_count; ++i) {
+                const DataT & current_edge = current_leaf_node.objects[i];
+                if(
+                    ignore_tiny_components &&
+                    current_edge.belongsToTinyComponent
+                ) {
+                    continue;
+                }
+                if(current_edge.isIgnored()) {
+                    continue;
+                }
+                ConsiderEndPoint(current_edge.lat1, current_edge.lon1);
+                ConsiderEndPoint(current_edge.lat2, current_edge.lon2);
+            }
+        }
+
+        inline void ConsiderEndPoint(const int lat, const int lon) {
+            const double y = (lat - input_coordinate.lat)/COORDINATE_PRECISION;
+            const double x = ((lon - input_coordinate.lon)/COORDINATE_PRECISION)*lon_scale;
+            const double current_minimum_distance = x*x + y*y;
+            if( current_minimum_distance < min_dist ) {
+                //found a new minimum
+                min_dist = current_minimum_distance;
+                result_coordinate.lat = lat;
+                result_coordinate.lon = lon;
+                found_a_nearest_edge = true;
+            }
+        }
+
+        const FixedPointCoordinate & input_coordinate;
+        FixedPointCoordinate & result_coordinate;
+        const double lon_scale;
+        const bool ignore_tiny_components;
+        double min_dist;
+        bool found_a_nearest_edge;
+    };
+
+    //Scans a leaf for the edge with the smallest perpendicular distance and
+    //merges the two directions of a bidirectional edge into one phantom node.
+    struct PhantomNodeLeafProcessor {
+        PhantomNodeLeafProcessor(
+            const FixedPointCoordinate & input_coordinate,
+            PhantomNode & result_phantom_node,
+            const bool ignore_tiny_components
+        ) :
+            input_coordinate(input_coordinate),
+            result_phantom_node(result_phantom_node),
+            ignore_tiny_components(ignore_tiny_components),
+            min_dist(std::numeric_limits<double>::max()),
+            found_a_nearest_edge(false)
+        { }
+
+        inline void operator()(const LeafNode & current_leaf_node) {
+            FixedPointCoordinate nearest;
+            for(uint32_t i = 0; i < current_leaf_node.object_count; ++i) {
+                const DataT & current_edge = current_leaf_node.objects[i];
+                if(ignore_tiny_components && current_edge.belongsToTinyComponent) {
+                    continue;
+                }
+                if(current_edge.isIgnored()) {
+                    continue;
+                }
+
+                double current_ratio = 0.;
+                double current_perpendicular_distance = ComputePerpendicularDistance(
+                        input_coordinate,
+                        FixedPointCoordinate(current_edge.lat1, current_edge.lon1),
+                        FixedPointCoordinate(current_edge.lat2, current_edge.lon2),
+                        nearest,
+                        &current_ratio
+                );
+
+                if(
+                        current_perpendicular_distance < min_dist
+                        && !DoubleEpsilonCompare(
+                                current_perpendicular_distance,
+                                min_dist
+                        )
+                ) { //found a new minimum
+                    min_dist = current_perpendicular_distance;
+                    result_phantom_node.edgeBasedNode = current_edge.id;
+                    result_phantom_node.nodeBasedEdgeNameID = current_edge.nameID;
+                    result_phantom_node.weight1 = current_edge.weight;
+                    result_phantom_node.weight2 = INT_MAX;
+                    result_phantom_node.location = nearest;
+                    current_start_coordinate.lat = current_edge.lat1;
+                    current_start_coordinate.lon = current_edge.lon1;
+                    current_end_coordinate.lat = current_edge.lat2;
+                    current_end_coordinate.lon = current_edge.lon2;
+                    found_a_nearest_edge = true;
+                } else if(
+                        DoubleEpsilonCompare(current_perpendicular_distance, min_dist) &&
+                        EdgeIDsAreAdjacent(current_edge.id, result_phantom_node.edgeBasedNode)
+                && CoordinatesAreEquivalent(
+                        current_start_coordinate,
+                        FixedPointCoordinate(
+                                current_edge.lat1,
+                                current_edge.lon1
+                        ),
+                        FixedPointCoordinate(
+                                current_edge.lat2,
+                                current_edge.lon2
+                        ),
+                        current_end_coordinate
+                    )
+                ) {
+
+                    BOOST_ASSERT_MSG(current_edge.id != result_phantom_node.edgeBasedNode, "IDs not different");
+                    result_phantom_node.weight2 = current_edge.weight;
+                    if(current_edge.id < result_phantom_node.edgeBasedNode) {
+                        result_phantom_node.edgeBasedNode = current_edge.id;
+                        std::swap(result_phantom_node.weight1, result_phantom_node.weight2);
+                        std::swap(current_end_coordinate, current_start_coordinate);
+                    }
+                }
+            }
+        }
+
+        const FixedPointCoordinate & input_coordinate;
+        PhantomNode & result_phantom_node;
+        const bool ignore_tiny_components;
+        double min_dist;
+        bool found_a_nearest_edge;
+        FixedPointCoordinate current_start_coordinate;
+        FixedPointCoordinate current_end_coordinate;
+    };
+
+    //Depth-first branch-and-bound nearest neighbor search [2]. The leaf
+    //processor keeps the best distance found so far in min_dist, which must
+    //be measured in the same metric as GetMinSquaredDist(.., lon_scale).
+    //Leaves are looked up in and added to leaf_cache if one is given.
+    template<class LeafProcessorT>
+    inline void SearchNearestFirst(
+        const FixedPointCoordinate & input_coordinate,
+        const double lon_scale,
+        LeafProcessorT & leaf_processor,
+        LeafNodeCache * leaf_cache = NULL
+    ) {
+        LeafNode current_leaf_node;
+        CandidateStack traversal_stack;
+        QueryCandidate child_candidates[RTREE_BRANCHING_FACTOR];
+
+        //initialize stack with root element
+        traversal_stack.Push(QueryCandidate(0, 0.));
+        while(!traversal_stack.Empty()) {
+            const QueryCandidate current_query_node = traversal_stack.Pop();
+            //the bound may have shrunk since this candidate was pushed
+            if(current_query_node.min_dist > leaf_processor.min_dist) {
+                continue;
+            }
+
+            const TreeNode & current_tree_node = m_search_tree[current_query_node.node_id];
+            if (current_tree_node.child_is_on_disk) {
+                const uint32_t leaf_id = current_tree_node.children[0];
+                if(NULL == leaf_cache) {
+                    LoadLeafFromDisk(leaf_id, current_leaf_node);
+                    leaf_processor(current_leaf_node);
+                    continue;
+                }
+                const LeafNode * cached_leaf_node = leaf_cache->Find(leaf_id);
+                if(NULL == cached_leaf_node) {
+                    LeafNode & new_leaf_node = leaf_cache->Insert(leaf_id);
+                    LoadLeafFromDisk(leaf_id, new_leaf_node);
+                    cached_leaf_node = &new_leaf_node;
+                }
+                leaf_processor(*cached_leaf_node);
+                continue;
+            }
+
+            //traverse children, prune if global mindist is smaller than local one
+            uint32_t number_of_candidates = 0;
+            for (uint32_t i = 0; i < current_tree_node.child_count; ++i) {
+                const uint32_t child_id = current_tree_node.children[i];
+                const RectangleT & child_rectangle =
+                    m_search_tree[child_id].minimum_bounding_rectangle;
+                const double current_min_dist =
+                    child_rectangle.GetMinSquaredDist(input_coordinate, lon_scale);
+                if (current_min_dist > leaf_processor.min_dist) {
+                    continue;
+                }
+                child_candidates[number_of_candidates] =
+                    QueryCandidate(child_id, current_min_dist);
+                ++number_of_candidates;
+            }
+            traversal_stack.PushClosestLast(
+                child_candidates,
+                child_candidates + number_of_candidates
+            );
+        }
+    }
+
+    inline void CheckTreeHeight() const {
+        uint32_t tree_height = 1;
+        uint32_t current_node_id = 0;
+        while(!m_search_tree[current_node_id].child_is_on_disk) {
+            current_node_id = m_search_tree[current_node_id].children[0];
+            ++tree_height;
+        }
+        if(RTREE_MAX_HEIGHT < tree_height) {
+            throw OSRMException("r-tree too high, index file broken?");
+        }
+    }
+
+    inline void OpenLeafFile(const boost::filesystem::path & leaf_file) {
+        //open leaf node file and store thread specific pointer
+        if ( !boost::filesystem::exists( leaf_file ) ) {
+            throw OSRMException("mem index file does not exist");
+        }
+        if ( boost::filesystem::file_size( leaf_file ) <= m_leaf_file_offset ) {
+            throw OSRMException("mem index file is empty");
+        }
+
+        boost::filesystem::ifstream leaf_node_file( leaf_file, std::ios::binary );
+        leaf_node_file.seekg(m_leaf_file_offset);
+        leaf_node_file.read((char*)&m_element_count, sizeof(uint64_t));
+        leaf_node_file.close();
+        CheckTreeHeight();
+    }
+
     inline void LoadLeafFromDisk(const uint32_t leaf_id, LeafNode& result_node) {
+        RTreeLeafStream * leaf_stream = thread_local_rtree_stream.get();
         if(
-            !thread_local_rtree_stream.get() ||
-            !thread_local_rtree_stream->is_open()
+            NULL == leaf_stream ||
+            m_tree_id != leaf_stream->tree_id ||
+            !leaf_stream->stream.is_open()
         ) {
-            thread_local_rtree_stream.reset(
-                new boost::filesystem::ifstream(
-                        m_leaf_node_filename,
-                        std::ios::in | std::ios::binary
-                )
+            leaf_stream = new RTreeLeafStream();
+            leaf_stream->stream.open(
+                m_leaf_node_filename,
+                std::ios::in | std::ios::binary
             );
+            leaf_stream->tree_id = m_tree_id;
+            thread_local_rtree_stream.reset(leaf_stream);
         }
-        if(!thread_local_rtree_stream->good()) {
-            thread_local_rtree_stream->clear(std::ios::goodbit);
+        if(!leaf_stream->stream.good()) {
+            leaf_stream->stream.clear(std::ios::goodbit);
             SimpleLogger().Write(logDEBUG) << "Resetting stale filestream";
         }
-        uint64_t seek_pos = sizeof(uint64_t) + leaf_id*sizeof(LeafNode);
-        thread_local_rtree_stream->seekg(seek_pos);
-        thread_local_rtree_stream->read((char *)&result_node, sizeof(LeafNode));
+        uint64_t seek_pos = m_leaf_file_offset + sizeof(uint64_t) + leaf_id*sizeof(LeafNode);
+        leaf_stream->stream.seekg(seek_pos);
+        leaf_stream->stream.read((char *)&result_node, sizeof(LeafNode));
     }
 
-    inline double ComputePerpendicularDistance(
+    static inline double ComputePerpendicularDistance(
             const FixedPointCoordinate& inputPoint,
             const FixedPointCoordinate& source,
             const FixedPointCoordinate& target,
-            FixedPointCoordinate& nearest, double *r) const {
+            FixedPointCoordinate& nearest, double *r) {
         const double x = inputPoint.lat/COORDINATE_PRECISION;
         const double y = inputPoint.lon/COORDINATE_PRECISION;
         const double a = source.lat/COORDINATE_PRECISION;
@@ -958,14 +1091,19 @@ private:
         return (p-x)*(p-x) + (q-y)*(q-y);
     }
 
-    inline bool CoordinatesAreEquivalent(const FixedPointCoordinate & a, const FixedPointCoordinate & b, const FixedPointCoordinate & c, const FixedPointCoordinate & d) const {
+    static inline bool CoordinatesAreEquivalent(const FixedPointCoordinate & a, const FixedPointCoordinate & b, const FixedPointCoordinate & c, const FixedPointCoordinate & d) {
         return (a == b && c == d) || (a == c && b == d) || (a == d && b == c);
     }
 
-    inline bool DoubleEpsilonCompare(const double d1, const double d2) const {
+    static inline bool DoubleEpsilonCompare(const double d1, const double d2) {
         return (std::fabs(d1 - d2) < std::numeric_limits<double>::epsilon() );
     }
 
+    //both directions of an edge get consecutive edge-based node ids
+    static inline bool EdgeIDsAreAdjacent(const NodeID a, const NodeID b) {
+        return (a + 1 == b) || (b + 1 == a);
+    }
+
 };
 
 //[1] "On Packing R-Trees"; I. Kamel, C. Faloutsos; 1993; DOI: 10.1145/170088.170403
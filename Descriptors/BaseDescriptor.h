@@ -46,12 +46,18 @@ struct DescriptorConfig {
         instructions(true),
         geometry(true),
         encode_geometry(true),
-        zoom_level(18)
+        generalize(false),
+        zoom_level(18),
+        geometry_precision(6)
     { }
     bool instructions;
     bool geometry;
     bool encode_geometry;
+    //GPX only, the other formats always write the generalized geometry
+    bool generalize;
     unsigned short zoom_level;
+    //digits of encoded geometries, 5 or 6
+    unsigned short geometry_precision;
 };
 
 template<class DataFacadeT>
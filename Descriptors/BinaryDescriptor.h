@@ -0,0 +1,297 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef BINARY_DESCRIPTOR_H_
+#define BINARY_DESCRIPTOR_H_
+
+#include "BaseDescriptor.h"
+#include "DescriptionFactory.h"
+#include "../Algorithms/PhantomNodeHint.h"
+#include "../DataStructures/NameStore.h"
+#include "../DataStructures/SegmentInformation.h"
+#include "../DataStructures/TurnInstructions.h"
+#include "../Library/BinaryRouteFormat.h"
+
+#include <boost/foreach.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <cmath>
+
+#include <string>
+#include <vector>
+
+//writes routes in the format described in BinaryRouteFormat.h
+template<class DataFacadeT>
+class BinaryDescriptor : public BaseDescriptor<DataFacadeT> {
+private:
+    typedef boost::unordered_map<unsigned, unsigned> NameIndexMap;
+
+    DescriptorConfig config;
+    DescriptionFactory description_factory;
+    DescriptionFactory alternative_description_factory;
+    //position of each name id in the name table
+    NameIndexMap name_indices;
+    std::string name_table;
+    //instructions of the route being written
+    std::string instructions;
+
+public:
+    void SetConfig(const DescriptorConfig & c) { config = c; }
+
+    void Run(
+        http::Reply & reply,
+        const RawRouteData & raw_route_information,
+        PhantomNodes & phantom_nodes,
+        const DataFacadeT * facade
+    ) {
+        //instances are reused, their buffers keep their capacity
+        description_factory.Clear();
+        alternative_description_factory.Clear();
+        name_indices.clear();
+        name_table.clear();
+
+        reply.content.push_back(std::string());
+        std::string & output = reply.content.back();
+
+        const bool found_route =
+            ( INT_MAX != raw_route_information.lengthOfShortestPath );
+        const bool found_alternative = found_route &&
+            ( INT_MAX != raw_route_information.lengthOfAlternativePath );
+        unsigned flags = 0;
+        flags |= ( found_route ? BinaryRouteFormat::ROUTE_FOUND : 0 );
+        flags |= ( found_alternative ? BinaryRouteFormat::ALTERNATIVE_FOUND : 0 );
+        flags |= ( config.geometry ? BinaryRouteFormat::GEOMETRY : 0 );
+        flags |= ( config.instructions ? BinaryRouteFormat::INSTRUCTIONS : 0 );
+
+        output.append(BinaryRouteFormat::GetMagic(), 4);
+        BinaryRouteFormat::AppendUInt8(BinaryRouteFormat::VERSION, output);
+        BinaryRouteFormat::AppendUInt8(flags, output);
+        BinaryRouteFormat::AppendUInt16(0, output);
+        BinaryRouteFormat::AppendUInt32(raw_route_information.checkSum, output);
+
+        if( found_route ) {
+            WriteRoute(
+                description_factory,
+                raw_route_information.computedShortestPath,
+                raw_route_information.lengthOfShortestPath,
+                phantom_nodes,
+                facade,
+                output
+            );
+        }
+        if( found_alternative ) {
+            WriteRoute(
+                alternative_description_factory,
+                raw_route_information.computedAlternativePath,
+                raw_route_information.lengthOfAlternativePath,
+                phantom_nodes,
+                facade,
+                output
+            );
+        }
+
+        const std::vector<PhantomNodes> & segment_end_coordinates =
+            raw_route_information.segmentEndCoordinates;
+        if( found_route && config.geometry ) {
+            BinaryRouteFormat::AppendVarint(segment_end_coordinates.size()+1, output);
+            for(unsigned i = 0; i < segment_end_coordinates.size(); ++i) {
+                WriteCoordinate(
+                    segment_end_coordinates[i].startPhantom.location.isSet() ?
+                    segment_end_coordinates[i].startPhantom.location :
+                    raw_route_information.rawViaNodeCoordinates[i],
+                    output
+                );
+            }
+            WriteCoordinate(
+                segment_end_coordinates.back().startPhantom.location.isSet() ?
+                segment_end_coordinates.back().targetPhantom.location :
+                raw_route_information.rawViaNodeCoordinates.back(),
+                output
+            );
+        } else {
+            BinaryRouteFormat::AppendVarint(0, output);
+        }
+
+        BinaryRouteFormat::AppendVarint(segment_end_coordinates.size()+1, output);
+        std::string hint;
+        for(unsigned i = 0; i < segment_end_coordinates.size(); ++i) {
+            PhantomNodeHint::Encode(
+                segment_end_coordinates[i].startPhantom,
+                raw_route_information.checkSum,
+                hint
+            );
+            BinaryRouteFormat::AppendString(hint.data(), hint.data()+hint.size(), output);
+        }
+        PhantomNodeHint::Encode(
+            segment_end_coordinates.back().targetPhantom,
+            raw_route_information.checkSum,
+            hint
+        );
+        BinaryRouteFormat::AppendString(hint.data(), hint.data()+hint.size(), output);
+
+        BinaryRouteFormat::AppendVarint(name_indices.size(), output);
+        output.append(name_table);
+    }
+
+private:
+    void WriteRoute(
+        DescriptionFactory & factory,
+        const std::vector<_PathData> & path,
+        const int route_length,
+        const PhantomNodes & phantom_nodes,
+        const DataFacadeT * facade,
+        std::string & output
+    ) {
+        //instructions are built first, they count the restricted areas
+        instructions.clear();
+        unsigned number_of_instructions = 0;
+        unsigned entered_restricted_area_count = 0;
+        if( !config.geometry && !config.instructions ) {
+            entered_restricted_area_count = factory.RunSummaryOnly(
+                facade,
+                phantom_nodes,
+                path
+            );
+        } else {
+            factory.Reserve(path.size());
+            factory.SetStartSegment(phantom_nodes.startPhantom);
+            BOOST_FOREACH(const _PathData & path_data, path) {
+                factory.AppendSegment(facade->GetCoordinateOfNode(path_data.node), path_data);
+            }
+            factory.SetEndSegment(phantom_nodes.targetPhantom);
+            factory.BuildSegments();
+            factory.Generalize(config.zoom_level);
+            if( config.instructions ) {
+                factory.ComputeBearings();
+            }
+        }
+        unsigned number_of_necessary_segments = 0;
+        unsigned roundabout_exit = 0;
+        BOOST_FOREACH(const SegmentInformation & segment, factory.pathDescription) {
+            const TurnInstruction current_instruction =
+                segment.turnInstruction & TurnInstructions.InverseAccessRestrictionFlag;
+            entered_restricted_area_count += (current_instruction != segment.turnInstruction);
+            if(
+                config.instructions &&
+                TurnInstructions.TurnIsNecessary(current_instruction) &&
+                TurnInstructions.EnterRoundAbout != current_instruction
+            ) {
+                if( TurnInstructions.LeaveRoundAbout == current_instruction ) {
+                    BinaryRouteFormat::AppendUInt8(TurnInstructions.EnterRoundAbout, instructions);
+                    BinaryRouteFormat::AppendUInt8(roundabout_exit+1, instructions);
+                    roundabout_exit = 0;
+                } else {
+                    BinaryRouteFormat::AppendUInt8(current_instruction, instructions);
+                    BinaryRouteFormat::AppendUInt8(0, instructions);
+                }
+                BinaryRouteFormat::AppendVarint(GetNameIndex(segment.nameID, facade), instructions);
+                BinaryRouteFormat::AppendVarint(unsigned(segment.length), instructions);
+                BinaryRouteFormat::AppendVarint(number_of_necessary_segments, instructions);
+                BinaryRouteFormat::AppendVarint(segment.duration/10, instructions);
+                BinaryRouteFormat::AppendUInt16(unsigned(round(segment.bearing)) % 360, instructions);
+                ++number_of_instructions;
+            } else if( TurnInstructions.StayOnRoundAbout == current_instruction ) {
+                ++roundabout_exit;
+            }
+            if( segment.necessary ) {
+                ++number_of_necessary_segments;
+            }
+        }
+        if( config.instructions ) {
+            BinaryRouteFormat::AppendUInt8(TurnInstructions.ReachedYourDestination, instructions);
+            BinaryRouteFormat::AppendUInt8(0, instructions);
+            BinaryRouteFormat::AppendVarint(GetNameIndex(UINT_MAX, facade), instructions);
+            BinaryRouteFormat::AppendVarint(0, instructions);
+            BinaryRouteFormat::AppendVarint(
+                ( 0 < number_of_necessary_segments ? number_of_necessary_segments-1 : 0 ),
+                instructions
+            );
+            BinaryRouteFormat::AppendVarint(0, instructions);
+            BinaryRouteFormat::AppendUInt16(0, instructions);
+            ++number_of_instructions;
+        }
+
+        factory.BuildRouteSummary(
+            factory.entireLength,
+            route_length - entered_restricted_area_count*TurnInstructions.AccessRestrictionPenalty
+        );
+        BinaryRouteFormat::AppendUInt32(factory.summary.distance, output);
+        BinaryRouteFormat::AppendUInt32(factory.summary.duration, output);
+        //start and end point are the ones of the shortest path
+        BinaryRouteFormat::AppendUInt32(
+            GetNameIndex(description_factory.summary.startName, facade),
+            output
+        );
+        BinaryRouteFormat::AppendUInt32(
+            GetNameIndex(description_factory.summary.destName, facade),
+            output
+        );
+
+        if( config.geometry ) {
+            unsigned number_of_points = 0;
+            BOOST_FOREACH(const SegmentInformation & segment, factory.pathDescription) {
+                number_of_points += segment.necessary;
+            }
+            BinaryRouteFormat::AppendVarint(number_of_points, output);
+            FixedPointCoordinate previous(0, 0);
+            BOOST_FOREACH(const SegmentInformation & segment, factory.pathDescription) {
+                if( !segment.necessary ) {
+                    continue;
+                }
+                BinaryRouteFormat::AppendSignedVarint(segment.location.lat - previous.lat, output);
+                BinaryRouteFormat::AppendSignedVarint(segment.location.lon - previous.lon, output);
+                previous = segment.location;
+            }
+        }
+        if( config.instructions ) {
+            BinaryRouteFormat::AppendVarint(number_of_instructions, output);
+            output.append(instructions);
+        }
+    }
+
+    void WriteCoordinate(
+        const FixedPointCoordinate & coordinate,
+        std::string & output
+    ) const {
+        BinaryRouteFormat::AppendUInt32(coordinate.lat, output);
+        BinaryRouteFormat::AppendUInt32(coordinate.lon, output);
+    }
+
+    //adds the name to the name table on first use
+    unsigned GetNameIndex(const unsigned name_id, const DataFacadeT * facade) {
+        std::pair<NameIndexMap::iterator, bool> insert_result =
+            name_indices.emplace(name_id, name_indices.size());
+        if( insert_result.second ) {
+            const NameView name = facade->GetEscapedName(name_id);
+            BinaryRouteFormat::AppendString(name.begin(), name.end(), name_table);
+        }
+        return insert_result.first->second;
+    }
+};
+
+#endif /* BINARY_DESCRIPTOR_H_ */
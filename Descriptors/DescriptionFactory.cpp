@@ -27,6 +27,73 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "DescriptionFactory.h"
 
+#include <boost/assert.hpp>
+
+#include <cstdlib>
+
+namespace {
+
+//cosine of 0 to 180 degrees in steps of a tenth of a degree, interpolated
+//linearly in between. The relative error is below 4e-7.
+class CosineTable {
+public:
+    CosineTable() {
+        for(unsigned i = 0; i <= NUMBER_OF_STEPS; ++i) {
+            values[i] = cos(i*M_PI/NUMBER_OF_STEPS);
+        }
+        values[NUMBER_OF_STEPS+1] = values[NUMBER_OF_STEPS];
+    }
+
+    //fixed point degrees from 0 to 180
+    inline double Get(const int fixed_point_degrees) const {
+        BOOST_ASSERT(0 <= fixed_point_degrees);
+        BOOST_ASSERT(fixed_point_degrees <= 180*COORDINATE_PRECISION);
+        const int index = fixed_point_degrees/STEP;
+        const double fraction = (fixed_point_degrees - index*STEP)/double(STEP);
+        return values[index] + fraction*(values[index+1] - values[index]);
+    }
+
+private:
+    static const int STEP = 100000;
+    static const unsigned NUMBER_OF_STEPS = 1800;
+    double values[NUMBER_OF_STEPS+2];
+};
+
+const CosineTable cosine_table;
+
+//one degree in fixed point units
+const int MAX_FAST_BEARING_SPAN = 1000000;
+
+//error bound of the fast bearing with a good margin
+const double BEARING_TOLERANCE = 1e-3;
+
+//degrees from 0 to 360 like atan2, the error is below 1e-4 degrees
+inline double FastAtan2InDegrees(const double y, const double x) {
+    const double abs_y = std::fabs(y);
+    const double abs_x = std::fabs(x);
+    if( 0. == abs_x && 0. == abs_y ) {
+        return 0.;
+    }
+    const bool steep = ( abs_y > abs_x );
+    const double z = ( steep ? abs_x/abs_y : abs_y/abs_x );
+    const double z2 = z*z;
+    double angle = z*(0.99997726 + z2*(-0.33262347 + z2*(0.19354346 +
+        z2*(-0.11643287 + z2*(0.05265332 + z2*(-0.01172120))))));
+    if( steep ) {
+        angle = M_PI/2 - angle;
+    }
+    if( 0. > x ) {
+        angle = M_PI - angle;
+    }
+    angle *= 180/M_PI;
+    if( 0. > y ) {
+        angle = 360. - angle;
+    }
+    return angle;
+}
+
+}
+
 DescriptionFactory::DescriptionFactory() : entireLength(0) { }
 
 DescriptionFactory::~DescriptionFactory() { }
@@ -60,11 +127,63 @@ double DescriptionFactory::GetBearing(
     return result;
 }
 
+double DescriptionFactory::GetFastBearing(
+    const FixedPointCoordinate & A,
+    const FixedPointCoordinate & B
+) const {
+    int delta_lon = B.lon - A.lon;
+    if( 180*COORDINATE_PRECISION < delta_lon ) {
+        delta_lon -= 360*COORDINATE_PRECISION;
+    } else if( -180*COORDINATE_PRECISION > delta_lon ) {
+        delta_lon += 360*COORDINATE_PRECISION;
+    }
+    const int delta_lat = B.lat - A.lat;
+    if(
+        MAX_FAST_BEARING_SPAN < std::abs(delta_lon) ||
+        MAX_FAST_BEARING_SPAN < std::abs(delta_lat)
+    ) {
+        return GetBearing(A, B);
+    }
+
+    //the terms of GetBearing expanded up to third order in the deltas
+    const double lambda = DegreeToRadian(delta_lon/COORDINATE_PRECISION);
+    const double phi = DegreeToRadian(delta_lat/COORDINATE_PRECISION);
+    const double cos_lat2 = cosine_table.Get(std::abs(B.lat));
+    const double sin_lat1 = cosine_table.Get(90*COORDINATE_PRECISION - A.lat);
+    const double y = lambda*(1. - lambda*lambda/6.)*cos_lat2;
+    const double x =
+        phi*(1. - phi*phi/6.) + 0.5*lambda*lambda*sin_lat1*cos_lat2;
+    const double result = FastAtan2InDegrees(y, x);
+
+    //close to half degrees rounding and azimuths could differ from GetBearing
+    const double fraction = result - floor(result);
+    if(
+        std::fabs(fraction - 0.5) < BEARING_TOLERANCE ||
+        BEARING_TOLERANCE > result ||
+        360. - BEARING_TOLERANCE < result
+    ) {
+        return GetBearing(A, B);
+    }
+    return result;
+}
+
+void DescriptionFactory::Clear() {
+    pathDescription.clear();
+    entireLength = 0;
+    summary = RouteSummary();
+    start_phantom = PhantomNode();
+    target_phantom = PhantomNode();
+}
+
+void DescriptionFactory::Reserve(const std::size_t number_of_path_nodes) {
+    pathDescription.reserve(number_of_path_nodes + 2);
+}
+
 void DescriptionFactory::SetStartSegment(const PhantomNode & sph) {
     start_phantom = sph;
     AppendSegment(
         sph.location,
-        _PathData(0, sph.nodeBasedEdgeNameID, 10, sph.weight1)
+        _PathData(0, sph.nodeBasedEdgeNameID, 10, sph.weight1, 0)
     );
 }
 
@@ -89,21 +208,132 @@ void DescriptionFactory::AppendSegment(
     if(1 == pathDescription.size() && pathDescription.back().location == coordinate) {
         pathDescription.back().nameID = data.nameID;
     } else {
-        pathDescription.push_back(SegmentInformation(coordinate, data.nameID, 0, data.durationOfSegment, data.turnInstruction) );
+        pathDescription.push_back(SegmentInformation(coordinate, data.nameID, 0, data.durationOfSegment, data.turnInstruction, data.minZoomLevel) );
+    }
+}
+
+void DescriptionFactory::Generalize(const unsigned zoomLevel) {
+    for(unsigned i = 0; i < pathDescription.size(); ++i) {
+        if(pathDescription[i].minZoomLevel <= zoomLevel) {
+            pathDescription[i].necessary = true;
+        }
+    }
+}
+
+void DescriptionFactory::ComputeBearings() {
+    for(unsigned i = 0; i+1 < pathDescription.size(); ++i){
+        if(pathDescription[i].necessary) {
+            pathDescription[i].bearing = GetFastBearing(
+                pathDescription[i].location,
+                pathDescription[i+1].location
+            );
+        }
+    }
+}
+
+DescriptionFactory::SummaryAccumulator::SummaryAccumulator(
+    const PhantomNode & start_phantom
+) :
+    entire_length(0.),
+    entered_restricted_area_count(0),
+    number_of_segments(0),
+    last_length(0.),
+    length_of_first_segment(0.),
+    first_turn_found(false),
+    second_name_id(0),
+    second_turn_instruction(0)
+{
+    //same as SetStartSegment
+    Push(start_phantom.location, start_phantom.nodeBasedEdgeNameID, 10);
+}
+
+void DescriptionFactory::SummaryAccumulator::Append(
+    const FixedPointCoordinate & location,
+    const _PathData & data
+) {
+    //same as AppendSegment
+    if( 1 == number_of_segments && last_location == location ) {
+        name_ids[0] = data.nameID;
+        return;
+    }
+    Push(location, data.nameID, data.turnInstruction);
+}
+
+void DescriptionFactory::SummaryAccumulator::Push(
+    const FixedPointCoordinate & location,
+    const unsigned name_id,
+    const TurnInstruction turn_instruction
+) {
+    if( 0 != number_of_segments ) {
+        last_length = ApproximateEuclideanDistance(last_location, location);
+        entire_length += last_length;
+        //Run accumulates the first segment up to and including the first turn
+        if( !first_turn_found ) {
+            length_of_first_segment += last_length;
+            first_turn_found = (TurnInstructionsClass::NoTurn != turn_instruction);
+        }
+    }
+    if( 1 == number_of_segments ) {
+        second_name_id = name_id;
+        second_turn_instruction = turn_instruction;
+    }
+    entered_restricted_area_count += EnteredRestrictedArea(turn_instruction);
+    name_ids[number_of_segments%3] = name_id;
+    turn_instructions[number_of_segments%3] = turn_instruction;
+    last_location = location;
+    ++number_of_segments;
+}
+
+unsigned DescriptionFactory::SummaryAccumulator::EnteredRestrictedArea(
+    const TurnInstruction turn_instruction
+) const {
+    return (
+        turn_instruction !=
+        (turn_instruction & TurnInstructions.InverseAccessRestrictionFlag)
+    );
+}
+
+void DescriptionFactory::SummaryAccumulator::Finish(
+    PhantomNode & start_phantom,
+    PhantomNode & target_phantom
+) {
+    //same as SetEndSegment
+    Push(target_phantom.location, target_phantom.nodeBasedEdgeNameID, 0);
+
+    //same post-processing as BuildSegments
+    if(
+        std::numeric_limits<double>::epsilon() > last_length &&
+        number_of_segments > 2
+    ) {
+        --number_of_segments;
+        entered_restricted_area_count -= EnteredRestrictedArea(
+            turn_instructions[(number_of_segments-1)%3]
+        );
+        target_phantom.nodeBasedEdgeNameID = name_ids[(number_of_segments-2)%3];
+    }
+    if(
+        std::numeric_limits<double>::epsilon() > length_of_first_segment &&
+        number_of_segments > 2
+    ) {
+        entered_restricted_area_count -= EnteredRestrictedArea(second_turn_instruction);
+        start_phantom.nodeBasedEdgeNameID = second_name_id;
     }
 }
 
 void DescriptionFactory::AppendEncodedPolylineString(
     const bool return_encoded,
-    std::vector<std::string> & output
-) {
-    std::string temp;
+    JSONWriter & writer,
+    const unsigned precision
+) const {
     if(return_encoded) {
-        polyline_compressor.printEncodedString(pathDescription, temp);
+        polyline_compressor.printEncodedString(
+            pathDescription,
+            writer.GetOutput(),
+            precision
+        );
     } else {
-        polyline_compressor.printUnencodedString(pathDescription, temp);
+        polyline_compressor.printUnencodedString(pathDescription, writer);
     }
-    output.push_back(temp);
 }
 
 void DescriptionFactory::AppendEncodedPolylineString(
@@ -118,7 +348,8 @@ void DescriptionFactory::AppendUnencodedPolylineString(
     std::vector<std::string>& output
 ) const {
     std::string temp;
-    polyline_compressor.printUnencodedString(pathDescription, temp);
+    JSONWriter writer(temp);
+    polyline_compressor.printUnencodedString(pathDescription, writer);
     output.push_back(temp);
 }
 
@@ -249,5 +480,5 @@ void DescriptionFactory::BuildRouteSummary(
 ) {
     summary.startName = start_phantom.nodeBasedEdgeNameID;
     summary.destName = target_phantom.nodeBasedEdgeNameID;
-    summary.BuildDurationAndLengthStrings(distance, time);
+    summary.BuildDurationAndLength(distance, time);
 }
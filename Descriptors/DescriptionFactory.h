@@ -28,16 +28,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef DESCRIPTIONFACTORY_H_
 #define DESCRIPTIONFACTORY_H_
 
-#include "../Algorithms/DouglasPeucker.h"
 #include "../Algorithms/PolylineCompressor.h"
 #include "../DataStructures/Coordinate.h"
 #include "../DataStructures/PhantomNodes.h"
 #include "../DataStructures/RawRouteData.h"
 #include "../DataStructures/SegmentInformation.h"
 #include "../DataStructures/TurnInstructions.h"
+#include "../Util/JSONWriter.h"
 #include "../Util/SimpleLogger.h"
 #include "../typedefs.h"
 
+#include <boost/foreach.hpp>
+
 #include <limits>
 #include <vector>
 
@@ -45,33 +47,63 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *  and produces the description plus the encoded polyline */
 
 class DescriptionFactory {
-    DouglasPeucker polyline_generalizer;
     PolylineCompressor polyline_compressor;
     PhantomNode start_phantom, target_phantom;
 
+    //Follows the segments that SetStartSegment, AppendSegment and
+    //SetEndSegment would add and what Run does to them, but keeps only the
+    //few that the post-processing looks at.
+    class SummaryAccumulator {
+    public:
+        explicit SummaryAccumulator(const PhantomNode & start_phantom);
+        void Append(const FixedPointCoordinate & location, const _PathData & data);
+        void Finish(PhantomNode & start_phantom, PhantomNode & target_phantom);
+
+        double entire_length;
+        unsigned entered_restricted_area_count;
+    private:
+        void Push(
+            const FixedPointCoordinate & location,
+            const unsigned name_id,
+            const TurnInstruction turn_instruction
+        );
+        unsigned EnteredRestrictedArea(const TurnInstruction turn_instruction) const;
+
+        unsigned number_of_segments;
+        FixedPointCoordinate last_location;
+        double last_length;
+        double length_of_first_segment;
+        bool first_turn_found;
+        //second segment and the last three segments
+        unsigned second_name_id;
+        TurnInstruction second_turn_instruction;
+        unsigned name_ids[3];
+        TurnInstruction turn_instructions[3];
+    };
+
     double DegreeToRadian(const double degree) const;
     double RadianToDegree(const double degree) const;
 public:
     struct RouteSummary {
-        std::string lengthString;
-        std::string durationString;
+        //meters and seconds
+        int distance;
+        int duration;
         unsigned startName;
         unsigned destName;
         RouteSummary() :
-            lengthString("0"),
-            durationString("0"),
+            distance(0),
+            duration(0),
             startName(0),
             destName(0)
         {}
 
-        void BuildDurationAndLengthStrings(
+        void BuildDurationAndLength(
             const double distance,
             const unsigned time
         ) {
             //compute distance/duration for route summary
-            intToString(round(distance), lengthString);
-            int travelTime = time/10 + 1;
-            intToString(travelTime, durationString);
+            this->distance = round(distance);
+            duration = time/10 + 1;
         }
     } summary;
 
@@ -82,6 +114,14 @@ public:
     DescriptionFactory();
     virtual ~DescriptionFactory();
     double GetBearing(const FixedPointCoordinate& C, const FixedPointCoordinate& B) const;
+    //GetBearing without trigonometric functions for the short segments of
+    //routes. Rounded to whole degrees or turned into an azimuth, the result
+    //is the same, longer segments and close calls are left to GetBearing.
+    double GetFastBearing(const FixedPointCoordinate& A, const FixedPointCoordinate& B) const;
+    //forgets the previous route, but keeps the buffers for the next one
+    void Clear();
+    //room for the nodes of a path plus both phantom segments
+    void Reserve(const std::size_t number_of_path_nodes);
     void AppendEncodedPolylineString(std::vector<std::string> &output) const;
     void AppendUnencodedPolylineString(std::vector<std::string> &output) const;
     void AppendSegment(const FixedPointCoordinate & coordinate, const _PathData & data);
@@ -90,12 +130,46 @@ public:
     void SetEndSegment(const PhantomNode & start_phantom);
     void AppendEncodedPolylineString(
         const bool return_encoded,
-        std::vector<std::string> & output
-        );
+        JSONWriter & writer,
+        const unsigned precision = PolylineCompressor::DEFAULT_PRECISION
+    ) const;
+
+    //Summary only fast path. Sets entireLength and the end point names like
+    //the full pipeline, but never fills pathDescription. Returns the number
+    //of entered restricted areas.
+    template<class DataFacadeT>
+    unsigned RunSummaryOnly(
+        const DataFacadeT * facade,
+        const PhantomNodes & phantom_nodes,
+        const std::vector<_PathData> & path
+    ) {
+        SummaryAccumulator accumulator(phantom_nodes.startPhantom);
+        BOOST_FOREACH(const _PathData & path_data, path) {
+            accumulator.Append(facade->GetCoordinateOfNode(path_data.node), path_data);
+        }
+        start_phantom = phantom_nodes.startPhantom;
+        target_phantom = phantom_nodes.targetPhantom;
+        accumulator.Finish(start_phantom, target_phantom);
+        entireLength = accumulator.entire_length;
+        return accumulator.entered_restricted_area_count;
+    }
 
+    //All stages, for descriptors that need turn instructions
     template<class DataFacadeT>
     void Run(const DataFacadeT * facade, const unsigned zoomLevel) {
+        BuildSegments();
+        Generalize(zoomLevel);
+        ComputeBearings();
+    }
+
+    //Generalizes the polyline, the zoom levels of the points are precomputed
+    void Generalize(const unsigned zoomLevel);
+    //bearings of the necessary segments, only instructions show them
+    void ComputeBearings();
 
+    //sums up lengths and durations of the segments between turns and drops
+    //empty segments at both ends
+    void BuildSegments() {
         if( pathDescription.empty() ) {
             return;
         }
@@ -200,20 +274,6 @@ public:
         } else {
             pathDescription[0].duration *= start_phantom.ratio;
         }
-
-        //Generalize poly line
-        polyline_generalizer.Run(pathDescription, zoomLevel);
-
-        //fix what needs to be fixed else
-        for(unsigned i = 0; i < pathDescription.size()-1 && pathDescription.size() >= 2; ++i){
-            if(pathDescription[i].necessary) {
-                double angle = GetBearing(pathDescription[i].location, pathDescription[i+1].location);
-                pathDescription[i].bearing = angle;
-            }
-        }
-
-    //    BuildRouteSummary(entireLength, duration);
-        return;
     }
 };
 
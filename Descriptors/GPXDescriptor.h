@@ -29,6 +29,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define GPX_DESCRIPTOR_H_
 
 #include "BaseDescriptor.h"
+#include "DescriptionFactory.h"
+#include "../Util/BufferWriter.h"
 
 #include <boost/foreach.hpp>
 
@@ -36,9 +38,11 @@ template<class DataFacadeT>
 class GPXDescriptor : public BaseDescriptor<DataFacadeT> {
 private:
     DescriptorConfig config;
-    FixedPointCoordinate current;
+    DescriptionFactory description_factory;
+
+    //<rtept lat="-90.000000" lon="-180.000000"></rtept> plus spare room
+    static const unsigned MAX_ROUTE_POINT_LENGTH = 64;
 
-    std::string tmp;
 public:
     void SetConfig(const DescriptorConfig & c) { config = c; }
 
@@ -49,55 +53,88 @@ public:
         PhantomNodes &phantomNodes,
         const DataFacadeT * facade
     ) {
-        reply.content.push_back("<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
-        reply.content.push_back(
+        //the whole document is written into a single snippet of the reply
+        reply.content.push_back(std::string());
+        BufferWriter writer(reply.content.back());
+        writer.Raw("<?xml version=\"1.0\" encoding=\"UTF-8\"?>");
+        writer.Raw(
                 "<gpx creator=\"OSRM Routing Engine\" version=\"1.1\" "
                 "xmlns=\"http://www.topografix.com/GPX/1/1\" "
                 "xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" "
                 "xsi:schemaLocation=\"http://www.topografix.com/GPX/1/1 gpx.xsd"
                 "\">");
-        reply.content.push_back(
+        writer.Raw(
                 "<metadata><copyright author=\"Project OSRM\"><license>Data (c)"
                 " OpenStreetMap contributors (ODbL)</license></copyright>"
                 "</metadata>");
-        reply.content.push_back("<rte>");
+        writer.Raw("<rte>");
         bool found_route =  (rawRoute.lengthOfShortestPath != INT_MAX) &&
                             (rawRoute.computedShortestPath.size()         );
         if( found_route ) {
-            convertInternalLatLonToString(
-                phantomNodes.startPhantom.location.lat,
-                tmp
-            );
-            reply.content.push_back("<rtept lat=\"" + tmp + "\" ");
-            convertInternalLatLonToString(
-                phantomNodes.startPhantom.location.lon,
-                tmp
+            writer.GetOutput().reserve(
+                writer.GetOutput().size() + 16 +
+                MAX_ROUTE_POINT_LENGTH*(rawRoute.computedShortestPath.size() + 2)
             );
-            reply.content.push_back("lon=\"" + tmp + "\"></rtept>");
-
-            BOOST_FOREACH(
-                const _PathData & pathData,
-                rawRoute.computedShortestPath
-            ) {
-                current = facade->GetCoordinateOfNode(pathData.node);
-
-                convertInternalLatLonToString(current.lat, tmp);
-                reply.content.push_back("<rtept lat=\"" + tmp + "\" ");
-                convertInternalLatLonToString(current.lon, tmp);
-                reply.content.push_back("lon=\"" + tmp + "\"></rtept>");
+            if( config.generalize ) {
+                WriteGeneralizedRoute(writer, rawRoute, phantomNodes, facade);
+            } else {
+                WriteRoutePoint(writer, phantomNodes.startPhantom.location);
+                BOOST_FOREACH(
+                    const _PathData & pathData,
+                    rawRoute.computedShortestPath
+                ) {
+                    WriteRoutePoint(
+                        writer,
+                        facade->GetCoordinateOfNode(pathData.node)
+                    );
+                }
+                WriteRoutePoint(writer, phantomNodes.targetPhantom.location);
             }
-            convertInternalLatLonToString(
-                phantomNodes.targetPhantom.location.lat,
-                tmp
-            );
-            reply.content.push_back("<rtept lat=\"" + tmp + "\" ");
-            convertInternalLatLonToString(
-                phantomNodes.targetPhantom.location.lon,
-                tmp
+        }
+        writer.Raw("</rte></gpx>");
+    }
+
+private:
+    //the points of the route geometry of the other formats at the zoom level
+    void WriteGeneralizedRoute(
+        BufferWriter & writer,
+        const RawRouteData & rawRoute,
+        const PhantomNodes & phantomNodes,
+        const DataFacadeT * facade
+    ) {
+        description_factory.Clear();
+        description_factory.Reserve(rawRoute.computedShortestPath.size());
+        description_factory.SetStartSegment(phantomNodes.startPhantom);
+        BOOST_FOREACH(
+            const _PathData & pathData,
+            rawRoute.computedShortestPath
+        ) {
+            description_factory.AppendSegment(
+                facade->GetCoordinateOfNode(pathData.node),
+                pathData
             );
-            reply.content.push_back("lon=\"" + tmp + "\"></rtept>");
         }
-        reply.content.push_back("</rte></gpx>");
+        description_factory.SetEndSegment(phantomNodes.targetPhantom);
+        description_factory.BuildSegments();
+        description_factory.Generalize(config.zoom_level);
+        const std::vector<SegmentInformation> & path =
+            description_factory.pathDescription;
+        for(unsigned i = 0; i < path.size(); ++i) {
+            if( 0 != i && !path[i].necessary ) {
+                continue;
+            }
+            WriteRoutePoint(writer, path[i].location);
+        }
+    }
+
+    //<rtept lat="52.519930" lon="13.438640"></rtept>
+    static inline void WriteRoutePoint(
+        BufferWriter & writer,
+        const FixedPointCoordinate & coordinate
+    ) {
+        writer.Raw("<rtept lat=\"").FixedPoint(coordinate.lat);
+        writer.Raw("\" lon=\"").FixedPoint(coordinate.lon);
+        writer.Raw("\"></rtept>");
     }
 };
 #endif // GPX_DESCRIPTOR_H_
@@ -30,10 +30,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "BaseDescriptor.h"
 #include "DescriptionFactory.h"
-#include "../Algorithms/ObjectToBase64.h"
+#include "../Algorithms/PhantomNodeHint.h"
+#include "../DataStructures/NameStore.h"
 #include "../DataStructures/SegmentInformation.h"
 #include "../DataStructures/TurnInstructions.h"
 #include "../Util/Azimuth.h"
+#include "../Util/JSONWriter.h"
 #include "../Util/StringUtil.h"
 
 #include <boost/bind.hpp>
@@ -87,209 +89,256 @@ public:
         PhantomNodes & phantom_nodes,
         const DataFacadeT * facade
     ) {
+        //instances are reused, their buffers keep their capacity
+        description_factory.Clear();
+        alternateDescriptionFactory.Clear();
+        shortest_path_segments.clear();
+        alternative_path_segments.clear();
+        roundAbout = RoundAbout();
 
-        WriteHeaderToOutput(reply.content);
+        //the whole route is written into a single snippet of the reply
+        reply.content.push_back(std::string());
+        JSONWriter writer(reply.content.back());
 
+        WriteHeaderToOutput(writer);
+
+        entered_restricted_area_count = 0;
         if(raw_route_information.lengthOfShortestPath != INT_MAX) {
-            description_factory.SetStartSegment(phantom_nodes.startPhantom);
-            reply.content.push_back("0,"
+            writer.Raw("0,"
                     "\"status_message\": \"Found route between points\",");
-
-            //Get all the coordinates for the computed route
-            BOOST_FOREACH(const _PathData & path_data, raw_route_information.computedShortestPath) {
-                current = facade->GetCoordinateOfNode(path_data.node);
-                description_factory.AppendSegment(current, path_data );
-            }
-            description_factory.SetEndSegment(phantom_nodes.targetPhantom);
+            DescribeRoute(
+                description_factory,
+                phantom_nodes,
+                raw_route_information.computedShortestPath,
+                facade
+            );
         } else {
             //We do not need to do much, if there is no route ;-)
-            reply.content.push_back("207,"
+            writer.Raw("207,"
                     "\"status_message\": \"Cannot find route between points\",");
         }
 
-        description_factory.Run(facade, config.zoom_level);
-        reply.content.push_back("\"route_geometry\": ");
+        writer.Raw("\"route_geometry\": ");
         if(config.geometry) {
             description_factory.AppendEncodedPolylineString(
                config.encode_geometry,
-               reply.content
+               writer,
+               config.geometry_precision
             );
         } else {
-            reply.content.push_back("[]");
+            writer.Raw("[]");
         }
 
-        reply.content.push_back(","
+        writer.Raw(","
                 "\"route_instructions\": [");
-        entered_restricted_area_count = 0;
         if(config.instructions) {
             BuildTextualDescription(
                 description_factory,
-                reply,
+                writer,
                 raw_route_information.lengthOfShortestPath,
                 facade,
                 shortest_path_segments
             );
-        } else {
-            BOOST_FOREACH(
-                const SegmentInformation & segment,
-                description_factory.pathDescription
-            ) {
-                TurnInstruction current_instruction = segment.turnInstruction & TurnInstructions.InverseAccessRestrictionFlag;
-                entered_restricted_area_count += (current_instruction != segment.turnInstruction);
-            }
         }
-        reply.content.push_back("],");
+        writer.Raw("],");
         description_factory.BuildRouteSummary(
             description_factory.entireLength,
             raw_route_information.lengthOfShortestPath - ( entered_restricted_area_count*TurnInstructions.AccessRestrictionPenalty)
         );
 
-        reply.content.push_back("\"route_summary\":");
-        reply.content.push_back("{");
-        reply.content.push_back("\"total_distance\":");
-        reply.content.push_back(description_factory.summary.lengthString);
-        reply.content.push_back(","
-                "\"total_time\":");
-        reply.content.push_back(description_factory.summary.durationString);
-        reply.content.push_back(","
-                "\"start_point\":\"");
-        reply.content.push_back(
-            facade->GetEscapedNameForNameID(description_factory.summary.startName)
+        writer.Raw("\"route_summary\":");
+        WriteRouteSummary(
+            writer,
+            description_factory.summary,
+            description_factory.summary,
+            facade
         );
-        reply.content.push_back("\","
-                "\"end_point\":\"");
-        reply.content.push_back(
-            facade->GetEscapedNameForNameID(description_factory.summary.destName)
-        );
-        reply.content.push_back("\"");
-        reply.content.push_back("}");
-        reply.content.push_back(",");
+        writer.Raw(',');
 
         //only one alternative route is computed at this time, so this is hardcoded
 
+        entered_restricted_area_count = 0;
         if(raw_route_information.lengthOfAlternativePath != INT_MAX) {
-            alternateDescriptionFactory.SetStartSegment(phantom_nodes.startPhantom);
-            //Get all the coordinates for the computed route
-            BOOST_FOREACH(const _PathData & path_data, raw_route_information.computedAlternativePath) {
-                current = facade->GetCoordinateOfNode(path_data.node);
-                alternateDescriptionFactory.AppendSegment(current, path_data );
-            }
-            alternateDescriptionFactory.SetEndSegment(phantom_nodes.targetPhantom);
+            DescribeRoute(
+                alternateDescriptionFactory,
+                phantom_nodes,
+                raw_route_information.computedAlternativePath,
+                facade
+            );
         }
-        alternateDescriptionFactory.Run(facade, config.zoom_level);
 
         //give an array of alternative routes
-        reply.content.push_back("\"alternative_geometries\": [");
+        writer.Raw("\"alternative_geometries\": [");
         if(config.geometry && INT_MAX != raw_route_information.lengthOfAlternativePath) {
             //Generate the linestrings for each alternative
             alternateDescriptionFactory.AppendEncodedPolylineString(
                 config.encode_geometry,
-                reply.content
+                writer,
+                config.geometry_precision
             );
         }
-        reply.content.push_back("],");
-        reply.content.push_back("\"alternative_instructions\":[");
-        entered_restricted_area_count = 0;
+        writer.Raw("],");
+        writer.Raw("\"alternative_instructions\":[");
         if(INT_MAX != raw_route_information.lengthOfAlternativePath) {
-            reply.content.push_back("[");
+            writer.Raw('[');
             //Generate instructions for each alternative
             if(config.instructions) {
                 BuildTextualDescription(
                     alternateDescriptionFactory,
-                    reply,
+                    writer,
                     raw_route_information.lengthOfAlternativePath,
                     facade,
                     alternative_path_segments
                 );
-            } else {
-                BOOST_FOREACH(const SegmentInformation & segment, alternateDescriptionFactory.pathDescription) {
-                	TurnInstruction current_instruction = segment.turnInstruction & TurnInstructions.InverseAccessRestrictionFlag;
-                    entered_restricted_area_count += (current_instruction != segment.turnInstruction);
-                }
             }
-            reply.content.push_back("]");
+            writer.Raw(']');
         }
-        reply.content.push_back("],");
-        reply.content.push_back("\"alternative_summaries\":[");
+        writer.Raw("],");
+        writer.Raw("\"alternative_summaries\":[");
         if(INT_MAX != raw_route_information.lengthOfAlternativePath) {
             //Generate route summary (length, duration) for each alternative
             alternateDescriptionFactory.BuildRouteSummary(alternateDescriptionFactory.entireLength, raw_route_information.lengthOfAlternativePath - ( entered_restricted_area_count*TurnInstructions.AccessRestrictionPenalty));
-            reply.content.push_back("{");
-            reply.content.push_back("\"total_distance\":");
-            reply.content.push_back(alternateDescriptionFactory.summary.lengthString);
-            reply.content.push_back(","
-                    "\"total_time\":");
-            reply.content.push_back(alternateDescriptionFactory.summary.durationString);
-            reply.content.push_back(","
-                    "\"start_point\":\"");
-            reply.content.push_back(facade->GetEscapedNameForNameID(description_factory.summary.startName));
-            reply.content.push_back("\","
-                    "\"end_point\":\"");
-            reply.content.push_back(facade->GetEscapedNameForNameID(description_factory.summary.destName));
-            reply.content.push_back("\"");
-            reply.content.push_back("}");
+            //start and end point are taken from the shortest path
+            WriteRouteSummary(
+                writer,
+                alternateDescriptionFactory.summary,
+                description_factory.summary,
+                facade
+            );
         }
-        reply.content.push_back("],");
+        writer.Raw("],");
 
-        //Get Names for both routes
+        //Get Names for both routes, they come from the turn instructions
         RouteNames routeNames;
-        GetRouteNames(shortest_path_segments, alternative_path_segments, facade, routeNames);
+        if(config.instructions) {
+            GetRouteNames(shortest_path_segments, alternative_path_segments, facade, routeNames);
+        }
 
-        reply.content.push_back("\"route_name\":[\"");
-        reply.content.push_back(routeNames.shortestPathName1);
-        reply.content.push_back("\",\"");
-        reply.content.push_back(routeNames.shortestPathName2);
-        reply.content.push_back("\"],"
+        writer.Raw("\"route_name\":[");
+        writer.EscapedString(routeNames.shortestPathName1);
+        writer.Raw(',');
+        writer.EscapedString(routeNames.shortestPathName2);
+        writer.Raw("],"
                 "\"alternative_names\":[");
-        reply.content.push_back("[\"");
-        reply.content.push_back(routeNames.alternativePathName1);
-        reply.content.push_back("\",\"");
-        reply.content.push_back(routeNames.alternativePathName2);
-        reply.content.push_back("\"]");
-        reply.content.push_back("],");
+        writer.Raw('[');
+        writer.EscapedString(routeNames.alternativePathName1);
+        writer.Raw(',');
+        writer.EscapedString(routeNames.alternativePathName2);
+        writer.Raw(']');
+        writer.Raw("],");
         //list all viapoints so that the client may display it
-        reply.content.push_back("\"via_points\":[");
-        std::string tmp;
+        writer.Raw("\"via_points\":[");
         if(config.geometry && INT_MAX != raw_route_information.lengthOfShortestPath) {
             for(unsigned i = 0; i < raw_route_information.segmentEndCoordinates.size(); ++i) {
-                reply.content.push_back("[");
                 if(raw_route_information.segmentEndCoordinates[i].startPhantom.location.isSet())
-                    convertInternalReversedCoordinateToString(raw_route_information.segmentEndCoordinates[i].startPhantom.location, tmp);
+                    WriteViaPoint(writer, raw_route_information.segmentEndCoordinates[i].startPhantom.location);
                 else
-                    convertInternalReversedCoordinateToString(raw_route_information.rawViaNodeCoordinates[i], tmp);
-
-                reply.content.push_back(tmp);
-                reply.content.push_back("],");
+                    WriteViaPoint(writer, raw_route_information.rawViaNodeCoordinates[i]);
+                writer.Raw(',');
             }
-            reply.content.push_back("[");
             if(raw_route_information.segmentEndCoordinates.back().startPhantom.location.isSet())
-                convertInternalReversedCoordinateToString(raw_route_information.segmentEndCoordinates.back().targetPhantom.location, tmp);
+                WriteViaPoint(writer, raw_route_information.segmentEndCoordinates.back().targetPhantom.location);
             else
-                convertInternalReversedCoordinateToString(raw_route_information.rawViaNodeCoordinates.back(), tmp);
-            reply.content.push_back(tmp);
-            reply.content.push_back("]");
+                WriteViaPoint(writer, raw_route_information.rawViaNodeCoordinates.back());
         }
-        reply.content.push_back("],");
-        reply.content.push_back("\"hint_data\": {");
-        reply.content.push_back("\"checksum\":");
-        intToString(raw_route_information.checkSum, tmp);
-        reply.content.push_back(tmp);
-        reply.content.push_back(", \"locations\": [");
+        writer.Raw("],");
+        writer.Raw("\"hint_data\": {");
+        writer.Raw("\"checksum\":");
+        //printed signed for compatibility with existing clients
+        writer.Int(raw_route_information.checkSum);
+        writer.Raw(", \"locations\": [");
 
         std::string hint;
         for(unsigned i = 0; i < raw_route_information.segmentEndCoordinates.size(); ++i) {
-            reply.content.push_back("\"");
-            EncodeObjectToBase64(raw_route_information.segmentEndCoordinates[i].startPhantom, hint);
-            reply.content.push_back(hint);
-            reply.content.push_back("\", ");
+            PhantomNodeHint::Encode(
+                raw_route_information.segmentEndCoordinates[i].startPhantom,
+                raw_route_information.checkSum,
+                hint
+            );
+            writer.EscapedString(hint);
+            writer.Raw(", ");
         }
-        EncodeObjectToBase64(raw_route_information.segmentEndCoordinates.back().targetPhantom, hint);
-        reply.content.push_back("\"");
-        reply.content.push_back(hint);
-        reply.content.push_back("\"]");
-        reply.content.push_back("},");
-        reply.content.push_back("\"transactionId\": \"OSRM Routing Engine JSON Descriptor (v0.3)\"");
-        reply.content.push_back("}");
+        PhantomNodeHint::Encode(
+            raw_route_information.segmentEndCoordinates.back().targetPhantom,
+            raw_route_information.checkSum,
+            hint
+        );
+        writer.EscapedString(hint);
+        writer.Raw(']');
+        writer.Raw("},");
+        writer.Raw("\"transactionId\": \"OSRM Routing Engine JSON Descriptor (v0.3)\"");
+        writer.Raw('}');
+    }
+
+    //Runs only the stages of the description pipeline whose output is asked
+    //for. Without instructions the entered restricted areas are counted here,
+    //BuildTextualDescription counts them otherwise.
+    void DescribeRoute(
+        DescriptionFactory & factory,
+        const PhantomNodes & phantom_nodes,
+        const std::vector<_PathData> & path,
+        const DataFacadeT * facade
+    ) {
+        if(!config.geometry && !config.instructions) {
+            entered_restricted_area_count = factory.RunSummaryOnly(
+                facade,
+                phantom_nodes,
+                path
+            );
+            return;
+        }
+        factory.Reserve(path.size());
+        factory.SetStartSegment(phantom_nodes.startPhantom);
+        BOOST_FOREACH(const _PathData & path_data, path) {
+            current = facade->GetCoordinateOfNode(path_data.node);
+            factory.AppendSegment(current, path_data);
+        }
+        factory.SetEndSegment(phantom_nodes.targetPhantom);
+        if(config.instructions) {
+            factory.Run(facade, config.zoom_level);
+            return;
+        }
+        factory.BuildSegments();
+        factory.Generalize(config.zoom_level);
+        BOOST_FOREACH(const SegmentInformation & segment, factory.pathDescription) {
+            const TurnInstruction current_instruction =
+                segment.turnInstruction & TurnInstructions.InverseAccessRestrictionFlag;
+            entered_restricted_area_count += (current_instruction != segment.turnInstruction);
+        }
+    }
+
+    //{"total_distance":..,"total_time":..,"start_point":"..","end_point":".."}
+    void WriteRouteSummary(
+        JSONWriter & writer,
+        const DescriptionFactory::RouteSummary & summary,
+        const DescriptionFactory::RouteSummary & end_points,
+        const DataFacadeT * facade
+    ) const {
+        writer.Raw('{');
+        writer.Key("total_distance").Int(summary.distance);
+        writer.Raw(',');
+        writer.Key("total_time").Int(summary.duration);
+        writer.Raw(',');
+        writer.Key("start_point").EscapedString(
+            facade->GetEscapedName(end_points.startName)
+        );
+        writer.Raw(',');
+        writer.Key("end_point").EscapedString(
+            facade->GetEscapedName(end_points.destName)
+        );
+        writer.Raw('}');
+    }
+
+    //[lat,lon ], the blank is kept for compatibility with existing clients
+    inline void WriteViaPoint(
+        JSONWriter & writer,
+        const FixedPointCoordinate & coordinate
+    ) const {
+        writer.Raw('[');
+        writer.FixedPoint(coordinate.lat);
+        writer.Raw(',');
+        writer.FixedPoint(coordinate.lon);
+        writer.Raw(" ]");
     }
 
     // construct routes names
@@ -357,8 +406,8 @@ public:
         }
     }
 
-    inline void WriteHeaderToOutput(std::vector<std::string> & output) {
-        output.push_back(
+    inline void WriteHeaderToOutput(JSONWriter & writer) {
+        writer.Raw(
             "{"
             "\"version\": 0.3,"
             "\"status\":"
@@ -368,7 +417,7 @@ public:
     //TODO: reorder parameters
     inline void BuildTextualDescription(
         DescriptionFactory & description_factory,
-        http::Reply & reply,
+        JSONWriter & writer,
         const int route_length,
         const DataFacadeT * facade,
         std::vector<Segment> & route_segments_list
@@ -380,7 +429,6 @@ public:
         unsigned prefixSumOfNecessarySegments = 0;
         roundAbout.leave_at_exit = 0;
         roundAbout.name_id = 0;
-        std::string tmpDist, tmpLength, tmpDuration, tmpBearing, tmpInstruction;
         //Fetch data from Factory and generate a string from it.
         BOOST_FOREACH(const SegmentInformation & segment, description_factory.pathDescription) {
         	TurnInstruction current_instruction = segment.turnInstruction & TurnInstructions.InverseAccessRestrictionFlag;
@@ -391,41 +439,33 @@ public:
                     roundAbout.start_index = prefixSumOfNecessarySegments;
                 } else {
                     if(0 != prefixSumOfNecessarySegments){
-                        reply.content.push_back(",");
+                        writer.Raw(',');
                     }
-                    reply.content.push_back("[\"");
+                    writer.Raw("[\"");
                     if(TurnInstructions.LeaveRoundAbout == current_instruction) {
-                        intToString(TurnInstructions.EnterRoundAbout, tmpInstruction);
-                        reply.content.push_back(tmpInstruction);
-                        reply.content.push_back("-");
-                        intToString(roundAbout.leave_at_exit+1, tmpInstruction);
-                        reply.content.push_back(tmpInstruction);
+                        writer.Int(TurnInstructions.EnterRoundAbout);
+                        writer.Raw('-');
+                        writer.Int(roundAbout.leave_at_exit+1);
                         roundAbout.leave_at_exit = 0;
                     } else {
-                        intToString(current_instruction, tmpInstruction);
-                        reply.content.push_back(tmpInstruction);
+                        writer.Int(current_instruction);
                     }
 
-                    reply.content.push_back("\",\"");
-                    reply.content.push_back(facade->GetEscapedNameForNameID(segment.nameID));
-                    reply.content.push_back("\",");
-                    intToString(segment.length, tmpDist);
-                    reply.content.push_back(tmpDist);
-                    reply.content.push_back(",");
-                    intToString(prefixSumOfNecessarySegments, tmpLength);
-                    reply.content.push_back(tmpLength);
-                    reply.content.push_back(",");
-                    intToString(segment.duration/10, tmpDuration);
-                    reply.content.push_back(tmpDuration);
-                    reply.content.push_back(",\"");
-                    intToString(segment.length, tmpLength);
-                    reply.content.push_back(tmpLength);
-                    reply.content.push_back("m\",\"");
-                    reply.content.push_back(Azimuth::Get(segment.bearing));
-                    reply.content.push_back("\",");
-                    intToString(round(segment.bearing), tmpBearing);
-                    reply.content.push_back(tmpBearing);
-                    reply.content.push_back("]");
+                    writer.Raw("\",");
+                    writer.EscapedString(facade->GetEscapedName(segment.nameID));
+                    writer.Raw(',');
+                    writer.Int(segment.length);
+                    writer.Raw(',');
+                    writer.Int(prefixSumOfNecessarySegments);
+                    writer.Raw(',');
+                    writer.Int(segment.duration/10);
+                    writer.Raw(",\"");
+                    writer.Int(segment.length);
+                    writer.Raw("m\",\"");
+                    writer.Raw(Azimuth::Get(segment.bearing));
+                    writer.Raw("\",");
+                    writer.Int(round(segment.bearing));
+                    writer.Raw(']');
 
                     route_segments_list.push_back(
                         Segment(
@@ -442,23 +482,13 @@ public:
                 ++prefixSumOfNecessarySegments;
         }
         if(INT_MAX != route_length) {
-            reply.content.push_back(",[\"");
-            intToString(TurnInstructions.ReachedYourDestination, tmpInstruction);
-            reply.content.push_back(tmpInstruction);
-            reply.content.push_back("\",\"");
-            reply.content.push_back("\",");
-            reply.content.push_back("0");
-            reply.content.push_back(",");
-            intToString(prefixSumOfNecessarySegments-1, tmpLength);
-            reply.content.push_back(tmpLength);
-            reply.content.push_back(",");
-            reply.content.push_back("0");
-            reply.content.push_back(",\"");
-            reply.content.push_back("\",\"");
-            reply.content.push_back(Azimuth::Get(0.0));
-            reply.content.push_back("\",");
-            reply.content.push_back("0.0");
-            reply.content.push_back("]");
+            writer.Raw(",[\"");
+            writer.Int(TurnInstructions.ReachedYourDestination);
+            writer.Raw("\",\"\",0,");
+            writer.Int(prefixSumOfNecessarySegments-1);
+            writer.Raw(",0,\"\",\"");
+            writer.Raw(Azimuth::Get(0.0));
+            writer.Raw("\",0.0]");
         }
     }
 
@@ -0,0 +1,128 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef BINARY_ROUTE_FORMAT_H
+#define BINARY_ROUTE_FORMAT_H
+
+// Compact binary viaroute reply, requested with output=binary. Integers of
+// fixed width are little endian. Varints are unsigned LEB128, signed values
+// are zigzag encoded first. Names are HTML escaped, like in JSON replies.
+//
+//  header       char[4]  magic "OSRB"
+//               uint8    version, currently 1
+//               uint8    flags, see BinaryRouteFormat::Flags
+//               uint16   reserved, 0
+//               uint32   checksum of the data, to be sent back with hints
+//  route        present if ROUTE_FOUND is set
+//  alternative  present if ALTERNATIVE_FOUND is set
+//  via points   varint count, count times int32 lat, int32 lon
+//  hints        varint count, count times varint length and the hint
+//  names        varint count, count times varint length and the name
+//
+// A route is
+//  summary      uint32 distance in meters, uint32 duration in seconds,
+//               uint32 start name, uint32 end name
+//  geometry     if GEOMETRY is set: varint count, count times the zigzag
+//               varint differences of lat and lon to the previous point.
+//               The first point is relative to 0,0.
+//  instructions if INSTRUCTIONS is set: varint count, count times
+//               uint8 turn instruction, uint8 exit of a roundabout or 0,
+//               varint name, varint length in meters, varint index of the
+//               first geometry point, varint duration in seconds,
+//               uint16 bearing in degrees
+//
+// Names are indices into the name table at the end of the reply.
+// Coordinates are fixed point with six decimals, like everywhere in OSRM.
+
+#include <boost/cstdint.hpp>
+
+#include <string>
+
+struct BinaryRouteFormat {
+    enum Flags {
+        ROUTE_FOUND       = 1,
+        ALTERNATIVE_FOUND = 2,
+        GEOMETRY          = 4,
+        INSTRUCTIONS      = 8
+    };
+
+    static const unsigned VERSION = 1;
+    static const unsigned HEADER_SIZE = 12;
+    static const unsigned SUMMARY_SIZE = 16;
+
+    static const char * GetMagic() {
+        return "OSRB";
+    }
+
+    static void AppendUInt8(const unsigned value, std::string & output) {
+        output.push_back(char(value & 0xff));
+    }
+
+    static void AppendUInt16(const unsigned value, std::string & output) {
+        output.push_back(char(value & 0xff));
+        output.push_back(char((value >> 8) & 0xff));
+    }
+
+    static void AppendUInt32(const boost::uint32_t value, std::string & output) {
+        output.push_back(char(value & 0xff));
+        output.push_back(char((value >> 8) & 0xff));
+        output.push_back(char((value >> 16) & 0xff));
+        output.push_back(char((value >> 24) & 0xff));
+    }
+
+    static void AppendVarint(boost::uint32_t value, std::string & output) {
+        while( 0x80 <= value ) {
+            output.push_back(char(0x80 | (value & 0x7f)));
+            value >>= 7;
+        }
+        output.push_back(char(value));
+    }
+
+    static void AppendSignedVarint(const int value, std::string & output) {
+        AppendVarint(ZigZagEncode(value), output);
+    }
+
+    static void AppendString(
+        const char * begin,
+        const char * end,
+        std::string & output
+    ) {
+        AppendVarint(end - begin, output);
+        output.append(begin, end);
+    }
+
+    static boost::uint32_t ZigZagEncode(const int value) {
+        return (boost::uint32_t(value) << 1) ^ boost::uint32_t(value >> 31);
+    }
+
+    static int ZigZagDecode(const boost::uint32_t value) {
+        return int(value >> 1) ^ -int(value & 1);
+    }
+};
+
+#endif //BINARY_ROUTE_FORMAT_H
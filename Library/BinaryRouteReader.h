@@ -0,0 +1,219 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef BINARY_ROUTE_READER_H
+#define BINARY_ROUTE_READER_H
+
+//Decodes viaroute replies requested with output=binary. Clients only need
+//this header and BinaryRouteFormat.h.
+
+#include "BinaryRouteFormat.h"
+#include "../Util/OSRMException.h"
+
+#include <boost/cstdint.hpp>
+#include <boost/foreach.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct BinaryRoute {
+    //fixed point, divide by 1e6 for degrees
+    struct Coordinate {
+        int lat;
+        int lon;
+    };
+
+    struct Instruction {
+        unsigned turn_instruction;
+        //number of the exit to take, 0 if not leaving a roundabout
+        unsigned roundabout_exit;
+        //index into names
+        unsigned name;
+        unsigned length;
+        //index of the first point of the instruction in the geometry
+        unsigned position;
+        unsigned duration;
+        unsigned bearing;
+    };
+
+    struct Route {
+        unsigned distance;
+        unsigned duration;
+        unsigned start_name;
+        unsigned end_name;
+        std::vector<Coordinate> geometry;
+        std::vector<Instruction> instructions;
+    };
+
+    BinaryRoute() : version(0), flags(0), checksum(0) { }
+
+    bool HasRoute() const {
+        return flags & BinaryRouteFormat::ROUTE_FOUND;
+    }
+
+    bool HasAlternative() const {
+        return flags & BinaryRouteFormat::ALTERNATIVE_FOUND;
+    }
+
+    unsigned version;
+    unsigned flags;
+    unsigned checksum;
+    Route route;
+    Route alternative;
+    std::vector<Coordinate> via_points;
+    std::vector<std::string> hints;
+    std::vector<std::string> names;
+};
+
+class BinaryRouteReader {
+public:
+    BinaryRouteReader(const char * begin, const char * end) :
+        m_current(begin),
+        m_end(end)
+    { }
+
+    //throws if the reply is truncated or of another format
+    void Read(BinaryRoute & result) {
+        RequireBytes(BinaryRouteFormat::HEADER_SIZE);
+        if( 0 != std::memcmp(m_current, BinaryRouteFormat::GetMagic(), 4) ) {
+            throw OSRMException("not a binary route");
+        }
+        m_current += 4;
+        result.version = ReadUInt8();
+        if( BinaryRouteFormat::VERSION != result.version ) {
+            throw OSRMException("unsupported binary route version");
+        }
+        result.flags = ReadUInt8();
+        ReadUInt16();
+        result.checksum = ReadUInt32();
+
+        if( result.HasRoute() ) {
+            ReadRoute(result.flags, result.route);
+        }
+        if( result.HasAlternative() ) {
+            ReadRoute(result.flags, result.alternative);
+        }
+
+        result.via_points.resize(ReadCount(8));
+        for(unsigned i = 0; i < result.via_points.size(); ++i) {
+            result.via_points[i].lat = ReadUInt32();
+            result.via_points[i].lon = ReadUInt32();
+        }
+        ReadStrings(result.hints);
+        ReadStrings(result.names);
+    }
+
+private:
+    void ReadRoute(const unsigned flags, BinaryRoute::Route & route) {
+        RequireBytes(BinaryRouteFormat::SUMMARY_SIZE);
+        route.distance = ReadUInt32();
+        route.duration = ReadUInt32();
+        route.start_name = ReadUInt32();
+        route.end_name = ReadUInt32();
+
+        if( flags & BinaryRouteFormat::GEOMETRY ) {
+            route.geometry.resize(ReadCount(2));
+            BinaryRoute::Coordinate previous = { 0, 0 };
+            for(unsigned i = 0; i < route.geometry.size(); ++i) {
+                previous.lat += BinaryRouteFormat::ZigZagDecode(ReadVarint());
+                previous.lon += BinaryRouteFormat::ZigZagDecode(ReadVarint());
+                route.geometry[i] = previous;
+            }
+        }
+        if( flags & BinaryRouteFormat::INSTRUCTIONS ) {
+            route.instructions.resize(ReadCount(8));
+            BOOST_FOREACH(BinaryRoute::Instruction & instruction, route.instructions) {
+                instruction.turn_instruction = ReadUInt8();
+                instruction.roundabout_exit = ReadUInt8();
+                instruction.name = ReadVarint();
+                instruction.length = ReadVarint();
+                instruction.position = ReadVarint();
+                instruction.duration = ReadVarint();
+                instruction.bearing = ReadUInt16();
+            }
+        }
+    }
+
+    void ReadStrings(std::vector<std::string> & strings) {
+        strings.resize(ReadCount(1));
+        BOOST_FOREACH(std::string & string, strings) {
+            const unsigned length = ReadVarint();
+            RequireBytes(length);
+            string.assign(m_current, m_current+length);
+            m_current += length;
+        }
+    }
+
+    //number of elements that follows, each at least minimum_size bytes
+    unsigned ReadCount(const unsigned minimum_size) {
+        const unsigned count = ReadVarint();
+        if( unsigned(m_end - m_current)/minimum_size < count ) {
+            throw OSRMException("binary route truncated");
+        }
+        return count;
+    }
+
+    void RequireBytes(const unsigned number_of_bytes) const {
+        if( unsigned(m_end - m_current) < number_of_bytes ) {
+            throw OSRMException("binary route truncated");
+        }
+    }
+
+    unsigned ReadUInt8() {
+        RequireBytes(1);
+        return (unsigned char)(*m_current++);
+    }
+
+    unsigned ReadUInt16() {
+        const unsigned low = ReadUInt8();
+        return low | (ReadUInt8() << 8);
+    }
+
+    boost::uint32_t ReadUInt32() {
+        const boost::uint32_t low = ReadUInt16();
+        return low | (boost::uint32_t(ReadUInt16()) << 16);
+    }
+
+    boost::uint32_t ReadVarint() {
+        boost::uint32_t value = 0;
+        for(unsigned shift = 0; shift < 35; shift += 7) {
+            const unsigned byte = ReadUInt8();
+            value |= boost::uint32_t(byte & 0x7f) << shift;
+            if( 0 == (byte & 0x80) ) {
+                return value;
+            }
+        }
+        throw OSRMException("malformed varint in binary route");
+    }
+
+    const char * m_current;
+    const char * m_end;
+};
+
+#endif //BINARY_ROUTE_READER_H
@@ -27,51 +27,139 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "OSRM.h"
 
-OSRM::OSRM( const ServerPaths & server_paths, const bool use_shared_memory )
- :
-    use_shared_memory(use_shared_memory)
+OSRM::OSRM(
+    const ServerPaths & server_paths,
+    const bool use_shared_memory,
+    const bool use_mapped_files,
+    const bool replicate_per_numa_node,
+    const DataWarmupPolicy & warmup_policy,
+    const unsigned response_cache_size
+) :
+    server_paths(server_paths),
+    use_shared_memory(use_shared_memory),
+    use_mapped_files(use_mapped_files),
+    number_of_replicas(
+        ( replicate_per_numa_node && !use_shared_memory && !use_mapped_files ) ?
+        NUMATopology::GetInstance().GetNumberOfNodes() : 1
+    ),
+    warmup_policy(warmup_policy)
 {
+    if( replicate_per_numa_node && ( use_shared_memory || use_mapped_files ) ) {
+        SimpleLogger().Write(logWARNING) <<
+            "only data loaded into memory is replicated per NUMA node";
+    }
+    if( 1 < number_of_replicas ) {
+        SimpleLogger().Write() <<
+            "replicating data on " << number_of_replicas << " NUMA nodes";
+    }
+    CreateDataSets(current_data_sets);
+    if( 0 < response_cache_size ) {
+        SimpleLogger().Write() <<
+            "response cache of " << response_cache_size << " MB";
+        response_cache.reset(
+            new ResponseCache(uint64_t(response_cache_size) << 20)
+        );
+    }
+}
+
+OSRM::~OSRM() { }
+
+OSRM::DataFacade * OSRM::CreateDataFacade() const {
+    if( !use_shared_memory && use_mapped_files ) {
+        return new MappedDataFacade<QueryEdge::EdgeData>(server_paths);
+    }
     if( !use_shared_memory ) {
-        query_data_facade = new InternalDataFacade<QueryEdge::EdgeData>(
-            server_paths
+        return new InternalDataFacade<QueryEdge::EdgeData>(server_paths);
+    }
+    return new SharedDataFacade<QueryEdge::EdgeData>( );
+}
+
+boost::shared_ptr<OSRM::DataSet> OSRM::CreateDataSet() const {
+    boost::shared_ptr<DataSet> data_set(new DataSet(CreateDataFacade()));
+    if( warmup_policy.IsActive() ) {
+        DataWarmup<DataFacade> warmup(warmup_policy, data_set->facade);
+        warmup.Run();
+    }
+    return data_set;
+}
+
+void OSRM::CreateDataSets(DataSetList & data_sets) const {
+    data_sets.resize(number_of_replicas);
+    if( 1 == number_of_replicas ) {
+        data_sets[0] = CreateDataSet();
+        return;
+    }
+    //first touch places the pages of each replica on its node
+    std::vector<std::string> error_messages(number_of_replicas);
+    boost::thread_group loader_threads;
+    for(unsigned node = 0; node < number_of_replicas; ++node) {
+        loader_threads.create_thread(
+            boost::bind(
+                &OSRM::CreateDataSetOnNode,
+                this,
+                node,
+                &data_sets[node],
+                &error_messages[node]
+            )
         );
-    } else {
-        query_data_facade = new SharedDataFacade<QueryEdge::EdgeData>( );
     }
+    loader_threads.join_all();
+    BOOST_FOREACH(const std::string & error_message, error_messages) {
+        if( !error_message.empty() ) {
+            throw OSRMException(error_message);
+        }
+    }
+}
+
+void OSRM::CreateDataSetOnNode(
+    const unsigned node,
+    boost::shared_ptr<DataSet> * data_set,
+    std::string * error_message
+) const {
+    if( !NUMATopology::GetInstance().BindCurrentThreadToNode(node) ) {
+        SimpleLogger().Write(logWARNING) <<
+            "could not bind loader thread to NUMA node " << node;
+    }
+    try {
+        *data_set = CreateDataSet();
+    } catch(const std::exception & e) {
+        *error_message = e.what();
+    }
+}
 
+OSRM::DataSet::DataSet(DataFacade * facade) : facade(facade) {
     //The following plugins handle all requests.
     RegisterPlugin(
         new HelloWorldPlugin()
     );
     RegisterPlugin(
-        new LocatePlugin<BaseDataFacade<QueryEdge::EdgeData> >(
-            query_data_facade
-        )
+        new ETAPlugin<DataFacade>(facade)
+    );
+    RegisterPlugin(
+        new LocatePlugin<DataFacade>(facade)
     );
     RegisterPlugin(
-        new NearestPlugin<BaseDataFacade<QueryEdge::EdgeData> >(
-            query_data_facade
-        )
+        new NearestPlugin<DataFacade>(facade)
     );
     RegisterPlugin(
-        new TimestampPlugin<BaseDataFacade<QueryEdge::EdgeData> >(
-            query_data_facade
-        )
+        new NearestBatchPlugin<DataFacade>(facade)
     );
     RegisterPlugin(
-        new ViaRoutePlugin<BaseDataFacade<QueryEdge::EdgeData> >(
-            query_data_facade
-        )
+        new TimestampPlugin<DataFacade>(facade)
+    );
+    RegisterPlugin(
+        new ViaRoutePlugin<DataFacade>(facade)
     );
 }
 
-OSRM::~OSRM() {
+OSRM::DataSet::~DataSet() {
     BOOST_FOREACH(PluginMap::value_type & plugin_pointer, plugin_map) {
         delete plugin_pointer.second;
     }
+    delete facade;
 }
 
-void OSRM::RegisterPlugin(BasePlugin * plugin) {
+void OSRM::DataSet::RegisterPlugin(BasePlugin * plugin) {
     SimpleLogger().Write()  << "loaded plugin: " << plugin->GetDescriptor();
     if( plugin_map.find(plugin->GetDescriptor()) != plugin_map.end() ) {
         delete plugin_map.find(plugin->GetDescriptor())->second;
@@ -79,53 +167,114 @@ void OSRM::RegisterPlugin(BasePlugin * plugin) {
     plugin_map.emplace(plugin->GetDescriptor(), plugin);
 }
 
+void OSRM::ReloadData() {
+    if( use_shared_memory ) {
+        SimpleLogger().Write(logWARNING) <<
+            "shared memory is updated by osrm-datastore, nothing to reload";
+        return;
+    }
+    boost::mutex::scoped_lock reload_lock(reload_mutex);
+    SimpleLogger().Write() << "reloading data";
+    try {
+        //queries keep running on the current data while the new one loads
+        DataSetList data_sets;
+        CreateDataSets(data_sets);
+        for(unsigned i = 0; i < data_sets.size(); ++i) {
+            boost::atomic_store(&current_data_sets[i], data_sets[i]);
+        }
+        if( response_cache ) {
+            response_cache->Clear();
+        }
+        SimpleLogger().Write() << "data reloaded";
+    } catch(const std::exception & e) {
+        SimpleLogger().Write(logWARNING) <<
+            "data reload failed, keeping previous data: " << e.what();
+    }
+}
+
+boost::shared_ptr<OSRM::DataSet> OSRM::GetDataSetOfCurrentThread() const {
+    const unsigned node = ( 1 < number_of_replicas ?
+        std::min(
+            NUMATopology::GetInstance().GetNodeOfCurrentThread(),
+            number_of_replicas - 1
+        ) : 0
+    );
+    return boost::atomic_load(&current_data_sets[node]);
+}
+
 void OSRM::RunQuery(RouteParameters & route_parameters, http::Reply & reply) {
-    const PluginMap::const_iterator & iter = plugin_map.find(
+    //the data set stays alive until this query is answered
+    const boost::shared_ptr<DataSet> data_set(GetDataSetOfCurrentThread());
+    const PluginMap::const_iterator & iter = data_set->plugin_map.find(
         route_parameters.service
     );
 
-    if(plugin_map.end() != iter) {
+    if(data_set->plugin_map.end() != iter) {
         reply.status = http::Reply::ok;
         if( use_shared_memory ) {
-            // lock update pending
-            boost::interprocess::scoped_lock<
-                boost::interprocess::named_mutex
-            > pending_lock(barrier.pending_update_mutex);
-
-            // lock query
-            boost::interprocess::scoped_lock<
-                boost::interprocess::named_mutex
-            > query_lock(barrier.query_mutex);
-
-            // unlock update pending
-            pending_lock.unlock();
-
-            // increment query count
-            ++(barrier.number_of_queries);
-
-            (static_cast<SharedDataFacade<QueryEdge::EdgeData>* >(query_data_facade))->CheckAndReloadFacade();
-        }
-
-        iter->second->HandleRequest(route_parameters, reply );
-        if( use_shared_memory ) {
-            // lock query
-            boost::interprocess::scoped_lock<
-                boost::interprocess::named_mutex
-            > query_lock(barrier.query_mutex);
-
-            // decrement query count
-            --(barrier.number_of_queries);
-            BOOST_ASSERT_MSG(
-                0 <= barrier.number_of_queries,
-                "invalid number of queries"
+            // pins the current data generation until the reply is complete
+            SharedDataFacade<QueryEdge::EdgeData>::Reader data_reader(
+                *static_cast<SharedDataFacade<QueryEdge::EdgeData>* >(data_set->facade)
             );
-
-            // notify all processes that were waiting for this condition
-            if (0 == barrier.number_of_queries) {
-                barrier.no_running_queries_condition.notify_all();
-            }
+            iter->second->HandleRequest(route_parameters, reply );
+        } else {
+            iter->second->HandleRequest(route_parameters, reply );
         }
     } else {
         reply = http::Reply::StockReply(http::Reply::badRequest);
     }
 }
+
+void OSRM::RunQuery(
+    RouteParameters & route_parameters,
+    const http::Request & request,
+    http::Reply & reply
+) {
+    if( !response_cache ) {
+        RunQuery(route_parameters, reply);
+        return;
+    }
+    //the data set stays alive until this query is answered
+    const boost::shared_ptr<DataSet> data_set(GetDataSetOfCurrentThread());
+    const PluginMap::const_iterator & iter = data_set->plugin_map.find(
+        route_parameters.service
+    );
+    if(data_set->plugin_map.end() == iter) {
+        reply = http::Reply::StockReply(http::Reply::badRequest);
+        return;
+    }
+    // pins the current data generation, the checksum must match the reply
+    boost::scoped_ptr<SharedDataFacade<QueryEdge::EdgeData>::Reader> data_reader(
+        use_shared_memory ?
+        new SharedDataFacade<QueryEdge::EdgeData>::Reader(
+            *static_cast<SharedDataFacade<QueryEdge::EdgeData>* >(data_set->facade)
+        ) : NULL
+    );
+    const std::string key = ResponseCache::GetKey(
+        route_parameters,
+        data_set->facade->GetCheckSum()
+    );
+    const std::string etag = ResponseCache::GetETag(key);
+    if( std::string::npos != request.if_none_match.find(etag) ) {
+        reply.status = http::Reply::notModified;
+        reply.content.clear();
+        reply.headers.resize(2);
+        reply.headers[0].name = "Access-Control-Allow-Origin";
+        reply.headers[0].value = "*";
+        reply.headers[1].name = "ETag";
+        reply.headers[1].value = etag;
+        return;
+    }
+
+    ResponseCache::EntryPtr entry = response_cache->Fetch(key);
+    if( !entry ) {
+        reply.status = http::Reply::ok;
+        iter->second->HandleRequest(route_parameters, reply);
+        if( http::Reply::ok != reply.status ) {
+            return;
+        }
+        entry.reset(new ResponseCache::Entry(etag, reply));
+        response_cache->Insert(key, entry);
+    }
+    entry->WriteReply(request.compression_type, reply);
+}
@@ -31,17 +31,23 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "OSRM.h"
 
 #include "../Plugins/BasePlugin.h"
+#include "../Plugins/ETAPlugin.h"
 #include "../Plugins/HelloWorldPlugin.h"
 #include "../Plugins/LocatePlugin.h"
 #include "../Plugins/NearestPlugin.h"
+#include "../Plugins/NearestBatchPlugin.h"
 #include "../Plugins/TimestampPlugin.h"
 #include "../Plugins/ViaRoutePlugin.h"
 #include "../Server/DataStructures/BaseDataFacade.h"
+#include "../Server/DataStructures/DataWarmup.h"
 #include "../Server/DataStructures/InternalDataFacade.h"
-#include "../Server/DataStructures/SharedBarriers.h"
+#include "../Server/DataStructures/MappedDataFacade.h"
 #include "../Server/DataStructures/SharedDataFacade.h"
+#include "../Server/DataStructures/ResponseCache.h"
 #include "../Server/DataStructures/RouteParameters.h"
+#include "../Server/Http/Request.h"
 #include "../Util/InputFileUtil.h"
+#include "../Util/NUMATopology.h"
 #include "../Util/OSRMException.h"
 #include "../Util/SimpleLogger.h"
 
@@ -50,31 +56,77 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/foreach.hpp>
 #include <boost/interprocess/shared_memory_object.hpp>
 #include <boost/interprocess/mapped_region.hpp>
-#include <boost/interprocess/sync/scoped_lock.hpp>
 #include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/thread.hpp>
 
+#include <string>
 #include <vector>
 
 class OSRM : boost::noncopyable {
 private:
     typedef boost::unordered_map<std::string, BasePlugin *> PluginMap;
+    typedef BaseDataFacade<QueryEdge::EdgeData> DataFacade;
+
+    //a facade together with the plugins that answer queries on it. Queries
+    //hold a reference, a replaced data set is freed after its last query.
+    class DataSet : boost::noncopyable {
+    public:
+        explicit DataSet(DataFacade * facade);
+        ~DataSet();
+        DataFacade * const facade;
+        PluginMap plugin_map;
+    private:
+        void RegisterPlugin(BasePlugin * plugin);
+    };
+
 public:
     OSRM(
         const ServerPaths & paths,
-        const bool use_shared_memory = false
+        const bool use_shared_memory = false,
+        const bool use_mapped_files = false,
+        const bool replicate_per_numa_node = false,
+        const DataWarmupPolicy & warmup_policy = DataWarmupPolicy(),
+        const unsigned response_cache_size = 0
     );
     ~OSRM();
     void RunQuery(RouteParameters & route_parameters, http::Reply & reply);
+    //answers from the response cache if there is one, with the body encoded
+    //as the request accepts, and with 304 if the client has the reply
+    void RunQuery(
+        RouteParameters & route_parameters,
+        const http::Request & request,
+        http::Reply & reply
+    );
+    //loads the data files again and swaps them in without blocking queries
+    void ReloadData();
 
 private:
-    void RegisterPlugin(BasePlugin * plugin);
-    PluginMap plugin_map;
-    bool use_shared_memory;
-    SharedBarriers barrier;
-    //base class pointer to the objects
-    BaseDataFacade<QueryEdge::EdgeData> * query_data_facade;
+    typedef std::vector<boost::shared_ptr<DataSet> > DataSetList;
+
+    boost::shared_ptr<DataSet> GetDataSetOfCurrentThread() const;
+    DataFacade * CreateDataFacade() const;
+    //facade and plugins, with the data warmed up according to the policy
+    boost::shared_ptr<DataSet> CreateDataSet() const;
+    //one data set per replica, each one loaded by a thread on its node
+    void CreateDataSets(DataSetList & data_sets) const;
+    void CreateDataSetOnNode(
+        const unsigned node,
+        boost::shared_ptr<DataSet> * data_set,
+        std::string * error_message
+    ) const;
+
+    const ServerPaths server_paths;
+    const bool use_shared_memory;
+    const bool use_mapped_files;
+    const unsigned number_of_replicas;
+    const DataWarmupPolicy warmup_policy;
+    //indexed by NUMA node if data is replicated, a single entry otherwise
+    DataSetList current_data_sets;
+    boost::mutex reload_mutex;
+    //set if the size of the response cache is not zero
+    boost::scoped_ptr<ResponseCache> response_cache;
 };
 
 #endif //OSRM_H
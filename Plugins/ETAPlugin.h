@@ -0,0 +1,206 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ETAPLUGIN_H_
+#define ETAPLUGIN_H_
+
+#include "BasePlugin.h"
+#include "PhantomNodeLookup.h"
+
+#include "../Algorithms/PhantomNodeHint.h"
+#include "../DataStructures/SearchEngine.h"
+#include "../DataStructures/TurnInstructions.h"
+#include "../Util/JSONWriter.h"
+#include "../Util/SimpleLogger.h"
+#include "../Util/StringUtil.h"
+
+#include <boost/foreach.hpp>
+
+#include <cmath>
+
+#include <string>
+#include <vector>
+
+/*
+ * Answers only duration and distance of a route. The path is not unpacked,
+ * the distance is summed up from the lengths of the shortcuts computed by
+ * osrm-prepare. Access restriction penalties are taken out of the duration
+ * with the number of restricted areas each shortcut enters.
+ */
+
+template<class DataFacadeT>
+class ETAPlugin : public BasePlugin {
+public:
+    ETAPlugin(DataFacadeT * facade)
+     :
+        facade(facade),
+        descriptor_string("eta"),
+        phantom_node_lookup(facade)
+    {
+        search_engine_ptr = new SearchEngine<DataFacadeT>(facade);
+    }
+
+    virtual ~ETAPlugin() {
+        delete search_engine_ptr;
+    }
+
+    const std::string & GetDescriptor() const { return descriptor_string; }
+
+    void HandleRequest(
+        const RouteParameters & routeParameters,
+        http::Reply& reply
+    ) {
+        //check number of parameters
+        if( 2 > routeParameters.coordinates.size() ) {
+            reply = http::Reply::StockReply(http::Reply::badRequest);
+            return;
+        }
+        BOOST_FOREACH(const FixedPointCoordinate & coordinate, routeParameters.coordinates) {
+            if( !checkCoord(coordinate) ) {
+                reply = http::Reply::StockReply(http::Reply::badRequest);
+                return;
+            }
+        }
+
+        RawRouteData raw_route;
+        raw_route.checkSum = facade->GetCheckSum();
+        raw_route.rawViaNodeCoordinates = routeParameters.coordinates;
+        std::vector<PhantomNode> phantom_node_vector(
+            routeParameters.coordinates.size()
+        );
+        for(unsigned i = 0; i < phantom_node_vector.size(); ++i) {
+            phantom_node_lookup.FindPhantomNode(
+                routeParameters,
+                i,
+                phantom_node_vector[i]
+            );
+        }
+        for(unsigned i = 0; i < phantom_node_vector.size()-1; ++i) {
+            PhantomNodes segment_phantom_nodes;
+            segment_phantom_nodes.startPhantom = phantom_node_vector[i];
+            segment_phantom_nodes.targetPhantom = phantom_node_vector[i+1];
+            raw_route.segmentEndCoordinates.push_back(segment_phantom_nodes);
+        }
+        search_engine_ptr->shortest_path(
+            raw_route.segmentEndCoordinates,
+            raw_route,
+            false
+        );
+        if( INT_MAX == raw_route.lengthOfShortestPath ) {
+            SimpleLogger().Write(logDEBUG) <<
+                "Error occurred, single path not found";
+        }
+
+        std::string temp_string;
+        //json
+        reply.content.push_back(std::string());
+        JSONWriter writer(reply.content.back());
+
+        if("" != routeParameters.jsonpParameter) {
+            writer.Raw(routeParameters.jsonpParameter);
+            writer.Raw('(');
+        }
+
+        reply.status = http::Reply::ok;
+        writer.Raw('{');
+        writer.Raw("\"version\":0.3,");
+        if( INT_MAX != raw_route.lengthOfShortestPath ) {
+            writer.Raw("\"status\":0,");
+            writer.Raw("\"status_message\":\"Found route between points\",");
+            //rounded like the route summaries of viaroute
+            writer.Key("route_summary").Raw('{');
+            writer.Key("total_distance").Int(
+                (int)std::floor(raw_route.geometricLengthOfShortestPath + .5)
+            );
+            writer.Raw(',');
+            //without access restriction penalties like the descriptors
+            writer.Key("total_time").Int(
+                (
+                    raw_route.lengthOfShortestPath -
+                    int(raw_route.enteredRestrictedAreasOfShortestPath)*
+                    TurnInstructions.AccessRestrictionPenalty
+                )/10 + 1
+            );
+            writer.Raw("},");
+        } else {
+            writer.Raw("\"status\":207,");
+            writer.Raw("\"status_message\":\"Cannot find route between points\",");
+        }
+        WriteHints(writer, raw_route);
+        writer.Raw(",\"transactionId\":\"OSRM Routing Engine JSON ETA (v0.3)\"");
+        writer.Raw('}');
+        reply.headers.resize(3);
+        if( !routeParameters.jsonpParameter.empty() ) {
+            writer.Raw(')');
+            reply.headers[1].name = "Content-Type";
+            reply.headers[1].value = "text/javascript";
+            reply.headers[2].name = "Content-Disposition";
+            reply.headers[2].value = "attachment; filename=\"eta.js\"";
+        } else {
+            reply.headers[1].name = "Content-Type";
+            reply.headers[1].value = "application/x-javascript";
+            reply.headers[2].name = "Content-Disposition";
+            reply.headers[2].value = "attachment; filename=\"eta.json\"";
+        }
+        reply.headers[0].name = "Content-Length";
+        unsigned content_length = 0;
+        BOOST_FOREACH(const std::string & snippet, reply.content) {
+            content_length += snippet.length();
+        }
+        intToString(content_length, temp_string);
+        reply.headers[0].value = temp_string;
+    }
+
+private:
+    void WriteHints(JSONWriter & writer, const RawRouteData & raw_route) const {
+        writer.Raw("\"hint_data\":{");
+        writer.Raw("\"checksum\":");
+        //printed signed for compatibility with existing clients
+        writer.Int(raw_route.checkSum);
+        writer.Raw(",\"locations\":[");
+        std::string hint;
+        BOOST_FOREACH(const PhantomNodes & segment, raw_route.segmentEndCoordinates) {
+            PhantomNodeHint::Encode(segment.startPhantom, raw_route.checkSum, hint);
+            writer.EscapedString(hint);
+            writer.Raw(',');
+        }
+        PhantomNodeHint::Encode(
+            raw_route.segmentEndCoordinates.back().targetPhantom,
+            raw_route.checkSum,
+            hint
+        );
+        writer.EscapedString(hint);
+        writer.Raw("]}");
+    }
+
+    DataFacadeT * facade;
+    std::string descriptor_string;
+    SearchEngine<DataFacadeT> * search_engine_ptr;
+    PhantomNodeLookup<DataFacadeT> phantom_node_lookup;
+};
+
+#endif /* ETAPLUGIN_H_ */
@@ -29,6 +29,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define LOCATEPLUGIN_H_
 
 #include "BasePlugin.h"
+#include "../DataStructures/CoordinateCache.h"
+#include "../Util/JSONWriter.h"
 #include "../Util/StringUtil.h"
 
 //locates the nearest node in the road network for a given coordinate.
@@ -57,44 +59,55 @@ public:
             return;
         }
 
-        //query to helpdesk
+        //query to helpdesk, unless the coordinate was located before
         FixedPointCoordinate result;
+        const unsigned checksum = facade->GetCheckSum();
+        bool found_end_point = end_point_cache.Fetch(
+            routeParameters.coordinates[0],
+            18,
+            checksum,
+            result
+        );
+        if( !found_end_point ) {
+            found_end_point = facade->LocateClosestEndPointForCoordinate(
+                routeParameters.coordinates[0],
+                result
+            );
+            if( found_end_point ) {
+                end_point_cache.Insert(
+                    routeParameters.coordinates[0],
+                    18,
+                    checksum,
+                    result
+                );
+            }
+        }
         std::string tmp;
         //json
+        reply.content.push_back(std::string());
+        JSONWriter writer(reply.content.back());
 
         if(!routeParameters.jsonpParameter.empty()) {
-            reply.content.push_back(routeParameters.jsonpParameter);
-            reply.content.push_back("(");
+            writer.Raw(routeParameters.jsonpParameter);
+            writer.Raw('(');
         }
         reply.status = http::Reply::ok;
-        reply.content.push_back ("{");
-        reply.content.push_back ("\"version\":0.3,");
-        if(
-            !facade->LocateClosestEndPointForCoordinate(
-                routeParameters.coordinates[0],
-                result
-             )
-        ) {
-            reply.content.push_back ("\"status\":207,");
-            reply.content.push_back ("\"mapped_coordinate\":[]");
+        writer.Raw('{');
+        writer.Raw("\"version\":0.3,");
+        if( !found_end_point ) {
+            writer.Raw("\"status\":207,");
+            writer.Raw("\"mapped_coordinate\":[]");
         } else {
             //Write coordinate to stream
             reply.status = http::Reply::ok;
-            reply.content.push_back ("\"status\":0,");
-            reply.content.push_back ("\"mapped_coordinate\":");
-            convertInternalLatLonToString(result.lat, tmp);
-            reply.content.push_back("[");
-            reply.content.push_back(tmp);
-            convertInternalLatLonToString(result.lon, tmp);
-            reply.content.push_back(",");
-            reply.content.push_back(tmp);
-            reply.content.push_back("]");
+            writer.Raw("\"status\":0,");
+            writer.Key("mapped_coordinate").Coordinate(result);
         }
-        reply.content.push_back(",\"transactionId\": \"OSRM Routing Engine JSON Locate (v0.3)\"");
-        reply.content.push_back("}");
+        writer.Raw(",\"transactionId\": \"OSRM Routing Engine JSON Locate (v0.3)\"");
+        writer.Raw('}');
         reply.headers.resize(3);
         if(!routeParameters.jsonpParameter.empty()) {
-            reply.content.push_back( ")");
+            writer.Raw(')');
             reply.headers[1].name = "Content-Type";
             reply.headers[1].value = "text/javascript";
             reply.headers[2].name = "Content-Disposition";
@@ -118,6 +131,7 @@ public:
 private:
     std::string descriptor_string;
     DataFacadeT * facade;
+    CoordinateCache<FixedPointCoordinate> end_point_cache;
 };
 
 #endif /* LOCATEPLUGIN_H_ */
@@ -0,0 +1,158 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef NEARESTBATCHPLUGIN_H_
+#define NEARESTBATCHPLUGIN_H_
+
+#include "BasePlugin.h"
+#include "../DataStructures/NameStore.h"
+#include "../DataStructures/PhantomNodes.h"
+#include "../Util/JSONWriter.h"
+#include "../Util/StringUtil.h"
+
+#include <boost/foreach.hpp>
+
+#include <string>
+#include <vector>
+
+/*
+ * This Plugin snaps a whole batch of coordinates to the road network in one
+ * request. Results are returned in the order of the input coordinates.
+ * Requests with more than MAX_NUMBER_OF_COORDINATES coordinates are
+ * rejected.
+ */
+
+template<class DataFacadeT>
+class NearestBatchPlugin : public BasePlugin {
+public:
+    NearestBatchPlugin(DataFacadeT * facade )
+     :
+        facade(facade),
+        descriptor_string("nearestbatch")
+    { }
+    const std::string & GetDescriptor() const { return descriptor_string; }
+    void HandleRequest(const RouteParameters & routeParameters, http::Reply& reply) {
+        //check number of parameters
+        if(routeParameters.coordinates.empty()) {
+            reply = http::Reply::StockReply(http::Reply::badRequest);
+            return;
+        }
+        if(MAX_NUMBER_OF_COORDINATES < routeParameters.coordinates.size()) {
+            reply = http::Reply::StockReply(http::Reply::badRequest);
+            return;
+        }
+        BOOST_FOREACH(const FixedPointCoordinate & coordinate, routeParameters.coordinates) {
+            if( !checkCoord(coordinate) ) {
+                reply = http::Reply::StockReply(http::Reply::badRequest);
+                return;
+            }
+        }
+
+        std::vector<PhantomNode> results;
+        facade->FindPhantomNodesForCoordinates(
+            routeParameters.coordinates,
+            results,
+            routeParameters.zoomLevel
+        );
+
+        std::string temp_string;
+        //json
+        reply.content.push_back(std::string());
+        JSONWriter writer(reply.content.back());
+
+        if("" != routeParameters.jsonpParameter) {
+            writer.Raw(routeParameters.jsonpParameter);
+            writer.Raw('(');
+        }
+
+        reply.status = http::Reply::ok;
+        writer.Raw('{');
+        writer.Raw("\"version\":0.3,");
+        writer.Raw("\"status\":0,");
+        writer.Key("results").Raw('[');
+        for(unsigned i = 0; i < results.size(); ++i) {
+            const PhantomNode & result = results[i];
+            if(0 != i) {
+                writer.Raw(',');
+            }
+            writer.Raw('{');
+            writer.Key("status");
+            if(UINT_MAX != result.edgeBasedNode) {
+                writer.Raw("0,");
+            } else {
+                writer.Raw("207,");
+            }
+            writer.Key("mapped_coordinate");
+            if(UINT_MAX != result.edgeBasedNode) {
+                writer.Coordinate(result.location);
+            } else {
+                writer.Raw("[]");
+            }
+            writer.Raw(',');
+            writer.Key("name");
+            if(UINT_MAX != result.edgeBasedNode) {
+                writer.EscapedString(facade->GetEscapedName(result.nodeBasedEdgeNameID));
+            } else {
+                writer.Raw("\"\"");
+            }
+            writer.Raw('}');
+        }
+        writer.Raw(']');
+        writer.Raw(",\"transactionId\":\"OSRM Routing Engine JSON Nearest Batch (v0.3)\"");
+        writer.Raw('}');
+        reply.headers.resize(3);
+        if( !routeParameters.jsonpParameter.empty() ) {
+            writer.Raw(')');
+            reply.headers[1].name = "Content-Type";
+            reply.headers[1].value = "text/javascript";
+            reply.headers[2].name = "Content-Disposition";
+            reply.headers[2].value = "attachment; filename=\"location.js\"";
+        } else {
+            reply.headers[1].name = "Content-Type";
+            reply.headers[1].value = "application/x-javascript";
+            reply.headers[2].name = "Content-Disposition";
+            reply.headers[2].value = "attachment; filename=\"location.json\"";
+        }
+        reply.headers[0].name = "Content-Length";
+        unsigned content_length = 0;
+        BOOST_FOREACH(const std::string & snippet, reply.content) {
+            content_length += snippet.length();
+        }
+        intToString(content_length, temp_string);
+        reply.headers[0].value = temp_string;
+    }
+
+private:
+    //bounds the work a single request can cause
+    static const unsigned MAX_NUMBER_OF_COORDINATES = 1000;
+
+    DataFacadeT * facade;
+    std::string descriptor_string;
+};
+
+#endif /* NEARESTBATCHPLUGIN_H_ */
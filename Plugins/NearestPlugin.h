@@ -29,7 +29,10 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define NearestPlugin_H_
 
 #include "BasePlugin.h"
+#include "../DataStructures/CoordinateCache.h"
+#include "../DataStructures/NameStore.h"
 #include "../DataStructures/PhantomNodes.h"
+#include "../Util/JSONWriter.h"
 #include "../Util/StringUtil.h"
 
 /*
@@ -60,50 +63,68 @@ public:
         }
 
         PhantomNode result;
-        facade->FindPhantomNodeForCoordinate(
-            routeParameters.coordinates[0],
-            result,
-            routeParameters.zoomLevel
-        );
+        const unsigned checksum = facade->GetCheckSum();
+        if(
+            !phantom_node_cache.Fetch(
+                routeParameters.coordinates[0],
+                routeParameters.zoomLevel,
+                checksum,
+                result
+            )
+        ) {
+            const bool found_phantom_node = facade->FindPhantomNodeForCoordinate(
+                routeParameters.coordinates[0],
+                result,
+                routeParameters.zoomLevel
+            );
+            //misses are not cached, they would push out the hits
+            if( found_phantom_node ) {
+                phantom_node_cache.Insert(
+                    routeParameters.coordinates[0],
+                    routeParameters.zoomLevel,
+                    checksum,
+                    result
+                );
+            }
+        }
 
         std::string temp_string;
         //json
+        reply.content.push_back(std::string());
+        JSONWriter writer(reply.content.back());
 
         if("" != routeParameters.jsonpParameter) {
-            reply.content.push_back(routeParameters.jsonpParameter);
-            reply.content.push_back("(");
+            writer.Raw(routeParameters.jsonpParameter);
+            writer.Raw('(');
         }
 
         reply.status = http::Reply::ok;
-        reply.content.push_back("{");
-        reply.content.push_back("\"version\":0.3,");
-        reply.content.push_back("\"status\":");
+        writer.Raw('{');
+        writer.Raw("\"version\":0.3,");
+        writer.Key("status");
         if(UINT_MAX != result.edgeBasedNode) {
-            reply.content.push_back("0,");
+            writer.Raw("0,");
         } else {
-            reply.content.push_back("207,");
+            writer.Raw("207,");
         }
-        reply.content.push_back("\"mapped_coordinate\":");
-        reply.content.push_back("[");
+        writer.Key("mapped_coordinate");
         if(UINT_MAX != result.edgeBasedNode) {
-            convertInternalLatLonToString(result.location.lat, temp_string);
-            reply.content.push_back(temp_string);
-            convertInternalLatLonToString(result.location.lon, temp_string);
-            reply.content.push_back(",");
-            reply.content.push_back(temp_string);
+            writer.Coordinate(result.location);
+        } else {
+            writer.Raw("[]");
         }
-        reply.content.push_back("],");
-        reply.content.push_back("\"name\":\"");
+        writer.Raw(',');
+        writer.Key("name");
         if(UINT_MAX != result.edgeBasedNode) {
-            facade->GetName(result.nodeBasedEdgeNameID, temp_string);
-            reply.content.push_back(temp_string);
+            writer.EscapedString(facade->GetEscapedName(result.nodeBasedEdgeNameID));
+        } else {
+            writer.Raw("\"\"");
         }
-        reply.content.push_back("\"");
-        reply.content.push_back(",\"transactionId\":\"OSRM Routing Engine JSON Nearest (v0.3)\"");
-        reply.content.push_back("}");
+        writer.Raw(",\"transactionId\":\"OSRM Routing Engine JSON Nearest (v0.3)\"");
+        writer.Raw('}');
         reply.headers.resize(3);
         if( !routeParameters.jsonpParameter.empty() ) {
-            reply.content.push_back(")");
+            writer.Raw(')');
             reply.headers[1].name = "Content-Type";
             reply.headers[1].value = "text/javascript";
             reply.headers[2].name = "Content-Disposition";
@@ -127,6 +148,7 @@ private:
     DataFacadeT * facade;
     HashTable<std::string, unsigned> descriptorTable;
     std::string descriptor_string;
+    CoordinateCache<PhantomNode> phantom_node_cache;
 };
 
 #endif /* NearestPlugin_H_ */
@@ -0,0 +1,99 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PHANTOMNODELOOKUP_H_
+#define PHANTOMNODELOOKUP_H_
+
+#include "../Algorithms/PhantomNodeHint.h"
+#include "../DataStructures/CoordinateCache.h"
+#include "../DataStructures/PhantomNodes.h"
+#include "../Server/DataStructures/RouteParameters.h"
+
+#include <boost/noncopyable.hpp>
+
+//Snaps the coordinates of route requests. A coordinate is taken from its
+//hint if the hint matches the loaded data, else from the cache of earlier
+//lookups and only then from the r-tree.
+
+template<class DataFacadeT>
+class PhantomNodeLookup : boost::noncopyable {
+public:
+    explicit PhantomNodeLookup(DataFacadeT * facade) : facade(facade) { }
+
+    void FindPhantomNode(
+        const RouteParameters & routeParameters,
+        const unsigned index,
+        PhantomNode & phantom_node
+    ) {
+        const unsigned check_sum = facade->GetCheckSum();
+        if(
+            check_sum == routeParameters.checkSum &&
+            index < routeParameters.hints.size() &&
+            !routeParameters.hints[index].empty() &&
+            PhantomNodeHint::Decode(
+                routeParameters.hints[index],
+                check_sum,
+                phantom_node
+            ) &&
+            phantom_node.isValid(facade->GetNumberOfNodes())
+        ) {
+            return;
+        }
+        const FixedPointCoordinate & coordinate =
+            routeParameters.coordinates[index];
+        if(
+            phantom_node_cache.Fetch(
+                coordinate,
+                routeParameters.zoomLevel,
+                check_sum,
+                phantom_node
+            )
+        ) {
+            return;
+        }
+        const bool found_phantom_node = facade->FindPhantomNodeForCoordinate(
+            coordinate,
+            phantom_node,
+            routeParameters.zoomLevel
+        );
+        //misses are not cached, they would push out the hits
+        if( found_phantom_node ) {
+            phantom_node_cache.Insert(
+                coordinate,
+                routeParameters.zoomLevel,
+                check_sum,
+                phantom_node
+            );
+        }
+    }
+
+private:
+    DataFacadeT * facade;
+    CoordinateCache<PhantomNode> phantom_node_cache;
+};
+
+#endif /* PHANTOMNODELOOKUP_H_ */
@@ -29,6 +29,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define TIMESTAMPPLUGIN_H_
 
 #include "BasePlugin.h"
+#include "../Util/JSONWriter.h"
 
 template<class DataFacadeT>
 class TimestampPlugin : public BasePlugin {
@@ -41,24 +42,23 @@ public:
         std::string tmp;
 
         //json
+        reply.content.push_back(std::string());
+        JSONWriter writer(reply.content.back());
         if("" != routeParameters.jsonpParameter) {
-            reply.content.push_back(routeParameters.jsonpParameter);
-            reply.content.push_back("(");
+            writer.Raw(routeParameters.jsonpParameter);
+            writer.Raw('(');
         }
 
         reply.status = http::Reply::ok;
-        reply.content.push_back("{");
-        reply.content.push_back("\"version\":0.3,");
-        reply.content.push_back("\"status\":");
-            reply.content.push_back("0,");
-        reply.content.push_back("\"timestamp\":\"");
-        reply.content.push_back(facade->GetTimestamp());
-        reply.content.push_back("\"");
-        reply.content.push_back(",\"transactionId\":\"OSRM Routing Engine JSON timestamp (v0.3)\"");
-        reply.content.push_back("}");
+        writer.Raw('{');
+        writer.Raw("\"version\":0.3,");
+        writer.Raw("\"status\":0,");
+        writer.Key("timestamp").String(facade->GetTimestamp());
+        writer.Raw(",\"transactionId\":\"OSRM Routing Engine JSON timestamp (v0.3)\"");
+        writer.Raw('}');
         reply.headers.resize(3);
         if("" != routeParameters.jsonpParameter) {
-            reply.content.push_back(")");
+            writer.Raw(')');
             reply.headers[1].name = "Content-Type";
             reply.headers[1].value = "text/javascript";
             reply.headers[2].name = "Content-Disposition";
@@ -69,6 +69,7 @@ public:
             reply.headers[2].name = "Content-Disposition";
             reply.headers[2].value = "attachment; filename=\"timestamp.json\"";
         }
+        reply.headers[0].name = "Content-Length";
         unsigned content_length = 0;
         BOOST_FOREACH(const std::string & snippet, reply.content) {
             content_length += snippet.length();
@@ -29,16 +29,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define VIAROUTEPLUGIN_H_
 
 #include "BasePlugin.h"
+#include "PhantomNodeLookup.h"
 
-#include "../Algorithms/ObjectToBase64.h"
 #include "../DataStructures/QueryEdge.h"
 #include "../DataStructures/SearchEngine.h"
 #include "../Descriptors/BaseDescriptor.h"
+#include "../Descriptors/BinaryDescriptor.h"
 #include "../Descriptors/GPXDescriptor.h"
 #include "../Descriptors/JSONDescriptor.h"
 #include "../Util/SimpleLogger.h"
 #include "../Util/StringUtil.h"
 
+#include <boost/thread/tss.hpp>
 #include <boost/unordered_map.hpp>
 
 #include <cstdlib>
@@ -49,20 +51,33 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 template<class DataFacadeT>
 class ViaRoutePlugin : public BasePlugin {
 private:
+    //one set per thread, reused by all of its requests so that the buffers
+    //of the descriptors are allocated only once. Descriptors get the facade
+    //with every request, so the set is shared by all plugins of a thread and
+    //outlives reloads. It is freed when the thread exits.
+    struct ThreadLocalDescriptors {
+        JSONDescriptor<DataFacadeT> json_descriptor;
+        GPXDescriptor<DataFacadeT> gpx_descriptor;
+        BinaryDescriptor<DataFacadeT> binary_descriptor;
+    };
+
     boost::unordered_map<std::string, unsigned> descriptorTable;
     SearchEngine<DataFacadeT> * search_engine_ptr;
+    static boost::thread_specific_ptr<ThreadLocalDescriptors> thread_local_descriptors;
 public:
 
     ViaRoutePlugin(DataFacadeT * facade)
      :
         descriptor_string("viaroute"),
-        facade(facade)
+        facade(facade),
+        phantom_node_lookup(facade)
     {
         //TODO: set up an engine for each thread!!
         search_engine_ptr = new SearchEngine<DataFacadeT>(facade);
 
         descriptorTable.emplace("json", 0);
         descriptorTable.emplace("gpx" , 1);
+        descriptorTable.emplace("binary", 2);
     }
 
     virtual ~ViaRoutePlugin() {
@@ -83,7 +98,6 @@ public:
 
         RawRouteData rawRoute;
         rawRoute.checkSum = facade->GetCheckSum();
-        bool checksumOK = (routeParameters.checkSum == rawRoute.checkSum);
         std::vector<std::string> textCoord;
         for(unsigned i = 0; i < routeParameters.coordinates.size(); ++i) {
             if( !checkCoord(routeParameters.coordinates[i]) ) {
@@ -94,19 +108,10 @@ public:
         }
         std::vector<PhantomNode> phantomNodeVector(rawRoute.rawViaNodeCoordinates.size());
         for(unsigned i = 0; i < rawRoute.rawViaNodeCoordinates.size(); ++i) {
-            if(checksumOK && i < routeParameters.hints.size() && "" != routeParameters.hints[i]) {
-//                SimpleLogger().Write() <<"Decoding hint: " << routeParameters.hints[i] << " for location index " << i;
-                DecodeObjectFromBase64(routeParameters.hints[i], phantomNodeVector[i]);
-                if(phantomNodeVector[i].isValid(facade->GetNumberOfNodes())) {
-//                    SimpleLogger().Write() << "Decoded hint " << i << " successfully";
-                    continue;
-                }
-            }
-//            SimpleLogger().Write() << "Brute force lookup of coordinate " << i;
-            facade->FindPhantomNodeForCoordinate(
-                rawRoute.rawViaNodeCoordinates[i],
-                phantomNodeVector[i],
-                routeParameters.zoomLevel
+            phantom_node_lookup.FindPhantomNode(
+                routeParameters,
+                i,
+                phantomNodeVector[i]
             );
         }
 
@@ -137,35 +142,45 @@ public:
         }
         reply.status = http::Reply::ok;
 
-        //TODO: Move to member as smart pointer
-        BaseDescriptor<DataFacadeT> * desc;
-        if("" != routeParameters.jsonpParameter) {
-            reply.content.push_back(routeParameters.jsonpParameter);
-            reply.content.push_back("(");
+        if( !thread_local_descriptors.get() ) {
+            thread_local_descriptors.reset(new ThreadLocalDescriptors());
         }
-
+        BaseDescriptor<DataFacadeT> * desc;
         DescriptorConfig descriptorConfig;
 
         unsigned descriptorType = 0;
         if(descriptorTable.find(routeParameters.outputFormat) != descriptorTable.end() ) {
             descriptorType = descriptorTable.find(routeParameters.outputFormat)->second;
         }
+        //binary replies cannot be wrapped
+        const bool wrap_in_jsonp =
+            !routeParameters.jsonpParameter.empty() && 2 != descriptorType;
+        if( wrap_in_jsonp ) {
+            reply.content.push_back(routeParameters.jsonpParameter);
+            reply.content.push_back("(");
+        }
         descriptorConfig.zoom_level = routeParameters.zoomLevel;
         descriptorConfig.instructions = routeParameters.printInstructions;
         descriptorConfig.geometry = routeParameters.geometry;
         descriptorConfig.encode_geometry = routeParameters.compression;
+        descriptorConfig.generalize = routeParameters.generalize;
+        descriptorConfig.geometry_precision = routeParameters.geometryPrecision;
 
         switch(descriptorType){
         case 0:
-            desc = new JSONDescriptor<DataFacadeT>();
+            desc = &thread_local_descriptors->json_descriptor;
 
             break;
         case 1:
-            desc = new GPXDescriptor<DataFacadeT>();
+            desc = &thread_local_descriptors->gpx_descriptor;
+
+            break;
+        case 2:
+            desc = &thread_local_descriptors->binary_descriptor;
 
             break;
         default:
-            desc = new JSONDescriptor<DataFacadeT>();
+            desc = &thread_local_descriptors->json_descriptor;
 
             break;
         }
@@ -176,7 +191,7 @@ public:
         desc->SetConfig(descriptorConfig);
 
         desc->Run(reply, rawRoute, phantomNodes, facade);
-        if("" != routeParameters.jsonpParameter) {
+        if( wrap_in_jsonp ) {
             reply.content.push_back(")\n");
         }
         reply.headers.resize(3);
@@ -209,6 +224,13 @@ public:
             reply.headers[2].name = "Content-Disposition";
             reply.headers[2].value = "attachment; filename=\"route.gpx\"";
 
+            break;
+        case 2:
+            reply.headers[1].name = "Content-Type";
+            reply.headers[1].value = "application/octet-stream";
+            reply.headers[2].name = "Content-Disposition";
+            reply.headers[2].value = "attachment; filename=\"route.bin\"";
+
             break;
         default:
             if( !routeParameters.jsonpParameter.empty() ){
@@ -225,13 +247,17 @@ public:
             break;
         }
 
-        delete desc;
         return;
     }
 private:
     std::string descriptor_string;
     DataFacadeT * facade;
+    PhantomNodeLookup<DataFacadeT> phantom_node_lookup;
 };
 
+template<class DataFacadeT>
+boost::thread_specific_ptr<typename ViaRoutePlugin<DataFacadeT>::ThreadLocalDescriptors>
+ViaRoutePlugin<DataFacadeT>::thread_local_descriptors;
+
 
 #endif /* VIAROUTEPLUGIN_H_ */
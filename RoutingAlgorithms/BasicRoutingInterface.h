@@ -38,6 +38,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <climits>
 
+#include <algorithm>
 #include <stack>
 
 SearchEngineData::SearchEngineHeapPtr SearchEngineData::forwardHeap;
@@ -203,13 +204,115 @@ public:
                         ed.id,
                         facade->GetNameIndexFromEdgeID(ed.id),
                         facade->GetTurnInstructionForEdgeID(ed.id),
-                        ed.distance
+                        ed.distance,
+                        facade->GetMinZoomLevelForEdgeID(ed.id)
                     )
                 );
             }
         }
     }
 
+    //length in meters between the phantom nodes along a packed path. The
+    //lengths of its edges are summed up instead of unpacking them, see
+    //SearchGraphLengths. Edges are chosen like UnpackPath does. Their counts
+    //of entered restricted areas are summed up alike.
+    //the packed path holds the legs between the via points one after the
+    //other, leg_begin_list the index of the first node of each leg. The legs
+    //are measured one by one, consecutive legs need not be connected by an
+    //edge, e.g. if the route turns around at a via point.
+    inline double ComputeLengthOfPackedPath(
+        const std::vector<NodeID> & packed_path,
+        const std::vector<unsigned> & leg_begin_list,
+        const std::vector<PhantomNodes> & phantom_nodes_vector,
+        unsigned & entered_restricted_area_count
+    ) const {
+        BOOST_ASSERT( leg_begin_list.size() == phantom_nodes_vector.size() );
+        entered_restricted_area_count = 0;
+        double length = 0.;
+        for(unsigned leg = 0; leg < leg_begin_list.size(); ++leg) {
+            const unsigned leg_begin = leg_begin_list[leg];
+            const unsigned leg_end = (
+                leg+1 < leg_begin_list.size() ?
+                leg_begin_list[leg+1] : packed_path.size()
+            );
+            if( leg_begin == leg_end ) {
+                continue;
+            }
+            const PhantomNode & start_phantom =
+                phantom_nodes_vector[leg].startPhantom;
+            const PhantomNode & target_phantom =
+                phantom_nodes_vector[leg].targetPhantom;
+            //edge lengths are taken between the middles of first and last node
+            const NodeID first_node = packed_path[leg_begin];
+            const NodeID last_node = packed_path[leg_end-1];
+            const double start_ratio = (
+                first_node == start_phantom.edgeBasedNode ?
+                start_phantom.ratio : 1. - start_phantom.ratio
+            );
+            const double target_ratio = (
+                last_node == target_phantom.edgeBasedNode ?
+                target_phantom.ratio : 1. - target_phantom.ratio
+            );
+            length +=
+                facade->GetLengthOfNode(first_node)*(.5 - start_ratio) +
+                facade->GetLengthOfNode(last_node)*(target_ratio - .5);
+
+            for(unsigned i = leg_begin+1; i < leg_end; ++i) {
+                const EdgeID edge_id = FindPackedEdge(
+                    packed_path[i-1],
+                    packed_path[i]
+                );
+                if( SPECIAL_EDGEID != edge_id ) {
+                    length += facade->GetLengthOfEdge(edge_id);
+                    entered_restricted_area_count +=
+                        facade->GetRestrictionCountOfEdge(edge_id);
+                }
+            }
+        }
+        //lengths are stored in centimeters
+        return std::max(0., length/100.);
+    }
+
+    //shortest edge from -> to of the packed path, stored at either node
+    inline EdgeID FindPackedEdge(const NodeID from, const NodeID to) const {
+        EdgeID smaller_edge_id = SPECIAL_EDGEID;
+        int edge_weight = INT_MAX;
+        for(
+            EdgeID edge_id = facade->BeginEdges(from);
+            edge_id < facade->EndEdges(from);
+            ++edge_id
+        ){
+            const int weight = facade->GetEdgeData(edge_id).distance;
+            if(
+                (facade->GetTarget(edge_id) == to) &&
+                (weight < edge_weight)              &&
+                facade->GetEdgeData(edge_id).forward
+            ){
+                smaller_edge_id = edge_id;
+                edge_weight = weight;
+            }
+        }
+        if( SPECIAL_EDGEID == smaller_edge_id ){
+            for(
+                EdgeID edge_id = facade->BeginEdges(to);
+                edge_id < facade->EndEdges(to);
+                ++edge_id
+            ){
+                const int weight = facade->GetEdgeData(edge_id).distance;
+                if(
+                    (facade->GetTarget(edge_id) == from) &&
+                    (weight < edge_weight)              &&
+                    facade->GetEdgeData(edge_id).backward
+                ){
+                    smaller_edge_id = edge_id;
+                    edge_weight = weight;
+                }
+            }
+        }
+        BOOST_ASSERT_MSG(edge_weight != INT_MAX, "edge id invalid");
+        return smaller_edge_id;
+    }
+
     inline void UnpackEdge(
         const NodeID s,
         const NodeID t,
@@ -50,9 +50,12 @@ public:
 
     ~ShortestPathRouting() {}
 
+    //unpack_path == false skips unpacking, the route has no path but its
+    //geometric length
     void operator()(
         std::vector<PhantomNodes> & phantom_nodes_vector,
-        RawRouteData & raw_route_data
+        RawRouteData & raw_route_data,
+        const bool unpack_path = true
     ) const {
         BOOST_FOREACH(
             const PhantomNodes & phantom_node_pair,
@@ -73,6 +76,9 @@ public:
         NodeID middle2 = UINT_MAX;
         std::vector<NodeID> packed_path1;
         std::vector<NodeID> packed_path2;
+        //index of the first node of each leg in the packed paths
+        std::vector<unsigned> leg_begin_list1;
+        std::vector<unsigned> leg_begin_list2;
 
         engine_working_data.InitializeOrClearFirstThreadLocalStorage(
             super::facade->GetNumberOfNodes()
@@ -290,6 +296,7 @@ public:
                             packed_path1.begin(),
                             packed_path1.end()
                         );
+                        leg_begin_list2 = leg_begin_list1;
                     } else {
                         packed_path1.clear();
                         packed_path1.insert(
@@ -297,15 +304,19 @@ public:
                             packed_path2.begin(),
                             packed_path2.end()
                         );
+                        leg_begin_list1 = leg_begin_list2;
                     }
                 } else  {
                     //packed paths 1 and 2 may need to switch.
                     if( packed_path1.back() != temporary_packed_path1.front()) {
                         packed_path1.swap(packed_path2);
+                        leg_begin_list1.swap(leg_begin_list2);
                         std::swap(distance1, distance2);
                     }
                 }
             }
+            leg_begin_list1.push_back(packed_path1.size());
+            leg_begin_list2.push_back(packed_path2.size());
             packed_path1.insert(
                 packed_path1.end(),
                 temporary_packed_path1.begin(),
@@ -332,9 +343,20 @@ public:
 
         if( distance1 > distance2 ) {
             std::swap( packed_path1, packed_path2 );
+            std::swap( leg_begin_list1, leg_begin_list2 );
+        }
+        if( unpack_path ) {
+            remove_consecutive_duplicates_from_vector(packed_path1);
+            super::UnpackPath(packed_path1, raw_route_data.computedShortestPath);
+        } else {
+            raw_route_data.geometricLengthOfShortestPath =
+                super::ComputeLengthOfPackedPath(
+                    packed_path1,
+                    leg_begin_list1,
+                    phantom_nodes_vector,
+                    raw_route_data.enteredRestrictedAreasOfShortestPath
+                );
         }
-        remove_consecutive_duplicates_from_vector(packed_path1);
-        super::UnpackPath(packed_path1, raw_route_data.computedShortestPath);
         raw_route_data.lengthOfShortestPath = std::min(distance1, distance2);
     }
 };
@@ -28,6 +28,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef CONNECTION_H
 #define CONNECTION_H
 
+#include "Http/Compression.h"
 #include "Http/CompressionType.h"
 #include "RequestHandler.h"
 #include "RequestParser.h"
@@ -37,8 +38,6 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/assert.hpp>
 #include <boost/bind.hpp>
 #include <boost/enable_shared_from_this.hpp>
-#include <boost/iostreams/filtering_stream.hpp>
-#include <boost/iostreams/filter/gzip.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
 
@@ -96,8 +95,30 @@ private:
 				request_handler.handle_request(request, reply);
 
 				Header compression_header;
-				std::vector<char> compressed_output;
 				std::vector<boost::asio::const_buffer> output_buffer;
+				if( Reply::notModified == reply.status ) {
+					//has no body to compress
+					compression_type = noCompression;
+				}
+				if( noCompression != reply.content_encoding ) {
+					//compressed by the response cache, headers are complete
+					output_buffer = reply.HeaderstoBuffers();
+					output_buffer.push_back(
+						boost::asio::buffer(reply.compressed_content)
+					);
+					boost::asio::async_write(
+						TCP_socket,
+						output_buffer,
+						strand.wrap(
+							boost::bind(
+								&Connection::handle_write,
+								this->shared_from_this(),
+								boost::asio::placeholders::error
+							)
+						)
+					);
+					return;
+				}
 				switch(compression_type) {
 				case deflateRFC1951:
 					compression_header.name = "Content-Encoding";
@@ -106,7 +127,7 @@ private:
 						reply.headers.begin(),
 						compression_header
 					);
-					compressBufferCollection(
+					CompressBufferCollection(
 						reply.content,
 						compression_type,
 						compressed_output
@@ -135,7 +156,7 @@ private:
 						reply.headers.begin(),
 						compression_header
 					);
-					compressBufferCollection(
+					CompressBufferCollection(
 						reply.content,
 						compression_type,
 						compressed_output
@@ -212,35 +233,6 @@ private:
 		}
 	}
 
-	void compressBufferCollection(
-		std::vector<std::string> uncompressed_data,
-		CompressionType compression_type,
-	   	std::vector<char> & compressed_data
-   	) {
-   		boost::iostreams::gzip_params compression_parameters;
-
-   		compression_parameters.level = boost::iostreams::zlib::best_speed;
-   		if ( deflateRFC1951 == compression_type ) {
-   			compression_parameters.noheader = true;
-   		}
-
-		BOOST_ASSERT( compressed_data.empty() );
-		boost::iostreams::filtering_ostream compressing_stream;
-
-		compressing_stream.push(
-			boost::iostreams::gzip_compressor(compression_parameters)
-		);
-		compressing_stream.push(
-			boost::iostreams::back_inserter(compressed_data)
-		);
-
-		BOOST_FOREACH( const std::string & line, uncompressed_data) {
-			compressing_stream << line;
-		}
-
-		compressing_stream.reset();
-	}
-
 	// Big thanks to deusty who explains how to use gzip compression by
 	// the right call to deflateInit2():
 	// http://deusty.blogspot.com/2007/07/gzip-compressiondecompression.html
@@ -314,6 +306,8 @@ private:
 	Request request;
 	RequestParser request_parser;
 	Reply reply;
+	//outlives handle_read, the asynchronous write refers to it
+	std::vector<char> compressed_output;
 };
 
 } // namespace http
@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../../DataStructures/Coordinate.h"
 #include "../../DataStructures/EdgeBasedNode.h"
 #include "../../DataStructures/ImportNode.h"
+#include "../../DataStructures/NameStore.h"
 #include "../../DataStructures/PhantomNodes.h"
 #include "../../DataStructures/TurnInstructions.h"
 #include "../../Util/OSRMException.h"
@@ -40,6 +41,47 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../../typedefs.h"
 
 #include <string>
+#include <vector>
+
+//memory of one of the data structures of a facade, see DataWarmup
+struct DataRegion {
+    enum Structure {
+        RTREE_NODES = 0,
+        POINT_INDEX,
+        GRAPH_NODES,
+        GRAPH_EDGES,
+        COORDINATES,
+        ORIGINAL_EDGES,
+        NAMES,
+        NUMBER_OF_STRUCTURES
+    };
+
+    DataRegion(
+        const Structure structure,
+        const void * begin,
+        const uint64_t size
+    ) :
+        structure(structure),
+        begin((const char *)begin),
+        size(size)
+    { }
+
+    template<class VectorT>
+    static DataRegion FromVector(
+        const Structure structure,
+        const VectorT & vector
+    ) {
+        return DataRegion(
+            structure,
+            ( 0 == vector.size() ? NULL : &vector[0] ),
+            vector.size()*sizeof(vector[0])
+        );
+    }
+
+    Structure structure;
+    const char * begin;
+    uint64_t size;
+};
 
 template<class EdgeDataT>
 class BaseDataFacade {
@@ -58,9 +100,8 @@ public:
 
     virtual NodeID GetTarget( const EdgeID e ) const = 0;
 
-    virtual EdgeDataT &GetEdgeData( const EdgeID e ) = 0;
-
-    // virtual const EdgeDataT &GetEdgeData( const EdgeID e ) const = 0;
+    //read-only, the mapped and shared memory facades cannot be written to
+    virtual const EdgeDataT &GetEdgeData( const EdgeID e ) const = 0;
 
     virtual EdgeID BeginEdges( const NodeID n ) const = 0;
 
@@ -80,6 +121,14 @@ public:
         bool & result
     ) const = 0;
 
+    //geometric length in centimeters, see SearchGraphLengths
+    virtual unsigned GetLengthOfNode( const NodeID n ) const = 0;
+
+    virtual unsigned GetLengthOfEdge( const EdgeID e ) const = 0;
+
+    //number of restricted areas entered along an edge, see SearchGraphLengths
+    virtual unsigned GetRestrictionCountOfEdge( const EdgeID e ) const = 0;
+
     //node and edge information access
     virtual FixedPointCoordinate GetCoordinateOfNode(
         const unsigned id
@@ -89,6 +138,11 @@ public:
         const unsigned id
     ) const  = 0;
 
+    //smallest zoom level at which the generalized geometry keeps the via node
+    virtual unsigned char GetMinZoomLevelForEdgeID(
+        const unsigned id
+    ) const = 0;
+
     virtual bool LocateClosestEndPointForCoordinate(
         const FixedPointCoordinate& input_coordinate,
         FixedPointCoordinate& result,
@@ -101,22 +155,29 @@ public:
         const unsigned zoom_level
     ) const  = 0;
 
+    //answers all queries of a batch, results are in input order
+    virtual void FindPhantomNodesForCoordinates(
+        const std::vector<FixedPointCoordinate> & input_coordinates,
+        std::vector<PhantomNode> & resulting_phantom_nodes,
+        const unsigned zoom_level
+    ) const = 0;
+
     virtual unsigned GetCheckSum() const = 0;
 
     virtual unsigned GetNameIndexFromEdgeID(const unsigned id) const  = 0;
 
-    virtual void GetName(
-        const unsigned name_id,
-        std::string & result
-    ) const = 0;
+    //HTML escaped name, points into the facade's name store
+    virtual NameView GetEscapedName(const unsigned name_id) const = 0;
 
     std::string GetEscapedNameForNameID(const unsigned name_id) const {
-        std::string temporary_string;
-        GetName(name_id, temporary_string);
-        return HTMLEntitize(temporary_string);
+        const NameView name = GetEscapedName(name_id);
+        return std::string(name.begin(), name.end());
     }
 
     virtual std::string GetTimestamp() const = 0;
+
+    //memory of all data structures that are held in memory
+    virtual void GetDataRegions(std::vector<DataRegion> & regions) const = 0;
 };
 
 #endif // QUERY_DATA_FACADE_H
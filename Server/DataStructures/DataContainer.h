@@ -0,0 +1,652 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef DATA_CONTAINER_H
+#define DATA_CONTAINER_H
+
+//A container holds all data of a prepared dataset in a single file. A header
+//with a table of contents is followed by 4K aligned sections. Each section is
+//a flat array in exactly the layout the facades keep in memory, so it can be
+//mapped or read in one go without touching single elements. Sections are
+//stored in the order of SharedDataLayout and can be read front to back in
+//one sequential pass or section by section in parallel.
+
+#include "SharedDataType.h"
+
+#include "../../DataStructures/Coordinate.h"
+#include "../../DataStructures/NameStore.h"
+#include "../../DataStructures/OriginalEdgeFile.h"
+#include "../../DataStructures/QueryEdge.h"
+#include "../../DataStructures/QueryNode.h"
+#include "../../DataStructures/SearchGraphTrailer.h"
+#include "../../Util/OSRMException.h"
+#include "../../Util/ParallelLoader.h"
+#include "../../Util/ProgramOptions.h"
+#include "../../Util/SimpleLogger.h"
+#include "../../Util/UUID.h"
+#include "../../typedefs.h"
+
+#include <boost/bind.hpp>
+#include <boost/crc.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/static_assert.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//CRC-32C, the polynomial of the SSE4.2 crc32 instruction
+typedef boost::crc_optimal<32, 0x1EDC6F41, 0xFFFFFFFF, 0xFFFFFFFF, true, true>
+    DataContainerCRC;
+
+struct DataContainerSection {
+    uint64_t offset;
+    uint64_t size;
+    uint64_t number_of_elements;
+    uint32_t element_size;
+    uint32_t crc;
+};
+
+struct DataContainerHeader {
+    enum SectionID {
+        //escaped street names, see NameStore
+        NAME_BLOCKS = 0,
+        NAME_CHARS,
+        //via node, name id and turn instruction, see PackedOriginalEdgeData
+        ORIGINAL_EDGES,
+        GRAPH_NODES,
+        GRAPH_EDGES,
+        TIMESTAMP,
+        COORDINATES,
+        RTREE_NODES,
+        POINT_INDEX,
+        //geometric lengths and restriction counts of the graph, see
+        //SearchGraphLengths
+        GRAPH_NODE_LENGTHS,
+        GRAPH_EDGE_LENGTHS,
+        GRAPH_EDGE_RESTRICTION_COUNTS,
+        //min. zoom levels of the via nodes of the original edges
+        GEOMETRY_ZOOM_LEVELS,
+        //verbatim .fileIndex payload, read through file streams at query time
+        RTREE_LEAVES,
+        NUMBER_OF_SECTIONS
+    };
+
+    static const uint32_t VERSION = 7;
+    static const uint64_t ALIGNMENT = 4096;
+
+    char                 magic[8];
+    uint32_t             version;
+    uint32_t             number_of_sections;
+    uint32_t             checksum;
+    uint32_t             reserved;
+    DataContainerSection sections[NUMBER_OF_SECTIONS];
+    char                 uuid[sizeof(UUID)];
+
+    DataContainerHeader() :
+        version(VERSION),
+        number_of_sections(NUMBER_OF_SECTIONS),
+        checksum(0),
+        reserved(0)
+    {
+        std::memcpy(magic, "OSRMDATA", sizeof(magic));
+        std::memset(sections, 0, sizeof(sections));
+        std::memset(uuid, 0, sizeof(uuid));
+    }
+
+    static const char * GetSectionName(const SectionID section_id) {
+        static const char * section_names[NUMBER_OF_SECTIONS] = {
+            "name blocks",
+            "name chars",
+            "original edges",
+            "graph nodes",
+            "graph edges",
+            "timestamp",
+            "coordinates",
+            "r-tree nodes",
+            "point index",
+            "graph node lengths",
+            "graph edge lengths",
+            "graph edge restriction counts",
+            "geometry zoom levels",
+            "r-tree leaves"
+        };
+        return section_names[section_id];
+    }
+
+    //throws if the header does not describe a container of this build
+    void Check(const std::string & file_name) const {
+        if( 0 != std::memcmp(magic, "OSRMDATA", sizeof(magic)) ) {
+            throw OSRMException(file_name + " is not a data container");
+        }
+        if( VERSION != version || NUMBER_OF_SECTIONS != number_of_sections ) {
+            throw OSRMException(
+                file_name + " has an unsupported container version"
+            );
+        }
+        UUID uuid_orig;
+        if( !reinterpret_cast<const UUID *>(uuid)->TestGraphUtil(uuid_orig) ) {
+            SimpleLogger().Write(logWARNING) <<
+                file_name << " was prepared with different build. "
+                "Reprocess to get rid of this warning.";
+        }
+    }
+
+    //number of elements in a section, verifies the element layout
+    template<typename T>
+    uint64_t GetNumberOfElements(
+        const SectionID section_id,
+        const std::string & file_name
+    ) const {
+        const DataContainerSection & section = sections[section_id];
+        if( sizeof(T) != section.element_size ) {
+            throw OSRMException(
+                file_name + " has sections of an incompatible element layout"
+            );
+        }
+        return section.number_of_elements;
+    }
+};
+
+BOOST_STATIC_ASSERT(sizeof(DataContainerHeader) <= DataContainerHeader::ALIGNMENT);
+
+//Reads sections into caller provided memory with large sequential reads.
+//Every read opens its own stream, sections can be read concurrently.
+class DataContainerReader : boost::noncopyable {
+public:
+    explicit DataContainerReader(const boost::filesystem::path & container_path) :
+        m_container_path(container_path),
+        m_file_name(container_path.string())
+    {
+        boost::filesystem::ifstream input_stream(container_path, std::ios::binary);
+        if( !input_stream ) {
+            throw OSRMException(m_file_name + " could not be opened");
+        }
+        input_stream.read((char*)&m_header, sizeof(DataContainerHeader));
+        if( !input_stream ) {
+            throw OSRMException(m_file_name + " is truncated");
+        }
+        m_header.Check(m_file_name);
+    }
+
+    const DataContainerHeader & GetHeader() const {
+        return m_header;
+    }
+
+    const DataContainerSection & GetSection(
+        const DataContainerHeader::SectionID section_id
+    ) const {
+        return m_header.sections[section_id];
+    }
+
+    template<typename T>
+    uint64_t GetNumberOfElements(
+        const DataContainerHeader::SectionID section_id
+    ) const {
+        return m_header.GetNumberOfElements<T>(section_id, m_file_name);
+    }
+
+    //reads a whole section and verifies its checksum on the fly
+    void ReadSection(
+        const DataContainerHeader::SectionID section_id,
+        char * output
+    ) const {
+        const DataContainerSection & section = GetSection(section_id);
+        boost::filesystem::ifstream input_stream(m_container_path, std::ios::binary);
+        input_stream.seekg(section.offset);
+        DataContainerCRC crc;
+        uint64_t bytes_read = 0;
+        while( bytes_read < section.size ) {
+            const uint64_t chunk_size = std::min(
+                section.size - bytes_read,
+                (uint64_t)CHUNK_SIZE
+            );
+            input_stream.read(output + bytes_read, chunk_size);
+            if( !input_stream ) {
+                throw OSRMException(m_file_name + " is truncated");
+            }
+            crc.process_bytes(output + bytes_read, chunk_size);
+            bytes_read += chunk_size;
+        }
+        if( section.crc != crc.checksum() ) {
+            throw OSRMException(m_file_name + " has a corrupt section");
+        }
+    }
+
+    //reads a section into a vector of its element type
+    template<typename T>
+    void ReadSection(
+        const DataContainerHeader::SectionID section_id,
+        std::vector<T> & output
+    ) const {
+        output.resize(GetNumberOfElements<T>(section_id));
+        if( output.empty() ) {
+            return;
+        }
+        ReadSection(section_id, (char*)&output[0]);
+    }
+
+    //queues reading a section into output, output must be large enough
+    void AddSectionTask(
+        ParallelLoader & loader,
+        const DataContainerHeader::SectionID section_id,
+        char * output
+    ) const {
+        void (DataContainerReader::*read_section)(
+            const DataContainerHeader::SectionID,
+            char *
+        ) const = &DataContainerReader::ReadSection;
+        loader.AddTask(
+            DataContainerHeader::GetSectionName(section_id),
+            GetSection(section_id).size,
+            boost::bind(read_section, this, section_id, output)
+        );
+    }
+
+    //resizes output to the section and queues reading it
+    template<typename T>
+    void AddSectionTask(
+        ParallelLoader & loader,
+        const DataContainerHeader::SectionID section_id,
+        std::vector<T> & output
+    ) const {
+        output.resize(GetNumberOfElements<T>(section_id));
+        if( output.empty() ) {
+            return;
+        }
+        AddSectionTask(loader, section_id, (char*)&output[0]);
+    }
+
+private:
+    static const uint64_t CHUNK_SIZE = 8*1024*1024;
+
+    boost::filesystem::path       m_container_path;
+    std::string                   m_file_name;
+    DataContainerHeader           m_header;
+};
+
+//Collects the loose files written by osrm-extract and osrm-prepare into a
+//container. Records of .nodes and .edges are split into the per-field arrays
+//of the facades once, here, instead of at every start of the server.
+class DataContainerWriter : boost::noncopyable {
+public:
+    static void Write(
+        const ServerPaths & server_paths,
+        const boost::filesystem::path & container_path
+    ) {
+        DataContainerWriter writer(container_path);
+        writer.WriteNames(GetPath(server_paths, "namesdata"));
+        writer.WriteOriginalEdges(GetPath(server_paths, "edgesdata"));
+        writer.WriteGraph(GetPath(server_paths, "hsgrdata"));
+        writer.WriteTimestamp(GetPath(server_paths, "timestamp"));
+        writer.WriteCoordinates(GetPath(server_paths, "nodesdata"));
+        writer.WriteRTreeNodes(GetPath(server_paths, "ramindex"));
+        writer.WritePointIndex(GetPath(server_paths, "pointindex"));
+        writer.WriteGraphLengths();
+        writer.WriteGeometryZoomLevels();
+        writer.WriteRTreeLeaves(GetPath(server_paths, "fileindex"));
+        writer.Finish();
+        SimpleLogger().Write() <<
+            "wrote " << writer.m_current_offset << " bytes to " <<
+            container_path.string();
+    }
+
+private:
+    typedef DataContainerHeader Header;
+
+    explicit DataContainerWriter(const boost::filesystem::path & container_path) :
+        m_output_stream(container_path, std::ios::binary),
+        m_current_offset(0)
+    {
+        if( !m_output_stream ) {
+            throw OSRMException(container_path.string() + " could not be created");
+        }
+        //placeholder, the table of contents is known once all sections are in
+        WriteBytes((const char*)&m_header, sizeof(Header));
+    }
+
+    static boost::filesystem::path GetPath(
+        const ServerPaths & server_paths,
+        const std::string & key
+    ) {
+        ServerPaths::const_iterator paths_iterator = server_paths.find(key);
+        if( server_paths.end() == paths_iterator ) {
+            return boost::filesystem::path();
+        }
+        return paths_iterator->second;
+    }
+
+    static void OpenInput(
+        const boost::filesystem::path & file_path,
+        boost::filesystem::ifstream & input_stream
+    ) {
+        if( !boost::filesystem::is_regular_file(file_path) ) {
+            throw OSRMException(file_path.string() + " not found");
+        }
+        input_stream.open(file_path, std::ios::binary);
+    }
+
+    void WriteBytes(const char * data, const uint64_t size) {
+        m_output_stream.write(data, size);
+        m_current_offset += size;
+    }
+
+    void BeginSection(const Header::SectionID section_id, const uint32_t element_size) {
+        const uint64_t padding = (
+            Header::ALIGNMENT - m_current_offset % Header::ALIGNMENT
+        ) % Header::ALIGNMENT;
+        const std::vector<char> zeros(padding, 0);
+        if( 0 != padding ) {
+            WriteBytes(&zeros[0], padding);
+        }
+        DataContainerSection & section = m_header.sections[section_id];
+        section.offset = m_current_offset;
+        section.element_size = element_size;
+        m_crc.reset();
+    }
+
+    void AppendToSection(const char * data, const uint64_t size) {
+        m_crc.process_bytes(data, size);
+        WriteBytes(data, size);
+    }
+
+    void EndSection(const Header::SectionID section_id) {
+        DataContainerSection & section = m_header.sections[section_id];
+        section.size = m_current_offset - section.offset;
+        section.number_of_elements = section.size/section.element_size;
+        section.crc = m_crc.checksum();
+    }
+
+    //copies size bytes of a stream into the current section
+    void CopyToSection(std::istream & input_stream, uint64_t size) {
+        std::vector<char> buffer(std::min(size, (uint64_t)CHUNK_SIZE));
+        while( 0 < size ) {
+            const uint64_t chunk_size = std::min(size, (uint64_t)buffer.size());
+            input_stream.read(&buffer[0], chunk_size);
+            if( !input_stream ) {
+                throw OSRMException("input file is truncated");
+            }
+            AppendToSection(&buffer[0], chunk_size);
+            size -= chunk_size;
+        }
+    }
+
+    template<typename T>
+    void WriteArraySection(
+        const Header::SectionID section_id,
+        std::istream & input_stream,
+        const uint64_t number_of_elements
+    ) {
+        BeginSection(section_id, sizeof(T));
+        CopyToSection(input_stream, number_of_elements*sizeof(T));
+        EndSection(section_id);
+    }
+
+    template<typename T>
+    void WriteArraySection(
+        const Header::SectionID section_id,
+        const std::vector<T> & elements
+    ) {
+        BeginSection(section_id, sizeof(T));
+        if( !elements.empty() ) {
+            AppendToSection((const char*)&elements[0], elements.size()*sizeof(T));
+        }
+        EndSection(section_id);
+    }
+
+    //names are stored escaped and block packed, as the facades use them
+    void WriteNames(const boost::filesystem::path & names_path) {
+        if( !boost::filesystem::is_regular_file(names_path) ) {
+            throw OSRMException(names_path.string() + " not found");
+        }
+        std::vector<NameBlock> name_block_list;
+        std::vector<char> names_char_list;
+        NameStore<false>::LoadRawNames(names_path, name_block_list, names_char_list);
+        WriteArraySection(Header::NAME_BLOCKS, name_block_list);
+        WriteArraySection(Header::NAME_CHARS, names_char_list);
+    }
+
+    // .edges: header followed by OriginalEdgeData records, zoom levels of
+    //files without them are cleared
+    static void ReadOriginalEdges(
+        const boost::filesystem::path & edges_path,
+        std::vector<OriginalEdgeData> & original_edge_list
+    ) {
+        boost::filesystem::ifstream edges_input_stream;
+        OpenInput(edges_path, edges_input_stream);
+        const OriginalEdgeFileLayout edges_file_layout =
+            OriginalEdgeFileLayout::Read(edges_input_stream, edges_path.string());
+        const unsigned number_of_edges = edges_file_layout.number_of_edges;
+
+        original_edge_list.resize(number_of_edges);
+        if( 0 != number_of_edges ) {
+            edges_input_stream.read(
+                (char*)&original_edge_list[0],
+                number_of_edges*sizeof(OriginalEdgeData)
+            );
+        }
+        if( !edges_file_layout.has_zoom_levels ) {
+            for(unsigned i = 0; i < number_of_edges; ++i) {
+                original_edge_list[i].minZoomLevel = 0;
+            }
+        }
+    }
+
+    //the zoom levels are kept for WriteGeometryZoomLevels, so that .edges is
+    //read only once
+    void WriteOriginalEdges(const boost::filesystem::path & edges_path) {
+        std::vector<OriginalEdgeData> original_edge_list;
+        ReadOriginalEdges(edges_path, original_edge_list);
+        std::vector<PackedOriginalEdgeData> packed_edge_list(original_edge_list.size());
+        m_geometry_zoom_list.resize(original_edge_list.size());
+        for(unsigned i = 0; i < original_edge_list.size(); ++i) {
+            packed_edge_list[i] = PackedOriginalEdgeData(original_edge_list[i]);
+            m_geometry_zoom_list[i] = original_edge_list[i].minZoomLevel;
+        }
+        WriteArraySection(Header::ORIGINAL_EDGES, packed_edge_list);
+    }
+
+    void WriteGeometryZoomLevels() {
+        WriteArraySection(Header::GEOMETRY_ZOOM_LEVELS, m_geometry_zoom_list);
+        std::vector<unsigned char>().swap(m_geometry_zoom_list);
+    }
+
+    // .hsgr: uuid, checksum, #nodes, #edges, nodes, edges, trailer header,
+    //node lengths, edge lengths, edge restriction counts
+    void WriteGraph(const boost::filesystem::path & hsgr_path) {
+        boost::filesystem::ifstream hsgr_input_stream;
+        OpenInput(hsgr_path, hsgr_input_stream);
+        hsgr_input_stream.read(m_header.uuid, sizeof(UUID));
+        hsgr_input_stream.read((char*)&m_header.checksum, sizeof(unsigned));
+        unsigned number_of_nodes = 0;
+        unsigned number_of_edges = 0;
+        hsgr_input_stream.read((char*)&number_of_nodes, sizeof(unsigned));
+        hsgr_input_stream.read((char*)&number_of_edges, sizeof(unsigned));
+        WriteArraySection<QueryGraph::_StrNode>(
+            Header::GRAPH_NODES,
+            hsgr_input_stream,
+            number_of_nodes
+        );
+        WriteArraySection<QueryGraph::_StrEdge>(
+            Header::GRAPH_EDGES,
+            hsgr_input_stream,
+            number_of_edges
+        );
+        m_node_length_list.resize(number_of_nodes, 0);
+        m_edge_length_list.resize(number_of_edges, 0);
+        m_edge_restriction_count_list.resize(number_of_edges, 0);
+        if(
+            !SearchGraphTrailerHeader::Read(
+                hsgr_input_stream,
+                number_of_edges,
+                hsgr_path.string()
+            )
+        ) {
+            return;
+        }
+        if( 0 != number_of_nodes ) {
+            hsgr_input_stream.read(
+                (char*)&m_node_length_list[0],
+                number_of_nodes*sizeof(unsigned)
+            );
+        }
+        if( 0 != number_of_edges ) {
+            hsgr_input_stream.read(
+                (char*)&m_edge_length_list[0],
+                number_of_edges*sizeof(unsigned)
+            );
+            hsgr_input_stream.read(
+                (char*)&m_edge_restriction_count_list[0],
+                number_of_edges
+            );
+        }
+        if( !hsgr_input_stream ) {
+            throw OSRMException(hsgr_path.string() + " is truncated");
+        }
+    }
+
+    //the lengths are kept by WriteGraph, their sections come later
+    void WriteGraphLengths() {
+        WriteArraySection(Header::GRAPH_NODE_LENGTHS, m_node_length_list);
+        WriteArraySection(Header::GRAPH_EDGE_LENGTHS, m_edge_length_list);
+        WriteArraySection(
+            Header::GRAPH_EDGE_RESTRICTION_COUNTS,
+            m_edge_restriction_count_list
+        );
+        std::vector<unsigned>().swap(m_node_length_list);
+        std::vector<unsigned>().swap(m_edge_length_list);
+        std::vector<unsigned char>().swap(m_edge_restriction_count_list);
+    }
+
+    void WriteTimestamp(const boost::filesystem::path & timestamp_path) {
+        std::string timestamp;
+        if( boost::filesystem::exists(timestamp_path) ) {
+            boost::filesystem::ifstream timestamp_stream( timestamp_path );
+            getline(timestamp_stream, timestamp);
+        }
+        if(timestamp.empty()) {
+            timestamp = "n/a";
+        }
+        if(25 < timestamp.length()) {
+            timestamp.resize(25);
+        }
+        WriteArraySection(
+            Header::TIMESTAMP,
+            std::vector<char>(timestamp.begin(), timestamp.end())
+        );
+    }
+
+    // .nodes: count followed by NodeInfo records
+    void WriteCoordinates(const boost::filesystem::path & nodes_path) {
+        boost::filesystem::ifstream nodes_input_stream;
+        OpenInput(nodes_path, nodes_input_stream);
+        unsigned number_of_coordinates = 0;
+        nodes_input_stream.read((char *)&number_of_coordinates, sizeof(unsigned));
+        std::vector<NodeInfo> node_info_list(number_of_coordinates);
+        if( 0 != number_of_coordinates ) {
+            nodes_input_stream.read(
+                (char *)&node_info_list[0],
+                number_of_coordinates*sizeof(NodeInfo)
+            );
+        }
+        std::vector<FixedPointCoordinate> coordinate_list(number_of_coordinates);
+        for(unsigned i = 0; i < number_of_coordinates; ++i) {
+            coordinate_list[i] = FixedPointCoordinate(
+                node_info_list[i].lat,
+                node_info_list[i].lon
+            );
+        }
+        WriteArraySection(Header::COORDINATES, coordinate_list);
+    }
+
+    // .ramIndex: node count followed by the tree nodes
+    void WriteRTreeNodes(const boost::filesystem::path & ram_index_path) {
+        boost::filesystem::ifstream tree_node_file;
+        OpenInput(ram_index_path, tree_node_file);
+        uint32_t tree_size = 0;
+        tree_node_file.read((char*)&tree_size, sizeof(uint32_t));
+        WriteArraySection<RTreeNode>(Header::RTREE_NODES, tree_node_file, tree_size);
+    }
+
+    // .pointIndex: point count followed by the k-d tree, optional
+    void WritePointIndex(const boost::filesystem::path & point_index_path) {
+        std::vector<PointIndexNode> point_list;
+        if( boost::filesystem::is_regular_file(point_index_path) ) {
+            boost::filesystem::ifstream point_index_stream;
+            OpenInput(point_index_path, point_index_stream);
+            unsigned point_index_size = 0;
+            point_index_stream.read((char*)&point_index_size, sizeof(unsigned));
+            point_list.resize(point_index_size);
+            if( 0 != point_index_size ) {
+                point_index_stream.read(
+                    (char*)&point_list[0],
+                    point_index_size*sizeof(PointIndexNode)
+                );
+            }
+        } else {
+            SimpleLogger().Write(logWARNING) <<
+                "no point index found, container holds none";
+        }
+        WriteArraySection(Header::POINT_INDEX, point_list);
+    }
+
+    // .fileIndex: element count followed by the leaves, copied verbatim
+    void WriteRTreeLeaves(const boost::filesystem::path & file_index_path) {
+        boost::filesystem::ifstream leaf_node_file;
+        OpenInput(file_index_path, leaf_node_file);
+        WriteArraySection<char>(
+            Header::RTREE_LEAVES,
+            leaf_node_file,
+            boost::filesystem::file_size(file_index_path)
+        );
+    }
+
+    void Finish() {
+        m_output_stream.seekp(0);
+        m_output_stream.write((const char*)&m_header, sizeof(Header));
+        m_output_stream.close();
+        if( !m_output_stream ) {
+            throw OSRMException("could not write data container");
+        }
+    }
+
+    static const uint64_t CHUNK_SIZE = 8*1024*1024;
+
+    boost::filesystem::ofstream  m_output_stream;
+    uint64_t                     m_current_offset;
+    Header                       m_header;
+    DataContainerCRC             m_crc;
+    std::vector<unsigned>        m_node_length_list;
+    std::vector<unsigned>        m_edge_length_list;
+    std::vector<unsigned char>   m_edge_restriction_count_list;
+    std::vector<unsigned char>   m_geometry_zoom_list;
+};
+
+#endif //DATA_CONTAINER_H
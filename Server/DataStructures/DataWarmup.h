@@ -0,0 +1,299 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef DATA_WARMUP_H
+#define DATA_WARMUP_H
+
+//Brings the data of a facade into memory before it answers queries, so the
+//first requests do not pay for page faults. Regions are touched in the order
+//queries need them: the search index first, then the top levels of the
+//contraction hierarchy that nearly every query settles, then the rest.
+//Structures selected in the policy are locked to RAM afterwards.
+
+#include "BaseDataFacade.h"
+
+#include "../../Util/OSRMException.h"
+#include "../../Util/SimpleLogger.h"
+#include "../../Util/TimingUtil.h"
+#include "../../typedefs.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/foreach.hpp>
+#include <boost/noncopyable.hpp>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+struct DataWarmupPolicy {
+    DataWarmupPolicy() : prefault(false) {
+        std::fill(lock, lock+DataRegion::NUMBER_OF_STRUCTURES, false);
+    }
+
+    //comma separated list of rtree, pointindex, graph, coordinates, edges
+    //and names, or one of all and none
+    void SetLockedStructures(const std::string & structure_list) {
+        std::fill(lock, lock+DataRegion::NUMBER_OF_STRUCTURES, false);
+        std::vector<std::string> structure_names;
+        boost::algorithm::split(
+            structure_names,
+            structure_list,
+            boost::algorithm::is_any_of(",")
+        );
+        BOOST_FOREACH(std::string & name, structure_names) {
+            boost::algorithm::trim(name);
+            if( "all" == name ) {
+                std::fill(lock, lock+DataRegion::NUMBER_OF_STRUCTURES, true);
+            } else if( "rtree" == name ) {
+                lock[DataRegion::RTREE_NODES] = true;
+            } else if( "pointindex" == name ) {
+                lock[DataRegion::POINT_INDEX] = true;
+            } else if( "graph" == name ) {
+                lock[DataRegion::GRAPH_NODES] = true;
+                lock[DataRegion::GRAPH_EDGES] = true;
+            } else if( "coordinates" == name ) {
+                lock[DataRegion::COORDINATES] = true;
+            } else if( "edges" == name ) {
+                lock[DataRegion::ORIGINAL_EDGES] = true;
+            } else if( "names" == name ) {
+                lock[DataRegion::NAMES] = true;
+            } else if( "none" != name && !name.empty() ) {
+                throw OSRMException("unknown data structure to lock: " + name);
+            }
+        }
+    }
+
+    bool IsActive() const {
+        return prefault || lock+DataRegion::NUMBER_OF_STRUCTURES != std::find(
+            lock,
+            lock+DataRegion::NUMBER_OF_STRUCTURES,
+            true
+        );
+    }
+
+    bool prefault;
+    bool lock[DataRegion::NUMBER_OF_STRUCTURES];
+};
+
+template<class DataFacadeT>
+class DataWarmup : boost::noncopyable {
+public:
+    DataWarmup(
+        const DataWarmupPolicy & policy,
+        DataFacadeT * facade
+    ) :
+        m_policy(policy),
+        m_facade(facade),
+        m_page_size(4096)
+    {
+#ifndef _WIN32
+        const long page_size = sysconf(_SC_PAGESIZE);
+        if( 0 < page_size ) {
+            m_page_size = page_size;
+        }
+#endif
+        m_facade->GetDataRegions(m_regions);
+    }
+
+    void Run() {
+        if( m_policy.prefault ) {
+            WarmSearchIndex();
+            WarmTopLevels();
+            WarmRemainder();
+        }
+        LockRegions();
+    }
+
+private:
+    //number of nodes the upward searches start from
+    static const unsigned NUMBER_OF_SAMPLES = 1000;
+    //share of the graph nodes that are counted as top levels, in percent
+    static const unsigned TOP_LEVEL_PERCENTAGE = 5;
+
+    void WarmSearchIndex() {
+        const double time_stamp = get_timestamp();
+        uint64_t bytes = 0;
+        BOOST_FOREACH(const DataRegion & region, m_regions) {
+            if(
+                DataRegion::RTREE_NODES == region.structure ||
+                DataRegion::POINT_INDEX == region.structure
+            ) {
+                bytes += TouchPages(region.begin, region.size);
+            }
+        }
+        LogStage("search index", bytes, time_stamp);
+    }
+
+    //Node ids do not follow the levels of the hierarchy, but edges are stored
+    //with their lower node. The nodes reachable over stored edges from a
+    //sample of nodes are the top levels that most upward searches meet.
+    void WarmTopLevels() {
+        const double time_stamp = get_timestamp();
+        uint64_t bytes = 0;
+        BOOST_FOREACH(const DataRegion & region, m_regions) {
+            if( DataRegion::GRAPH_NODES == region.structure ) {
+                bytes += TouchPages(region.begin, region.size);
+            }
+        }
+
+        const unsigned number_of_nodes = m_facade->GetNumberOfNodes();
+        if( 0 == number_of_nodes ) {
+            LogStage("hierarchy top levels", bytes, time_stamp);
+            return;
+        }
+        const unsigned max_visited_nodes = std::max(
+            1u,
+            (unsigned)(uint64_t(number_of_nodes)*TOP_LEVEL_PERCENTAGE/100)
+        );
+        const unsigned sample_stride = std::max(
+            1u,
+            number_of_nodes/NUMBER_OF_SAMPLES
+        );
+        std::vector<bool> visited(number_of_nodes, false);
+        std::vector<NodeID> queue;
+        unsigned number_of_edges = 0;
+        for(
+            NodeID sample = 0;
+            sample < number_of_nodes && queue.size() < max_visited_nodes;
+            sample += sample_stride
+        ) {
+            if( visited[sample] ) {
+                continue;
+            }
+            visited[sample] = true;
+            queue.push_back(sample);
+            for(
+                unsigned i = queue.size()-1;
+                i < queue.size() && queue.size() < max_visited_nodes;
+                ++i
+            ) {
+                const NodeID node = queue[i];
+                const EdgeID end_edge = m_facade->EndEdges(node);
+                for(
+                    EdgeID edge = m_facade->BeginEdges(node);
+                    edge < end_edge;
+                    ++edge
+                ) {
+                    ++number_of_edges;
+                    const NodeID target = m_facade->GetTarget(edge);
+                    if( target < number_of_nodes && !visited[target] ) {
+                        visited[target] = true;
+                        queue.push_back(target);
+                    }
+                }
+            }
+        }
+        BOOST_FOREACH(const DataRegion & region, m_regions) {
+            if(
+                DataRegion::GRAPH_EDGES == region.structure &&
+                0 != m_facade->GetNumberOfEdges()
+            ) {
+                bytes += uint64_t(number_of_edges)*
+                    (region.size/m_facade->GetNumberOfEdges());
+            }
+        }
+        SimpleLogger().Write(logDEBUG) <<
+            "top levels: " << queue.size() << " nodes, " <<
+            number_of_edges << " edges";
+        LogStage("hierarchy top levels", bytes, time_stamp);
+    }
+
+    void WarmRemainder() {
+        const double time_stamp = get_timestamp();
+        uint64_t bytes = 0;
+        BOOST_FOREACH(const DataRegion & region, m_regions) {
+            if(
+                DataRegion::RTREE_NODES != region.structure &&
+                DataRegion::POINT_INDEX != region.structure &&
+                DataRegion::GRAPH_NODES != region.structure
+            ) {
+                bytes += TouchPages(region.begin, region.size);
+            }
+        }
+        LogStage("remaining data", bytes, time_stamp);
+    }
+
+    void LockRegions() {
+        const double time_stamp = get_timestamp();
+        uint64_t bytes = 0;
+        BOOST_FOREACH(const DataRegion & region, m_regions) {
+            if( !m_policy.lock[region.structure] || 0 == region.size ) {
+                continue;
+            }
+#ifndef _WIN32
+            const uintptr_t begin =
+                uintptr_t(region.begin) & ~uintptr_t(m_page_size-1);
+            const uintptr_t end = uintptr_t(region.begin) + region.size;
+            if( 0 != mlock((const void *)begin, end-begin) ) {
+                SimpleLogger().Write(logWARNING) <<
+                    "could not lock " << (end-begin) << " bytes of data to RAM";
+                continue;
+            }
+            bytes += region.size;
+#endif
+        }
+        if( 0 != bytes ) {
+            LogStage("locked data", bytes, time_stamp);
+        }
+    }
+
+    //reads one byte of every page in the range
+    uint64_t TouchPages(const char * begin, const uint64_t size) {
+        if( 0 == size ) {
+            return 0;
+        }
+        const volatile char * bytes = begin;
+        for(uint64_t offset = 0; offset < size; offset += m_page_size) {
+            bytes[offset];
+        }
+        bytes[size-1];
+        return size;
+    }
+
+    void LogStage(
+        const std::string & stage,
+        const uint64_t bytes,
+        const double time_stamp
+    ) const {
+        SimpleLogger().Write() <<
+            "warm-up " << stage << ": " << (bytes >> 20) << " MB in " <<
+            unsigned(1000*(get_timestamp() - time_stamp)) << " ms";
+    }
+
+    const DataWarmupPolicy m_policy;
+    DataFacadeT * m_facade;
+    uint64_t m_page_size;
+    std::vector<DataRegion> m_regions;
+};
+
+#endif //DATA_WARMUP_H
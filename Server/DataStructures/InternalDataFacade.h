@@ -31,19 +31,29 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //implements all data storage when shared memory is _NOT_ used
 
 #include "BaseDataFacade.h"
+#include "DataContainer.h"
 
 #include "../../DataStructures/Coordinate.h"
 #include "../../DataStructures/QueryNode.h"
+#include "../../DataStructures/OriginalEdgeFile.h"
 #include "../../DataStructures/QueryEdge.h"
 #include "../../DataStructures/SharedMemoryVectorWrapper.h"
 #include "../../DataStructures/StaticGraph.h"
+#include "../../DataStructures/StaticPointIndex.h"
 #include "../../DataStructures/StaticRTree.h"
 #include "../../Util/BoostFileSystemFix.h"
 #include "../../Util/GraphLoader.h"
 #include "../../Util/IniFile.h"
+#include "../../Util/ParallelLoader.h"
 #include "../../Util/ProgramOptions.h"
 #include "../../Util/SimpleLogger.h"
 
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include <algorithm>
+#include <vector>
+
 template<class EdgeDataT>
 class InternalDataFacade : public BaseDataFacade<EdgeDataT> {
 
@@ -55,19 +65,23 @@ private:
 
     InternalDataFacade() { }
 
+    static const unsigned RECORD_BLOCK_SIZE = 64*1024;
+
     unsigned                                 m_check_sum;
     unsigned                                 m_number_of_nodes;
-    QueryGraph                             * m_query_graph;
+    boost::scoped_ptr<QueryGraph>            m_query_graph;
+    ShM<unsigned, false>::vector             m_node_length_list;
+    ShM<unsigned, false>::vector             m_edge_length_list;
+    ShM<unsigned char, false>::vector        m_edge_restriction_count_list;
     std::string                              m_timestamp;
 
     ShM<FixedPointCoordinate, false>::vector m_coordinate_list;
-    ShM<NodeID, false>::vector               m_via_node_list;
-    ShM<unsigned, false>::vector             m_name_ID_list;
-    ShM<TurnInstruction, false>::vector      m_turn_instruction_list;
-    ShM<char, false>::vector                 m_names_char_list;
-    ShM<unsigned, false>::vector             m_name_begin_indices;
+    ShM<PackedOriginalEdgeData, false>::vector m_original_edge_list;
+    ShM<unsigned char, false>::vector        m_geometry_zoom_list;
+    NameStore<false>                         m_name_store;
 
-    StaticRTree<RTreeLeaf, false>          * m_static_rtree;
+    boost::scoped_ptr<StaticRTree<RTreeLeaf, false> > m_static_rtree;
+    boost::scoped_ptr<StaticPointIndex<false> > m_static_point_index;
 
 
     void LoadTimestamp(const boost::filesystem::path & timestamp_path) {
@@ -98,66 +112,90 @@ private:
             hsgr_path,
             node_list,
             edge_list,
+            m_node_length_list,
+            m_edge_length_list,
+            m_edge_restriction_count_list,
             &m_check_sum
         );
 
         BOOST_ASSERT_MSG(0 != node_list.size(), "node list empty");
         BOOST_ASSERT_MSG(0 != edge_list.size(), "edge list empty");
         SimpleLogger().Write() << "loaded " << node_list.size() << " nodes and " << edge_list.size() << " edges";
-        m_query_graph = new QueryGraph(node_list, edge_list);
+        m_query_graph.reset(new QueryGraph(node_list, edge_list));
 
         BOOST_ASSERT_MSG(0 == node_list.size(), "node list not flushed");
         BOOST_ASSERT_MSG(0 == edge_list.size(), "edge list not flushed");
         SimpleLogger().Write() << "Data checksum is " << m_check_sum;
     }
 
-    void LoadNodeAndEdgeInformation(
-        const boost::filesystem::path nodes_file,
-        const boost::filesystem::path edges_file
-    ) {
+    //records are read in large blocks and split into the per-field arrays
+    void LoadNodeInformation(const boost::filesystem::path nodes_file) {
         boost::filesystem::ifstream nodes_input_stream(
             nodes_file,
             std::ios::binary
         );
 
         SimpleLogger().Write(logDEBUG) << "Loading node data";
-        NodeInfo current_node;
         unsigned number_of_coordinates = 0;
         nodes_input_stream.read(
             (char *)&number_of_coordinates,
             sizeof(unsigned)
         );
         m_coordinate_list.resize(number_of_coordinates);
-        for(unsigned i = 0; i < number_of_coordinates; ++i) {
-            nodes_input_stream.read((char *)&current_node, sizeof(NodeInfo));
-            m_coordinate_list[i] = FixedPointCoordinate(
-                    current_node.lat,
-                    current_node.lon
+        std::vector<NodeInfo> node_buffer(
+            std::min(number_of_coordinates, (unsigned)RECORD_BLOCK_SIZE)
+        );
+        unsigned i = 0;
+        while( i < number_of_coordinates ) {
+            const unsigned block_size = std::min(
+                number_of_coordinates - i,
+                (unsigned)node_buffer.size()
+            );
+            nodes_input_stream.read(
+                (char *)&node_buffer[0],
+                block_size*sizeof(NodeInfo)
             );
+            for(unsigned j = 0; j < block_size; ++j, ++i) {
+                m_coordinate_list[i] = FixedPointCoordinate(
+                    node_buffer[j].lat,
+                    node_buffer[j].lon
+                );
+            }
         }
-        std::vector<FixedPointCoordinate>(m_coordinate_list).swap(m_coordinate_list);
         nodes_input_stream.close();
+    }
 
+    void LoadEdgeInformation(const boost::filesystem::path edges_file) {
         SimpleLogger().Write(logDEBUG) << "Loading edge data";
         boost::filesystem::ifstream edges_input_stream(
             edges_file,
             std::ios::binary
         );
-        unsigned number_of_edges = 0;
-        edges_input_stream.read((char*)&number_of_edges, sizeof(unsigned));
-        m_via_node_list.resize(number_of_edges);
-        m_name_ID_list.resize(number_of_edges);
-        m_turn_instruction_list.resize(number_of_edges);
-
-        OriginalEdgeData current_edge_data;
-        for(unsigned i = 0; i < number_of_edges; ++i) {
+        const OriginalEdgeFileLayout edges_file_layout =
+            OriginalEdgeFileLayout::Read(edges_input_stream, edges_file.string());
+        const unsigned number_of_edges = edges_file_layout.number_of_edges;
+        m_original_edge_list.resize(number_of_edges);
+        m_geometry_zoom_list.resize(number_of_edges);
+
+        std::vector<OriginalEdgeData> edge_buffer(
+            std::min(number_of_edges, (unsigned)RECORD_BLOCK_SIZE)
+        );
+        unsigned i = 0;
+        while( i < number_of_edges ) {
+            const unsigned block_size = std::min(
+                number_of_edges - i,
+                (unsigned)edge_buffer.size()
+            );
             edges_input_stream.read(
-                (char*)&(current_edge_data),
-                sizeof(OriginalEdgeData)
+                (char*)&edge_buffer[0],
+                block_size*sizeof(OriginalEdgeData)
             );
-            m_via_node_list[i] = current_edge_data.viaNode;
-            m_name_ID_list[i]  = current_edge_data.nameID;
-            m_turn_instruction_list[i] = current_edge_data.turnInstruction;
+            for(unsigned j = 0; j < block_size; ++j, ++i) {
+                m_original_edge_list[i] = PackedOriginalEdgeData(edge_buffer[j]);
+                m_geometry_zoom_list[i] = (
+                    edges_file_layout.has_zoom_levels ? edge_buffer[j].minZoomLevel : 0
+                );
+            }
         }
         edges_input_stream.close();
     }
@@ -166,47 +204,129 @@ private:
         const boost::filesystem::path & ram_index_path,
         const boost::filesystem::path & file_index_path
     ) {
-        m_static_rtree = new StaticRTree<RTreeLeaf>(
-            ram_index_path,
-            file_index_path
+        m_static_rtree.reset(
+            new StaticRTree<RTreeLeaf>(ram_index_path, file_index_path)
         );
     }
 
+    void LoadPointIndex(
+        const boost::filesystem::path & point_index_path
+    ) {
+        if( !boost::filesystem::exists(point_index_path) ) {
+            SimpleLogger().Write(logWARNING) <<
+                "no point index found, locate requests use the r-tree";
+            return;
+        }
+        m_static_point_index.reset(new StaticPointIndex<false>(point_index_path));
+    }
+
     void LoadStreetNames(
         const boost::filesystem::path & names_file
     ) {
-        boost::filesystem::ifstream name_stream(names_file, std::ios::binary);
-        unsigned number_of_names = 0;
-        unsigned number_of_chars = 0;
-        name_stream.read((char *)&number_of_names, sizeof(unsigned));
-        name_stream.read((char *)&number_of_chars, sizeof(unsigned));
-        BOOST_ASSERT_MSG(0 != number_of_names, "name file broken");
-        BOOST_ASSERT_MSG(0 != number_of_chars, "name file broken");
-
-        m_name_begin_indices.resize(number_of_names);
-        name_stream.read(
-            (char*)&m_name_begin_indices[0],
-            number_of_names*sizeof(unsigned)
-        );
-
-        m_names_char_list.resize(number_of_chars+1); //+1 gives sentinel element
-        name_stream.read(
-            (char *)&m_names_char_list[0],
-            number_of_chars*sizeof(char)
-        );
-        BOOST_ASSERT_MSG(
-            0 != m_names_char_list.size(),
-            "could not load any names"
-        );
-        name_stream.close();
-    }
-public:
-    ~InternalDataFacade() {
-        delete m_query_graph;
-        delete m_static_rtree;
+        std::vector<NameBlock> name_block_list;
+        std::vector<char> names_char_list;
+        NameStore<false>::LoadRawNames(
+            names_file,
+            name_block_list,
+            names_char_list
+        );
+        m_name_store.Swap(name_block_list, names_char_list);
     }
 
+    //reads all sections of a container front to back in its stored layout
+    void LoadContainer(const boost::filesystem::path & container_path) {
+        typedef DataContainerHeader Header;
+        typedef typename StaticRTree<RTreeLeaf>::TreeNode RTreeNode;
+        typedef typename StaticPointIndex<false>::PointT PointIndexNode;
+
+        SimpleLogger().Write() << "loading container " << container_path.string();
+        DataContainerReader container_reader(container_path);
+        m_check_sum = container_reader.GetHeader().checksum;
+
+        ParallelLoader loader;
+        std::vector<NameBlock> name_block_list;
+        std::vector<char> names_char_list;
+        container_reader.AddSectionTask(loader, Header::NAME_BLOCKS, name_block_list);
+        container_reader.AddSectionTask(loader, Header::NAME_CHARS, names_char_list);
+        container_reader.AddSectionTask(
+            loader,
+            Header::ORIGINAL_EDGES,
+            m_original_edge_list
+        );
+        container_reader.AddSectionTask(
+            loader,
+            Header::GEOMETRY_ZOOM_LEVELS,
+            m_geometry_zoom_list
+        );
+
+        typename ShM<typename QueryGraph::_StrNode, false>::vector node_list;
+        typename ShM<typename QueryGraph::_StrEdge, false>::vector edge_list;
+        container_reader.AddSectionTask(loader, Header::GRAPH_NODES, node_list);
+        container_reader.AddSectionTask(loader, Header::GRAPH_EDGES, edge_list);
+        container_reader.AddSectionTask(
+            loader,
+            Header::GRAPH_NODE_LENGTHS,
+            m_node_length_list
+        );
+        container_reader.AddSectionTask(
+            loader,
+            Header::GRAPH_EDGE_LENGTHS,
+            m_edge_length_list
+        );
+        container_reader.AddSectionTask(
+            loader,
+            Header::GRAPH_EDGE_RESTRICTION_COUNTS,
+            m_edge_restriction_count_list
+        );
+
+        std::vector<char> timestamp;
+        container_reader.AddSectionTask(loader, Header::TIMESTAMP, timestamp);
+        container_reader.AddSectionTask(loader, Header::COORDINATES, m_coordinate_list);
+        std::vector<RTreeNode> tree_nodes;
+        container_reader.AddSectionTask(loader, Header::RTREE_NODES, tree_nodes);
+        std::vector<PointIndexNode> point_list;
+        container_reader.AddSectionTask(loader, Header::POINT_INDEX, point_list);
+        loader.Run();
+        m_name_store.Swap(name_block_list, names_char_list);
+
+        if( node_list.empty() || edge_list.empty() ) {
+            throw OSRMException("container holds an empty graph");
+        }
+        m_number_of_nodes = node_list.size();
+        SimpleLogger().Write() << "loaded " << node_list.size() << " nodes and " << edge_list.size() << " edges";
+        m_query_graph.reset(new QueryGraph(node_list, edge_list));
+        SimpleLogger().Write() << "Data checksum is " << m_check_sum;
+
+        m_timestamp.assign(timestamp.begin(), timestamp.end());
+
+        m_static_rtree.reset(
+            new StaticRTree<RTreeLeaf>(
+                tree_nodes,
+                container_path,
+                container_reader.GetSection(Header::RTREE_LEAVES).offset
+            )
+        );
+
+        if( point_list.empty() ) {
+            SimpleLogger().Write(logWARNING) <<
+                "no point index found, locate requests use the r-tree";
+            return;
+        }
+        m_static_point_index.reset(new StaticPointIndex<false>(point_list));
+    }
+public:
+    // the graph, r-tree and point index are owned by scoped pointers, a
+    // load task that throws does not leak what the other tasks built
     InternalDataFacade( const ServerPaths & server_paths ) {
+        ServerPaths::const_iterator container_iterator = server_paths.find("container");
+        if(
+            server_paths.end() != container_iterator &&
+            boost::filesystem::is_regular_file(container_iterator->second)
+        ) {
+            LoadContainer(container_iterator->second);
+            return;
+        }
+
         //generate paths of data files
         if( server_paths.find("hsgrdata") == server_paths.end() ) {
             throw OSRMException("no hsgr file given in ini file");
@@ -248,18 +368,54 @@ public:
         paths_iterator = server_paths.find("namesdata");
         BOOST_ASSERT(server_paths.end() != paths_iterator);
         const boost::filesystem::path & names_data_path = paths_iterator->second;
+        paths_iterator = server_paths.find("pointindex");
+        const boost::filesystem::path point_index_path = (
+            server_paths.end() != paths_iterator ?
+            paths_iterator->second : boost::filesystem::path()
+        );
 
-        //load data
-        SimpleLogger().Write() << "loading graph data";
-        LoadGraph(hsgr_path);
-        SimpleLogger().Write() << "loading egde information";
-        LoadNodeAndEdgeInformation(nodes_data_path, edges_data_path);
-        SimpleLogger().Write() << "loading r-tree";
-        LoadRTree(ram_index_path, file_index_path);
-        SimpleLogger().Write() << "loading timestamp";
+        //load data, the files are independent and are read concurrently
+        ParallelLoader loader;
+        loader.AddTask(
+            "graph",
+            boost::filesystem::file_size(hsgr_path),
+            boost::bind(&InternalDataFacade::LoadGraph, this, hsgr_path)
+        );
+        loader.AddTask(
+            "coordinates",
+            boost::filesystem::file_size(nodes_data_path),
+            boost::bind(&InternalDataFacade::LoadNodeInformation, this, nodes_data_path)
+        );
+        loader.AddTask(
+            "original edges",
+            boost::filesystem::file_size(edges_data_path),
+            boost::bind(&InternalDataFacade::LoadEdgeInformation, this, edges_data_path)
+        );
+        loader.AddTask(
+            "r-tree",
+            boost::filesystem::file_size(ram_index_path),
+            boost::bind(
+                &InternalDataFacade::LoadRTree,
+                this,
+                ram_index_path,
+                file_index_path
+            )
+        );
+        loader.AddTask(
+            "point index",
+            (
+                boost::filesystem::exists(point_index_path) ?
+                boost::filesystem::file_size(point_index_path) : 0
+            ),
+            boost::bind(&InternalDataFacade::LoadPointIndex, this, point_index_path)
+        );
+        loader.AddTask(
+            "street names",
+            boost::filesystem::file_size(names_data_path),
+            boost::bind(&InternalDataFacade::LoadStreetNames, this, names_data_path)
+        );
+        loader.Run();
         LoadTimestamp(timestamp_path);
-        SimpleLogger().Write() << "loading street names";
-        LoadStreetNames(names_data_path);
     }
 
     //search graph access
@@ -278,10 +434,6 @@ public:
     NodeID GetTarget( const EdgeID e ) const {
         return m_query_graph->GetTarget(e); }
 
-    EdgeDataT &GetEdgeData( const EdgeID e ) {
-        return m_query_graph->GetEdgeData(e);
-    }
-
     const EdgeDataT &GetEdgeData( const EdgeID e ) const {
         return m_query_graph->GetEdgeData(e);
     }
@@ -314,18 +466,36 @@ public:
         return m_query_graph->FindEdgeIndicateIfReverse(from, to, result);
     }
 
+    unsigned GetLengthOfNode( const NodeID n ) const {
+        return m_node_length_list.at(n);
+    }
+
+    unsigned GetLengthOfEdge( const EdgeID e ) const {
+        return m_edge_length_list.at(e);
+    }
+
+    unsigned GetRestrictionCountOfEdge( const EdgeID e ) const {
+        return m_edge_restriction_count_list.at(e);
+    }
+
     //node and edge information access
     FixedPointCoordinate GetCoordinateOfNode(
         const unsigned id
     ) const {
-        const NodeID node = m_via_node_list.at(id);
+        const NodeID node = m_original_edge_list.at(id).GetViaNode();
         return m_coordinate_list.at(node);
     };
 
     TurnInstruction GetTurnInstructionForEdgeID(
         const unsigned id
     ) const {
-        return m_turn_instruction_list.at(id);
+        return m_original_edge_list.at(id).GetTurnInstruction();
+    }
+
+    unsigned char GetMinZoomLevelForEdgeID(
+        const unsigned id
+    ) const {
+        return m_geometry_zoom_list.at(id);
     }
 
     bool LocateClosestEndPointForCoordinate(
@@ -333,6 +503,13 @@ public:
         FixedPointCoordinate& result,
         const unsigned zoom_level = 18
     ) const {
+        //the point index holds no tiny component information
+        if( NULL != m_static_point_index.get() && 14 < zoom_level ) {
+            return m_static_point_index->LocateClosestPoint(
+                input_coordinate,
+                result
+            );
+        }
         return  m_static_rtree->LocateClosestEndPointForCoordinate(
                     input_coordinate,
                     result,
@@ -352,44 +529,77 @@ public:
                 );
     }
 
+    void FindPhantomNodesForCoordinates(
+        const std::vector<FixedPointCoordinate> & input_coordinates,
+        std::vector<PhantomNode> & resulting_phantom_nodes,
+        const unsigned zoom_level
+    ) const {
+        m_static_rtree->FindPhantomNodesForCoordinates(
+            input_coordinates,
+            resulting_phantom_nodes,
+            zoom_level
+        );
+    }
+
     unsigned GetCheckSum() const { return m_check_sum; }
 
     unsigned GetNameIndexFromEdgeID(const unsigned id) const {
-        return m_name_ID_list.at(id);
+        return m_original_edge_list.at(id).GetNameID();
     };
 
-    void GetName( const unsigned name_id, std::string & result ) const {
-        if(UINT_MAX == name_id) {
-            result = "";
-            return;
+    NameView GetEscapedName(const unsigned name_id) const {
+        return m_name_store.GetName(name_id);
+    }
+
+    std::string GetTimestamp() const {
+        return m_timestamp;
+    }
+
+    void GetDataRegions(std::vector<DataRegion> & regions) const {
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::RTREE_NODES, m_static_rtree->GetSearchTree())
+        );
+        if( NULL != m_static_point_index.get() ) {
+            regions.push_back(
+                DataRegion::FromVector(
+                    DataRegion::POINT_INDEX,
+                    m_static_point_index->GetTreePoints()
+                )
+            );
         }
-        BOOST_ASSERT_MSG(
-            name_id < m_name_begin_indices.size(),
-            "name id too high"
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_NODES, m_query_graph->GetNodeArray())
         );
-        unsigned begin_index = m_name_begin_indices[name_id];
-        unsigned end_index = m_name_begin_indices[name_id+1];
-        BOOST_ASSERT_MSG(
-            begin_index < m_names_char_list.size(),
-            "begin index of name too high"
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_NODES, m_node_length_list)
         );
-        BOOST_ASSERT_MSG(
-            end_index < m_names_char_list.size(),
-            "end index of name too high"
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_EDGES, m_query_graph->GetEdgeArray())
         );
-
-        BOOST_ASSERT_MSG(begin_index <= end_index, "string ends before begin");
-        result.clear();
-        result.resize(end_index - begin_index);
-        std::copy(
-            m_names_char_list.begin() + begin_index,
-            m_names_char_list.begin() + end_index,
-            result.begin()
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_EDGES, m_edge_length_list)
+        );
+        regions.push_back(
+            DataRegion::FromVector(
+                DataRegion::GRAPH_EDGES,
+                m_edge_restriction_count_list
+            )
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::COORDINATES, m_coordinate_list)
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::ORIGINAL_EDGES, m_original_edge_list)
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::ORIGINAL_EDGES, m_geometry_zoom_list)
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::NAMES, m_name_store.GetBlockList())
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::NAMES, m_name_store.GetCharList())
         );
-    }
-
-    std::string GetTimestamp() const {
-        return m_timestamp;
     }
 };
 
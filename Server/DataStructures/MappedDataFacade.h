@@ -0,0 +1,712 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef MAPPED_DATA_FACADE_H
+#define MAPPED_DATA_FACADE_H
+
+//implements all data storage by memory mapping the data files. Nothing is
+//copied or converted at startup, the facade points wrappers directly into
+//the mapped files, and all processes share the pages of the page cache.
+
+#include "BaseDataFacade.h"
+#include "DataContainer.h"
+
+#include "../../DataStructures/Coordinate.h"
+#include "../../DataStructures/QueryNode.h"
+#include "../../DataStructures/OriginalEdgeFile.h"
+#include "../../DataStructures/QueryEdge.h"
+#include "../../DataStructures/SearchGraphTrailer.h"
+#include "../../DataStructures/SharedMemoryVectorWrapper.h"
+#include "../../DataStructures/StaticGraph.h"
+#include "../../DataStructures/StaticPointIndex.h"
+#include "../../DataStructures/StaticRTree.h"
+#include "../../Util/BoostFileSystemFix.h"
+#include "../../Util/MappedFile.h"
+#include "../../Util/ProgramOptions.h"
+#include "../../Util/SimpleLogger.h"
+#include "../../Util/UUID.h"
+
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <algorithm>
+
+template<class EdgeDataT>
+class MappedDataFacade : public BaseDataFacade<EdgeDataT> {
+
+private:
+    typedef EdgeDataT EdgeData;
+    typedef BaseDataFacade<EdgeData>                        super;
+    typedef StaticGraph<EdgeData, true>                     QueryGraph;
+    typedef typename StaticGraph<EdgeData, true>::_StrNode  GraphNode;
+    typedef typename StaticGraph<EdgeData, true>::_StrEdge  GraphEdge;
+    typedef typename super::RTreeLeaf                       RTreeLeaf;
+    typedef typename StaticRTree<RTreeLeaf, true>::TreeNode RTreeNode;
+    typedef StaticPointIndex<true>::PointT                  PointIndexNode;
+
+    MappedDataFacade() : m_use_container(false), m_has_zoom_levels(true) { }
+
+    unsigned                                m_check_sum;
+    std::string                             m_timestamp;
+    bool                                    m_use_container;
+    //.edges of older builds hold garbage in place of the zoom levels
+    bool                                    m_has_zoom_levels;
+
+    boost::shared_ptr<MappedFile>           m_container_file;
+    boost::shared_ptr<MappedFile>           m_hsgr_file;
+    boost::shared_ptr<MappedFile>           m_nodes_file;
+    boost::shared_ptr<MappedFile>           m_edges_file;
+    boost::shared_ptr<MappedFile>           m_ram_index_file;
+    boost::shared_ptr<MappedFile>           m_point_index_file;
+
+    boost::shared_ptr<QueryGraph>           m_query_graph;
+    ShM<unsigned, true>::vector             m_node_length_list;
+    ShM<unsigned, true>::vector             m_edge_length_list;
+    ShM<unsigned char, true>::vector        m_edge_restriction_count_list;
+    //zero lengths and counts for .hsgr files that were written without them
+    std::vector<unsigned>                   m_length_storage;
+    std::vector<unsigned char>              m_restriction_count_storage;
+    ShM<NodeInfo, true>::vector             m_node_info_list;
+    ShM<OriginalEdgeData, true>::vector     m_original_edge_list;
+    //arrays as stored in a container
+    ShM<FixedPointCoordinate, true>::vector m_coordinate_list;
+    ShM<PackedOriginalEdgeData, true>::vector m_packed_edge_list;
+    ShM<unsigned char, true>::vector        m_geometry_zoom_list;
+    NameStore<true>                         m_name_store;
+    //names of loose files are escaped at startup and cannot be mapped
+    std::vector<NameBlock>                  m_name_block_storage;
+    std::vector<char>                       m_name_char_storage;
+    boost::shared_ptr<StaticRTree<RTreeLeaf, true> > m_static_rtree;
+    boost::shared_ptr<StaticPointIndex<true> >       m_static_point_index;
+
+    void LoadTimestamp(const boost::filesystem::path & timestamp_path) {
+        if( boost::filesystem::exists(timestamp_path) ) {
+            SimpleLogger().Write() << "Loading Timestamp";
+            boost::filesystem::ifstream timestampInStream( timestamp_path );
+            if(!timestampInStream) {
+                SimpleLogger().Write(logWARNING) << timestamp_path << " not found";
+            }
+            getline(timestampInStream, m_timestamp);
+            timestampInStream.close();
+        }
+        if(m_timestamp.empty()) {
+            m_timestamp = "n/a";
+        }
+        if(25 < m_timestamp.length()) {
+            m_timestamp.resize(25);
+        }
+    }
+
+    // .hsgr: uuid, checksum, #nodes, #edges, nodes, edges, trailer header,
+    //node lengths, edge lengths, edge restriction counts
+    void LoadGraph(const boost::filesystem::path & hsgr_path) {
+        SimpleLogger().Write() << "mapping graph from " << hsgr_path.string();
+        m_hsgr_file = boost::make_shared<MappedFile>(hsgr_path);
+
+        UUID uuid_orig;
+        if( !m_hsgr_file->GetPointer<UUID>(0, 1)->TestGraphUtil(uuid_orig) ) {
+            SimpleLogger().Write(logWARNING) <<
+                ".hsgr was prepared with different build. "
+                "Reprocess to get rid of this warning.";
+        }
+        std::size_t offset = sizeof(UUID);
+        m_check_sum = m_hsgr_file->GetValue<unsigned>(offset);
+        offset += sizeof(unsigned);
+        const unsigned number_of_nodes = m_hsgr_file->GetValue<unsigned>(offset);
+        offset += sizeof(unsigned);
+        const unsigned number_of_edges = m_hsgr_file->GetValue<unsigned>(offset);
+        offset += sizeof(unsigned);
+        if( 0 == number_of_nodes || 0 == number_of_edges ) {
+            throw OSRMException("hsgr file holds an empty graph");
+        }
+
+        typename ShM<GraphNode, true>::vector node_list(
+            AsShMPointer(m_hsgr_file->GetPointer<GraphNode>(offset, number_of_nodes)),
+            number_of_nodes
+        );
+        offset += number_of_nodes*sizeof(GraphNode);
+        typename ShM<GraphEdge, true>::vector edge_list(
+            AsShMPointer(m_hsgr_file->GetPointer<GraphEdge>(offset, number_of_edges)),
+            number_of_edges
+        );
+        offset += number_of_edges*sizeof(GraphEdge);
+        m_query_graph = boost::make_shared<QueryGraph>(node_list, edge_list);
+        SimpleLogger().Write() << "mapped " << number_of_nodes << " nodes and " <<
+            number_of_edges << " edges";
+
+        SimpleLogger().Write() << "Data checksum is " << m_check_sum;
+
+        const uint64_t size_of_trailer_header = std::min(
+            uint64_t(sizeof(SearchGraphTrailerHeader)),
+            uint64_t(m_hsgr_file->Size() - offset)
+        );
+        if(
+            !SearchGraphTrailerHeader::Check(
+                m_hsgr_file->GetPointer<char>(offset, size_of_trailer_header),
+                size_of_trailer_header,
+                number_of_edges,
+                hsgr_path.string()
+            )
+        ) {
+            m_length_storage.resize(std::max(number_of_nodes, number_of_edges), 0);
+            typename ShM<unsigned, true>::vector node_length_list(
+                &m_length_storage[0],
+                number_of_nodes
+            );
+            typename ShM<unsigned, true>::vector edge_length_list(
+                &m_length_storage[0],
+                number_of_edges
+            );
+            m_node_length_list.swap(node_length_list);
+            m_edge_length_list.swap(edge_length_list);
+            m_restriction_count_storage.resize(number_of_edges, 0);
+            typename ShM<unsigned char, true>::vector edge_restriction_count_list(
+                &m_restriction_count_storage[0],
+                number_of_edges
+            );
+            m_edge_restriction_count_list.swap(edge_restriction_count_list);
+            return;
+        }
+        offset += sizeof(SearchGraphTrailerHeader);
+
+        typename ShM<unsigned, true>::vector node_length_list(
+            AsShMPointer(m_hsgr_file->GetPointer<unsigned>(offset, number_of_nodes)),
+            number_of_nodes
+        );
+        offset += number_of_nodes*sizeof(unsigned);
+        typename ShM<unsigned, true>::vector edge_length_list(
+            AsShMPointer(m_hsgr_file->GetPointer<unsigned>(offset, number_of_edges)),
+            number_of_edges
+        );
+        offset += number_of_edges*sizeof(unsigned);
+        m_node_length_list.swap(node_length_list);
+        m_edge_length_list.swap(edge_length_list);
+        typename ShM<unsigned char, true>::vector edge_restriction_count_list(
+            AsShMPointer(m_hsgr_file->GetPointer<unsigned char>(offset, number_of_edges)),
+            number_of_edges
+        );
+        m_edge_restriction_count_list.swap(edge_restriction_count_list);
+    }
+
+    // .nodes: element count followed by the elements, .edges: header
+    //followed by the elements
+    void LoadNodeAndEdgeInformation(
+        const boost::filesystem::path nodes_file,
+        const boost::filesystem::path edges_file
+    ) {
+        m_nodes_file = boost::make_shared<MappedFile>(nodes_file);
+        const unsigned number_of_coordinates = m_nodes_file->GetValue<unsigned>(0);
+        typename ShM<NodeInfo, true>::vector node_info_list(
+            AsShMPointer(m_nodes_file->GetPointer<NodeInfo>(sizeof(unsigned), number_of_coordinates)),
+            number_of_coordinates
+        );
+        m_node_info_list.swap(node_info_list);
+
+        m_edges_file = boost::make_shared<MappedFile>(edges_file);
+        const OriginalEdgeFileLayout edges_file_layout = OriginalEdgeFileLayout::Get(
+            m_edges_file->GetPointer<char>(0, 0),
+            m_edges_file->Size(),
+            edges_file.string()
+        );
+        m_has_zoom_levels = edges_file_layout.has_zoom_levels;
+        const unsigned number_of_edges = edges_file_layout.number_of_edges;
+        typename ShM<OriginalEdgeData, true>::vector original_edge_list(
+            AsShMPointer(m_edges_file->GetPointer<OriginalEdgeData>(
+                edges_file_layout.records_offset,
+                number_of_edges
+            )),
+            number_of_edges
+        );
+        m_original_edge_list.swap(original_edge_list);
+    }
+
+    // .ramIndex: node count followed by the tree nodes
+    void LoadRTree(
+        const boost::filesystem::path & ram_index_path,
+        const boost::filesystem::path & file_index_path
+    ) {
+        m_ram_index_file = boost::make_shared<MappedFile>(ram_index_path);
+        const uint32_t tree_size = m_ram_index_file->GetValue<uint32_t>(0);
+        m_static_rtree = boost::make_shared<StaticRTree<RTreeLeaf, true> >(
+            AsShMPointer(m_ram_index_file->GetPointer<RTreeNode>(sizeof(uint32_t), tree_size)),
+            tree_size,
+            file_index_path
+        );
+    }
+
+    // .pointIndex: point count followed by the k-d tree
+    void LoadPointIndex(
+        const boost::filesystem::path & point_index_path
+    ) {
+        if( !boost::filesystem::exists(point_index_path) ) {
+            SimpleLogger().Write(logWARNING) <<
+                "no point index found, locate requests use the r-tree";
+            return;
+        }
+        m_point_index_file = boost::make_shared<MappedFile>(point_index_path);
+        const unsigned point_index_size = m_point_index_file->GetValue<unsigned>(0);
+        m_static_point_index = boost::make_shared<StaticPointIndex<true> >(
+            AsShMPointer(m_point_index_file->GetPointer<PointIndexNode>(sizeof(unsigned), point_index_size)),
+            point_index_size
+        );
+    }
+
+    void LoadStreetNames(
+        const boost::filesystem::path & names_file
+    ) {
+        NameStore<true>::LoadRawNames(
+            names_file,
+            m_name_block_storage,
+            m_name_char_storage
+        );
+        typename ShM<NameBlock, true>::vector name_block_list(
+            m_name_block_storage.empty() ? NULL : &m_name_block_storage[0],
+            m_name_block_storage.size()
+        );
+        typename ShM<char, true>::vector names_char_list(
+            m_name_char_storage.empty() ? NULL : &m_name_char_storage[0],
+            m_name_char_storage.size()
+        );
+        m_name_store.Swap(name_block_list, names_char_list);
+    }
+
+    //MappedFile hands out const pointers into its read-only mappings. The
+    //ShM vectors take mutable ones, since they wrap shared memory as well,
+    //but this facade only ever reads through them.
+    template<typename T>
+    static T * AsShMPointer(const T * pointer) {
+        return const_cast<T *>(pointer);
+    }
+
+    template<typename T>
+    void MapSection(
+        const DataContainerHeader & header,
+        const DataContainerHeader::SectionID section_id,
+        const std::string & file_name,
+        typename ShM<T, true>::vector & result
+    ) const {
+        const DataContainerSection & section = header.sections[section_id];
+        const uint64_t number_of_elements =
+            header.GetNumberOfElements<T>(section_id, file_name);
+        if( number_of_elements*sizeof(T) != section.size ) {
+            throw OSRMException(file_name + " has a section of inconsistent size");
+        }
+        T * section_ptr = AsShMPointer(m_container_file->GetPointer<T>(
+            section.offset,
+            number_of_elements
+        ));
+        result = typename ShM<T, true>::vector(section_ptr, number_of_elements);
+    }
+
+    //sections of a container are mapped as they are. Header and section
+    //bounds are checked, but checksums are not, that would read the whole
+    //file at startup. osrm-datastore and the internal facade verify them.
+    void LoadContainer(const boost::filesystem::path & container_path) {
+        typedef DataContainerHeader Header;
+
+        SimpleLogger().Write() << "mapping container " << container_path.string();
+        const std::string file_name = container_path.string();
+        m_container_file = boost::make_shared<MappedFile>(container_path);
+        const Header & header = *m_container_file->GetPointer<Header>(0, 1);
+        header.Check(file_name);
+        m_check_sum = header.checksum;
+        m_use_container = true;
+
+        SimpleLogger().Write() << "mapping street names";
+        typename ShM<NameBlock, true>::vector name_block_list;
+        typename ShM<char, true>::vector names_char_list;
+        MapSection<NameBlock>(header, Header::NAME_BLOCKS, file_name, name_block_list);
+        MapSection<char>(header, Header::NAME_CHARS, file_name, names_char_list);
+        m_name_store.Swap(name_block_list, names_char_list);
+
+        SimpleLogger().Write() << "mapping egde information";
+        MapSection<PackedOriginalEdgeData>(
+            header,
+            Header::ORIGINAL_EDGES,
+            file_name,
+            m_packed_edge_list
+        );
+        MapSection<unsigned char>(
+            header,
+            Header::GEOMETRY_ZOOM_LEVELS,
+            file_name,
+            m_geometry_zoom_list
+        );
+
+        SimpleLogger().Write() << "mapping graph data";
+        typename ShM<GraphNode, true>::vector node_list;
+        typename ShM<GraphEdge, true>::vector edge_list;
+        MapSection<GraphNode>(header, Header::GRAPH_NODES, file_name, node_list);
+        MapSection<GraphEdge>(header, Header::GRAPH_EDGES, file_name, edge_list);
+        if( 0 == node_list.size() || 0 == edge_list.size() ) {
+            throw OSRMException("container holds an empty graph");
+        }
+        SimpleLogger().Write() << "mapped " << node_list.size() << " nodes and " <<
+            edge_list.size() << " edges";
+        m_query_graph = boost::make_shared<QueryGraph>(node_list, edge_list);
+        SimpleLogger().Write() << "Data checksum is " << m_check_sum;
+        MapSection<unsigned>(
+            header,
+            Header::GRAPH_NODE_LENGTHS,
+            file_name,
+            m_node_length_list
+        );
+        MapSection<unsigned>(
+            header,
+            Header::GRAPH_EDGE_LENGTHS,
+            file_name,
+            m_edge_length_list
+        );
+        MapSection<unsigned char>(
+            header,
+            Header::GRAPH_EDGE_RESTRICTION_COUNTS,
+            file_name,
+            m_edge_restriction_count_list
+        );
+
+        SimpleLogger().Write() << "loading timestamp";
+        ShM<char, true>::vector timestamp;
+        MapSection<char>(header, Header::TIMESTAMP, file_name, timestamp);
+        m_timestamp.assign(timestamp.begin(), timestamp.end());
+
+        MapSection<FixedPointCoordinate>(
+            header,
+            Header::COORDINATES,
+            file_name,
+            m_coordinate_list
+        );
+
+        SimpleLogger().Write() << "mapping r-tree";
+        typename ShM<RTreeNode, true>::vector tree_nodes;
+        MapSection<RTreeNode>(header, Header::RTREE_NODES, file_name, tree_nodes);
+        m_static_rtree.reset(
+            new StaticRTree<RTreeLeaf, true>(
+                tree_nodes,
+                container_path,
+                header.sections[Header::RTREE_LEAVES].offset
+            )
+        );
+
+        SimpleLogger().Write() << "mapping point index";
+        typename ShM<PointIndexNode, true>::vector point_list;
+        MapSection<PointIndexNode>(header, Header::POINT_INDEX, file_name, point_list);
+        if( 0 == point_list.size() ) {
+            SimpleLogger().Write(logWARNING) <<
+                "no point index found, locate requests use the r-tree";
+            return;
+        }
+        m_static_point_index.reset(new StaticPointIndex<true>(point_list));
+    }
+
+public:
+    MappedDataFacade( const ServerPaths & server_paths ) :
+        m_use_container(false),
+        m_has_zoom_levels(true)
+    {
+        ServerPaths::const_iterator container_iterator = server_paths.find("container");
+        if(
+            server_paths.end() != container_iterator &&
+            boost::filesystem::is_regular_file(container_iterator->second)
+        ) {
+            LoadContainer(container_iterator->second);
+            return;
+        }
+
+        //generate paths of data files
+        if( server_paths.find("hsgrdata") == server_paths.end() ) {
+            throw OSRMException("no hsgr file given in ini file");
+        }
+        if( server_paths.find("ramindex") == server_paths.end() ) {
+            throw OSRMException("no ram index file given in ini file");
+        }
+        if( server_paths.find("fileindex") == server_paths.end() ) {
+            throw OSRMException("no leaf index file given in ini file");
+        }
+        if( server_paths.find("nodesdata") == server_paths.end() ) {
+            throw OSRMException("no nodes file given in ini file");
+        }
+        if( server_paths.find("edgesdata") == server_paths.end() ) {
+            throw OSRMException("no edges file given in ini file");
+        }
+        if( server_paths.find("namesdata") == server_paths.end() ) {
+            throw OSRMException("no names file given in ini file");
+        }
+
+        ServerPaths::const_iterator paths_iterator = server_paths.find("hsgrdata");
+        BOOST_ASSERT(server_paths.end() != paths_iterator);
+        const boost::filesystem::path & hsgr_path = paths_iterator->second;
+        paths_iterator = server_paths.find("timestamp");
+        BOOST_ASSERT(server_paths.end() != paths_iterator);
+        const boost::filesystem::path & timestamp_path = paths_iterator->second;
+        paths_iterator = server_paths.find("ramindex");
+        BOOST_ASSERT(server_paths.end() != paths_iterator);
+        const boost::filesystem::path & ram_index_path = paths_iterator->second;
+        paths_iterator = server_paths.find("fileindex");
+        BOOST_ASSERT(server_paths.end() != paths_iterator);
+        const boost::filesystem::path & file_index_path = paths_iterator->second;
+        paths_iterator = server_paths.find("nodesdata");
+        BOOST_ASSERT(server_paths.end() != paths_iterator);
+        const boost::filesystem::path & nodes_data_path = paths_iterator->second;
+        paths_iterator = server_paths.find("edgesdata");
+        BOOST_ASSERT(server_paths.end() != paths_iterator);
+        const boost::filesystem::path & edges_data_path = paths_iterator->second;
+        paths_iterator = server_paths.find("namesdata");
+        BOOST_ASSERT(server_paths.end() != paths_iterator);
+        const boost::filesystem::path & names_data_path = paths_iterator->second;
+        paths_iterator = server_paths.find("pointindex");
+        const boost::filesystem::path point_index_path = (
+            server_paths.end() != paths_iterator ?
+            paths_iterator->second : boost::filesystem::path()
+        );
+
+        //map data
+        SimpleLogger().Write() << "mapping graph data";
+        LoadGraph(hsgr_path);
+        SimpleLogger().Write() << "mapping egde information";
+        LoadNodeAndEdgeInformation(nodes_data_path, edges_data_path);
+        SimpleLogger().Write() << "mapping r-tree";
+        LoadRTree(ram_index_path, file_index_path);
+        SimpleLogger().Write() << "mapping point index";
+        LoadPointIndex(point_index_path);
+        SimpleLogger().Write() << "loading timestamp";
+        LoadTimestamp(timestamp_path);
+        SimpleLogger().Write() << "mapping street names";
+        LoadStreetNames(names_data_path);
+    }
+
+    //search graph access
+    unsigned GetNumberOfNodes() const {
+        return m_query_graph->GetNumberOfNodes();
+    }
+
+    unsigned GetNumberOfEdges() const {
+        return m_query_graph->GetNumberOfEdges();
+    }
+
+    unsigned GetOutDegree( const NodeID n ) const {
+        return m_query_graph->GetOutDegree(n);
+    }
+
+    NodeID GetTarget( const EdgeID e ) const {
+        return m_query_graph->GetTarget(e); }
+
+    const EdgeDataT &GetEdgeData( const EdgeID e ) const {
+        return m_query_graph->GetEdgeData(e);
+    }
+
+    EdgeID BeginEdges( const NodeID n ) const {
+        return m_query_graph->BeginEdges(n);
+    }
+
+    EdgeID EndEdges( const NodeID n ) const {
+        return m_query_graph->EndEdges(n);
+    }
+
+    //searches for a specific edge
+    EdgeID FindEdge( const NodeID from, const NodeID to ) const {
+        return m_query_graph->FindEdge(from, to);
+    }
+
+    EdgeID FindEdgeInEitherDirection(
+        const NodeID from,
+        const NodeID to
+    ) const {
+        return m_query_graph->FindEdgeInEitherDirection(from, to);
+    }
+
+    EdgeID FindEdgeIndicateIfReverse(
+        const NodeID from,
+        const NodeID to,
+        bool & result
+    ) const {
+        return m_query_graph->FindEdgeIndicateIfReverse(from, to, result);
+    }
+
+    unsigned GetLengthOfNode( const NodeID n ) const {
+        return m_node_length_list.at(n);
+    }
+
+    unsigned GetLengthOfEdge( const EdgeID e ) const {
+        return m_edge_length_list.at(e);
+    }
+
+    unsigned GetRestrictionCountOfEdge( const EdgeID e ) const {
+        return m_edge_restriction_count_list.at(e);
+    }
+
+    //node and edge information access
+    FixedPointCoordinate GetCoordinateOfNode(
+        const unsigned id
+    ) const {
+        if( m_use_container ) {
+            return m_coordinate_list.at(m_packed_edge_list.at(id).GetViaNode());
+        }
+        const NodeID node = m_original_edge_list.at(id).viaNode;
+        const NodeInfo & node_info = m_node_info_list.at(node);
+        return FixedPointCoordinate(node_info.lat, node_info.lon);
+    };
+
+    TurnInstruction GetTurnInstructionForEdgeID(
+        const unsigned id
+    ) const {
+        if( m_use_container ) {
+            return m_packed_edge_list.at(id).GetTurnInstruction();
+        }
+        return m_original_edge_list.at(id).turnInstruction;
+    }
+
+    unsigned char GetMinZoomLevelForEdgeID(
+        const unsigned id
+    ) const {
+        if( m_use_container ) {
+            return m_geometry_zoom_list.at(id);
+        }
+        if( !m_has_zoom_levels ) {
+            return 0;
+        }
+        return m_original_edge_list.at(id).minZoomLevel;
+    }
+
+    bool LocateClosestEndPointForCoordinate(
+        const FixedPointCoordinate& input_coordinate,
+        FixedPointCoordinate& result,
+        const unsigned zoom_level = 18
+    ) const {
+        //the point index holds no tiny component information
+        if( m_static_point_index && 14 < zoom_level ) {
+            return m_static_point_index->LocateClosestPoint(
+                input_coordinate,
+                result
+            );
+        }
+        return  m_static_rtree->LocateClosestEndPointForCoordinate(
+                    input_coordinate,
+                    result,
+                    zoom_level
+                );
+    }
+
+    bool FindPhantomNodeForCoordinate(
+        const FixedPointCoordinate & input_coordinate,
+        PhantomNode & resulting_phantom_node,
+        const unsigned zoom_level
+    ) const {
+        return  m_static_rtree->FindPhantomNodeForCoordinate(
+                    input_coordinate,
+                    resulting_phantom_node,
+                    zoom_level
+                );
+    }
+
+    void FindPhantomNodesForCoordinates(
+        const std::vector<FixedPointCoordinate> & input_coordinates,
+        std::vector<PhantomNode> & resulting_phantom_nodes,
+        const unsigned zoom_level
+    ) const {
+        m_static_rtree->FindPhantomNodesForCoordinates(
+            input_coordinates,
+            resulting_phantom_nodes,
+            zoom_level
+        );
+    }
+
+    unsigned GetCheckSum() const { return m_check_sum; }
+
+    unsigned GetNameIndexFromEdgeID(const unsigned id) const {
+        if( m_use_container ) {
+            return m_packed_edge_list.at(id).GetNameID();
+        }
+        return m_original_edge_list.at(id).nameID;
+    };
+
+    NameView GetEscapedName(const unsigned name_id) const {
+        return m_name_store.GetName(name_id);
+    }
+
+    std::string GetTimestamp() const {
+        return m_timestamp;
+    }
+
+    void GetDataRegions(std::vector<DataRegion> & regions) const {
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::RTREE_NODES, m_static_rtree->GetSearchTree())
+        );
+        if( m_static_point_index ) {
+            regions.push_back(
+                DataRegion::FromVector(
+                    DataRegion::POINT_INDEX,
+                    m_static_point_index->GetTreePoints()
+                )
+            );
+        }
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_NODES, m_query_graph->GetNodeArray())
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_NODES, m_node_length_list)
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_EDGES, m_query_graph->GetEdgeArray())
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_EDGES, m_edge_length_list)
+        );
+        regions.push_back(
+            DataRegion::FromVector(
+                DataRegion::GRAPH_EDGES,
+                m_edge_restriction_count_list
+            )
+        );
+        if( m_use_container ) {
+            regions.push_back(
+                DataRegion::FromVector(DataRegion::COORDINATES, m_coordinate_list)
+            );
+            regions.push_back(
+                DataRegion::FromVector(DataRegion::ORIGINAL_EDGES, m_packed_edge_list)
+            );
+            regions.push_back(
+                DataRegion::FromVector(DataRegion::ORIGINAL_EDGES, m_geometry_zoom_list)
+            );
+        } else {
+            regions.push_back(
+                DataRegion::FromVector(DataRegion::COORDINATES, m_node_info_list)
+            );
+            regions.push_back(
+                DataRegion::FromVector(DataRegion::ORIGINAL_EDGES, m_original_edge_list)
+            );
+        }
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::NAMES, m_name_store.GetBlockList())
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::NAMES, m_name_store.GetCharList())
+        );
+    }
+};
+
+#endif  // MAPPED_DATA_FACADE_H
@@ -0,0 +1,286 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+//Keeps the complete replies of recent queries. Entries are keyed on the
+//parsed route parameters and the checksum of the data, so requests that only
+//differ in parameter order or number formatting share an entry and replies
+//computed on other data are never hit. The ETag of a reply is a hash of its
+//key. Besides the body, an entry keeps the gzip and deflate encodings once a
+//client asked for them. Like the CoordinateCache, the cache is split into
+//shards with a mutex and an LRU list each, every shard bounded by its share
+//of the byte budget.
+
+#include "RouteParameters.h"
+#include "../Http/Compression.h"
+#include "../Http/CompressionType.h"
+#include "../Http/Reply.h"
+
+#include <boost/assert.hpp>
+#include <boost/foreach.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/integer.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/unordered_map.hpp>
+
+#include <cstdio>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ResponseCache : boost::noncopyable {
+public:
+    class Entry : boost::noncopyable {
+    public:
+        //copies headers and body of a successful reply
+        Entry(const std::string & etag, const http::Reply & reply) :
+            etag(etag),
+            m_headers(reply.headers),
+            m_content(reply.content),
+            m_content_size(0)
+        {
+            BOOST_ASSERT(http::Reply::ok == reply.status);
+            BOOST_FOREACH(const std::string & line, m_content) {
+                m_content_size += line.size();
+            }
+        }
+
+        //fills in the reply in the encoding the client accepts, the body is
+        //compressed on first use of an encoding
+        void WriteReply(
+            const http::CompressionType compression_type,
+            http::Reply & reply
+        ) {
+            reply.status = http::Reply::ok;
+            reply.headers = m_headers;
+            http::Header etag_header;
+            etag_header.name = "ETag";
+            etag_header.value = etag;
+            reply.headers.push_back(etag_header);
+            if( http::noCompression == compression_type ) {
+                reply.content = m_content;
+                return;
+            }
+            reply.content.clear();
+            {
+                boost::mutex::scoped_lock lock(m_compression_mutex);
+                std::vector<char> & compressed_content =
+                    m_compressed_content[compression_type];
+                if( compressed_content.empty() ) {
+                    http::CompressBufferCollection(
+                        m_content,
+                        compression_type,
+                        compressed_content
+                    );
+                }
+                reply.compressed_content = compressed_content;
+            }
+            reply.content_encoding = compression_type;
+            http::Header compression_header;
+            compression_header.name = "Content-Encoding";
+            compression_header.value =
+                ( http::gzipRFC1952 == compression_type ? "gzip" : "deflate" );
+            reply.headers.insert(reply.headers.begin(), compression_header);
+            reply.setSize(reply.compressed_content.size());
+        }
+
+        //bytes charged against the budget, compressed bodies are smaller
+        //than the plain one and get the same amount again
+        uint64_t GetSize() const {
+            uint64_t size = sizeof(Entry) + etag.size() + 2*m_content_size;
+            BOOST_FOREACH(const http::Header & header, m_headers) {
+                size += header.name.size() + header.value.size();
+            }
+            return size;
+        }
+
+        const std::string etag;
+
+    private:
+        const std::vector<http::Header> m_headers;
+        const std::vector<std::string> m_content;
+        uint64_t m_content_size;
+        boost::mutex m_compression_mutex;
+        //indexed by compression type
+        std::vector<char> m_compressed_content[3];
+    };
+
+    typedef boost::shared_ptr<Entry> EntryPtr;
+
+    explicit ResponseCache(const uint64_t size_in_bytes) :
+        m_shard_capacity(size_in_bytes/NUMBER_OF_SHARDS)
+    { }
+
+    //all parameters that influence a reply, plus the data it was computed on
+    static std::string GetKey(
+        const RouteParameters & route_parameters,
+        const unsigned checksum
+    ) {
+        std::string key;
+        key.reserve(
+            64 + route_parameters.service.size() +
+            8*route_parameters.coordinates.size() +
+            32*route_parameters.hints.size()
+        );
+        AppendValue(key, checksum);
+        AppendString(key, route_parameters.service);
+        AppendString(key, route_parameters.outputFormat);
+        AppendString(key, route_parameters.jsonpParameter);
+        AppendString(key, route_parameters.language);
+        AppendValue(key, route_parameters.zoomLevel);
+        AppendValue(key, route_parameters.geometryPrecision);
+        const unsigned char flags =
+            ( route_parameters.printInstructions ? 0x01 : 0 ) |
+            ( route_parameters.alternateRoute    ? 0x02 : 0 ) |
+            ( route_parameters.geometry          ? 0x04 : 0 ) |
+            ( route_parameters.compression       ? 0x08 : 0 ) |
+            ( route_parameters.deprecatedAPI     ? 0x10 : 0 ) |
+            ( route_parameters.generalize        ? 0x20 : 0 );
+        AppendValue(key, flags);
+        AppendValue(key, route_parameters.checkSum);
+        AppendValue(key, unsigned(route_parameters.coordinates.size()));
+        BOOST_FOREACH(
+            const FixedPointCoordinate & coordinate,
+            route_parameters.coordinates
+        ) {
+            AppendValue(key, coordinate.lat);
+            AppendValue(key, coordinate.lon);
+        }
+        AppendValue(key, unsigned(route_parameters.hints.size()));
+        BOOST_FOREACH(const std::string & hint, route_parameters.hints) {
+            AppendString(key, hint);
+        }
+        return key;
+    }
+
+    //quoted 64 bit FNV-1a hash, the same on every server and platform
+    static std::string GetETag(const std::string & key) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        BOOST_FOREACH(const char c, key) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001B3ULL;
+        }
+        char etag[20];
+        std::snprintf(
+            etag,
+            sizeof(etag),
+            "\"%08x%08x\"",
+            static_cast<unsigned>(hash >> 32),
+            static_cast<unsigned>(hash)
+        );
+        return etag;
+    }
+
+    EntryPtr Fetch(const std::string & key) {
+        Shard & shard = GetShard(key);
+        boost::mutex::scoped_lock lock(shard.mutex);
+        const PositionMap::iterator position = shard.position_map.find(key);
+        if( shard.position_map.end() == position ) {
+            return EntryPtr();
+        }
+        //move to front, list iterators stay valid
+        shard.entry_list.splice(
+            shard.entry_list.begin(),
+            shard.entry_list,
+            position->second
+        );
+        return position->second->second;
+    }
+
+    void Insert(const std::string & key, const EntryPtr & entry) {
+        const uint64_t entry_size = entry->GetSize() + key.size();
+        //a few large replies would push out everything else
+        if( m_shard_capacity < 8*entry_size ) {
+            return;
+        }
+        Shard & shard = GetShard(key);
+        boost::mutex::scoped_lock lock(shard.mutex);
+        if( shard.position_map.end() != shard.position_map.find(key) ) {
+            return;
+        }
+        shard.entry_list.push_front(std::make_pair(key, entry));
+        shard.position_map.emplace(key, shard.entry_list.begin());
+        shard.size += entry_size;
+        while( shard.size > m_shard_capacity ) {
+            const CacheItem & last = shard.entry_list.back();
+            shard.size -= last.second->GetSize() + last.first.size();
+            shard.position_map.erase(last.first);
+            shard.entry_list.pop_back();
+        }
+    }
+
+    void Clear() {
+        for(unsigned i = 0; i < NUMBER_OF_SHARDS; ++i) {
+            boost::mutex::scoped_lock lock(m_shards[i].mutex);
+            m_shards[i].position_map.clear();
+            m_shards[i].entry_list.clear();
+            m_shards[i].size = 0;
+        }
+    }
+
+private:
+    static const unsigned NUMBER_OF_SHARDS = 16;
+
+    typedef std::pair<std::string, EntryPtr> CacheItem;
+    typedef boost::unordered_map<
+        std::string,
+        std::list<CacheItem>::iterator
+    > PositionMap;
+
+    struct Shard {
+        Shard() : size(0) {}
+        boost::mutex mutex;
+        std::list<CacheItem> entry_list;
+        PositionMap position_map;
+        uint64_t size;
+    };
+
+    template<typename T>
+    static inline void AppendValue(std::string & key, const T value) {
+        key.append(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    static inline void AppendString(std::string & key, const std::string & s) {
+        AppendValue(key, unsigned(s.size()));
+        key.append(s);
+    }
+
+    inline Shard & GetShard(const std::string & key) {
+        return m_shards[boost::hash<std::string>()(key) % NUMBER_OF_SHARDS];
+    }
+
+    const uint64_t m_shard_capacity;
+    Shard m_shards[NUMBER_OF_SHARDS];
+};
+
+#endif /* RESPONSE_CACHE_H */
@@ -41,17 +41,21 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 struct RouteParameters {
     RouteParameters() :
         zoomLevel(18),
+        geometryPrecision(6),
         printInstructions(false),
         alternateRoute(true),
         geometry(true),
         compression(true),
+        generalize(false),
         deprecatedAPI(false),
         checkSum(-1) {}
     short zoomLevel;
+    unsigned short geometryPrecision;
     bool printInstructions;
     bool alternateRoute;
     bool geometry;
     bool compression;
+    bool generalize;
     bool deprecatedAPI;
     unsigned checkSum;
     std::string service;
@@ -68,6 +72,12 @@ struct RouteParameters {
         }
     }
 
+    void setGeometryPrecision(const short i) {
+        if (5 == i || 6 == i) {
+            geometryPrecision = i;
+        }
+    }
+
     void setAlternateRouteFlag(const bool b) {
         alternateRoute = b;
     }
@@ -113,6 +123,10 @@ struct RouteParameters {
         compression = b;
     }
 
+    void setGeneralizeFlag(const bool b) {
+        generalize = b;
+    }
+
     void addCoordinate(const boost::fusion::vector < double, double > & arg_) {
         int lat = COORDINATE_PRECISION*boost::fusion::at_c < 0 > (arg_);
         int lon = COORDINATE_PRECISION*boost::fusion::at_c < 1 > (arg_);
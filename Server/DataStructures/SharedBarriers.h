@@ -1,40 +1,192 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef SHARED_BARRIERS_H
+#define SHARED_BARRIERS_H
+
+#include "SharedDataType.h"
+
+#include "../../Util/SimpleLogger.h"
+
+#include <boost/assert.hpp>
+#include <boost/atomic.hpp>
 #include <boost/interprocess/sync/named_mutex.hpp>
-#include <boost/interprocess/sync/named_condition.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
 
 struct SharedBarriers {
 
    SharedBarriers ()
     :
-      pending_update_mutex(
-         boost::interprocess::open_or_create,
-         "pending_update"
-      ),
       update_mutex(
          boost::interprocess::open_or_create,
          "update"
-      ),
-      query_mutex(
-         boost::interprocess::open_or_create,
-         "query"
-      ),
-      no_running_queries_condition(
-         boost::interprocess::open_or_create,
-         "no_running_queries"
-      ),
-      update_ongoing(false),
-      number_of_queries(0)
+      )
    { }
 
-   // Mutex to protect access to the boolean variable
-   boost::interprocess::named_mutex   pending_update_mutex;
+   // Serializes concurrent runs of osrm-datastore. Queries never take it.
    boost::interprocess::named_mutex   update_mutex;
-   boost::interprocess::named_mutex   query_mutex;
+};
+
+// Epoch based access to the data published in shared memory. A query pins
+// the generation it runs on with a single atomic increment of the reader
+// count of its data region and then checks that the generation is still the
+// current one. osrm-datastore publishes the next generation first and only
+// waits for the readers of the previous region before it frees that region.
+// Generation and regions are packed into one word, a reader can never see
+// the regions of one generation together with the number of another.
+class SharedDataGeneration : boost::noncopyable {
+public:
+    explicit SharedDataGeneration(SharedDataTimestamp * data_timestamp_ptr)
+     :
+        layout(LAYOUT_NONE),
+        data(DATA_NONE),
+        timestamp(0),
+        m_data_timestamp_ptr(data_timestamp_ptr),
+        m_is_pinned(false)
+    { }
+
+    ~SharedDataGeneration() {
+        Unpin();
+    }
+
+    void Pin() {
+        BOOST_ASSERT( !m_is_pinned );
+        for(;;) {
+            const uint32_t current_generation =
+                m_data_timestamp_ptr->current_generation.load();
+            timestamp = current_generation >> 1;
+            layout    = ( (current_generation & SECOND_REGIONS) ? LAYOUT_2 : LAYOUT_1 );
+            data      = ( (current_generation & SECOND_REGIONS) ? DATA_2 : DATA_1 );
+            m_slot    = GetReaderSlot(data);
+            ++(m_data_timestamp_ptr->number_of_readers[m_slot]);
+            if( current_generation == m_data_timestamp_ptr->current_generation.load() ) {
+                break;
+            }
+            //an update was published in between, retry on the new data
+            --(m_data_timestamp_ptr->number_of_readers[m_slot]);
+        }
+        m_is_pinned = true;
+    }
+
+    void Unpin() {
+        if( m_is_pinned ) {
+            --(m_data_timestamp_ptr->number_of_readers[m_slot]);
+            m_is_pinned = false;
+        }
+    }
+
+    static unsigned GetReaderSlot(const SharedDataType data) {
+        return ( DATA_2 == data ? 1 : 0 );
+    }
 
-   // Condition that no update is running
-   boost::interprocess::named_condition  no_running_queries_condition;
+    // Returns the data region of the current generation, the one a new
+    // generation must not be loaded into.
+    static SharedDataType GetCurrentData(
+        const SharedDataTimestamp * data_timestamp_ptr
+    ) {
+        return (
+            (data_timestamp_ptr->current_generation.load() & SECOND_REGIONS) ?
+            DATA_2 : DATA_1
+        );
+    }
 
-   // Is there an ongoing update?
-   bool update_ongoing;
-   // Is there any query?
-   int number_of_queries;
+    // Makes layout and data the current generation and returns true as soon
+    // as no query runs on the data of the previous generation anymore. If
+    // the readers of the previous data do not drain within the timeout, e.g.
+    // because a query process crashed while it held a pin, the previous
+    // data is published again under a new generation and false is returned.
+    // Only called with the update mutex held.
+    static bool Publish(
+        SharedDataTimestamp * data_timestamp_ptr,
+        const SharedDataType layout,
+        const SharedDataType data,
+        const unsigned timeout_in_seconds
+    ) {
+        BOOST_ASSERT(
+            ( LAYOUT_1 == layout && DATA_1 == data ) ||
+            ( LAYOUT_2 == layout && DATA_2 == data )
+        );
+        const uint32_t previous_generation =
+            data_timestamp_ptr->current_generation.load();
+        data_timestamp_ptr->current_generation.store(
+            ( ((previous_generation >> 1) + 1) << 1 ) |
+            ( DATA_2 == data ? SECOND_REGIONS : 0 )
+        );
+
+        const unsigned previous_slot = 1-GetReaderSlot(data);
+        if( WaitForReaders(data_timestamp_ptr, previous_slot, timeout_in_seconds) ) {
+            return true;
+        }
+        // roll back, queries that already pinned the new data keep it
+        data_timestamp_ptr->current_generation.store(
+            ( ((previous_generation >> 1) + 2) << 1 ) |
+            ( previous_generation & SECOND_REGIONS )
+        );
+        return false;
+    }
+
+    // Returns true once no query runs on the data of the given reader slot
+    // and false if there are still some after the timeout.
+    static bool WaitForReaders(
+        const SharedDataTimestamp * data_timestamp_ptr,
+        const unsigned slot,
+        const unsigned timeout_in_seconds
+    ) {
+        const boost::posix_time::ptime deadline =
+            boost::posix_time::microsec_clock::universal_time() +
+            boost::posix_time::seconds(timeout_in_seconds);
+        unsigned number_of_waits = 0;
+        while( 0 < data_timestamp_ptr->number_of_readers[slot].load() ) {
+            if( deadline < boost::posix_time::microsec_clock::universal_time() ) {
+                return false;
+            }
+            if( 0 == (++number_of_waits % 1000) ) {
+                SimpleLogger().Write(logWARNING) <<
+                    "waiting for " <<
+                    data_timestamp_ptr->number_of_readers[slot].load() <<
+                    " queries on the previous data";
+            }
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+        return true;
+    }
+
+    SharedDataType layout;
+    SharedDataType data;
+    unsigned timestamp;
+
+private:
+    static const uint32_t SECOND_REGIONS = 1;
+
+    SharedDataTimestamp * m_data_timestamp_ptr;
+    unsigned m_slot;
+    bool m_is_pinned;
 };
+
+#endif //SHARED_BARRIERS_H
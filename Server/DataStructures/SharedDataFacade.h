@@ -30,13 +30,18 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 //implements all data storage when shared memory is _NOT_ used
 
+#include <boost/atomic.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
 
 #include "BaseDataFacade.h"
+#include "SharedBarriers.h"
 #include "SharedDataType.h"
 
 #include "../../DataStructures/StaticGraph.h"
+#include "../../DataStructures/StaticPointIndex.h"
 #include "../../DataStructures/StaticRTree.h"
 #include "../../Util/BoostFileSystemFix.h"
 #include "../../Util/ProgramOptions.h"
@@ -61,24 +66,28 @@ private:
     char                * shared_memory;
     SharedDataTimestamp * data_timestamp_ptr;
 
-    SharedDataType     CURRENT_LAYOUT;
-    SharedDataType     CURRENT_DATA;
-    unsigned           CURRENT_TIMESTAMP;
+    //generation the facade serves, UINT_MAX while it is reloaded
+    boost::atomic<unsigned> m_loaded_timestamp;
+    //queries of this process running on the loaded generation
+    boost::atomic<int>      m_number_of_readers;
+    boost::mutex            m_reload_mutex;
 
     unsigned                                m_check_sum;
     unsigned                                m_number_of_nodes;
     boost::shared_ptr<QueryGraph>           m_query_graph;
+    ShM<unsigned, true>::vector             m_node_length_list;
+    ShM<unsigned, true>::vector             m_edge_length_list;
+    ShM<unsigned char, true>::vector        m_edge_restriction_count_list;
     boost::shared_ptr<SharedMemory>         m_layout_memory;
     boost::shared_ptr<SharedMemory>         m_large_memory;
     std::string                             m_timestamp;
 
     ShM<FixedPointCoordinate, true>::vector m_coordinate_list;
-    ShM<NodeID, true>::vector               m_via_node_list;
-    ShM<unsigned, true>::vector             m_name_ID_list;
-    ShM<TurnInstruction, true>::vector      m_turn_instruction_list;
-    ShM<char, true>::vector                 m_names_char_list;
-    ShM<unsigned, true>::vector             m_name_begin_indices;
+    ShM<PackedOriginalEdgeData, true>::vector m_original_edge_list;
+    ShM<unsigned char, true>::vector        m_geometry_zoom_list;
+    NameStore<true>                         m_name_store;
     boost::shared_ptr<StaticRTree<RTreeLeaf, true> > m_static_rtree;
+    boost::shared_ptr<StaticPointIndex<true> >       m_static_point_index;
 
     // SharedDataFacade() { }
 
@@ -101,7 +110,24 @@ private:
         m_static_rtree = boost::make_shared<StaticRTree<RTreeLeaf, true> >(
             tree_ptr,
             data_layout->r_search_tree_size,
-            file_index_path
+            file_index_path,
+            data_layout->ram_index_file_offset
+        );
+    }
+
+    void LoadPointIndex() {
+        if( 0 == data_layout->point_index_size ) {
+            SimpleLogger().Write(logWARNING) <<
+                "no point index loaded, locate requests use the r-tree";
+            m_static_point_index.reset();
+            return;
+        }
+        PointIndexNode * point_index_ptr = (PointIndexNode *)(
+            shared_memory + data_layout->GetPointIndexOffset()
+        );
+        m_static_point_index = boost::make_shared<StaticPointIndex<true> >(
+            point_index_ptr,
+            data_layout->point_index_size
         );
     }
 
@@ -127,6 +153,32 @@ private:
             new QueryGraph(node_list, edge_list)
         );
 
+        unsigned * node_length_list_ptr = (unsigned *)(
+            shared_memory + data_layout->GetNodeLengthListOffset()
+        );
+        typename ShM<unsigned, true>::vector node_length_list(
+            node_length_list_ptr,
+            data_layout->node_length_list_size
+        );
+        m_node_length_list.swap(node_length_list);
+
+        unsigned * edge_length_list_ptr = (unsigned *)(
+            shared_memory + data_layout->GetEdgeLengthListOffset()
+        );
+        typename ShM<unsigned, true>::vector edge_length_list(
+            edge_length_list_ptr,
+            data_layout->edge_length_list_size
+        );
+        m_edge_length_list.swap(edge_length_list);
+
+        unsigned char * edge_restriction_count_list_ptr = (unsigned char *)(
+            shared_memory + data_layout->GetEdgeRestrictionCountListOffset()
+        );
+        typename ShM<unsigned char, true>::vector edge_restriction_count_list(
+            edge_restriction_count_list_ptr,
+            data_layout->edge_restriction_count_list_size
+        );
+        m_edge_restriction_count_list.swap(edge_restriction_count_list);
     }
 
     void LoadNodeAndEdgeInformation() {
@@ -140,45 +192,33 @@ private:
         );
         m_coordinate_list.swap( coordinate_list );
 
-        TurnInstruction * turn_instruction_list_ptr = (TurnInstruction *)(
-            shared_memory + data_layout->GetTurnInstructionListOffset()
-        );
-        typename ShM<TurnInstruction, true>::vector turn_instruction_list(
-            turn_instruction_list_ptr,
-            data_layout->turn_instruction_list_size
-        );
-        m_turn_instruction_list.swap(turn_instruction_list);
-
-        unsigned * name_id_list_ptr = (unsigned *)(
-            shared_memory + data_layout->GetNameIDListOffset()
+        PackedOriginalEdgeData * original_edge_list_ptr = (PackedOriginalEdgeData *)(
+            shared_memory + data_layout->GetOriginalEdgeListOffset()
         );
-        typename ShM<unsigned, true>::vector name_id_list(
-            name_id_list_ptr,
-            data_layout->name_id_list_size
+        typename ShM<PackedOriginalEdgeData, true>::vector original_edge_list(
+            original_edge_list_ptr,
+            data_layout->original_edge_list_size
         );
-        m_name_ID_list.swap(name_id_list);
-    }
+        m_original_edge_list.swap(original_edge_list);
 
-    void LoadViaNodeList() {
-        NodeID * via_node_list_ptr = (NodeID *)(
-            shared_memory + data_layout->GetViaNodeListOffset()
+        unsigned char * geometry_zoom_list_ptr = (unsigned char *)(
+            shared_memory + data_layout->GetGeometryZoomListOffset()
         );
-        typename ShM<NodeID, true>::vector via_node_list(
-            via_node_list_ptr,
-            data_layout->via_node_list_size
+        typename ShM<unsigned char, true>::vector geometry_zoom_list(
+            geometry_zoom_list_ptr,
+            data_layout->geometry_zoom_list_size
         );
-        m_via_node_list.swap(via_node_list);
+        m_geometry_zoom_list.swap(geometry_zoom_list);
     }
 
     void LoadNames() {
-        unsigned * street_names_index_ptr = (unsigned *)(
-            shared_memory + data_layout->GetNameIndexOffset()
+        NameBlock * name_block_list_ptr = (NameBlock *)(
+            shared_memory + data_layout->GetNameBlockOffset()
         );
-        typename ShM<unsigned, true>::vector name_begin_indices(
-            street_names_index_ptr,
-            data_layout->name_index_list_size
+        typename ShM<NameBlock, true>::vector name_block_list(
+            name_block_list_ptr,
+            data_layout->name_block_list_size
         );
-        m_name_begin_indices.swap(name_begin_indices);
 
         char * names_list_ptr = (char *)(
             shared_memory + data_layout->GetNameListOffset()
@@ -187,69 +227,107 @@ private:
             names_list_ptr,
             data_layout->name_char_list_size
         );
-        m_names_char_list.swap(names_char_list);
+        m_name_store.Swap(name_block_list, names_char_list);
     }
 
-public:
-    SharedDataFacade( ) {
-        data_timestamp_ptr = (SharedDataTimestamp *)SharedMemoryFactory::Get(
-            CURRENT_REGIONS,
-            sizeof(SharedDataTimestamp),
-            false,
-            false
-        )->Ptr();
+    void LoadData(const SharedDataGeneration & generation) {
+        m_layout_memory.reset( SharedMemoryFactory::Get(generation.layout) );
 
-        CURRENT_LAYOUT = LAYOUT_NONE;
-        CURRENT_DATA = DATA_NONE;
-        CURRENT_TIMESTAMP = 0;
+        data_layout = (SharedDataLayout *)(
+            m_layout_memory->Ptr()
+        );
+        boost::filesystem::path ram_index_path(data_layout->ram_index_file_name);
+        if( !boost::filesystem::exists(ram_index_path) ) {
+            throw OSRMException(
+                "no leaf index file given. "
+                "Is any data loaded into shared memory?"
+            );
+        }
 
-        //load data
-        CheckAndReloadFacade();
-    }
+        m_large_memory.reset( SharedMemoryFactory::Get(generation.data) );
+        shared_memory = (char *)(
+            m_large_memory->Ptr()
+        );
+        m_check_sum = data_layout->checksum;
 
-    void CheckAndReloadFacade() {
-        if(
-            CURRENT_LAYOUT    != data_timestamp_ptr->layout    ||
-            CURRENT_DATA      != data_timestamp_ptr->data      ||
-            CURRENT_TIMESTAMP != data_timestamp_ptr->timestamp
-        ) {
-            // release the previous shared memory segments
-            SharedMemory::Remove(CURRENT_LAYOUT);
-            SharedMemory::Remove(CURRENT_DATA);
+        LoadGraph();
+        LoadNodeAndEdgeInformation();
+        LoadRTree(ram_index_path);
+        LoadPointIndex();
+        LoadTimestamp();
+        LoadNames();
 
-            CURRENT_LAYOUT    = data_timestamp_ptr->layout;
-            CURRENT_DATA      = data_timestamp_ptr->data;
-            CURRENT_TIMESTAMP = data_timestamp_ptr->timestamp;
+        data_layout->PrintInformation();
+    }
 
-            m_layout_memory.reset( SharedMemoryFactory::Get(CURRENT_LAYOUT) );
+    // Switches the facade to the current generation once all queries of
+    // this process that still run on the loaded one have finished.
+    void ReloadFacade() {
+        boost::mutex::scoped_lock reload_lock(m_reload_mutex);
+        SharedDataGeneration generation(data_timestamp_ptr);
+        generation.Pin();
+        if( generation.timestamp == m_loaded_timestamp.load() ) {
+            return;
+        }
+        m_loaded_timestamp = UINT_MAX;
+        while( 0 < m_number_of_readers.load() ) {
+            boost::this_thread::yield();
+        }
+        LoadData(generation);
+        m_loaded_timestamp = generation.timestamp;
+    }
 
-            data_layout = (SharedDataLayout *)(
-                m_layout_memory->Ptr()
-            );
-            boost::filesystem::path ram_index_path(data_layout->ram_index_file_name);
-            if( !boost::filesystem::exists(ram_index_path) ) {
-                throw OSRMException(
-                    "no leaf index file given. "
-                    "Is any data loaded into shared memory?"
-                );
+    // Pins the current generation and registers the calling query on this
+    // facade, reloading it first if the facade is behind.
+    void AcquireData(SharedDataGeneration & generation) {
+        for(;;) {
+            generation.Pin();
+            ++m_number_of_readers;
+            if( generation.timestamp == m_loaded_timestamp.load() ) {
+                return;
             }
+            --m_number_of_readers;
+            generation.Unpin();
+            ReloadFacade();
+        }
+    }
 
-            m_large_memory.reset( SharedMemoryFactory::Get(CURRENT_DATA) );
-            shared_memory = (char *)(
-                m_large_memory->Ptr()
-            );
-
-            LoadGraph();
-            LoadNodeAndEdgeInformation();
-            LoadRTree(ram_index_path);
-            LoadTimestamp();
-            LoadViaNodeList();
-            LoadNames();
+public:
+    // Keeps the data a query runs on alive until the query has finished.
+    // Taking it costs two atomic increments unless the data was updated.
+    class Reader : boost::noncopyable {
+    public:
+        explicit Reader(SharedDataFacade & facade)
+         :
+            m_facade(facade),
+            m_generation(facade.data_timestamp_ptr)
+        {
+            m_facade.AcquireData(m_generation);
+        }
 
-            data_layout->PrintInformation();
+        ~Reader() {
+            --(m_facade.m_number_of_readers);
         }
-    }
 
+    private:
+        SharedDataFacade & m_facade;
+        SharedDataGeneration m_generation;
+    };
+
+    SharedDataFacade( ) :
+        m_loaded_timestamp(UINT_MAX),
+        m_number_of_readers(0)
+    {
+        data_timestamp_ptr = (SharedDataTimestamp *)SharedMemoryFactory::Get(
+            CURRENT_REGIONS,
+            sizeof(SharedDataTimestamp),
+            false,
+            false
+        )->Ptr();
+
+        //load data
+        ReloadFacade();
+    }
 
     //search graph access
     unsigned GetNumberOfNodes() const {
@@ -267,14 +345,10 @@ public:
     NodeID GetTarget( const EdgeID e ) const {
         return m_query_graph->GetTarget(e); }
 
-    EdgeDataT &GetEdgeData( const EdgeID e ) {
+    const EdgeDataT &GetEdgeData( const EdgeID e ) const {
         return m_query_graph->GetEdgeData(e);
     }
 
-    // const EdgeDataT &GetEdgeData( const EdgeID e ) const {
-    //     return m_query_graph->GetEdgeData(e);
-    // }
-
     EdgeID BeginEdges( const NodeID n ) const {
         return m_query_graph->BeginEdges(n);
     }
@@ -303,18 +377,36 @@ public:
         return m_query_graph->FindEdgeIndicateIfReverse(from, to, result);
     }
 
+    unsigned GetLengthOfNode( const NodeID n ) const {
+        return m_node_length_list.at(n);
+    }
+
+    unsigned GetLengthOfEdge( const EdgeID e ) const {
+        return m_edge_length_list.at(e);
+    }
+
+    unsigned GetRestrictionCountOfEdge( const EdgeID e ) const {
+        return m_edge_restriction_count_list.at(e);
+    }
+
     //node and edge information access
     FixedPointCoordinate GetCoordinateOfNode(
         const unsigned id
     ) const {
-        const NodeID node = m_via_node_list.at(id);
+        const NodeID node = m_original_edge_list.at(id).GetViaNode();
         return m_coordinate_list.at(node);
     };
 
     TurnInstruction GetTurnInstructionForEdgeID(
         const unsigned id
     ) const {
-        return m_turn_instruction_list.at(id);
+        return m_original_edge_list.at(id).GetTurnInstruction();
+    }
+
+    unsigned char GetMinZoomLevelForEdgeID(
+        const unsigned id
+    ) const {
+        return m_geometry_zoom_list.at(id);
     }
 
     bool LocateClosestEndPointForCoordinate(
@@ -322,6 +414,13 @@ public:
         FixedPointCoordinate& result,
         const unsigned zoom_level = 18
     ) const {
+        //the point index holds no tiny component information
+        if( m_static_point_index && 14 < zoom_level ) {
+            return m_static_point_index->LocateClosestPoint(
+                input_coordinate,
+                result
+            );
+        }
         return  m_static_rtree->LocateClosestEndPointForCoordinate(
                     input_coordinate,
                     result,
@@ -341,44 +440,77 @@ public:
                 );
     }
 
+    void FindPhantomNodesForCoordinates(
+        const std::vector<FixedPointCoordinate> & input_coordinates,
+        std::vector<PhantomNode> & resulting_phantom_nodes,
+        const unsigned zoom_level
+    ) const {
+        m_static_rtree->FindPhantomNodesForCoordinates(
+            input_coordinates,
+            resulting_phantom_nodes,
+            zoom_level
+        );
+    }
+
     unsigned GetCheckSum() const { return m_check_sum; }
 
     unsigned GetNameIndexFromEdgeID(const unsigned id) const {
-        return m_name_ID_list.at(id);
+        return m_original_edge_list.at(id).GetNameID();
     };
 
-    void GetName( const unsigned name_id, std::string & result ) const {
-        if(UINT_MAX == name_id) {
-            result = "";
-            return;
+    NameView GetEscapedName(const unsigned name_id) const {
+        return m_name_store.GetName(name_id);
+    }
+
+    std::string GetTimestamp() const {
+        return m_timestamp;
+    }
+
+    void GetDataRegions(std::vector<DataRegion> & regions) const {
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::RTREE_NODES, m_static_rtree->GetSearchTree())
+        );
+        if( m_static_point_index ) {
+            regions.push_back(
+                DataRegion::FromVector(
+                    DataRegion::POINT_INDEX,
+                    m_static_point_index->GetTreePoints()
+                )
+            );
         }
-        BOOST_ASSERT_MSG(
-            name_id < m_name_begin_indices.size(),
-            "name id too high"
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_NODES, m_query_graph->GetNodeArray())
         );
-        unsigned begin_index = m_name_begin_indices[name_id];
-        unsigned end_index = m_name_begin_indices[name_id+1];
-        BOOST_ASSERT_MSG(
-            begin_index < m_names_char_list.size(),
-            "begin index of name too high"
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_NODES, m_node_length_list)
         );
-        BOOST_ASSERT_MSG(
-            end_index < m_names_char_list.size(),
-            "end index of name too high"
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_EDGES, m_query_graph->GetEdgeArray())
         );
-
-        BOOST_ASSERT_MSG(begin_index <= end_index, "string ends before begin");
-        result.clear();
-        result.resize(end_index - begin_index);
-        std::copy(
-            m_names_char_list.begin() + begin_index,
-            m_names_char_list.begin() + end_index,
-            result.begin()
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::GRAPH_EDGES, m_edge_length_list)
+        );
+        regions.push_back(
+            DataRegion::FromVector(
+                DataRegion::GRAPH_EDGES,
+                m_edge_restriction_count_list
+            )
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::COORDINATES, m_coordinate_list)
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::ORIGINAL_EDGES, m_original_edge_list)
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::ORIGINAL_EDGES, m_geometry_zoom_list)
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::NAMES, m_name_store.GetBlockList())
+        );
+        regions.push_back(
+            DataRegion::FromVector(DataRegion::NAMES, m_name_store.GetCharList())
         );
-    }
-
-    std::string GetTimestamp() const {
-        return m_timestamp;
     }
 };
 
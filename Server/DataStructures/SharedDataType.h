@@ -32,180 +32,248 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "BaseDataFacade.h"
 
 #include "../../DataStructures/Coordinate.h"
+#include "../../DataStructures/NameStore.h"
 #include "../../DataStructures/QueryEdge.h"
 #include "../../DataStructures/StaticGraph.h"
+#include "../../DataStructures/StaticPointIndex.h"
 #include "../../DataStructures/StaticRTree.h"
 #include "../../DataStructures/TurnInstructions.h"
 
 #include "../../typedefs.h"
 
+#include <boost/atomic.hpp>
 #include <boost/integer.hpp>
 
 typedef BaseDataFacade<QueryEdge::EdgeData>::RTreeLeaf RTreeLeaf;
 typedef StaticRTree<RTreeLeaf, true>::TreeNode RTreeNode;
+typedef StaticPointIndex<true>::PointT PointIndexNode;
 typedef StaticGraph<QueryEdge::EdgeData> QueryGraph;
 
 struct SharedDataLayout {
-    uint64_t name_index_list_size;
+    uint64_t name_block_list_size;
     uint64_t name_char_list_size;
-    uint64_t name_id_list_size;
-    uint64_t via_node_list_size;
+    uint64_t original_edge_list_size;
     uint64_t graph_node_list_size;
     uint64_t graph_edge_list_size;
     uint64_t coordinate_list_size;
-    uint64_t turn_instruction_list_size;
     uint64_t r_search_tree_size;
+    uint64_t point_index_size;
+    uint64_t node_length_list_size;
+    uint64_t edge_length_list_size;
+    uint64_t geometry_zoom_list_size;
+    uint64_t edge_restriction_count_list_size;
 
     unsigned checksum;
     unsigned timestamp_length;
 
     char ram_index_file_name[1024];
+    //position of the r-tree leaves inside ram_index_file_name
+    uint64_t ram_index_file_offset;
 
     SharedDataLayout() :
-        name_index_list_size(0),
+        name_block_list_size(0),
         name_char_list_size(0),
-        name_id_list_size(0),
-        via_node_list_size(0),
+        original_edge_list_size(0),
         graph_node_list_size(0),
         graph_edge_list_size(0),
         coordinate_list_size(0),
-        turn_instruction_list_size(0),
         r_search_tree_size(0),
+        point_index_size(0),
+        node_length_list_size(0),
+        edge_length_list_size(0),
+        geometry_zoom_list_size(0),
+        edge_restriction_count_list_size(0),
         checksum(0),
-        timestamp_length(0)
+        timestamp_length(0),
+        ram_index_file_offset(0)
     {
         ram_index_file_name[0] = '\0';
     }
 
     void PrintInformation() const {
         SimpleLogger().Write(logDEBUG) << "-";
-        SimpleLogger().Write(logDEBUG) << "name_index_list_size:       " << name_index_list_size;
+        SimpleLogger().Write(logDEBUG) << "name_block_list_size:       " << name_block_list_size;
         SimpleLogger().Write(logDEBUG) << "name_char_list_size:        " << name_char_list_size;
-        SimpleLogger().Write(logDEBUG) << "name_id_list_size:          " << name_id_list_size;
-        SimpleLogger().Write(logDEBUG) << "via_node_list_size:         " << via_node_list_size;
+        SimpleLogger().Write(logDEBUG) << "original_edge_list_size:    " << original_edge_list_size;
         SimpleLogger().Write(logDEBUG) << "graph_node_list_size:       " << graph_node_list_size;
         SimpleLogger().Write(logDEBUG) << "graph_edge_list_size:       " << graph_edge_list_size;
         SimpleLogger().Write(logDEBUG) << "timestamp_length:           " << timestamp_length;
         SimpleLogger().Write(logDEBUG) << "coordinate_list_size:       " << coordinate_list_size;
-        SimpleLogger().Write(logDEBUG) << "turn_instruction_list_size: " << turn_instruction_list_size;
         SimpleLogger().Write(logDEBUG) << "r_search_tree_size:         " << r_search_tree_size;
+        SimpleLogger().Write(logDEBUG) << "point_index_size:           " << point_index_size;
+        SimpleLogger().Write(logDEBUG) << "node_length_list_size:      " << node_length_list_size;
+        SimpleLogger().Write(logDEBUG) << "edge_length_list_size:      " << edge_length_list_size;
+        SimpleLogger().Write(logDEBUG) << "geometry_zoom_list_size:    " << geometry_zoom_list_size;
+        SimpleLogger().Write(logDEBUG) << "edge_restriction_count_list_size: " << edge_restriction_count_list_size;
         SimpleLogger().Write(logDEBUG) << "sizeof(checksum):           " << sizeof(checksum);
         SimpleLogger().Write(logDEBUG) << "ram index file name:        " << ram_index_file_name;
+        SimpleLogger().Write(logDEBUG) << "ram index file offset:      " << ram_index_file_offset;
     }
 
     uint64_t GetSizeOfLayout() const {
         uint64_t result =
-            (name_index_list_size       * sizeof(unsigned)            ) +
+            (name_block_list_size       * sizeof(NameBlock)           ) +
             (name_char_list_size        * sizeof(char)                ) +
-            (name_id_list_size          * sizeof(unsigned)            ) +
-            (via_node_list_size         * sizeof(NodeID)              ) +
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData)) +
             (graph_node_list_size       * sizeof(QueryGraph::_StrNode)) +
             (graph_edge_list_size       * sizeof(QueryGraph::_StrEdge)) +
             (timestamp_length           * sizeof(char)                ) +
             (coordinate_list_size       * sizeof(FixedPointCoordinate)) +
-            (turn_instruction_list_size * sizeof(TurnInstructions)    ) +
             (r_search_tree_size         * sizeof(RTreeNode)           ) +
+            (point_index_size           * sizeof(PointIndexNode)      ) +
+            (node_length_list_size      * sizeof(unsigned)            ) +
+            (edge_length_list_size      * sizeof(unsigned)            ) +
+            (geometry_zoom_list_size    * sizeof(unsigned char)       ) +
+            (edge_restriction_count_list_size * sizeof(unsigned char) ) +
             sizeof(checksum)                                            +
             1024*sizeof(char);
         return result;
     }
 
-    uint64_t GetNameIndexOffset() const {
+    uint64_t GetNameBlockOffset() const {
         return 0;
     }
     uint64_t GetNameListOffset() const {
         uint64_t result =
-            (name_index_list_size       * sizeof(unsigned)            );
+            (name_block_list_size       * sizeof(NameBlock)           );
         return result;
     }
-    uint64_t GetNameIDListOffset() const {
+    uint64_t GetOriginalEdgeListOffset() const {
         uint64_t result =
-            (name_index_list_size       * sizeof(unsigned)            ) +
+            (name_block_list_size       * sizeof(NameBlock)           ) +
             (name_char_list_size        * sizeof(char)                );
         return result;
     }
-    uint64_t GetViaNodeListOffset() const {
-        uint64_t result =
-            (name_index_list_size       * sizeof(unsigned)            ) +
-            (name_char_list_size        * sizeof(char)                ) +
-            (name_id_list_size          * sizeof(unsigned)            );
-        return result;
-    }
     uint64_t GetGraphNodeListOffset() const {
         uint64_t result =
-            (name_index_list_size       * sizeof(unsigned)            ) +
+            (name_block_list_size       * sizeof(NameBlock)           ) +
             (name_char_list_size        * sizeof(char)                ) +
-            (name_id_list_size          * sizeof(unsigned)            ) +
-            (via_node_list_size         * sizeof(NodeID)              );
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData));
         return result;
     }
     uint64_t GetGraphEdgeListOffsett() const {
         uint64_t result =
-            (name_index_list_size           * sizeof(unsigned)            ) +
-            (name_char_list_size            * sizeof(char)                ) +
-            (name_id_list_size          * sizeof(unsigned)            ) +
-            (via_node_list_size         * sizeof(NodeID)              ) +
-            (graph_node_list_size       * sizeof(QueryGraph::_StrNode)) ;
+            (name_block_list_size       * sizeof(NameBlock)           ) +
+            (name_char_list_size        * sizeof(char)                ) +
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData)) +
+            (graph_node_list_size       * sizeof(QueryGraph::_StrNode));
         return result;
     }
     uint64_t GetTimeStampOffset() const {
         uint64_t result =
-            (name_index_list_size       * sizeof(unsigned)            ) +
+            (name_block_list_size       * sizeof(NameBlock)           ) +
             (name_char_list_size        * sizeof(char)                ) +
-            (name_id_list_size          * sizeof(unsigned)            ) +
-            (via_node_list_size         * sizeof(NodeID)              ) +
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData)) +
             (graph_node_list_size       * sizeof(QueryGraph::_StrNode)) +
             (graph_edge_list_size       * sizeof(QueryGraph::_StrEdge));
         return result;
     }
     uint64_t GetCoordinateListOffset() const {
         uint64_t result =
-            (name_index_list_size       * sizeof(unsigned)            ) +
+            (name_block_list_size       * sizeof(NameBlock)           ) +
             (name_char_list_size        * sizeof(char)                ) +
-            (name_id_list_size          * sizeof(unsigned)            ) +
-            (via_node_list_size         * sizeof(NodeID)              ) +
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData)) +
             (graph_node_list_size       * sizeof(QueryGraph::_StrNode)) +
             (graph_edge_list_size       * sizeof(QueryGraph::_StrEdge)) +
             (timestamp_length           * sizeof(char)                );
         return result;
     }
-    uint64_t GetTurnInstructionListOffset() const {
+    uint64_t GetRSearchTreeOffset() const {
         uint64_t result =
-            (name_index_list_size       * sizeof(unsigned)            ) +
+            (name_block_list_size       * sizeof(NameBlock)           ) +
             (name_char_list_size        * sizeof(char)                ) +
-            (name_id_list_size          * sizeof(unsigned)            ) +
-            (via_node_list_size         * sizeof(NodeID)              ) +
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData)) +
             (graph_node_list_size       * sizeof(QueryGraph::_StrNode)) +
             (graph_edge_list_size       * sizeof(QueryGraph::_StrEdge)) +
             (timestamp_length           * sizeof(char)                ) +
             (coordinate_list_size       * sizeof(FixedPointCoordinate));
         return result;
     }
-    uint64_t GetRSearchTreeOffset() const {
+    uint64_t GetPointIndexOffset() const {
+        uint64_t result =
+            (name_block_list_size       * sizeof(NameBlock)           ) +
+            (name_char_list_size        * sizeof(char)                ) +
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData)) +
+            (graph_node_list_size       * sizeof(QueryGraph::_StrNode)) +
+            (graph_edge_list_size       * sizeof(QueryGraph::_StrEdge)) +
+            (timestamp_length           * sizeof(char)                ) +
+            (coordinate_list_size       * sizeof(FixedPointCoordinate)) +
+            (r_search_tree_size         * sizeof(RTreeNode)           );
+        return result;
+    }
+    uint64_t GetNodeLengthListOffset() const {
+        uint64_t result =
+            (name_block_list_size       * sizeof(NameBlock)           ) +
+            (name_char_list_size        * sizeof(char)                ) +
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData)) +
+            (graph_node_list_size       * sizeof(QueryGraph::_StrNode)) +
+            (graph_edge_list_size       * sizeof(QueryGraph::_StrEdge)) +
+            (timestamp_length           * sizeof(char)                ) +
+            (coordinate_list_size       * sizeof(FixedPointCoordinate)) +
+            (r_search_tree_size         * sizeof(RTreeNode)           ) +
+            (point_index_size           * sizeof(PointIndexNode)      );
+        return result;
+    }
+    uint64_t GetEdgeLengthListOffset() const {
+        uint64_t result =
+            (name_block_list_size       * sizeof(NameBlock)           ) +
+            (name_char_list_size        * sizeof(char)                ) +
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData)) +
+            (graph_node_list_size       * sizeof(QueryGraph::_StrNode)) +
+            (graph_edge_list_size       * sizeof(QueryGraph::_StrEdge)) +
+            (timestamp_length           * sizeof(char)                ) +
+            (coordinate_list_size       * sizeof(FixedPointCoordinate)) +
+            (r_search_tree_size         * sizeof(RTreeNode)           ) +
+            (point_index_size           * sizeof(PointIndexNode)      ) +
+            (node_length_list_size      * sizeof(unsigned)            );
+        return result;
+    }
+    uint64_t GetGeometryZoomListOffset() const {
         uint64_t result =
-            (name_index_list_size       * sizeof(unsigned)            ) +
+            (name_block_list_size       * sizeof(NameBlock)           ) +
             (name_char_list_size        * sizeof(char)                ) +
-            (name_id_list_size          * sizeof(unsigned)            ) +
-            (via_node_list_size         * sizeof(NodeID)              ) +
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData)) +
             (graph_node_list_size       * sizeof(QueryGraph::_StrNode)) +
             (graph_edge_list_size       * sizeof(QueryGraph::_StrEdge)) +
             (timestamp_length           * sizeof(char)                ) +
             (coordinate_list_size       * sizeof(FixedPointCoordinate)) +
-            (turn_instruction_list_size * sizeof(TurnInstructions)    );
+            (r_search_tree_size         * sizeof(RTreeNode)           ) +
+            (point_index_size           * sizeof(PointIndexNode)      ) +
+            (node_length_list_size      * sizeof(unsigned)            ) +
+            (edge_length_list_size      * sizeof(unsigned)            );
+        return result;
+    }
+    uint64_t GetEdgeRestrictionCountListOffset() const {
+        uint64_t result =
+            (name_block_list_size       * sizeof(NameBlock)           ) +
+            (name_char_list_size        * sizeof(char)                ) +
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData)) +
+            (graph_node_list_size       * sizeof(QueryGraph::_StrNode)) +
+            (graph_edge_list_size       * sizeof(QueryGraph::_StrEdge)) +
+            (timestamp_length           * sizeof(char)                ) +
+            (coordinate_list_size       * sizeof(FixedPointCoordinate)) +
+            (r_search_tree_size         * sizeof(RTreeNode)           ) +
+            (point_index_size           * sizeof(PointIndexNode)      ) +
+            (node_length_list_size      * sizeof(unsigned)            ) +
+            (edge_length_list_size      * sizeof(unsigned)            ) +
+            (geometry_zoom_list_size    * sizeof(unsigned char)       );
         return result;
     }
     uint64_t GetChecksumOffset() const {
         uint64_t result =
-            (name_index_list_size       * sizeof(unsigned)            ) +
+            (name_block_list_size       * sizeof(NameBlock)           ) +
             (name_char_list_size        * sizeof(char)                ) +
-            (name_id_list_size          * sizeof(unsigned)            ) +
-            (via_node_list_size         * sizeof(NodeID)              ) +
+            (original_edge_list_size    * sizeof(PackedOriginalEdgeData)) +
             (graph_node_list_size       * sizeof(QueryGraph::_StrNode)) +
             (graph_edge_list_size       * sizeof(QueryGraph::_StrEdge)) +
             (timestamp_length           * sizeof(char)                ) +
             (coordinate_list_size       * sizeof(FixedPointCoordinate)) +
-            (turn_instruction_list_size * sizeof(TurnInstructions)    ) +
-            (r_search_tree_size         * sizeof(RTreeNode)           );
+            (r_search_tree_size         * sizeof(RTreeNode)           ) +
+            (point_index_size           * sizeof(PointIndexNode)      ) +
+            (node_length_list_size      * sizeof(unsigned)            ) +
+            (edge_length_list_size      * sizeof(unsigned)            ) +
+            (geometry_zoom_list_size    * sizeof(unsigned char)       ) +
+            (edge_restriction_count_list_size * sizeof(unsigned char) );
         return result;
     }
 };
@@ -221,9 +289,12 @@ enum SharedDataType {
 };
 
 struct SharedDataTimestamp {
-    SharedDataType layout;
-    SharedDataType data;
-    unsigned timestamp;
+    //generation of the data in the upper bits and whether it lives in
+    //LAYOUT_2 and DATA_2 in the lowest bit, so that readers see both in a
+    //single load. See SharedDataGeneration.
+    boost::atomic<uint32_t> current_generation;
+    //queries currently running on DATA_1 and DATA_2, respectively
+    boost::atomic<int> number_of_readers[2];
 };
 
 #endif /* SHARED_DATA_TYPE_H_ */
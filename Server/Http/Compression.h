@@ -0,0 +1,76 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef HTTP_COMPRESSION_H
+#define HTTP_COMPRESSION_H
+
+#include "CompressionType.h"
+
+#include <boost/assert.hpp>
+#include <boost/foreach.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+
+#include <string>
+#include <vector>
+
+namespace http {
+
+inline void CompressBufferCollection(
+    const std::vector<std::string> & uncompressed_data,
+    const CompressionType compression_type,
+    std::vector<char> & compressed_data
+) {
+    BOOST_ASSERT( noCompression != compression_type );
+    boost::iostreams::gzip_params compression_parameters;
+
+    compression_parameters.level = boost::iostreams::zlib::best_speed;
+    if ( deflateRFC1951 == compression_type ) {
+        compression_parameters.noheader = true;
+    }
+
+    BOOST_ASSERT( compressed_data.empty() );
+    boost::iostreams::filtering_ostream compressing_stream;
+
+    compressing_stream.push(
+        boost::iostreams::gzip_compressor(compression_parameters)
+    );
+    compressing_stream.push(
+        boost::iostreams::back_inserter(compressed_data)
+    );
+
+    BOOST_FOREACH( const std::string & line, uncompressed_data) {
+        compressing_stream << line;
+    }
+
+    compressing_stream.reset();
+}
+
+} // namespace http
+
+#endif //HTTP_COMPRESSION_H
@@ -90,6 +90,7 @@ Reply Reply::StockReply(Reply::status_type status) {
 std::string Reply::ToString(Reply::status_type status) {
     switch (status) {
     case Reply::ok:
+    case Reply::notModified:
         return okHTML;
     case Reply::badRequest:
         return badRequestHTML;
@@ -102,6 +103,8 @@ boost::asio::const_buffer Reply::ToBuffer(Reply::status_type status) {
     switch (status) {
     case Reply::ok:
         return boost::asio::buffer(okString);
+    case Reply::notModified:
+        return boost::asio::buffer(notModifiedString);
     case Reply::internalServerError:
         return boost::asio::buffer(internalServerErrorString);
     default:
@@ -110,7 +113,7 @@ boost::asio::const_buffer Reply::ToBuffer(Reply::status_type status) {
 }
 
 
-Reply::Reply() : status(ok) {
+Reply::Reply() : status(ok), content_encoding(noCompression) {
 
 }
 
@@ -28,6 +28,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef REPLY_H
 #define REPLY_H
 
+#include "CompressionType.h"
 #include "Header.h"
 #include "../../Util/StringUtil.h"
 
@@ -44,6 +45,7 @@ const char internalServerErrorHTML[] = "<html><head><title>Internal Server Error
 const char seperators[]              = { ':', ' ' };
 const char crlf[]                    = { '\r', '\n' };
 const std::string okString = "HTTP/1.0 200 OK\r\n";
+const std::string notModifiedString = "HTTP/1.0 304 Not Modified\r\n";
 const std::string badRequestString = "HTTP/1.0 400 Bad Request\r\n";
 const std::string internalServerErrorString = "HTTP/1.0 500 Internal Server Error\r\n";
 
@@ -51,6 +53,7 @@ class Reply {
     public:
     enum status_type {
             ok                  = 200,
+            notModified         = 304,
             badRequest          = 400,
             internalServerError = 500
         } status;
@@ -60,6 +63,9 @@ class Reply {
         std::vector<boost::asio::const_buffer> toBuffers();
         std::vector<boost::asio::const_buffer> HeaderstoBuffers();
         std::vector<std::string> content;
+        //set if the body was compressed before, it is sent instead of content
+        CompressionType content_encoding;
+        std::vector<char> compressed_content;
         static Reply StockReply(status_type status);
         void setSize(const unsigned size);
         Reply();
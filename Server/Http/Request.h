@@ -28,6 +28,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef REQUEST_H
 #define REQUEST_H
 
+#include "CompressionType.h"
 #include "../../Util/StringUtil.h"
 
 #include <boost/asio.hpp>
@@ -37,9 +38,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 namespace http {
 
 struct Request {
+	Request() : compression_type(noCompression) { }
 	std::string uri;
 	std::string referrer;
 	std::string agent;
+	std::string if_none_match;
+	CompressionType compression_type;
 	boost::asio::ip::address endpoint;
 };
 
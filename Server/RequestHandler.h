@@ -103,7 +103,7 @@ public:
                     routing_machine != NULL,
                     "pointer not init'ed"
                 );
-                routing_machine->RunQuery(routeParameters, rep);
+                routing_machine->RunQuery(routeParameters, req, rep);
                 return;
             }
         } catch(std::exception& e) {
@@ -170,6 +170,7 @@ boost::tribool RequestParser::consume(
                 *compressionType = deflateRFC1951;
             if(header.value.find("gzip") != std::string::npos)
                 *compressionType = gzipRFC1952;
+            req.compression_type = *compressionType;
         }
 
         if("Referer" == header.name)
@@ -178,6 +179,9 @@ boost::tribool RequestParser::consume(
         if("User-Agent" == header.name)
             req.agent = header.value;
 
+        if("If-None-Match" == header.name)
+            req.if_none_match = header.value;
+
         if (input == '\r') {
             state_ = expecting_newline_3;
             return boost::indeterminate;
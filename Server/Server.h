@@ -31,6 +31,9 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Connection.h"
 #include "RequestHandler.h"
 
+#include "../Util/NUMATopology.h"
+#include "../Util/SimpleLogger.h"
+
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
 #include <boost/noncopyable.hpp>
@@ -44,9 +47,11 @@ public:
 	explicit Server(
 		const std::string& address,
 		const std::string& port,
-		unsigned thread_pool_size
+		unsigned thread_pool_size,
+		const bool bind_threads_to_numa_nodes = false
 	) :
 		threadPoolSize(thread_pool_size),
+		bindThreadsToNUMANodes(bind_threads_to_numa_nodes),
 		acceptor(ioService),
 		newConnection(new http::Connection(ioService, requestHandler)),
 		requestHandler()
@@ -71,8 +76,15 @@ public:
 
 	void Run() {
 		std::vector<boost::shared_ptr<boost::thread> > threads;
+		const unsigned number_of_nodes = NUMATopology::GetInstance().GetNumberOfNodes();
 		for (unsigned i = 0; i < threadPoolSize; ++i) {
-			boost::shared_ptr<boost::thread> thread(new boost::thread(boost::bind(&boost::asio::io_service::run, &ioService)));
+			boost::shared_ptr<boost::thread> thread;
+			if (bindThreadsToNUMANodes) {
+				//worker threads are spread round robin over the nodes
+				thread.reset(new boost::thread(boost::bind(&Server::runOnNode, this, i % number_of_nodes)));
+			} else {
+				thread.reset(new boost::thread(boost::bind(&boost::asio::io_service::run, &ioService)));
+			}
 			threads.push_back(thread);
 		}
 		for (unsigned i = 0; i < threads.size(); ++i)
@@ -88,6 +100,14 @@ public:
 	}
 
 private:
+	void runOnNode(const unsigned node) {
+		if (!NUMATopology::GetInstance().BindCurrentThreadToNode(node)) {
+			SimpleLogger().Write(logWARNING) <<
+				"could not bind worker thread to NUMA node " << node;
+		}
+		ioService.run();
+	}
+
 	void handleAccept(const boost::system::error_code& e) {
 		if (!e) {
 			newConnection->start();
@@ -106,6 +126,7 @@ private:
 	}
 
 	unsigned threadPoolSize;
+	bool bindThreadsToNUMANodes;
 	boost::asio::io_service ioService;
 	boost::asio::ip::tcp::acceptor acceptor;
 	boost::shared_ptr<http::Connection> newConnection;
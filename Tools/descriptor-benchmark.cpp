@@ -0,0 +1,614 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+//Measures how fast the JSON descriptor turns long synthetic routes into
+//replies, with and without geometry and turn instructions, and how fast the
+//polyline encoder alone is. Allocations are counted to show the heap traffic
+//of new descriptors compared to a reused one.
+//
+//Given an extract with the options of osrm-routed, it instead compares the
+//route geometry of random routes with the one of the former generalization,
+//which ran Douglas-Peucker over each route between its turns at query time.
+//
+//Either way it first checks that GetFastBearing gives the rounded bearings
+//and azimuths of GetBearing, on random segments around the globe and on the
+//segments of the routes. Any mismatch fails the benchmark.
+
+#include "../Algorithms/DouglasPeucker.h"
+#include "../Algorithms/PolylineCompressor.h"
+#include "../DataStructures/Coordinate.h"
+#include "../DataStructures/NameStore.h"
+#include "../DataStructures/PhantomNodes.h"
+#include "../DataStructures/QueryEdge.h"
+#include "../DataStructures/RawRouteData.h"
+#include "../DataStructures/SearchEngine.h"
+#include "../DataStructures/TurnInstructions.h"
+#include "../Descriptors/JSONDescriptor.h"
+#include "../Server/DataStructures/InternalDataFacade.h"
+#include "../Server/Http/Reply.h"
+#include "../Util/Azimuth.h"
+#include "../Util/GitDescription.h"
+#include "../Util/ProgramOptions.h"
+#include "../Util/SimpleLogger.h"
+#include "../Util/TimingUtil.h"
+
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <boost/random/uniform_real_distribution.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <iomanip>
+#include <new>
+#include <string>
+#include <vector>
+
+//heap traffic of the whole process, counted by the replaced operator new
+static uint64_t number_of_allocations = 0;
+static uint64_t number_of_allocated_bytes = 0;
+
+void * operator new(std::size_t size)
+#if __cplusplus < 201103L
+    throw(std::bad_alloc)
+#endif
+{
+    ++number_of_allocations;
+    number_of_allocated_bytes += size;
+    void * pointer = std::malloc(size ? size : 1);
+    if( NULL == pointer ) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void operator delete(void * pointer) throw() {
+    std::free(pointer);
+}
+
+//serves the few lookups the descriptor does from synthetic data
+class BenchmarkFacade {
+public:
+    explicit BenchmarkFacade(const unsigned number_of_nodes) {
+        boost::mt19937 generator(number_of_nodes);
+        boost::random::uniform_int_distribution<int> step_distribution(-300, 700);
+        FixedPointCoordinate coordinate(
+            52.5*COORDINATE_PRECISION,
+            13.4*COORDINATE_PRECISION
+        );
+        for(unsigned i = 0; i < number_of_nodes; ++i) {
+            coordinate.lat += step_distribution(generator);
+            coordinate.lon += step_distribution(generator);
+            m_coordinate_list.push_back(coordinate);
+        }
+        for(unsigned i = 0; i < 100; ++i) {
+            m_name_list.push_back("Stra&szlig;e " + boost::lexical_cast<std::string>(i));
+        }
+    }
+
+    FixedPointCoordinate GetCoordinateOfNode(const unsigned id) const {
+        return m_coordinate_list[id];
+    }
+
+    NameView GetEscapedName(const unsigned name_id) const {
+        if( m_name_list.size() <= name_id ) {
+            return NameView();
+        }
+        return NameView(
+            m_name_list[name_id].c_str(),
+            m_name_list[name_id].length()
+        );
+    }
+
+    std::string GetEscapedNameForNameID(const unsigned name_id) const {
+        const NameView name = GetEscapedName(name_id);
+        return std::string(name.begin(), name.end());
+    }
+
+    const std::vector<FixedPointCoordinate> & GetCoordinates() const {
+        return m_coordinate_list;
+    }
+
+private:
+    std::vector<FixedPointCoordinate> m_coordinate_list;
+    std::vector<std::string> m_name_list;
+};
+
+//one path along all nodes of the facade, turning every 40 nodes
+static void BuildRoute(const BenchmarkFacade & facade, RawRouteData & raw_route) {
+    const std::vector<FixedPointCoordinate> & coordinates = facade.GetCoordinates();
+    //zoom levels as osrm-prepare stores them for a single way
+    std::vector<unsigned char> min_zoom_levels;
+    DouglasPeucker().ComputeMinZoomLevels(coordinates, min_zoom_levels);
+    for(unsigned i = 1; i+1 < coordinates.size(); ++i) {
+        const unsigned name_id = (i/40) % 100;
+        const unsigned turn_instruction = (
+            0 == i % 40 ? TurnInstructionsClass::TurnRight : TurnInstructionsClass::NoTurn
+        );
+        raw_route.computedShortestPath.push_back(
+            _PathData(i, name_id, turn_instruction, 30, min_zoom_levels[i])
+        );
+    }
+    raw_route.computedAlternativePath = raw_route.computedShortestPath;
+
+    PhantomNodes phantom_nodes;
+    phantom_nodes.startPhantom.location = coordinates.front();
+    phantom_nodes.startPhantom.nodeBasedEdgeNameID = 0;
+    phantom_nodes.startPhantom.edgeBasedNode = 0;
+    phantom_nodes.startPhantom.weight1 = 10;
+    phantom_nodes.startPhantom.ratio = 0.5;
+    phantom_nodes.targetPhantom.location = coordinates.back();
+    phantom_nodes.targetPhantom.nodeBasedEdgeNameID = 1;
+    phantom_nodes.targetPhantom.edgeBasedNode = coordinates.size()-1;
+    phantom_nodes.targetPhantom.weight1 = 10;
+    phantom_nodes.targetPhantom.ratio = 0.5;
+    raw_route.segmentEndCoordinates.push_back(phantom_nodes);
+    raw_route.rawViaNodeCoordinates.push_back(coordinates.front());
+    raw_route.rawViaNodeCoordinates.push_back(coordinates.back());
+    raw_route.checkSum = 12345;
+    raw_route.lengthOfShortestPath = 30*coordinates.size();
+    raw_route.lengthOfAlternativePath = 31*coordinates.size();
+}
+
+static void RunBenchmark(
+    const unsigned number_of_nodes,
+    const std::string & label,
+    const DescriptorConfig & config,
+    const bool reuse_descriptor
+) {
+    const BenchmarkFacade facade(number_of_nodes);
+    RawRouteData raw_route;
+    BuildRoute(facade, raw_route);
+    PhantomNodes phantom_nodes = raw_route.segmentEndCoordinates.front();
+
+    const unsigned number_of_runs = std::max(5u, 2000000/number_of_nodes);
+    uint64_t number_of_bytes = 0;
+    uint64_t number_of_snippets = 0;
+    //the reused descriptor is warmed up like the one of a busy server thread
+    JSONDescriptor<BenchmarkFacade> reused_descriptor;
+    reused_descriptor.SetConfig(config);
+    {
+        http::Reply reply;
+        reused_descriptor.Run(reply, raw_route, phantom_nodes, &facade);
+    }
+    const uint64_t allocations_at_start = number_of_allocations;
+    const uint64_t allocated_bytes_at_start = number_of_allocated_bytes;
+    const double start_time = get_timestamp();
+    for(unsigned i = 0; i < number_of_runs; ++i) {
+        http::Reply reply;
+        if( reuse_descriptor ) {
+            reused_descriptor.Run(reply, raw_route, phantom_nodes, &facade);
+        } else {
+            JSONDescriptor<BenchmarkFacade> descriptor;
+            descriptor.SetConfig(config);
+            descriptor.Run(reply, raw_route, phantom_nodes, &facade);
+        }
+        number_of_snippets += reply.content.size();
+        BOOST_FOREACH(const std::string & snippet, reply.content) {
+            number_of_bytes += snippet.length();
+        }
+    }
+    const double duration = get_timestamp() - start_time;
+    const uint64_t allocations = number_of_allocations - allocations_at_start;
+    const uint64_t allocated_bytes =
+        number_of_allocated_bytes - allocated_bytes_at_start;
+    SimpleLogger().Write() <<
+        number_of_nodes << " nodes, " << label <<
+        ( reuse_descriptor ? ", reused descriptor: " : ", new descriptor: " ) <<
+        1000.*duration/number_of_runs << " ms per route, " <<
+        number_of_bytes/number_of_runs << " bytes in " <<
+        number_of_snippets/number_of_runs << " snippets, " <<
+        allocations/number_of_runs << " allocations of " <<
+        allocated_bytes/number_of_runs << " bytes";
+}
+
+static void RunPolylineBenchmark(
+    const unsigned number_of_nodes,
+    const unsigned precision
+) {
+    const BenchmarkFacade facade(number_of_nodes);
+    const std::vector<FixedPointCoordinate> & coordinates = facade.GetCoordinates();
+    const PolylineCompressor polyline_compressor;
+
+    const unsigned number_of_runs = std::max(5u, 20000000/number_of_nodes);
+    uint64_t number_of_bytes = 0;
+    std::string output;
+    const double start_time = get_timestamp();
+    for(unsigned i = 0; i < number_of_runs; ++i) {
+        output.clear();
+        polyline_compressor.printEncodedString(coordinates, output, precision);
+        number_of_bytes += output.length();
+    }
+    const double duration = get_timestamp() - start_time;
+    SimpleLogger().Write() <<
+        number_of_nodes << " nodes, polyline precision " << precision << ": " <<
+        1000000.*duration/number_of_runs << " us per route, " <<
+        number_of_bytes/number_of_runs << " bytes";
+}
+
+typedef InternalDataFacade<QueryEdge::EdgeData> ExtractFacade;
+typedef std::pair<FixedPointCoordinate, FixedPointCoordinate> Segment;
+
+static const unsigned NUMBER_OF_COMPARED_ROUTES = 2000;
+static const unsigned NUMBER_OF_RANDOM_SEGMENTS = 5000000;
+static const unsigned MAX_REPORTED_MISMATCHES = 10;
+
+//mismatches of the rounded bearings and the azimuths the descriptors write
+static unsigned CheckBearings(const std::vector<Segment> & segment_list) {
+    DescriptionFactory description_factory;
+    unsigned number_of_mismatches = 0;
+    BOOST_FOREACH(const Segment & segment, segment_list) {
+        const double fast_bearing =
+            description_factory.GetFastBearing(segment.first, segment.second);
+        const double bearing =
+            description_factory.GetBearing(segment.first, segment.second);
+        if(
+            int(round(fast_bearing)) == int(round(bearing)) &&
+            0 == std::strcmp(Azimuth::Get(fast_bearing), Azimuth::Get(bearing))
+        ) {
+            continue;
+        }
+        if( MAX_REPORTED_MISMATCHES > number_of_mismatches ) {
+            SimpleLogger().Write(logWARNING) << "bearing mismatch from " <<
+                segment.first << " to " << segment.second << ": " <<
+                std::setprecision(10) << fast_bearing << " instead of " <<
+                bearing;
+        }
+        ++number_of_mismatches;
+    }
+    SimpleLogger().Write() << number_of_mismatches << " bearing mismatches in " <<
+        segment_list.size() << " segments";
+    return number_of_mismatches;
+}
+
+//segments of 1 m to 100 km in all directions, also close to the poles, across
+//the antimeridian and a few units short
+static void GenerateRandomSegments(
+    const unsigned number_of_segments,
+    std::vector<Segment> & segment_list
+) {
+    boost::mt19937 generator(number_of_segments);
+    boost::random::uniform_real_distribution<double> distribution(0., 1.);
+    boost::random::uniform_int_distribution<int> short_delta(-10, 10);
+    const int MAX_LAT = 90*COORDINATE_PRECISION;
+    const int MAX_LON = 180*COORDINATE_PRECISION;
+    segment_list.resize(number_of_segments);
+    for(unsigned i = 0; i < number_of_segments; ++i) {
+        const double max_lat = ( 0 == i%10 ? 89.99 : 80. )*COORDINATE_PRECISION;
+        const int lat = int((2.*distribution(generator) - 1.)*max_lat);
+        int lon = int((2.*distribution(generator) - 1.)*MAX_LON);
+        if( 0 == i%7 ) {
+            lon = MAX_LON - int(5000*distribution(generator));
+            if( 0.5 > distribution(generator) ) {
+                lon = -lon;
+            }
+        }
+        //about 111 km per degree
+        const double length = std::pow(10., 5.*distribution(generator))/
+            111000.*COORDINATE_PRECISION;
+        const double angle = 2.*M_PI*distribution(generator);
+        const double cos_lat = std::max(
+            0.05,
+            std::cos(lat/COORDINATE_PRECISION*M_PI/180.)
+        );
+        int delta_lat = int(length*std::cos(angle));
+        int delta_lon = int(length*std::sin(angle)/cos_lat);
+        if( 0 == i%13 ) {
+            delta_lat = short_delta(generator);
+            delta_lon = short_delta(generator);
+        }
+        int lon2 = lon + delta_lon;
+        if( MAX_LON < lon2 ) {
+            lon2 -= 2*MAX_LON;
+        } else if( -MAX_LON > lon2 ) {
+            lon2 += 2*MAX_LON;
+        }
+        segment_list[i] = Segment(
+            FixedPointCoordinate(lat, lon),
+            FixedPointCoordinate(
+                std::max(-MAX_LAT, std::min(MAX_LAT, lat + delta_lat)),
+                lon2
+            )
+        );
+    }
+}
+
+static unsigned CheckBearingsOfRandomSegments() {
+    std::vector<Segment> segment_list;
+    GenerateRandomSegments(NUMBER_OF_RANDOM_SEGMENTS, segment_list);
+    SimpleLogger().Write() << "checking bearings of random segments";
+    return CheckBearings(segment_list);
+}
+
+//distance in meters of a point from a segment
+static double GetDistanceFromSegment(
+    const FixedPointCoordinate & point,
+    const FixedPointCoordinate & segment_begin,
+    const FixedPointCoordinate & segment_end
+) {
+    const double delta_lon = segment_end.lon - segment_begin.lon;
+    const double delta_lat = segment_end.lat - segment_begin.lat;
+    const double squared_length = delta_lon*delta_lon + delta_lat*delta_lat;
+    double ratio = ( 0. == squared_length ? 0. : (
+        (point.lon - segment_begin.lon)*delta_lon +
+        (point.lat - segment_begin.lat)*delta_lat
+    )/squared_length );
+    ratio = std::max(0., std::min(1., ratio));
+    const FixedPointCoordinate projection(
+        segment_begin.lat + ratio*delta_lat,
+        segment_begin.lon + ratio*delta_lon
+    );
+    return ApproximateEuclideanDistance(point, projection);
+}
+
+//largest distance of a point of the route from the kept polyline
+static double GetLargestDeviation(
+    const std::vector<SegmentInformation> & path,
+    const std::vector<bool> & is_kept
+) {
+    double largest_deviation = 0.;
+    unsigned left_border = 0;
+    for(unsigned right_border = 1; right_border < path.size(); ++right_border) {
+        if( !is_kept[right_border] ) {
+            continue;
+        }
+        for(unsigned i = left_border+1; i < right_border; ++i) {
+            largest_deviation = std::max(
+                largest_deviation,
+                GetDistanceFromSegment(
+                    path[i].location,
+                    path[left_border].location,
+                    path[right_border].location
+                )
+            );
+        }
+        left_border = right_border;
+    }
+    return largest_deviation;
+}
+
+//zoom levels the former generalization gave each point of a route, every
+//range between two necessary points was generalized on its own
+static void ComputeRouteZoomLevels(
+    const std::vector<SegmentInformation> & path,
+    std::vector<unsigned char> & route_zoom_levels
+) {
+    route_zoom_levels.assign(path.size(), 0);
+    std::vector<FixedPointCoordinate> range;
+    std::vector<unsigned char> range_zoom_levels;
+    unsigned left_border = 0;
+    for(unsigned right_border = 1; right_border < path.size(); ++right_border) {
+        if( !path[right_border].necessary ) {
+            continue;
+        }
+        range.clear();
+        for(unsigned i = left_border; i <= right_border; ++i) {
+            range.push_back(path[i].location);
+        }
+        DouglasPeucker().ComputeMinZoomLevels(range, range_zoom_levels);
+        for(unsigned i = left_border+1; i < right_border; ++i) {
+            route_zoom_levels[i] = range_zoom_levels[i-left_border];
+        }
+        left_border = right_border;
+    }
+}
+
+//statistics of one zoom level over all compared routes
+struct GeneralizationComparison {
+    GeneralizationComparison() :
+        number_of_routes(0),
+        number_of_unchanged_routes(0),
+        number_of_former_points(0),
+        number_of_current_points(0),
+        largest_former_deviation(0.),
+        largest_current_deviation(0.)
+    { }
+
+    uint64_t number_of_routes;
+    uint64_t number_of_unchanged_routes;
+    uint64_t number_of_former_points;
+    uint64_t number_of_current_points;
+    double largest_former_deviation;
+    double largest_current_deviation;
+};
+
+//segment_list receives the segments of the compared routes
+static void CompareGeneralization(
+    ExtractFacade * facade,
+    std::vector<Segment> & segment_list
+) {
+    SearchEngine<ExtractFacade> search_engine(facade);
+    boost::mt19937 generator(NUMBER_OF_COMPARED_ROUTES);
+    boost::random::uniform_int_distribution<unsigned> node_distribution(
+        0,
+        facade->GetNumberOfNodes()-1
+    );
+    std::vector<GeneralizationComparison> comparisons(
+        DouglasPeucker::NUMBER_OF_ZOOM_LEVELS
+    );
+    DescriptionFactory description_factory;
+    std::vector<unsigned char> route_zoom_levels;
+    std::vector<bool> is_kept_formerly, is_kept_currently;
+    std::vector<PhantomNodes> phantom_node_pairs(1);
+    for(unsigned i = 0; i < NUMBER_OF_COMPARED_ROUTES; ++i) {
+        PhantomNodes & phantom_nodes = phantom_node_pairs[0];
+        phantom_nodes.startPhantom.edgeBasedNode = node_distribution(generator);
+        phantom_nodes.startPhantom.weight1 = 0;
+        phantom_nodes.targetPhantom.edgeBasedNode = node_distribution(generator);
+        phantom_nodes.targetPhantom.weight1 = 0;
+        RawRouteData raw_route;
+        raw_route.segmentEndCoordinates = phantom_node_pairs;
+        search_engine.shortest_path(phantom_node_pairs, raw_route);
+        const std::vector<_PathData> & route = raw_route.computedShortestPath;
+        if( INT_MAX == raw_route.lengthOfShortestPath || route.size() < 2 ) {
+            continue;
+        }
+
+        //the route starts and ends at its first and last node
+        phantom_nodes.startPhantom.location = facade->GetCoordinateOfNode(route.front().node);
+        phantom_nodes.startPhantom.nodeBasedEdgeNameID = route.front().nameID;
+        phantom_nodes.targetPhantom.location = facade->GetCoordinateOfNode(route.back().node);
+        phantom_nodes.targetPhantom.nodeBasedEdgeNameID = route.back().nameID;
+        description_factory.Clear();
+        description_factory.Reserve(route.size());
+        description_factory.SetStartSegment(phantom_nodes.startPhantom);
+        BOOST_FOREACH(const _PathData & path_data, route) {
+            description_factory.AppendSegment(
+                facade->GetCoordinateOfNode(path_data.node),
+                path_data
+            );
+        }
+        description_factory.SetEndSegment(phantom_nodes.targetPhantom);
+        description_factory.BuildSegments();
+        const std::vector<SegmentInformation> & path =
+            description_factory.pathDescription;
+        ComputeRouteZoomLevels(path, route_zoom_levels);
+        for(unsigned j = 1; j < path.size(); ++j) {
+            segment_list.push_back(Segment(path[j-1].location, path[j].location));
+        }
+
+        for(unsigned zoom_level = 0; zoom_level < comparisons.size(); ++zoom_level) {
+            GeneralizationComparison & comparison = comparisons[zoom_level];
+            is_kept_formerly.assign(path.size(), false);
+            is_kept_currently.assign(path.size(), false);
+            for(unsigned j = 0; j < path.size(); ++j) {
+                //same as DescriptionFactory::Generalize
+                is_kept_currently[j] =
+                    path[j].necessary || path[j].minZoomLevel <= zoom_level;
+                is_kept_formerly[j] =
+                    path[j].necessary || route_zoom_levels[j] <= zoom_level;
+                comparison.number_of_current_points += is_kept_currently[j];
+                comparison.number_of_former_points += is_kept_formerly[j];
+            }
+            ++comparison.number_of_routes;
+            comparison.number_of_unchanged_routes +=
+                ( is_kept_formerly == is_kept_currently );
+            comparison.largest_former_deviation = std::max(
+                comparison.largest_former_deviation,
+                GetLargestDeviation(path, is_kept_formerly)
+            );
+            comparison.largest_current_deviation = std::max(
+                comparison.largest_current_deviation,
+                GetLargestDeviation(path, is_kept_currently)
+            );
+        }
+    }
+
+    for(unsigned zoom_level = 0; zoom_level < comparisons.size(); ++zoom_level) {
+        const GeneralizationComparison & comparison = comparisons[zoom_level];
+        if( 0 == comparison.number_of_routes ) {
+            SimpleLogger().Write(logWARNING) << "no routes found";
+            return;
+        }
+        SimpleLogger().Write() << "zoom " << zoom_level << ": " <<
+            double(comparison.number_of_former_points)/comparison.number_of_routes <<
+            " points per route formerly, " <<
+            double(comparison.number_of_current_points)/comparison.number_of_routes <<
+            " now, " <<
+            100.*comparison.number_of_unchanged_routes/comparison.number_of_routes <<
+            "% of routes unchanged, largest deviation " <<
+            comparison.largest_former_deviation << " m formerly, " <<
+            comparison.largest_current_deviation << " m now";
+    }
+}
+
+static int RunExtractComparison(int argc, const char * argv[]) {
+    std::string ip_address;
+    int ip_port, requested_num_threads;
+    bool use_shared_memory = false;
+    bool use_mapped_files = false;
+    bool replicate_per_numa_node = false;
+    bool warm_up_data = true;
+    std::string locked_structures;
+    unsigned response_cache_size = 0;
+    ServerPaths server_paths;
+    if( !GenerateServerProgramOptions(
+            argc,
+            argv,
+            server_paths,
+            ip_address,
+            ip_port,
+            requested_num_threads,
+            use_shared_memory,
+            use_mapped_files,
+            replicate_per_numa_node,
+            warm_up_data,
+            locked_structures,
+            response_cache_size
+         )
+    ) {
+        return 0;
+    }
+    ExtractFacade facade(server_paths);
+    SimpleLogger().Write() << "comparing the geometry of " <<
+        NUMBER_OF_COMPARED_ROUTES << " random routes";
+    std::vector<Segment> segment_list;
+    CompareGeneralization(&facade, segment_list);
+    SimpleLogger().Write() << "checking bearings of route segments";
+    unsigned number_of_mismatches = CheckBearings(segment_list);
+    number_of_mismatches += CheckBearingsOfRandomSegments();
+    return ( 0 == number_of_mismatches ? 0 : 1 );
+}
+
+int main (int argc, const char * argv[]) {
+    LogPolicy::GetInstance().Unmute();
+    SimpleLogger().Write() << "descriptor benchmark, " << g_GIT_DESCRIPTION;
+    if( 1 < argc ) {
+        try {
+            return RunExtractComparison(argc, argv);
+        } catch (const std::exception & e) {
+            SimpleLogger().Write(logWARNING) << "caught exception: " << e.what();
+            return 1;
+        }
+    }
+    if( 0 != CheckBearingsOfRandomSegments() ) {
+        return 1;
+    }
+
+    DescriptorConfig encoded_config;
+    DescriptorConfig unencoded_config;
+    unencoded_config.encode_geometry = false;
+    DescriptorConfig summary_config;
+    summary_config.geometry = false;
+    summary_config.instructions = false;
+
+    const unsigned route_sizes[] = { 1000, 10000, 100000 };
+    BOOST_FOREACH(const unsigned number_of_nodes, route_sizes) {
+        for(unsigned reuse = 0; reuse < 2; ++reuse) {
+            RunBenchmark(number_of_nodes, "encoded geometry", encoded_config, reuse);
+            RunBenchmark(number_of_nodes, "unencoded geometry", unencoded_config, reuse);
+            RunBenchmark(number_of_nodes, "summary only", summary_config, reuse);
+        }
+        RunPolylineBenchmark(number_of_nodes, 6);
+        RunPolylineBenchmark(number_of_nodes, 5);
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+//Compares the compact phantom node hints against the previous boost
+//base64 archive encoding for 25-waypoint requests.
+
+#include "../Algorithms/ObjectToBase64.h"
+#include "../Algorithms/PhantomNodeHint.h"
+#include "../DataStructures/PhantomNodes.h"
+#include "../Util/GitDescription.h"
+#include "../Util/SimpleLogger.h"
+#include "../Util/TimingUtil.h"
+
+#include <boost/lexical_cast.hpp>
+
+#include <cmath>
+#include <cstdlib>
+
+#include <string>
+#include <vector>
+
+const static unsigned NUMBER_OF_WAYPOINTS = 25;
+const static unsigned CHECKSUM = 0xDEADBEEF;
+
+int main (int argc, char * argv[]) {
+    LogPolicy::GetInstance().Unmute();
+    SimpleLogger().Write() <<
+        "starting up engines, " << g_GIT_DESCRIPTION << ", " <<
+        "compiled at " << __DATE__ << ", " __TIME__;
+
+    const unsigned number_of_requests = ( 1 < argc ?
+        boost::lexical_cast<unsigned>(argv[1]) : 100000
+    );
+
+    //plausible phantom nodes of a continental extract
+    std::srand(1);
+    std::vector<PhantomNode> phantom_node_list(NUMBER_OF_WAYPOINTS);
+    for(unsigned i = 0; i < NUMBER_OF_WAYPOINTS; ++i) {
+        PhantomNode & phantom_node = phantom_node_list[i];
+        phantom_node.edgeBasedNode = std::rand()%50000000;
+        phantom_node.nodeBasedEdgeNameID = std::rand()%2000000;
+        phantom_node.ratio = std::rand()/(RAND_MAX+1.);
+        phantom_node.weight1 = (std::rand()%1000)*phantom_node.ratio;
+        phantom_node.weight2 = ( 0 == i%2 ? INT_MAX :
+            (std::rand()%1000)*(1.-phantom_node.ratio)
+        );
+        phantom_node.location.lat = 52000000 + std::rand()%1000000;
+        phantom_node.location.lon = -2000000 + std::rand()%4000000;
+    }
+
+    std::vector<std::string> base64_hints(NUMBER_OF_WAYPOINTS);
+    std::vector<std::string> compact_hints(NUMBER_OF_WAYPOINTS);
+    std::vector<PhantomNode> decoded_list(NUMBER_OF_WAYPOINTS);
+
+    double time1 = get_timestamp();
+    for(unsigned r = 0; r < number_of_requests; ++r) {
+        for(unsigned i = 0; i < NUMBER_OF_WAYPOINTS; ++i) {
+            EncodeObjectToBase64(phantom_node_list[i], base64_hints[i]);
+        }
+    }
+    double time2 = get_timestamp();
+    for(unsigned r = 0; r < number_of_requests; ++r) {
+        for(unsigned i = 0; i < NUMBER_OF_WAYPOINTS; ++i) {
+            DecodeObjectFromBase64(base64_hints[i], decoded_list[i]);
+        }
+    }
+    double time3 = get_timestamp();
+    for(unsigned r = 0; r < number_of_requests; ++r) {
+        for(unsigned i = 0; i < NUMBER_OF_WAYPOINTS; ++i) {
+            PhantomNodeHint::Encode(phantom_node_list[i], CHECKSUM, compact_hints[i]);
+        }
+    }
+    double time4 = get_timestamp();
+    unsigned number_of_failures = 0;
+    for(unsigned r = 0; r < number_of_requests; ++r) {
+        for(unsigned i = 0; i < NUMBER_OF_WAYPOINTS; ++i) {
+            if( !PhantomNodeHint::Decode(compact_hints[i], CHECKSUM, decoded_list[i]) ) {
+                ++number_of_failures;
+            }
+        }
+    }
+    double time5 = get_timestamp();
+
+    unsigned base64_length = 0;
+    unsigned compact_length = 0;
+    for(unsigned i = 0; i < NUMBER_OF_WAYPOINTS; ++i) {
+        base64_length += base64_hints[i].length();
+        compact_length += compact_hints[i].length();
+        const PhantomNode & input = phantom_node_list[i];
+        const PhantomNode & output = decoded_list[i];
+        if(
+            input.edgeBasedNode != output.edgeBasedNode ||
+            input.nodeBasedEdgeNameID != output.nodeBasedEdgeNameID ||
+            input.weight1 != output.weight1 ||
+            input.weight2 != output.weight2 ||
+            !(input.location == output.location) ||
+            1./65535 < std::abs(input.ratio - output.ratio)
+        ) {
+            ++number_of_failures;
+        }
+    }
+    PhantomNode stale;
+    if( PhantomNodeHint::Decode(compact_hints[0], CHECKSUM+1, stale) ) {
+        ++number_of_failures;
+    }
+
+    const double usec_per_request = 1000000./number_of_requests;
+    SimpleLogger().Write() << "base64  encode: " << (time2-time1)*usec_per_request <<
+        " usec, decode: " << (time3-time2)*usec_per_request <<
+        " usec per request, " << base64_length/NUMBER_OF_WAYPOINTS << " chars/hint";
+    SimpleLogger().Write() << "compact encode: " << (time4-time3)*usec_per_request <<
+        " usec, decode: " << (time5-time4)*usec_per_request <<
+        " usec per request, " << compact_length/NUMBER_OF_WAYPOINTS << " chars/hint";
+    SimpleLogger().Write() << "round trip failures: " << number_of_failures;
+    return ( 0 == number_of_failures ? 0 : 1 );
+}
@@ -0,0 +1,219 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+//Measures what huge pages gain on shared memory. Run it once with huge pages
+//reserved (vm.nr_hugepages) and once without, and reload osrm-datastore in
+//between for the query test.
+//
+//  osrm-hugepage-benchmark lookups [MiB]    dependent random reads through a
+//                                           scratch region, 1024 MiB default
+//  osrm-hugepage-benchmark queries [threads] routes between random nodes of
+//                                           the data osrm-datastore loaded
+
+#include "../DataStructures/PhantomNodes.h"
+#include "../DataStructures/QueryEdge.h"
+#include "../DataStructures/RawRouteData.h"
+#include "../DataStructures/SearchEngine.h"
+#include "../DataStructures/SharedMemoryFactory.h"
+#include "../Server/DataStructures/SharedBarriers.h"
+#include "../Server/DataStructures/SharedDataFacade.h"
+#include "../Server/DataStructures/SharedDataType.h"
+#include "../Util/GitDescription.h"
+#include "../Util/OSRMException.h"
+#include "../Util/SimpleLogger.h"
+#include "../Util/TimingUtil.h"
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef SharedDataFacade<QueryEdge::EdgeData> DataFacade;
+typedef BaseDataFacade<QueryEdge::EdgeData> BaseFacade;
+
+const static unsigned NUMBER_OF_LOOKUPS = 20000000;
+const static unsigned NUMBER_OF_LOOKUP_ROUNDS = 3;
+const static unsigned NUMBER_OF_QUERIES_PER_THREAD = 2000;
+
+//as large as a graph edge, only the first member is followed
+struct LookupRecord {
+    unsigned next;
+    unsigned payload[2];
+};
+
+//page size of the mapping that holds address, from /proc/self/smaps, in kB
+static unsigned GetKernelPageSize(const void * address) {
+    std::ifstream smaps("/proc/self/smaps");
+    const unsigned long position = reinterpret_cast<unsigned long>(address);
+    bool in_mapping = false;
+    std::string line;
+    while( std::getline(smaps, line) ) {
+        unsigned long begin, end;
+        char dash;
+        std::istringstream fields(line);
+        if( fields >> std::hex >> begin >> dash >> end && '-' == dash ) {
+            in_mapping = (begin <= position && position < end);
+        } else if( in_mapping && 0 == line.compare(0, 15, "KernelPageSize:") ) {
+            unsigned page_size = 0;
+            std::istringstream(line.substr(15)) >> page_size;
+            return page_size;
+        }
+    }
+    return 0;
+}
+
+static void RunLookups(const uint64_t size_in_mib) {
+    const uint64_t number_of_records = size_in_mib*1024*1024/sizeof(LookupRecord);
+    if( 2 > number_of_records || UINT_MAX < number_of_records ) {
+        throw OSRMException("region size out of range");
+    }
+    boost::scoped_ptr<SharedMemory> region(
+        SharedMemoryFactory::Get(DATA_NONE, number_of_records*sizeof(LookupRecord), true)
+    );
+    LookupRecord * records = static_cast<LookupRecord *>(region->Ptr());
+    SimpleLogger().Write() << size_in_mib << " MiB scratch region, " <<
+        GetKernelPageSize(records) << " kB pages";
+
+    //Sattolo's shuffle yields a single cycle through all records, so the
+    //reads below cannot be prefetched and never settle in a short loop
+    for(unsigned i = 0; i < number_of_records; ++i) {
+        records[i].next = i;
+    }
+    boost::mt19937 generator(42);
+    for(unsigned i = number_of_records-1; i > 0; --i) {
+        boost::random::uniform_int_distribution<unsigned> distribution(0, i-1);
+        std::swap(records[i].next, records[distribution(generator)].next);
+    }
+
+    for(unsigned round = 0; round < NUMBER_OF_LOOKUP_ROUNDS; ++round) {
+        unsigned current = 0;
+        const double start_time = get_timestamp();
+        for(unsigned i = 0; i < NUMBER_OF_LOOKUPS; ++i) {
+            current = records[current].next;
+        }
+        const double duration = get_timestamp() - start_time;
+        SimpleLogger().Write() << NUMBER_OF_LOOKUPS/duration/1000000. <<
+            " M lookups/s (ended at " << current << ")";
+    }
+}
+
+//routes between random nodes and reads the coordinates of each path
+static void RunQueries(
+    DataFacade * facade,
+    const unsigned seed,
+    uint64_t * checksum
+) {
+    SearchEngine<BaseFacade> search_engine(facade);
+    boost::mt19937 generator(seed);
+    boost::random::uniform_int_distribution<unsigned> node_distribution(
+        0,
+        facade->GetNumberOfNodes()-1
+    );
+    std::vector<PhantomNodes> phantom_node_pairs(1);
+    for(unsigned i = 0; i < NUMBER_OF_QUERIES_PER_THREAD; ++i) {
+        DataFacade::Reader data_reader(*facade);
+        PhantomNodes & phantom_nodes = phantom_node_pairs[0];
+        phantom_nodes.startPhantom.edgeBasedNode = node_distribution(generator);
+        phantom_nodes.startPhantom.weight1 = 0;
+        phantom_nodes.targetPhantom.edgeBasedNode = node_distribution(generator);
+        phantom_nodes.targetPhantom.weight1 = 0;
+        RawRouteData raw_route;
+        raw_route.segmentEndCoordinates = phantom_node_pairs;
+        search_engine.shortest_path(phantom_node_pairs, raw_route);
+        BOOST_FOREACH(const _PathData & path_data, raw_route.computedShortestPath) {
+            const FixedPointCoordinate coordinate =
+                facade->GetCoordinateOfNode(path_data.node);
+            *checksum += coordinate.lat + path_data.nameID;
+        }
+    }
+}
+
+static void RunQueryBenchmark(const unsigned number_of_threads) {
+    DataFacade facade;
+
+    SharedDataTimestamp * data_timestamp_ptr = static_cast<SharedDataTimestamp *>(
+        SharedMemoryFactory::Get(
+            CURRENT_REGIONS,
+            sizeof(SharedDataTimestamp),
+            false,
+            false
+        )->Ptr()
+    );
+    boost::scoped_ptr<SharedMemory> data_region(
+        SharedMemoryFactory::Get(SharedDataGeneration::GetCurrentData(data_timestamp_ptr))
+    );
+    SimpleLogger().Write() << facade.GetNumberOfNodes() << " nodes, data in " <<
+        GetKernelPageSize(data_region->Ptr()) << " kB pages";
+
+    std::vector<uint64_t> checksums(number_of_threads, 0);
+    boost::thread_group query_threads;
+    const double start_time = get_timestamp();
+    for(unsigned i = 0; i < number_of_threads; ++i) {
+        query_threads.create_thread(
+            boost::bind(RunQueries, &facade, i, &checksums[i])
+        );
+    }
+    query_threads.join_all();
+    const double duration = get_timestamp() - start_time;
+    SimpleLogger().Write() << number_of_threads << " thread(s): " <<
+        number_of_threads*NUMBER_OF_QUERIES_PER_THREAD/duration << " queries/s";
+}
+
+int main (int argc, const char * argv[]) {
+    LogPolicy::GetInstance().Unmute();
+    try {
+        SimpleLogger().Write() <<
+            "starting up engines, " << g_GIT_DESCRIPTION << ", " <<
+            "compiled at " << __DATE__ << ", " __TIME__;
+
+        const std::string mode( 1 < argc ? argv[1] : "" );
+        if( "lookups" == mode ) {
+            RunLookups( 2 < argc ? boost::lexical_cast<uint64_t>(argv[2]) : 1024 );
+        } else if( "queries" == mode ) {
+            RunQueryBenchmark(
+                std::max(1u, 2 < argc ? boost::lexical_cast<unsigned>(argv[2]) : 1u)
+            );
+        } else {
+            SimpleLogger().Write(logWARNING) <<
+                "usage: " << argv[0] << " lookups [MiB] | queries [threads]";
+            return -1;
+        }
+    } catch (std::exception & e) {
+        SimpleLogger().Write(logWARNING) << "caught exception: " << e.what();
+        return -1;
+    }
+    return 0;
+}
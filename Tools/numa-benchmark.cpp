@@ -0,0 +1,206 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+//Measures how route queries scale from one to all NUMA nodes, once with all
+//threads reading a single copy of the data and once with a copy per node.
+//Takes the same options as osrm-routed, --threads is the number of threads
+//per node.
+
+#include "../DataStructures/PhantomNodes.h"
+#include "../DataStructures/QueryEdge.h"
+#include "../DataStructures/RawRouteData.h"
+#include "../DataStructures/SearchEngine.h"
+#include "../Server/DataStructures/InternalDataFacade.h"
+#include "../Util/GitDescription.h"
+#include "../Util/NUMATopology.h"
+#include "../Util/ProgramOptions.h"
+#include "../Util/SimpleLogger.h"
+#include "../Util/TimingUtil.h"
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+
+#include <climits>
+
+#include <string>
+#include <vector>
+
+typedef InternalDataFacade<QueryEdge::EdgeData> DataFacade;
+
+const static unsigned NUMBER_OF_QUERIES_PER_THREAD = 2000;
+
+static void LoadReplica(
+    const ServerPaths & server_paths,
+    const unsigned node,
+    boost::shared_ptr<DataFacade> * facade
+) {
+    if( !NUMATopology::GetInstance().BindCurrentThreadToNode(node) ) {
+        SimpleLogger().Write(logWARNING) << "could not bind to NUMA node " << node;
+    }
+    facade->reset(new DataFacade(server_paths));
+}
+
+//routes between random nodes and reads the coordinates of each path
+static void RunQueries(
+    const unsigned node,
+    DataFacade * facade,
+    const unsigned seed,
+    uint64_t * checksum
+) {
+    NUMATopology::GetInstance().BindCurrentThreadToNode(node);
+    SearchEngine<DataFacade> search_engine(facade);
+    boost::mt19937 generator(seed);
+    boost::random::uniform_int_distribution<unsigned> node_distribution(
+        0,
+        facade->GetNumberOfNodes()-1
+    );
+    std::vector<PhantomNodes> phantom_node_pairs(1);
+    for(unsigned i = 0; i < NUMBER_OF_QUERIES_PER_THREAD; ++i) {
+        PhantomNodes & phantom_nodes = phantom_node_pairs[0];
+        phantom_nodes.startPhantom.edgeBasedNode = node_distribution(generator);
+        phantom_nodes.startPhantom.weight1 = 0;
+        phantom_nodes.targetPhantom.edgeBasedNode = node_distribution(generator);
+        phantom_nodes.targetPhantom.weight1 = 0;
+        RawRouteData raw_route;
+        raw_route.segmentEndCoordinates = phantom_node_pairs;
+        search_engine.shortest_path(phantom_node_pairs, raw_route);
+        BOOST_FOREACH(const _PathData & path_data, raw_route.computedShortestPath) {
+            const FixedPointCoordinate coordinate =
+                facade->GetCoordinateOfNode(path_data.node);
+            *checksum += coordinate.lat + path_data.nameID;
+        }
+    }
+}
+
+static double RunBenchmark(
+    const std::vector<boost::shared_ptr<DataFacade> > & replicas,
+    const unsigned number_of_nodes,
+    const unsigned threads_per_node,
+    const bool use_replicas
+) {
+    const unsigned number_of_threads = number_of_nodes*threads_per_node;
+    std::vector<uint64_t> checksums(number_of_threads, 0);
+    boost::thread_group query_threads;
+    const double start_time = get_timestamp();
+    for(unsigned i = 0; i < number_of_threads; ++i) {
+        const unsigned node = i % number_of_nodes;
+        query_threads.create_thread(
+            boost::bind(
+                RunQueries,
+                node,
+                replicas[use_replicas ? node : 0].get(),
+                i,
+                &checksums[i]
+            )
+        );
+    }
+    query_threads.join_all();
+    return number_of_threads*NUMBER_OF_QUERIES_PER_THREAD/(get_timestamp() - start_time);
+}
+
+int main (int argc, const char * argv[]) {
+    LogPolicy::GetInstance().Unmute();
+    try {
+        std::string ip_address;
+        int ip_port, requested_num_threads;
+        bool use_shared_memory = false;
+        bool use_mapped_files = false;
+        bool replicate_per_numa_node = false;
+        bool warm_up_data = true;
+        std::string locked_structures;
+        unsigned response_cache_size = 0;
+        ServerPaths server_paths;
+        if( !GenerateServerProgramOptions(
+                argc,
+                argv,
+                server_paths,
+                ip_address,
+                ip_port,
+                requested_num_threads,
+                use_shared_memory,
+                use_mapped_files,
+                replicate_per_numa_node,
+                warm_up_data,
+                locked_structures,
+                response_cache_size
+             )
+        ) {
+            return 0;
+        }
+        SimpleLogger().Write() <<
+            "starting up engines, " << g_GIT_DESCRIPTION << ", " <<
+            "compiled at " << __DATE__ << ", " __TIME__;
+
+        const unsigned number_of_nodes = NUMATopology::GetInstance().GetNumberOfNodes();
+        const unsigned threads_per_node = std::max(1, requested_num_threads);
+        SimpleLogger().Write() << number_of_nodes << " NUMA nodes, " <<
+            threads_per_node << " threads per node";
+
+        std::vector<boost::shared_ptr<DataFacade> > replicas(number_of_nodes);
+        boost::thread_group loader_threads;
+        for(unsigned node = 0; node < number_of_nodes; ++node) {
+            loader_threads.create_thread(
+                boost::bind(LoadReplica, boost::cref(server_paths), node, &replicas[node])
+            );
+        }
+        loader_threads.join_all();
+        BOOST_FOREACH(const boost::shared_ptr<DataFacade> & replica, replicas) {
+            if( !replica ) {
+                throw OSRMException("could not load data");
+            }
+        }
+
+        LogPolicy::GetInstance().Mute();
+        std::vector<double> single_copy_rates, replicated_rates;
+        for(unsigned nodes = 1; nodes <= number_of_nodes; ++nodes) {
+            single_copy_rates.push_back(
+                RunBenchmark(replicas, nodes, threads_per_node, false)
+            );
+            replicated_rates.push_back(
+                RunBenchmark(replicas, nodes, threads_per_node, true)
+            );
+        }
+        LogPolicy::GetInstance().Unmute();
+
+        for(unsigned i = 0; i < number_of_nodes; ++i) {
+            SimpleLogger().Write() << (i+1) << " node(s): " <<
+                single_copy_rates[i] << " queries/s with one copy (" <<
+                single_copy_rates[i]/single_copy_rates[0] << "x), " <<
+                replicated_rates[i] << " queries/s with a copy per node (" <<
+                replicated_rates[i]/replicated_rates[0] << "x)";
+        }
+    } catch (std::exception & e) {
+        SimpleLogger().Write(logWARNING) << "caught exception: " << e.what();
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,260 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+//Compares the nearest neighbor queries of the static r-tree against an
+//exhaustive scan of all leaves for a corpus of random and near-road
+//coordinates, checks that batch queries agree with single queries, and
+//reports mismatches and query timings.
+
+#include "../DataStructures/Coordinate.h"
+#include "../DataStructures/EdgeBasedNode.h"
+#include "../DataStructures/PhantomNodes.h"
+#include "../DataStructures/StaticRTree.h"
+#include "../Util/GitDescription.h"
+#include "../Util/OSRMException.h"
+#include "../Util/SimpleLogger.h"
+#include "../Util/TimingUtil.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include <cmath>
+#include <cstdlib>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+typedef StaticRTree<EdgeBasedNode> RTreeT;
+
+//squared distance in plain lat/lon space from input to segment (a,b)
+double SquaredDistanceToSegment(
+    const FixedPointCoordinate & input,
+    const EdgeBasedNode & edge
+) {
+    const double x  = input.lon/COORDINATE_PRECISION;
+    const double y  = input.lat/COORDINATE_PRECISION;
+    const double x1 = edge.lon1/COORDINATE_PRECISION;
+    const double y1 = edge.lat1/COORDINATE_PRECISION;
+    const double x2 = edge.lon2/COORDINATE_PRECISION;
+    const double y2 = edge.lat2/COORDINATE_PRECISION;
+    const double dx = x2 - x1;
+    const double dy = y2 - y1;
+    const double squared_length = dx*dx + dy*dy;
+    double t = 0.;
+    if(0. < squared_length) {
+        t = std::max(0., std::min(1., ((x-x1)*dx + (y-y1)*dy)/squared_length));
+    }
+    const double px = x1 + t*dx - x;
+    const double py = y1 + t*dy - y;
+    return px*px + py*py;
+}
+
+double SquaredDistance(
+    const FixedPointCoordinate & a,
+    const FixedPointCoordinate & b
+) {
+    const double dx = (a.lon - b.lon)/COORDINATE_PRECISION;
+    const double dy = (a.lat - b.lat)/COORDINATE_PRECISION;
+    return dx*dx + dy*dy;
+}
+
+int main (int argc, char * argv[]) {
+    LogPolicy::GetInstance().Unmute();
+    SimpleLogger().Write() <<
+        "starting up engines, " << g_GIT_DESCRIPTION << ", " <<
+        "compiled at " << __DATE__ << ", " __TIME__;
+
+    if( 3 > argc ) {
+        SimpleLogger().Write(logWARNING) <<
+            "usage: " << argv[0] << " <.ramIndex> <.fileIndex> [queries]";
+        return -1;
+    }
+
+    try {
+        const boost::filesystem::path ram_index_path(argv[1]);
+        const boost::filesystem::path file_index_path(argv[2]);
+        const unsigned number_of_queries = ( 3 < argc ?
+            boost::lexical_cast<unsigned>(argv[3]) : 10000
+        );
+
+        RTreeT rtree(ram_index_path, file_index_path);
+
+        //root bounding box spans the area to draw random queries from
+        RTreeT::TreeNode root_node;
+        uint32_t tree_size = 0;
+        boost::filesystem::ifstream tree_node_file(
+            ram_index_path,
+            std::ios::binary
+        );
+        tree_node_file.read((char*)&tree_size, sizeof(uint32_t));
+        tree_node_file.read((char*)&root_node, sizeof(RTreeT::TreeNode));
+        tree_node_file.close();
+
+        //load all edges for the exhaustive reference scan
+        std::vector<EdgeBasedNode> edge_list;
+        boost::filesystem::ifstream leaf_node_file(
+            file_index_path,
+            std::ios::binary
+        );
+        uint64_t element_count = 0;
+        leaf_node_file.read((char*)&element_count, sizeof(uint64_t));
+        edge_list.reserve(element_count);
+        RTreeT::LeafNode * current_leaf_node = new RTreeT::LeafNode();
+        while(edge_list.size() < element_count) {
+            leaf_node_file.read((char*)current_leaf_node, sizeof(RTreeT::LeafNode));
+            if(!leaf_node_file) {
+                throw OSRMException("leaf file truncated");
+            }
+            edge_list.insert(
+                edge_list.end(),
+                current_leaf_node->objects,
+                current_leaf_node->objects + current_leaf_node->object_count
+            );
+        }
+        delete current_leaf_node;
+        leaf_node_file.close();
+        if( edge_list.empty() ) {
+            throw OSRMException("r-tree has no elements");
+        }
+        SimpleLogger().Write() << "loaded " << tree_size << " tree nodes and " <<
+            edge_list.size() << " edges";
+
+        //every other query is a jittered edge end point, i.e. close to a road
+        const RTreeT::RectangleT & bbox = root_node.minimum_bounding_rectangle;
+        std::srand(1);
+        std::vector<FixedPointCoordinate> query_list(number_of_queries);
+        for(unsigned i = 0; i < number_of_queries; ++i) {
+            if( 0 == i%2 ) {
+                const double lat_rand = std::rand()/(RAND_MAX+1.);
+                const double lon_rand = std::rand()/(RAND_MAX+1.);
+                query_list[i].lat = bbox.min_lat + lat_rand*(bbox.max_lat - bbox.min_lat);
+                query_list[i].lon = bbox.min_lon + lon_rand*(bbox.max_lon - bbox.min_lon);
+            } else {
+                const EdgeBasedNode & edge = edge_list[std::rand()%edge_list.size()];
+                query_list[i].lat = edge.lat1 + (std::rand()%2001) - 1000;
+                query_list[i].lon = edge.lon1 + (std::rand()%2001) - 1000;
+            }
+        }
+
+        std::vector<PhantomNode> phantom_node_list(number_of_queries);
+        std::vector<FixedPointCoordinate> end_point_list(number_of_queries);
+
+        double time1 = get_timestamp();
+        for(unsigned i = 0; i < number_of_queries; ++i) {
+            rtree.FindPhantomNodeForCoordinate(query_list[i], phantom_node_list[i], 18);
+        }
+        double time2 = get_timestamp();
+        for(unsigned i = 0; i < number_of_queries; ++i) {
+            rtree.LocateClosestEndPointForCoordinate(query_list[i], end_point_list[i], 18);
+        }
+        double time3 = get_timestamp();
+        std::vector<PhantomNode> batch_phantom_node_list;
+        rtree.FindPhantomNodesForCoordinates(query_list, batch_phantom_node_list, 18);
+        double time4 = get_timestamp();
+        SimpleLogger().Write() << "nearest: " <<
+            1000000.*(time2-time1)/number_of_queries << " usec/query";
+        SimpleLogger().Write() << "locate:  " <<
+            1000000.*(time3-time2)/number_of_queries << " usec/query";
+        SimpleLogger().Write() << "batch:   " <<
+            1000000.*(time4-time3)/number_of_queries << " usec/query";
+
+        unsigned batch_mismatches = 0;
+        for(unsigned i = 0; i < number_of_queries; ++i) {
+            const PhantomNode & single = phantom_node_list[i];
+            const PhantomNode & batch = batch_phantom_node_list[i];
+            if(
+                single.edgeBasedNode != batch.edgeBasedNode ||
+                !(single.location == batch.location)
+            ) {
+                ++batch_mismatches;
+                SimpleLogger().Write(logDEBUG) << "batch mismatch at " << query_list[i];
+            }
+        }
+
+        //fixed point rounding of the snapped location is tolerated
+        const double tolerance = 2./COORDINATE_PRECISION;
+        unsigned nearest_mismatches = 0;
+        unsigned locate_mismatches = 0;
+        double max_locate_deviation = 0.;
+        for(unsigned i = 0; i < number_of_queries; ++i) {
+            const FixedPointCoordinate & input = query_list[i];
+            double min_squared_dist = std::numeric_limits<double>::max();
+            double min_haversine_dist = std::numeric_limits<double>::max();
+            for(unsigned j = 0; j < edge_list.size(); ++j) {
+                const EdgeBasedNode & edge = edge_list[j];
+                if( edge.isIgnored() ) {
+                    continue;
+                }
+                min_squared_dist = std::min(
+                    min_squared_dist,
+                    SquaredDistanceToSegment(input, edge)
+                );
+                min_haversine_dist = std::min(
+                    min_haversine_dist,
+                    std::min(
+                        ApproximateDistance(input.lat, input.lon, edge.lat1, edge.lon1),
+                        ApproximateDistance(input.lat, input.lon, edge.lat2, edge.lon2)
+                    )
+                );
+            }
+
+            const double nearest_dist = std::sqrt(
+                SquaredDistance(input, phantom_node_list[i].location)
+            );
+            if( std::sqrt(min_squared_dist) + tolerance < nearest_dist ) {
+                ++nearest_mismatches;
+                SimpleLogger().Write(logDEBUG) << "nearest mismatch at " << input;
+            }
+
+            const double locate_deviation =
+                ApproximateDistance(input, end_point_list[i]) - min_haversine_dist;
+            max_locate_deviation = std::max(max_locate_deviation, locate_deviation);
+            if( 0.01 < locate_deviation ) {
+                ++locate_mismatches;
+                SimpleLogger().Write(logDEBUG) << "locate mismatch at " << input;
+            }
+        }
+        SimpleLogger().Write() << "nearest mismatches: " << nearest_mismatches <<
+            "/" << number_of_queries;
+        SimpleLogger().Write() << "locate mismatches:  " << locate_mismatches <<
+            "/" << number_of_queries << ", max deviation " <<
+            max_locate_deviation << "m";
+        SimpleLogger().Write() << "batch mismatches:   " << batch_mismatches <<
+            "/" << number_of_queries;
+        return (
+            0 == nearest_mismatches &&
+            0 == locate_mismatches &&
+            0 == batch_mismatches
+        ) ? 0 : 1;
+    } catch(const std::exception & e) {
+        SimpleLogger().Write(logWARNING) << "caught exception: " << e.what();
+        return -1;
+    }
+}
@@ -56,6 +56,11 @@ int main (int argc, const char * argv[]) {
         std::string ip_address;
         int ip_port, requested_num_threads;
         bool use_shared_memory = false;
+        bool use_mapped_files = false;
+        bool replicate_per_numa_node = false;
+        bool warm_up_data = true;
+        std::string locked_structures;
+        unsigned response_cache_size = 0;
         ServerPaths server_paths;
         if( !GenerateServerProgramOptions(
                 argc,
@@ -64,7 +69,12 @@ int main (int argc, const char * argv[]) {
                 ip_address,
                 ip_port,
                 requested_num_threads,
-                use_shared_memory
+                use_shared_memory,
+                use_mapped_files,
+                replicate_per_numa_node,
+                warm_up_data,
+                locked_structures,
+                response_cache_size
              )
         ) {
             return 0;
@@ -74,7 +84,12 @@ int main (int argc, const char * argv[]) {
             "starting up engines, " << g_GIT_DESCRIPTION << ", " <<
             "compiled at " << __DATE__ << ", " __TIME__;
 
-        OSRM routing_machine( server_paths, use_shared_memory );
+        OSRM routing_machine(
+            server_paths,
+            use_shared_memory,
+            use_mapped_files,
+            replicate_per_numa_node
+        );
 
         RouteParameters route_parameters;
         route_parameters.zoomLevel = 18; //no generalization
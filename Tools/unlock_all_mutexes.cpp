@@ -27,6 +27,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "../Util/GitDescription.h"
 #include "../Util/SimpleLogger.h"
+#include "../DataStructures/SharedMemoryFactory.h"
 #include "../Server/DataStructures/SharedBarriers.h"
 
 #include <iostream>
@@ -38,8 +39,23 @@ int main() {
             "compiled at " << __DATE__ << ", " __TIME__;
     SimpleLogger().Write() << "Releasing all locks";
     SharedBarriers barrier;
-    barrier.pending_update_mutex.unlock();
-    barrier.query_mutex.unlock();
     barrier.update_mutex.unlock();
+    if( SharedMemory::RegionExists(CURRENT_REGIONS) ) {
+        // drop readers that were pinned by crashed query processes
+        SharedDataTimestamp * data_timestamp_ptr = static_cast<SharedDataTimestamp*>(
+            SharedMemoryFactory::Get(
+                CURRENT_REGIONS,
+                sizeof(SharedDataTimestamp),
+                true,
+                false
+            )->Ptr()
+        );
+        SimpleLogger().Write() << "Resetting " <<
+            data_timestamp_ptr->number_of_readers[0].load() << " and " <<
+            data_timestamp_ptr->number_of_readers[1].load() <<
+            " readers of the shared data";
+        data_timestamp_ptr->number_of_readers[0].store(0);
+        data_timestamp_ptr->number_of_readers[1].store(0);
+    }
     return 0;
 }
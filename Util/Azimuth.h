@@ -28,10 +28,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef AZIMUTH_H_
 #define AZIMUTH_H_
 
-#include <string>
-
 struct Azimuth {
-    static std::string Get(const double heading) {
+    static const char * Get(const double heading) {
         if(heading <= 202.5) {
             if(heading >= 0 && heading <= 22.5)
                 return "N";
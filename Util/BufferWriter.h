@@ -0,0 +1,122 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef BUFFER_WRITER_H
+#define BUFFER_WRITER_H
+
+//Appends text to a string. Numbers and fixed-point coordinates are formatted
+//in a small stack buffer, so no temporary strings are created. The writer
+//knows no output format, see JSONWriter for the JSON specific parts.
+
+#include <boost/noncopyable.hpp>
+
+#include <string>
+
+class BufferWriter : boost::noncopyable {
+public:
+    explicit BufferWriter(std::string & output) : m_output(output) { }
+
+    BufferWriter & Raw(const char character) {
+        m_output.push_back(character);
+        return *this;
+    }
+
+    BufferWriter & Raw(const char * text) {
+        m_output.append(text);
+        return *this;
+    }
+
+    BufferWriter & Raw(const std::string & text) {
+        m_output.append(text);
+        return *this;
+    }
+
+    BufferWriter & UInt(unsigned value) {
+        char buffer[NUMBER_BUFFER_SIZE];
+        char * const end = buffer + NUMBER_BUFFER_SIZE;
+        m_output.append(FormatUInt(value, end), end);
+        return *this;
+    }
+
+    BufferWriter & Int(const int value) {
+        char buffer[NUMBER_BUFFER_SIZE];
+        char * const end = buffer + NUMBER_BUFFER_SIZE;
+        char * begin = FormatUInt(Magnitude(value), end);
+        if( 0 > value ) {
+            *--begin = '-';
+        }
+        m_output.append(begin, end);
+        return *this;
+    }
+
+    //latitude or longitude in degrees with six decimals, like 52.519930
+    BufferWriter & FixedPoint(const int value) {
+        char buffer[NUMBER_BUFFER_SIZE];
+        char * const end = buffer + NUMBER_BUFFER_SIZE;
+        char * begin = end;
+        unsigned magnitude = Magnitude(value);
+        for(unsigned i = 0; i < COORDINATE_DECIMALS; ++i) {
+            *--begin = '0' + magnitude % 10;
+            magnitude /= 10;
+        }
+        *--begin = '.';
+        begin = FormatUInt(magnitude, begin);
+        if( 0 > value ) {
+            *--begin = '-';
+        }
+        m_output.append(begin, end);
+        return *this;
+    }
+
+    std::string & GetOutput() {
+        return m_output;
+    }
+
+protected:
+    std::string & m_output;
+
+private:
+    //digits of COORDINATE_PRECISION
+    static const unsigned COORDINATE_DECIMALS = 6;
+    //sign, ten digits, decimal point and spare room
+    static const unsigned NUMBER_BUFFER_SIZE = 16;
+
+    static unsigned Magnitude(const int value) {
+        return ( 0 > value ? 0u - unsigned(value) : unsigned(value) );
+    }
+
+    //writes the digits in front of end, returns the first digit
+    static char * FormatUInt(unsigned value, char * end) {
+        do {
+            *--end = '0' + value % 10;
+            value /= 10;
+        } while( 0 != value );
+        return end;
+    }
+};
+
+#endif //BUFFER_WRITER_H
@@ -33,6 +33,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "../DataStructures/ImportEdge.h"
 #include "../DataStructures/QueryNode.h"
 #include "../DataStructures/Restriction.h"
+#include "../DataStructures/SearchGraphTrailer.h"
 #include "../Util/SimpleLogger.h"
 #include "../Util/UUID.h"
 #include "../typedefs.h"
@@ -414,11 +415,17 @@ NodeID readDDSGGraphFromStream(std::istream &in, std::vector<EdgeT>& edge_list,
     return numberOfNodes;
 }
 
+//node and edge lengths and the restriction counts of the edges follow the
+//edges behind a SearchGraphTrailerHeader, see SearchGraphLengths. Files
+//without them load with all lengths and counts zero.
 template<typename NodeT, typename EdgeT>
 unsigned readHSGRFromStream(
     const boost::filesystem::path & hsgr_file,
     std::vector<NodeT> & node_list,
     std::vector<EdgeT> & edge_list,
+    std::vector<unsigned> & node_length_list,
+    std::vector<unsigned> & edge_length_list,
+    std::vector<unsigned char> & edge_restriction_count_list,
     unsigned * check_sum
 ) {
     if ( !boost::filesystem::exists( hsgr_file ) ) {
@@ -456,6 +463,33 @@ unsigned readHSGRFromStream(
         (char*) &(edge_list[0]),
         number_of_edges*sizeof(EdgeT)
     );
+
+    node_length_list.resize(number_of_nodes, 0);
+    edge_length_list.resize(number_of_edges, 0);
+    edge_restriction_count_list.resize(number_of_edges, 0);
+    if(
+        SearchGraphTrailerHeader::Read(
+            hsgr_input_stream,
+            number_of_edges,
+            hsgr_file.string()
+        )
+    ) {
+        hsgr_input_stream.read(
+            (char*) &(node_length_list[0]),
+            number_of_nodes*sizeof(unsigned)
+        );
+        hsgr_input_stream.read(
+            (char*) &(edge_length_list[0]),
+            number_of_edges*sizeof(unsigned)
+        );
+        hsgr_input_stream.read(
+            (char*) &(edge_restriction_count_list[0]),
+            number_of_edges
+        );
+        if( !hsgr_input_stream ) {
+            throw OSRMException("hsgr file is truncated");
+        }
+    }
     hsgr_input_stream.close();
     return number_of_nodes;
 }
@@ -0,0 +1,94 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+//Appends JSON to a string, see BufferWriter for raw text and numbers. The
+//writer does not track the document structure, separators are written by
+//the caller.
+
+#include "BufferWriter.h"
+#include "../DataStructures/Coordinate.h"
+
+#include <string>
+
+class JSONWriter : public BufferWriter {
+public:
+    explicit JSONWriter(std::string & output) : BufferWriter(output) { }
+
+    //"key":
+    JSONWriter & Key(const char * key) {
+        m_output.push_back('"');
+        m_output.append(key);
+        m_output.append("\":", 2);
+        return *this;
+    }
+
+    //text that may need escaping, written in quotes
+    JSONWriter & String(const std::string & text) {
+        m_output.push_back('"');
+        for(std::string::const_iterator it = text.begin(); it != text.end(); ++it) {
+            const unsigned char character = *it;
+            if( '"' == character || '\\' == character ) {
+                m_output.push_back('\\');
+                m_output.push_back(character);
+            } else if( 0x20 > character ) {
+                static const char hex_digits[] = "0123456789abcdef";
+                m_output.append("\\u00", 4);
+                m_output.push_back(hex_digits[character >> 4]);
+                m_output.push_back(hex_digits[character & 0xf]);
+            } else {
+                m_output.push_back(character);
+            }
+        }
+        m_output.push_back('"');
+        return *this;
+    }
+
+    //text that is escaped already, e.g. street names, written in quotes
+    template<class RangeT>
+    JSONWriter & EscapedString(const RangeT & text) {
+        m_output.push_back('"');
+        m_output.append(text.begin(), text.end());
+        m_output.push_back('"');
+        return *this;
+    }
+
+    //[lat,lon]
+    JSONWriter & Coordinate(const FixedPointCoordinate & coordinate) {
+        m_output.push_back('[');
+        FixedPoint(coordinate.lat);
+        m_output.push_back(',');
+        FixedPoint(coordinate.lon);
+        m_output.push_back(']');
+        return *this;
+    }
+};
+
+#endif //JSON_WRITER_H
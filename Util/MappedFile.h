@@ -0,0 +1,101 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include "../Util/OSRMException.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/type_traits.hpp>
+
+#include <string>
+
+//Read-only memory mapping of a whole data file. Pages come from the page
+//cache and are shared by all processes that map the same file.
+class MappedFile : boost::noncopyable {
+public:
+    explicit MappedFile(const boost::filesystem::path & file_path) :
+        m_file_name(file_path.string())
+    {
+        if( !boost::filesystem::exists(file_path) ) {
+            throw OSRMException(m_file_name + " does not exist");
+        }
+        if( 0 == boost::filesystem::file_size(file_path) ) {
+            throw OSRMException(m_file_name + " is empty");
+        }
+        boost::interprocess::file_mapping mapping(
+            m_file_name.c_str(),
+            boost::interprocess::read_only
+        );
+        boost::interprocess::mapped_region region(
+            mapping,
+            boost::interprocess::read_only
+        );
+        m_region.swap(region);
+    }
+
+    std::size_t Size() const {
+        return m_region.get_size();
+    }
+
+    //returns a pointer to number_of_elements objects at byte offset, the
+    //mapping is read-only
+    template<typename T>
+    const T * GetPointer(
+        const std::size_t offset,
+        const std::size_t number_of_elements
+    ) const {
+        if(
+            Size() < offset ||
+            (Size() - offset)/sizeof(T) < number_of_elements
+        ) {
+            throw OSRMException(m_file_name + " is truncated");
+        }
+        if( 0 != offset % boost::alignment_of<T>::value ) {
+            throw OSRMException(m_file_name + " has misaligned data");
+        }
+        return reinterpret_cast<const T *>(
+            static_cast<const char *>(m_region.get_address()) + offset
+        );
+    }
+
+    template<typename T>
+    T GetValue(const std::size_t offset) const {
+        return *GetPointer<T>(offset, 1);
+    }
+
+private:
+    std::string m_file_name;
+    boost::interprocess::mapped_region m_region;
+};
+
+#endif //MAPPED_FILE_H
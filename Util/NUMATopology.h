@@ -0,0 +1,193 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+
+#ifndef NUMA_TOPOLOGY_H
+#define NUMA_TOPOLOGY_H
+
+//NUMA nodes and their cpus as listed in sysfs. Nodes without cpus are left
+//out. Memory is placed by the kernel on the node of the thread that touches
+//it first, so data built by a thread bound to a node is local to that node.
+//Other platforms and machines without sysfs report a single node.
+
+#include "SimpleLogger.h"
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/noncopyable.hpp>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include <map>
+#include <string>
+#include <vector>
+
+class NUMATopology : boost::noncopyable {
+public:
+    static const NUMATopology & GetInstance() {
+        static NUMATopology topology("/sys/devices/system/node");
+        return topology;
+    }
+
+    explicit NUMATopology(const boost::filesystem::path & node_directory) {
+        ReadNodes(node_directory);
+        if( m_node_cpu_lists.empty() ) {
+            m_node_cpu_lists.push_back(std::vector<unsigned>());
+        }
+        for(unsigned node = 0; node < m_node_cpu_lists.size(); ++node) {
+            BOOST_FOREACH(const unsigned cpu, m_node_cpu_lists[node]) {
+                if( m_cpu_to_node.size() <= cpu ) {
+                    m_cpu_to_node.resize(cpu+1, 0);
+                }
+                m_cpu_to_node[cpu] = node;
+            }
+        }
+    }
+
+    //nodes are numbered densely from 0, regardless of their ids in sysfs
+    unsigned GetNumberOfNodes() const {
+        return m_node_cpu_lists.size();
+    }
+
+    const std::vector<unsigned> & GetCPUsOfNode(const unsigned node) const {
+        return m_node_cpu_lists.at(node);
+    }
+
+    unsigned GetNodeOfCPU(const unsigned cpu) const {
+        return ( cpu < m_cpu_to_node.size() ? m_cpu_to_node[cpu] : 0 );
+    }
+
+    //node of the cpu the calling thread currently runs on
+    unsigned GetNodeOfCurrentThread() const {
+#ifdef __linux__
+        if( 1 < m_node_cpu_lists.size() ) {
+            const int cpu = sched_getcpu();
+            if( 0 <= cpu ) {
+                return GetNodeOfCPU(cpu);
+            }
+        }
+#endif
+        return 0;
+    }
+
+    //restricts the calling thread to the cpus of a node, threads stay
+    //unrestricted if the topology is unknown
+    bool BindCurrentThreadToNode(const unsigned node) const {
+        const std::vector<unsigned> & cpu_list = GetCPUsOfNode(node);
+        if( cpu_list.empty() ) {
+            return true;
+        }
+#ifdef __linux__
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        BOOST_FOREACH(const unsigned cpu, cpu_list) {
+            if( (unsigned)CPU_SETSIZE <= cpu ) {
+                return false;
+            }
+            CPU_SET(cpu, &cpu_set);
+        }
+        return ( 0 == sched_setaffinity(0, sizeof(cpu_set_t), &cpu_set) );
+#else
+        return false;
+#endif
+    }
+
+private:
+    void ReadNodes(const boost::filesystem::path & node_directory) {
+        if( !boost::filesystem::is_directory(node_directory) ) {
+            return;
+        }
+        //ordered by node id
+        std::map<unsigned, std::vector<unsigned> > cpu_lists;
+        boost::filesystem::directory_iterator end_iterator;
+        for(
+            boost::filesystem::directory_iterator iterator(node_directory);
+            iterator != end_iterator;
+            ++iterator
+        ) {
+            const std::string name = iterator->path().filename().string();
+            if(
+                name.size() <= 4 ||
+                0 != name.compare(0, 4, "node") ||
+                std::string::npos != name.find_first_not_of("0123456789", 4)
+            ) {
+                continue;
+            }
+            std::vector<unsigned> cpu_list;
+            try {
+                ParseCPUList(iterator->path() / "cpulist", cpu_list);
+            } catch(const std::exception & e) {
+                SimpleLogger().Write(logWARNING) <<
+                    "could not read cpus of " << name << ": " << e.what();
+                continue;
+            }
+            if( !cpu_list.empty() ) {
+                cpu_lists[boost::lexical_cast<unsigned>(name.substr(4))] = cpu_list;
+            }
+        }
+        typedef std::map<unsigned, std::vector<unsigned> >::value_type CPUListEntry;
+        BOOST_FOREACH(const CPUListEntry & entry, cpu_lists) {
+            m_node_cpu_lists.push_back(entry.second);
+        }
+    }
+
+    //cpulist format, e.g. "0-7,16-23"
+    static void ParseCPUList(
+        const boost::filesystem::path & cpu_list_path,
+        std::vector<unsigned> & cpu_list
+    ) {
+        boost::filesystem::ifstream cpu_list_stream(cpu_list_path);
+        std::string line;
+        std::getline(cpu_list_stream, line);
+        boost::algorithm::trim(line);
+        if( line.empty() ) {
+            return;
+        }
+        std::vector<std::string> ranges;
+        boost::algorithm::split(ranges, line, boost::algorithm::is_any_of(","));
+        BOOST_FOREACH(const std::string & range, ranges) {
+            const std::string::size_type dash = range.find('-');
+            const unsigned first = boost::lexical_cast<unsigned>(range.substr(0, dash));
+            const unsigned last = ( std::string::npos == dash ? first :
+                boost::lexical_cast<unsigned>(range.substr(dash+1))
+            );
+            for(unsigned cpu = first; cpu <= last; ++cpu) {
+                cpu_list.push_back(cpu);
+            }
+        }
+    }
+
+    std::vector<std::vector<unsigned> > m_node_cpu_lists;
+    std::vector<unsigned>               m_cpu_to_node;
+};
+
+#endif //NUMA_TOPOLOGY_H
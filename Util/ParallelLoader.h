@@ -0,0 +1,157 @@
+/*
+
+Copyright (c) 2013, Project OSRM, Dennis Luxen, others
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+Redistributions of source code must retain the above copyright notice, this list
+of conditions and the following disclaimer.
+Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON
+ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef PARALLEL_LOADER_H
+#define PARALLEL_LOADER_H
+
+#include "OSRMException.h"
+#include "SimpleLogger.h"
+#include "TimingUtil.h"
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/thread.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+//Runs independent loading tasks on a small pool of threads. Every task reads
+//its own file or section, the pool logs load time and throughput per task.
+class ParallelLoader : boost::noncopyable {
+public:
+    explicit ParallelLoader(
+        const unsigned number_of_threads = boost::thread::hardware_concurrency()
+    ) :
+        m_number_of_threads(std::max(1u, number_of_threads)),
+        m_next_task(0)
+    { }
+
+    void AddTask(
+        const std::string & name,
+        const uint64_t number_of_bytes,
+        const boost::function0<void> & function
+    ) {
+        Task task;
+        task.name = name;
+        task.number_of_bytes = number_of_bytes;
+        task.function = function;
+        m_tasks.push_back(task);
+    }
+
+    //runs all tasks, rethrows the first error after all threads finished
+    void Run() {
+        //start with the largest tasks to keep the threads evenly busy
+        std::stable_sort(m_tasks.begin(), m_tasks.end(), LargerTask);
+        const double start_time = get_timestamp();
+        const unsigned number_of_threads = std::min(
+            m_number_of_threads,
+            (unsigned)m_tasks.size()
+        );
+        boost::thread_group threads;
+        for(unsigned i = 0; i < number_of_threads; ++i) {
+            threads.create_thread(boost::bind(&ParallelLoader::Work, this));
+        }
+        threads.join_all();
+        if( !m_error_message.empty() ) {
+            throw OSRMException(m_error_message);
+        }
+
+        uint64_t total_bytes = 0;
+        for(unsigned i = 0; i < m_tasks.size(); ++i) {
+            total_bytes += m_tasks[i].number_of_bytes;
+        }
+        LogThroughput(
+            "all data",
+            total_bytes,
+            get_timestamp() - start_time
+        );
+        m_tasks.clear();
+        m_next_task = 0;
+    }
+
+private:
+    struct Task {
+        std::string            name;
+        uint64_t               number_of_bytes;
+        boost::function0<void> function;
+    };
+
+    static bool LargerTask(const Task & first, const Task & second) {
+        return first.number_of_bytes > second.number_of_bytes;
+    }
+
+    static void LogThroughput(
+        const std::string & name,
+        const uint64_t number_of_bytes,
+        const double duration
+    ) {
+        const double megabytes = number_of_bytes/(1024.*1024.);
+        SimpleLogger().Write() <<
+            "loaded " << name << ": " << megabytes << " MB in " <<
+            duration << " s, " <<
+            (0. < duration ? megabytes/duration : 0.) << " MB/s";
+    }
+
+    void Work() {
+        while(true) {
+            unsigned task_index = 0;
+            {
+                boost::mutex::scoped_lock lock(m_mutex);
+                if( m_tasks.size() == m_next_task || !m_error_message.empty() ) {
+                    return;
+                }
+                task_index = m_next_task;
+                ++m_next_task;
+            }
+            const Task & task = m_tasks[task_index];
+            try {
+                const double start_time = get_timestamp();
+                task.function();
+                LogThroughput(
+                    task.name,
+                    task.number_of_bytes,
+                    get_timestamp() - start_time
+                );
+            } catch(const std::exception & e) {
+                boost::mutex::scoped_lock lock(m_mutex);
+                if( m_error_message.empty() ) {
+                    m_error_message = task.name + ": " + e.what();
+                }
+            }
+        }
+    }
+
+    const unsigned    m_number_of_threads;
+    std::vector<Task> m_tasks;
+    unsigned          m_next_task;
+    std::string       m_error_message;
+    boost::mutex      m_mutex;
+};
+
+#endif //PARALLEL_LOADER_H
@@ -95,7 +95,12 @@ inline bool GenerateServerProgramOptions(
     std::string & ip_address,
     int & ip_port,
     int & requested_num_threads,
-    bool & use_shared_memory
+    bool & use_shared_memory,
+    bool & use_mapped_files,
+    bool & replicate_per_numa_node,
+    bool & warm_up_data,
+    std::string & locked_structures,
+    unsigned & response_cache_size
 ) {
 
     // declare a group of options that will be allowed only on command line
@@ -137,6 +142,10 @@ inline bool GenerateServerProgramOptions(
             "fileindex",
             boost::program_options::value<boost::filesystem::path>(&paths["fileindex"]),
             "File index file")
+        (
+            "pointindex",
+            boost::program_options::value<boost::filesystem::path>(&paths["pointindex"]),
+            ".pointIndex file")
         (
             "namesdata",
             boost::program_options::value<boost::filesystem::path>(&paths["namesdata"]),
@@ -145,6 +154,10 @@ inline bool GenerateServerProgramOptions(
             "timestamp",
             boost::program_options::value<boost::filesystem::path>(&paths["timestamp"]),
             ".timestamp file")
+        (
+            "container",
+            boost::program_options::value<boost::filesystem::path>(&paths["container"]),
+            ".container file, replaces all other data files")
         (
             "ip,i",
             boost::program_options::value<std::string>(&ip_address)->default_value("0.0.0.0"),
@@ -164,6 +177,36 @@ inline bool GenerateServerProgramOptions(
             "sharedmemory,s",
             boost::program_options::value<bool>(&use_shared_memory)->default_value(false),
             "Load data from shared memory"
+        )
+        (
+            "mmap,m",
+            boost::program_options::value<bool>(&use_mapped_files)->default_value(false),
+            "Map data files into memory instead of loading them"
+        )
+        (
+            "numa",
+            boost::program_options::value<bool>(&replicate_per_numa_node)->default_value(false),
+            "Keep a copy of the data on each NUMA node and bind threads to nodes"
+        )
+        (
+            "warmup",
+            boost::program_options::value<bool>(&warm_up_data)->default_value(true),
+            "Touch all data before accepting requests, hot regions first"
+        )
+        (
+            "lock",
+            boost::program_options::value<std::string>(&locked_structures)->default_value("all"),
+            "Lock memory to RAM: all, none or a list of rtree,pointindex,graph,coordinates,edges,names"
+        )
+        (
+            "warmupqueries",
+            boost::program_options::value<boost::filesystem::path>(&paths["warmupqueries"]),
+            "File of request URIs, one per line, answered before accepting requests"
+        )
+        (
+            "responsecache",
+            boost::program_options::value<unsigned>(&response_cache_size)->default_value(0),
+            "Size of the response cache in megabytes, 0 disables it"
         );
 
     // hidden options, will be allowed both on command line and in config
@@ -272,6 +315,14 @@ inline bool GenerateServerProgramOptions(
             path_iterator->second = base_string + ".fileIndex";
         }
 
+        path_iterator = paths.find("pointindex");
+        if(
+            path_iterator != paths.end() &&
+            !boost::filesystem::is_regular_file(path_iterator->second)
+        ) {
+            path_iterator->second = base_string + ".pointIndex";
+        }
+
         path_iterator = paths.find("namesdata");
         if(
             path_iterator != paths.end() &&
@@ -287,6 +338,14 @@ inline bool GenerateServerProgramOptions(
         ) {
             path_iterator->second = base_string + ".timestamp";
         }
+
+        path_iterator = paths.find("container");
+        if(
+            path_iterator != paths.end() &&
+            !boost::filesystem::is_regular_file(path_iterator->second)
+        ) {
+            path_iterator->second = base_string + ".container";
+        }
     }
 
     if( 1 > requested_num_threads ) {
@@ -25,15 +25,21 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 
+#include "DataStructures/NameStore.h"
+#include "DataStructures/OriginalEdgeFile.h"
 #include "DataStructures/QueryEdge.h"
+#include "DataStructures/SearchGraphTrailer.h"
 #include "DataStructures/SharedMemoryFactory.h"
 #include "DataStructures/SharedMemoryVectorWrapper.h"
 #include "DataStructures/StaticGraph.h"
+#include "DataStructures/StaticPointIndex.h"
 #include "DataStructures/StaticRTree.h"
 #include "Server/DataStructures/BaseDataFacade.h"
+#include "Server/DataStructures/DataContainer.h"
 #include "Server/DataStructures/SharedDataType.h"
 #include "Server/DataStructures/SharedBarriers.h"
 #include "Util/BoostFileSystemFix.h"
+#include "Util/ParallelLoader.h"
 #include "Util/ProgramOptions.h"
 #include "Util/SimpleLogger.h"
 #include "Util/UUID.h"
@@ -43,12 +49,606 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <sys/mman.h>
 #endif
 
+#include <boost/bind.hpp>
 #include <boost/integer.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
+static const unsigned RECORD_BLOCK_SIZE = 64*1024;
+// how long an update waits for the queries on the previous data
+static const unsigned PUBLISH_TIMEOUT_IN_SECONDS = 60;
+
+static void SetRamIndexFileName(
+    const std::string & file_name,
+    SharedDataLayout * shared_layout_ptr
+) {
+    std::copy(
+        file_name.begin(),
+        (file_name.length() <= 1024 ? file_name.end() : file_name.begin()+1023),
+        shared_layout_ptr->ram_index_file_name
+    );
+    // add zero termination
+    unsigned end_of_string_index = std::min(1023ul, file_name.length());
+    shared_layout_ptr->ram_index_file_name[end_of_string_index] = '\0';
+}
+
+static void ReadFromStream(
+    std::istream * input_stream,
+    char * output,
+    const uint64_t number_of_bytes
+) {
+    input_stream->read(output, number_of_bytes);
+    if( !(*input_stream) ) {
+        throw OSRMException("input file is truncated");
+    }
+}
+
+// two arrays that follow each other in the file, e.g. graph nodes and edges
+static void ReadConsecutiveArrays(
+    std::istream * input_stream,
+    char * first_output,
+    const uint64_t first_number_of_bytes,
+    char * second_output,
+    const uint64_t second_number_of_bytes
+) {
+    ReadFromStream(input_stream, first_output, first_number_of_bytes);
+    ReadFromStream(input_stream, second_output, second_number_of_bytes);
+}
+
+// records are read in large blocks and packed into the shared arrays
+static void ReadOriginalEdges(
+    std::istream * edges_input_stream,
+    const uint64_t number_of_original_edges,
+    const bool has_zoom_levels,
+    PackedOriginalEdgeData * original_edge_ptr,
+    unsigned char * geometry_zoom_ptr
+) {
+    std::vector<OriginalEdgeData> edge_buffer(
+        std::min(number_of_original_edges, (uint64_t)RECORD_BLOCK_SIZE)
+    );
+    uint64_t i = 0;
+    while( i < number_of_original_edges ) {
+        const uint64_t block_size = std::min(
+            number_of_original_edges - i,
+            (uint64_t)edge_buffer.size()
+        );
+        ReadFromStream(
+            edges_input_stream,
+            (char*)&edge_buffer[0],
+            block_size*sizeof(OriginalEdgeData)
+        );
+        for(uint64_t j = 0; j < block_size; ++j, ++i) {
+            original_edge_ptr[i] = PackedOriginalEdgeData(edge_buffer[j]);
+            geometry_zoom_ptr[i] = ( has_zoom_levels ? edge_buffer[j].minZoomLevel : 0 );
+        }
+    }
+}
+
+static void ReadCoordinates(
+    std::istream * nodes_input_stream,
+    const uint64_t coordinate_list_size,
+    FixedPointCoordinate * coordinates_ptr
+) {
+    std::vector<NodeInfo> node_buffer(
+        std::min(coordinate_list_size, (uint64_t)RECORD_BLOCK_SIZE)
+    );
+    uint64_t i = 0;
+    while( i < coordinate_list_size ) {
+        const uint64_t block_size = std::min(
+            coordinate_list_size - i,
+            (uint64_t)node_buffer.size()
+        );
+        ReadFromStream(
+            nodes_input_stream,
+            (char*)&node_buffer[0],
+            block_size*sizeof(NodeInfo)
+        );
+        for(uint64_t j = 0; j < block_size; ++j, ++i) {
+            coordinates_ptr[i] = FixedPointCoordinate(
+                node_buffer[j].lat,
+                node_buffer[j].lon
+            );
+        }
+    }
+}
+
+// sections are stored in the order of the shared memory layout, each one is
+// read into place by its own task
+static void LoadDataContainer(
+    const boost::filesystem::path & container_path,
+    SharedDataLayout * shared_layout_ptr,
+    const SharedDataType DATA,
+    const unsigned number_of_threads
+) {
+    typedef DataContainerHeader Header;
+
+    SimpleLogger().Write() << "load container from: " << container_path;
+    DataContainerReader container_reader(container_path);
+    SetRamIndexFileName(container_path.string(), shared_layout_ptr);
+    shared_layout_ptr->ram_index_file_offset =
+        container_reader.GetSection(Header::RTREE_LEAVES).offset;
+    shared_layout_ptr->checksum = container_reader.GetHeader().checksum;
+
+    shared_layout_ptr->name_block_list_size =
+        container_reader.GetNumberOfElements<NameBlock>(Header::NAME_BLOCKS);
+    shared_layout_ptr->name_char_list_size =
+        container_reader.GetNumberOfElements<char>(Header::NAME_CHARS);
+    shared_layout_ptr->original_edge_list_size =
+        container_reader.GetNumberOfElements<PackedOriginalEdgeData>(Header::ORIGINAL_EDGES);
+    shared_layout_ptr->graph_node_list_size =
+        container_reader.GetNumberOfElements<QueryGraph::_StrNode>(Header::GRAPH_NODES);
+    shared_layout_ptr->graph_edge_list_size =
+        container_reader.GetNumberOfElements<QueryGraph::_StrEdge>(Header::GRAPH_EDGES);
+    shared_layout_ptr->timestamp_length =
+        container_reader.GetNumberOfElements<char>(Header::TIMESTAMP);
+    shared_layout_ptr->coordinate_list_size =
+        container_reader.GetNumberOfElements<FixedPointCoordinate>(Header::COORDINATES);
+    shared_layout_ptr->r_search_tree_size =
+        container_reader.GetNumberOfElements<RTreeNode>(Header::RTREE_NODES);
+    shared_layout_ptr->point_index_size =
+        container_reader.GetNumberOfElements<PointIndexNode>(Header::POINT_INDEX);
+    shared_layout_ptr->node_length_list_size =
+        container_reader.GetNumberOfElements<unsigned>(Header::GRAPH_NODE_LENGTHS);
+    shared_layout_ptr->edge_length_list_size =
+        container_reader.GetNumberOfElements<unsigned>(Header::GRAPH_EDGE_LENGTHS);
+    shared_layout_ptr->geometry_zoom_list_size =
+        container_reader.GetNumberOfElements<unsigned char>(Header::GEOMETRY_ZOOM_LEVELS);
+    shared_layout_ptr->edge_restriction_count_list_size =
+        container_reader.GetNumberOfElements<unsigned char>(
+            Header::GRAPH_EDGE_RESTRICTION_COUNTS
+        );
+    if( 0 == shared_layout_ptr->graph_node_list_size ) {
+        throw OSRMException("container holds an empty graph");
+    }
+    if( 0 == shared_layout_ptr->point_index_size ) {
+        SimpleLogger().Write(logWARNING) <<
+            "no point index found, locate requests use the r-tree";
+    }
+
+    SimpleLogger().Write() << "allocating shared memory of " << shared_layout_ptr->GetSizeOfLayout() << " bytes";
+    SharedMemory * shared_memory = SharedMemoryFactory::Get(
+        DATA,
+        shared_layout_ptr->GetSizeOfLayout()
+    );
+    char * shared_memory_ptr = static_cast<char *>(shared_memory->Ptr());
+
+    ParallelLoader loader(number_of_threads);
+    container_reader.AddSectionTask(
+        loader,
+        Header::NAME_BLOCKS,
+        shared_memory_ptr + shared_layout_ptr->GetNameBlockOffset()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::NAME_CHARS,
+        shared_memory_ptr + shared_layout_ptr->GetNameListOffset()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::ORIGINAL_EDGES,
+        shared_memory_ptr + shared_layout_ptr->GetOriginalEdgeListOffset()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::GRAPH_NODES,
+        shared_memory_ptr + shared_layout_ptr->GetGraphNodeListOffset()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::GRAPH_EDGES,
+        shared_memory_ptr + shared_layout_ptr->GetGraphEdgeListOffsett()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::TIMESTAMP,
+        shared_memory_ptr + shared_layout_ptr->GetTimeStampOffset()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::COORDINATES,
+        shared_memory_ptr + shared_layout_ptr->GetCoordinateListOffset()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::RTREE_NODES,
+        shared_memory_ptr + shared_layout_ptr->GetRSearchTreeOffset()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::POINT_INDEX,
+        shared_memory_ptr + shared_layout_ptr->GetPointIndexOffset()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::GRAPH_NODE_LENGTHS,
+        shared_memory_ptr + shared_layout_ptr->GetNodeLengthListOffset()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::GRAPH_EDGE_LENGTHS,
+        shared_memory_ptr + shared_layout_ptr->GetEdgeLengthListOffset()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::GEOMETRY_ZOOM_LEVELS,
+        shared_memory_ptr + shared_layout_ptr->GetGeometryZoomListOffset()
+    );
+    container_reader.AddSectionTask(
+        loader,
+        Header::GRAPH_EDGE_RESTRICTION_COUNTS,
+        shared_memory_ptr + shared_layout_ptr->GetEdgeRestrictionCountListOffset()
+    );
+    loader.Run();
+}
+
+static void LoadDataFiles(
+    const ServerPaths & server_paths,
+    SharedDataLayout * shared_layout_ptr,
+    const SharedDataType DATA,
+    const unsigned number_of_threads
+) {
+    if( server_paths.find("hsgrdata") == server_paths.end() ) {
+        throw OSRMException("no hsgr file given in ini file");
+    }
+    if( server_paths.find("ramindex") == server_paths.end() ) {
+        throw OSRMException("no ram index file given in ini file");
+    }
+    if( server_paths.find("fileindex") == server_paths.end() ) {
+        throw OSRMException("no leaf index file given in ini file");
+    }
+    if( server_paths.find("nodesdata") == server_paths.end() ) {
+        throw OSRMException("no nodes file given in ini file");
+    }
+    if( server_paths.find("edgesdata") == server_paths.end() ) {
+        throw OSRMException("no edges file given in ini file");
+    }
+    if( server_paths.find("namesdata") == server_paths.end() ) {
+        throw OSRMException("no names file given in ini file");
+    }
+
+    ServerPaths::const_iterator paths_iterator = server_paths.find("hsgrdata");
+    BOOST_ASSERT(server_paths.end() != paths_iterator);
+    BOOST_ASSERT(!paths_iterator->second.empty());
+    const boost::filesystem::path & hsgr_path = paths_iterator->second;
+    paths_iterator = server_paths.find("timestamp");
+    BOOST_ASSERT(server_paths.end() != paths_iterator);
+    BOOST_ASSERT(!paths_iterator->second.empty());
+    const boost::filesystem::path & timestamp_path = paths_iterator->second;
+    paths_iterator = server_paths.find("ramindex");
+    BOOST_ASSERT(server_paths.end() != paths_iterator);
+    BOOST_ASSERT(!paths_iterator->second.empty());
+    const boost::filesystem::path & ram_index_path = paths_iterator->second;
+    paths_iterator = server_paths.find("fileindex");
+    BOOST_ASSERT(server_paths.end() != paths_iterator);
+    BOOST_ASSERT(!paths_iterator->second.empty());
+    const std::string & file_index_file_name = paths_iterator->second.string();
+    paths_iterator = server_paths.find("nodesdata");
+    BOOST_ASSERT(server_paths.end() != paths_iterator);
+    BOOST_ASSERT(!paths_iterator->second.empty());
+    const boost::filesystem::path & nodes_data_path = paths_iterator->second;
+    paths_iterator = server_paths.find("edgesdata");
+    BOOST_ASSERT(server_paths.end() != paths_iterator);
+    BOOST_ASSERT(!paths_iterator->second.empty());
+    const boost::filesystem::path & edges_data_path = paths_iterator->second;
+    paths_iterator = server_paths.find("namesdata");
+    BOOST_ASSERT(server_paths.end() != paths_iterator);
+    BOOST_ASSERT(!paths_iterator->second.empty());
+    const boost::filesystem::path & names_data_path = paths_iterator->second;
+    paths_iterator = server_paths.find("pointindex");
+    const boost::filesystem::path point_index_path = (
+        server_paths.end() != paths_iterator ?
+        paths_iterator->second : boost::filesystem::path()
+    );
+
+    SetRamIndexFileName(file_index_file_name, shared_layout_ptr);
+
+    // collect number of elements to store in shared memory object
+    SimpleLogger().Write(logDEBUG) << "Collecting files sizes";
+    SimpleLogger().Write() << "load names from: " << names_data_path;
+    // names are escaped and packed up front, their final size is unknown
+    std::vector<NameBlock> name_block_list;
+    std::vector<char> names_char_list;
+    NameStore<true>::LoadRawNames(
+        names_data_path,
+        name_block_list,
+        names_char_list
+    );
+    shared_layout_ptr->name_block_list_size = name_block_list.size();
+    shared_layout_ptr->name_char_list_size = names_char_list.size();
+
+    //Loading information for original edges
+    boost::filesystem::ifstream edges_input_stream(
+        edges_data_path,
+        std::ios::binary
+    );
+    const OriginalEdgeFileLayout edges_file_layout = OriginalEdgeFileLayout::Read(
+        edges_input_stream,
+        edges_data_path.string()
+    );
+    const unsigned number_of_original_edges = edges_file_layout.number_of_edges;
+
+    shared_layout_ptr->original_edge_list_size = number_of_original_edges;
+    shared_layout_ptr->geometry_zoom_list_size = number_of_original_edges;
+
+    boost::filesystem::ifstream hsgr_input_stream(
+        hsgr_path,
+        std::ios::binary
+    );
+
+    UUID uuid_loaded, uuid_orig;
+    hsgr_input_stream.read((char *)&uuid_loaded, sizeof(UUID));
+    if( !uuid_loaded.TestGraphUtil(uuid_orig) ) {
+        SimpleLogger().Write(logWARNING) <<
+            ".hsgr was prepared with different build. "
+            "Reprocess to get rid of this warning.";
+    } else {
+        SimpleLogger().Write(logDEBUG) << "UUID checked out ok";
+    }
+
+    // load checksum
+    unsigned checksum = 0;
+    hsgr_input_stream.read((char*)&checksum, sizeof(unsigned) );
+    shared_layout_ptr->checksum = checksum;
+    // load graph node size
+    unsigned number_of_graph_nodes = 0;
+    hsgr_input_stream.read(
+        (char*) &number_of_graph_nodes,
+        sizeof(unsigned)
+    );
+
+    BOOST_ASSERT_MSG(
+        (0 != number_of_graph_nodes),
+        "number of nodes is zero"
+    );
+    shared_layout_ptr->graph_node_list_size = number_of_graph_nodes;
+
+    // load graph edge size
+    unsigned number_of_graph_edges = 0;
+    hsgr_input_stream.read( (char*) &number_of_graph_edges, sizeof(unsigned) );
+    BOOST_ASSERT_MSG(
+        0 != number_of_graph_edges,
+        "number of graph edges is zero"
+    );
+    shared_layout_ptr->graph_edge_list_size = number_of_graph_edges;
+
+    // node and edge lengths and the edge restriction counts follow the
+    // edges behind a header, each read by a stream of their own
+    shared_layout_ptr->node_length_list_size = number_of_graph_nodes;
+    shared_layout_ptr->edge_length_list_size = number_of_graph_edges;
+    shared_layout_ptr->edge_restriction_count_list_size = number_of_graph_edges;
+    const uint64_t trailer_offset =
+        uint64_t(hsgr_input_stream.tellg()) +
+        number_of_graph_nodes*sizeof(QueryGraph::_StrNode) +
+        number_of_graph_edges*sizeof(QueryGraph::_StrEdge);
+    const uint64_t restriction_counts_offset =
+        trailer_offset + sizeof(SearchGraphTrailerHeader) +
+        (uint64_t(number_of_graph_nodes) + number_of_graph_edges)*sizeof(unsigned);
+    boost::filesystem::ifstream graph_lengths_stream(hsgr_path, std::ios::binary);
+    graph_lengths_stream.seekg(trailer_offset);
+    boost::filesystem::ifstream restriction_counts_stream;
+    if(
+        SearchGraphTrailerHeader::Read(
+            graph_lengths_stream,
+            number_of_graph_edges,
+            hsgr_path.string()
+        )
+    ) {
+        if(
+            boost::filesystem::file_size(hsgr_path) <
+            restriction_counts_offset + number_of_graph_edges
+        ) {
+            throw OSRMException("hsgr file is truncated");
+        }
+        restriction_counts_stream.open(hsgr_path, std::ios::binary);
+        restriction_counts_stream.seekg(restriction_counts_offset);
+    } else {
+        graph_lengths_stream.close();
+    }
+
+    // load rsearch tree size
+    boost::filesystem::ifstream tree_node_file(
+        ram_index_path,
+        std::ios::binary
+    );
+
+    uint32_t tree_size = 0;
+    tree_node_file.read((char*)&tree_size, sizeof(uint32_t));
+    shared_layout_ptr->r_search_tree_size = tree_size;
+
+    // load point index size, the index is optional
+    boost::filesystem::ifstream point_index_stream;
+    if( boost::filesystem::exists(point_index_path) ) {
+        point_index_stream.open(point_index_path, std::ios::binary);
+        unsigned point_index_size = 0;
+        point_index_stream.read((char*)&point_index_size, sizeof(unsigned));
+        shared_layout_ptr->point_index_size = point_index_size;
+    } else {
+        SimpleLogger().Write(logWARNING) <<
+            "no point index found, locate requests use the r-tree";
+    }
+
+    //load timestamp size
+    std::string m_timestamp;
+    if( boost::filesystem::exists(timestamp_path) ) {
+        boost::filesystem::ifstream timestampInStream( timestamp_path );
+        if(!timestampInStream) {
+            SimpleLogger().Write(logWARNING) <<
+                timestamp_path << " not found. setting to default";
+        } else {
+            getline(timestampInStream, m_timestamp);
+            timestampInStream.close();
+        }
+    }
+    if(m_timestamp.empty()) {
+        m_timestamp = "n/a";
+    }
+    if(25 < m_timestamp.length()) {
+        m_timestamp.resize(25);
+    }
+    shared_layout_ptr->timestamp_length = m_timestamp.length();
+
+    //load coordinate size
+    boost::filesystem::ifstream nodes_input_stream(
+        nodes_data_path,
+        std::ios::binary
+    );
+    unsigned coordinate_list_size = 0;
+    nodes_input_stream.read((char *)&coordinate_list_size, sizeof(unsigned));
+    shared_layout_ptr->coordinate_list_size = coordinate_list_size;
+
+
+    // allocate shared memory block
+
+    SimpleLogger().Write() << "allocating shared memory of " << shared_layout_ptr->GetSizeOfLayout() << " bytes";
+    SharedMemory * shared_memory = SharedMemoryFactory::Get(
+        DATA,
+        shared_layout_ptr->GetSizeOfLayout()
+    );
+    char * shared_memory_ptr = static_cast<char *>(shared_memory->Ptr());
+
+    // read actual data into shared memory object, one task per file //
+    ParallelLoader loader(number_of_threads);
+
+    std::copy(
+        name_block_list.begin(),
+        name_block_list.end(),
+        (NameBlock *)(shared_memory_ptr + shared_layout_ptr->GetNameBlockOffset())
+    );
+    std::copy(
+        names_char_list.begin(),
+        names_char_list.end(),
+        shared_memory_ptr + shared_layout_ptr->GetNameListOffset()
+    );
+
+    loader.AddTask(
+        "original edges",
+        number_of_original_edges*sizeof(OriginalEdgeData),
+        boost::bind(
+            ReadOriginalEdges,
+            &edges_input_stream,
+            number_of_original_edges,
+            edges_file_layout.has_zoom_levels,
+            (PackedOriginalEdgeData *)(
+                shared_memory_ptr + shared_layout_ptr->GetOriginalEdgeListOffset()
+            ),
+            (unsigned char *)(
+                shared_memory_ptr + shared_layout_ptr->GetGeometryZoomListOffset()
+            )
+        )
+    );
+
+    loader.AddTask(
+        "coordinates",
+        coordinate_list_size*sizeof(NodeInfo),
+        boost::bind(
+            ReadCoordinates,
+            &nodes_input_stream,
+            coordinate_list_size,
+            (FixedPointCoordinate *)(
+                shared_memory_ptr + shared_layout_ptr->GetCoordinateListOffset()
+            )
+        )
+    );
+
+    // store search tree portion of rtree
+    loader.AddTask(
+        "r-tree nodes",
+        sizeof(RTreeNode)*tree_size,
+        boost::bind(
+            ReadFromStream,
+            &tree_node_file,
+            shared_memory_ptr + shared_layout_ptr->GetRSearchTreeOffset(),
+            sizeof(RTreeNode)*tree_size
+        )
+    );
+
+    if( point_index_stream.is_open() ) {
+        loader.AddTask(
+            "point index",
+            sizeof(PointIndexNode)*shared_layout_ptr->point_index_size,
+            boost::bind(
+                ReadFromStream,
+                &point_index_stream,
+                shared_memory_ptr + shared_layout_ptr->GetPointIndexOffset(),
+                sizeof(PointIndexNode)*shared_layout_ptr->point_index_size
+            )
+        );
+    }
+
+    // the nodes and edges of the search graph
+    loader.AddTask(
+        "graph",
+        shared_layout_ptr->graph_node_list_size*sizeof(QueryGraph::_StrNode) +
+        shared_layout_ptr->graph_edge_list_size*sizeof(QueryGraph::_StrEdge),
+        boost::bind(
+            ReadConsecutiveArrays,
+            &hsgr_input_stream,
+            shared_memory_ptr + shared_layout_ptr->GetGraphNodeListOffset(),
+            shared_layout_ptr->graph_node_list_size*sizeof(QueryGraph::_StrNode),
+            shared_memory_ptr + shared_layout_ptr->GetGraphEdgeListOffsett(),
+            shared_layout_ptr->graph_edge_list_size*sizeof(QueryGraph::_StrEdge)
+        )
+    );
+
+    if( graph_lengths_stream.is_open() ) {
+        loader.AddTask(
+            "graph lengths",
+            (
+                shared_layout_ptr->node_length_list_size +
+                shared_layout_ptr->edge_length_list_size
+            )*sizeof(unsigned),
+            boost::bind(
+                ReadConsecutiveArrays,
+                &graph_lengths_stream,
+                shared_memory_ptr + shared_layout_ptr->GetNodeLengthListOffset(),
+                shared_layout_ptr->node_length_list_size*sizeof(unsigned),
+                shared_memory_ptr + shared_layout_ptr->GetEdgeLengthListOffset(),
+                shared_layout_ptr->edge_length_list_size*sizeof(unsigned)
+            )
+        );
+    } else {
+        std::fill(
+            shared_memory_ptr + shared_layout_ptr->GetNodeLengthListOffset(),
+            shared_memory_ptr + shared_layout_ptr->GetGeometryZoomListOffset(),
+            0
+        );
+    }
+    if( restriction_counts_stream.is_open() ) {
+        loader.AddTask(
+            "graph restriction counts",
+            shared_layout_ptr->edge_restriction_count_list_size,
+            boost::bind(
+                ReadFromStream,
+                &restriction_counts_stream,
+                shared_memory_ptr + shared_layout_ptr->GetEdgeRestrictionCountListOffset(),
+                shared_layout_ptr->edge_restriction_count_list_size
+            )
+        );
+    } else {
+        std::fill(
+            shared_memory_ptr + shared_layout_ptr->GetEdgeRestrictionCountListOffset(),
+            shared_memory_ptr + shared_layout_ptr->GetChecksumOffset(),
+            0
+        );
+    }
+
+    loader.Run();
+
+    //store timestamp
+    char * timestamp_ptr = static_cast<char *>(
+        shared_memory_ptr + shared_layout_ptr->GetTimeStampOffset()
+    );
+    std::copy(
+        m_timestamp.c_str(),
+        m_timestamp.c_str()+m_timestamp.length(),
+        timestamp_ptr
+    );
+}
+
 int main( const int argc, const char * argv[] ) {
     SharedBarriers barrier;
 
@@ -60,19 +660,16 @@ int main( const int argc, const char * argv[] ) {
         }
 #endif
 
-    try {
-        boost::interprocess::scoped_lock<
-            boost::interprocess::named_mutex
-        > pending_lock(barrier.pending_update_mutex);
-    } catch(...) {
-        // hard unlock in case of any exception.
-        barrier.pending_update_mutex.unlock();
-    }
     try {
         LogPolicy::GetInstance().Unmute();
         SimpleLogger().Write(logDEBUG) << "Checking input parameters";
 
         bool use_shared_memory = false;
+        bool use_mapped_files = false;
+        bool replicate_per_numa_node = false;
+        bool warm_up_data = true;
+        std::string locked_structures;
+        unsigned response_cache_size = 0;
         std::string ip_address;
         int ip_port, requested_num_threads;
 
@@ -85,62 +682,36 @@ int main( const int argc, const char * argv[] ) {
                 ip_address,
                 ip_port,
                 requested_num_threads,
-                use_shared_memory
+                use_shared_memory,
+                use_mapped_files,
+                replicate_per_numa_node,
+                warm_up_data,
+                locked_structures,
+                response_cache_size
             )
         ) {
             return 0;
         }
-        if( server_paths.find("hsgrdata") == server_paths.end() ) {
-            throw OSRMException("no hsgr file given in ini file");
-        }
-        if( server_paths.find("ramindex") == server_paths.end() ) {
-            throw OSRMException("no ram index file given in ini file");
-        }
-        if( server_paths.find("fileindex") == server_paths.end() ) {
-            throw OSRMException("no leaf index file given in ini file");
-        }
-        if( server_paths.find("nodesdata") == server_paths.end() ) {
-            throw OSRMException("no nodes file given in ini file");
-        }
-        if( server_paths.find("edgesdata") == server_paths.end() ) {
-            throw OSRMException("no edges file given in ini file");
-        }
-        if( server_paths.find("namesdata") == server_paths.end() ) {
-            throw OSRMException("no names file given in ini file");
-        }
 
-        ServerPaths::const_iterator paths_iterator = server_paths.find("hsgrdata");
-        BOOST_ASSERT(server_paths.end() != paths_iterator);
-        BOOST_ASSERT(!paths_iterator->second.empty());
-        const boost::filesystem::path & hsgr_path = paths_iterator->second;
-        paths_iterator = server_paths.find("timestamp");
-        BOOST_ASSERT(server_paths.end() != paths_iterator);
-        BOOST_ASSERT(!paths_iterator->second.empty());
-        const boost::filesystem::path & timestamp_path = paths_iterator->second;
-        paths_iterator = server_paths.find("ramindex");
-        BOOST_ASSERT(server_paths.end() != paths_iterator);
-        BOOST_ASSERT(!paths_iterator->second.empty());
-        const boost::filesystem::path & ram_index_path = paths_iterator->second;
-        paths_iterator = server_paths.find("fileindex");
-        BOOST_ASSERT(server_paths.end() != paths_iterator);
-        BOOST_ASSERT(!paths_iterator->second.empty());
-        const std::string & file_index_file_name = paths_iterator->second.string();
-        paths_iterator = server_paths.find("nodesdata");
-        BOOST_ASSERT(server_paths.end() != paths_iterator);
-        BOOST_ASSERT(!paths_iterator->second.empty());
-        const boost::filesystem::path & nodes_data_path = paths_iterator->second;
-        paths_iterator = server_paths.find("edgesdata");
-        BOOST_ASSERT(server_paths.end() != paths_iterator);
-        BOOST_ASSERT(!paths_iterator->second.empty());
-        const boost::filesystem::path & edges_data_path = paths_iterator->second;
-        paths_iterator = server_paths.find("namesdata");
-        BOOST_ASSERT(server_paths.end() != paths_iterator);
-        BOOST_ASSERT(!paths_iterator->second.empty());
-        const boost::filesystem::path & names_data_path = paths_iterator->second;
-
-
-        // get the shared memory segment to use
-        bool use_first_segment = SharedMemory::RegionExists( LAYOUT_2 );
+        // only one update at a time, queries are not blocked by it
+        boost::interprocess::scoped_lock<
+            boost::interprocess::named_mutex
+        > update_lock(barrier.update_mutex);
+
+        SharedMemory * data_type_memory = SharedMemoryFactory::Get(
+            CURRENT_REGIONS,
+            sizeof(SharedDataTimestamp),
+            true,
+            false
+        );
+        SharedDataTimestamp * data_timestamp_ptr = static_cast<SharedDataTimestamp*>(
+            data_type_memory->Ptr()
+        );
+
+        // get the shared memory segment to use, never the current one
+        bool use_first_segment = (
+            DATA_2 == SharedDataGeneration::GetCurrentData(data_timestamp_ptr)
+        );
         SharedDataType LAYOUT = ( use_first_segment ? LAYOUT_1 : LAYOUT_2 );
         SharedDataType DATA   = ( use_first_segment ? DATA_1 : DATA_2 );
 
@@ -154,254 +725,52 @@ int main( const int argc, const char * argv[] ) {
         );
         shared_layout_ptr = new(layout_memory->Ptr()) SharedDataLayout();
 
-        std::copy(
-            file_index_file_name.begin(),
-            (file_index_file_name.length() <= 1024 ? file_index_file_name.end() : file_index_file_name.begin()+1023),
-            shared_layout_ptr->ram_index_file_name
-        );
-        // add zero termination
-        unsigned end_of_string_index = std::min(1023ul, file_index_file_name.length());
-        shared_layout_ptr->ram_index_file_name[end_of_string_index] = '\0';
-
-        // collect number of elements to store in shared memory object
-        SimpleLogger().Write(logDEBUG) << "Collecting files sizes";
-        SimpleLogger().Write() << "load names from: " << names_data_path;
-        // number of entries in name index
-        boost::filesystem::ifstream name_stream(
-            names_data_path, std::ios::binary
-        );
-        unsigned name_index_size = 0;
-        name_stream.read((char *)&name_index_size, sizeof(unsigned));
-        shared_layout_ptr->name_index_list_size = name_index_size;
-        SimpleLogger().Write() << "size: " << name_index_size;
-        // SimpleLogger().Write() << "name index size: " << shared_layout_ptr->name_index_list_size;
-        BOOST_ASSERT_MSG(0 != shared_layout_ptr->name_index_list_size, "name file broken");
-
-        unsigned number_of_chars = 0;
-        name_stream.read((char *)&number_of_chars, sizeof(unsigned));
-        shared_layout_ptr->name_char_list_size = number_of_chars;
-        // SimpleLogger().Write() << "name char size: " << shared_layout_ptr->name_char_list_size;
-
-        //Loading information for original edges
-        boost::filesystem::ifstream edges_input_stream(
-            edges_data_path,
-            std::ios::binary
-        );
-        unsigned number_of_original_edges = 0;
-        edges_input_stream.read((char*)&number_of_original_edges, sizeof(unsigned));
-
-        shared_layout_ptr->via_node_list_size = number_of_original_edges;
-        shared_layout_ptr->name_id_list_size = number_of_original_edges;
-        shared_layout_ptr->turn_instruction_list_size = number_of_original_edges;
-
-        boost::filesystem::ifstream hsgr_input_stream(
-            hsgr_path,
-            std::ios::binary
-        );
-
-        UUID uuid_loaded, uuid_orig;
-        hsgr_input_stream.read((char *)&uuid_loaded, sizeof(UUID));
-        if( !uuid_loaded.TestGraphUtil(uuid_orig) ) {
-            SimpleLogger().Write(logWARNING) <<
-                ".hsgr was prepared with different build. "
-                "Reprocess to get rid of this warning.";
+        ServerPaths::const_iterator container_iterator = server_paths.find("container");
+        if(
+            server_paths.end() != container_iterator &&
+            boost::filesystem::is_regular_file(container_iterator->second)
+        ) {
+            LoadDataContainer(
+                container_iterator->second,
+                shared_layout_ptr,
+                DATA,
+                requested_num_threads
+            );
         } else {
-            SimpleLogger().Write(logDEBUG) << "UUID checked out ok";
+            LoadDataFiles(
+                server_paths,
+                shared_layout_ptr,
+                DATA,
+                requested_num_threads
+            );
         }
 
-        // load checksum
-        unsigned checksum = 0;
-        hsgr_input_stream.read((char*)&checksum, sizeof(unsigned) );
-        shared_layout_ptr->checksum = checksum;
-        // load graph node size
-        unsigned number_of_graph_nodes = 0;
-        hsgr_input_stream.read(
-            (char*) &number_of_graph_nodes,
-            sizeof(unsigned)
-        );
-
-        BOOST_ASSERT_MSG(
-            (0 != number_of_graph_nodes),
-            "number of nodes is zero"
-        );
-        shared_layout_ptr->graph_node_list_size = number_of_graph_nodes;
-
-        // load graph edge size
-        unsigned number_of_graph_edges = 0;
-        hsgr_input_stream.read( (char*) &number_of_graph_edges, sizeof(unsigned) );
-        BOOST_ASSERT_MSG(
-            0 != number_of_graph_edges,
-            "number of graph edges is zero"
-        );
-        shared_layout_ptr->graph_edge_list_size = number_of_graph_edges;
-
-        // load rsearch tree size
-        boost::filesystem::ifstream tree_node_file(
-            ram_index_path,
-            std::ios::binary
-        );
-
-        uint32_t tree_size = 0;
-        tree_node_file.read((char*)&tree_size, sizeof(uint32_t));
-        shared_layout_ptr->r_search_tree_size = tree_size;
-
-        //load timestamp size
-        std::string m_timestamp;
-        if( boost::filesystem::exists(timestamp_path) ) {
-            boost::filesystem::ifstream timestampInStream( timestamp_path );
-            if(!timestampInStream) {
-                SimpleLogger().Write(logWARNING) <<
-                    timestamp_path << " not found. setting to default";
-            } else {
-                getline(timestampInStream, m_timestamp);
-                timestampInStream.close();
+        // publish the new data, then wait for queries on the old one
+        if(
+            !SharedDataGeneration::Publish(
+                data_timestamp_ptr,
+                LAYOUT,
+                DATA,
+                PUBLISH_TIMEOUT_IN_SECONDS
+            )
+        ) {
+            // the previous data is current again, drop the new one once the
+            // queries that already picked it up are done
+            if(
+                SharedDataGeneration::WaitForReaders(
+                    data_timestamp_ptr,
+                    SharedDataGeneration::GetReaderSlot(DATA),
+                    PUBLISH_TIMEOUT_IN_SECONDS
+                )
+            ) {
+                SharedMemory::Remove(DATA);
+                SharedMemory::Remove(LAYOUT);
             }
-        }
-        if(m_timestamp.empty()) {
-            m_timestamp = "n/a";
-        }
-        if(25 < m_timestamp.length()) {
-            m_timestamp.resize(25);
-        }
-        shared_layout_ptr->timestamp_length = m_timestamp.length();
-
-        //load coordinate size
-        boost::filesystem::ifstream nodes_input_stream(
-            nodes_data_path,
-            std::ios::binary
-        );
-        unsigned coordinate_list_size = 0;
-        nodes_input_stream.read((char *)&coordinate_list_size, sizeof(unsigned));
-        shared_layout_ptr->coordinate_list_size = coordinate_list_size;
-
-
-        // allocate shared memory block
-
-        SimpleLogger().Write() << "allocating shared memory of " << shared_layout_ptr->GetSizeOfLayout() << " bytes";
-        SharedMemory * shared_memory = SharedMemoryFactory::Get(
-            DATA,
-            shared_layout_ptr->GetSizeOfLayout()
-        );
-        char * shared_memory_ptr = static_cast<char *>(shared_memory->Ptr());
-
-        // read actual data into shared memory object //
-        // Loading street names
-        // SimpleLogger().Write() << "Loading names index and chars from: " << names_data_path.string();
-        unsigned * name_index_ptr = (unsigned*)(
-            shared_memory_ptr + shared_layout_ptr->GetNameIndexOffset()
-        );
-        // SimpleLogger().Write(logDEBUG) << "Bytes: " << shared_layout_ptr->name_index_list_size*sizeof(unsigned);
-
-        name_stream.read(
-            (char*)name_index_ptr,
-            shared_layout_ptr->name_index_list_size*sizeof(unsigned)
-        );
-
-        char * name_char_ptr = shared_memory_ptr + shared_layout_ptr->GetNameListOffset();
-        name_stream.read(
-            name_char_ptr,
-            shared_layout_ptr->name_char_list_size*sizeof(char)
-        );
-        name_stream.close();
-
-        //load original edge information
-        NodeID * via_node_ptr = (NodeID *)(
-            shared_memory_ptr + shared_layout_ptr->GetViaNodeListOffset()
-        );
-
-        unsigned * name_id_ptr = (unsigned *)(
-            shared_memory_ptr + shared_layout_ptr->GetNameIDListOffset()
-        );
-
-        TurnInstruction * turn_instructions_ptr = (TurnInstruction *)(
-            shared_memory_ptr + shared_layout_ptr->GetTurnInstructionListOffset()
-        );
-
-        OriginalEdgeData current_edge_data;
-        for(unsigned i = 0; i < number_of_original_edges; ++i) {
-            // SimpleLogger().Write() << i << "/" << number_of_edges;
-            edges_input_stream.read(
-                (char*)&(current_edge_data),
-                sizeof(OriginalEdgeData)
+            throw OSRMException(
+                "queries on the previous data did not finish, run "
+                "osrm-unlock-all if a query process has crashed"
             );
-            via_node_ptr[i] = current_edge_data.viaNode;
-            name_id_ptr[i]  = current_edge_data.nameID;
-            turn_instructions_ptr[i] = current_edge_data.turnInstruction;
-        }
-        edges_input_stream.close();
-
-        // Loading list of coordinates
-        FixedPointCoordinate * coordinates_ptr = (FixedPointCoordinate *)(
-            shared_memory_ptr + shared_layout_ptr->GetCoordinateListOffset()
-        );
-
-        NodeInfo current_node;
-        for(unsigned i = 0; i < coordinate_list_size; ++i) {
-            nodes_input_stream.read((char *)&current_node, sizeof(NodeInfo));
-            coordinates_ptr[i] = FixedPointCoordinate(current_node.lat, current_node.lon);
-        }
-        nodes_input_stream.close();
-
-        //store timestamp
-        char * timestamp_ptr = static_cast<char *>(
-            shared_memory_ptr + shared_layout_ptr->GetTimeStampOffset()
-        );
-        std::copy(
-            m_timestamp.c_str(),
-            m_timestamp.c_str()+m_timestamp.length(),
-            timestamp_ptr
-        );
-
-        // store search tree portion of rtree
-        char * rtree_ptr = static_cast<char *>(
-            shared_memory_ptr + shared_layout_ptr->GetRSearchTreeOffset()
-        );
-
-        tree_node_file.read(rtree_ptr, sizeof(RTreeNode)*tree_size);
-        tree_node_file.close();
-
-        // load the nodes of the search graph
-        QueryGraph::_StrNode * graph_node_list_ptr = (QueryGraph::_StrNode*)(
-            shared_memory_ptr + shared_layout_ptr->GetGraphNodeListOffset()
-        );
-        hsgr_input_stream.read(
-            (char*) graph_node_list_ptr,
-            shared_layout_ptr->graph_node_list_size*sizeof(QueryGraph::_StrNode)
-        );
-
-        // load the edges of the search graph
-        QueryGraph::_StrEdge * graph_edge_list_ptr = (QueryGraph::_StrEdge *)(
-            shared_memory_ptr + shared_layout_ptr->GetGraphEdgeListOffsett()
-        );
-        hsgr_input_stream.read(
-            (char*) graph_edge_list_ptr,
-            shared_layout_ptr->graph_edge_list_size*sizeof(QueryGraph::_StrEdge)
-        );
-        hsgr_input_stream.close();
-
-        //TODO acquire lock
-        SharedMemory * data_type_memory = SharedMemoryFactory::Get(
-            CURRENT_REGIONS,
-            sizeof(SharedDataTimestamp),
-            true,
-            false
-        );
-        SharedDataTimestamp * data_timestamp_ptr = static_cast<SharedDataTimestamp*>(
-            data_type_memory->Ptr()
-        );
-
-        boost::interprocess::scoped_lock<
-            boost::interprocess::named_mutex
-        > query_lock(barrier.query_mutex);
-
-        // notify all processes that were waiting for this condition
-        if (0 < barrier.number_of_queries) {
-            barrier.no_running_queries_condition.wait(query_lock);
         }
-
-        data_timestamp_ptr->layout = LAYOUT;
-        data_timestamp_ptr->data = DATA;
-        data_timestamp_ptr->timestamp +=1;
         if(use_first_segment) {
             BOOST_ASSERT( DATA   == DATA_1   );
             BOOST_ASSERT( LAYOUT == LAYOUT_1 );
@@ -424,6 +793,7 @@ int main( const int argc, const char * argv[] ) {
         SimpleLogger().Write() << "all data loaded";
     } catch(const std::exception & e) {
         SimpleLogger().Write(logWARNING) << "caught exception: " << e.what();
+        return 1;
     }
 
     return 0;
@@ -0,0 +1,90 @@
+@binary
+Feature: Binary route output
+The binary reply decodes to the same route as the JSON reply
+
+    Background:
+        Given the profile "testbot"
+
+    Scenario: Binary - Turns and names
+        Given the node map
+            | a | b | c |
+            |   |   | d |
+            | f |   | e |
+
+        And the ways
+            | nodes |
+            | abc   |
+            | cde   |
+            | ef    |
+
+        When I route in binary I should get
+            | from | to | route      | binary |
+            | a    | c  | abc        | same   |
+            | a    | e  | abc,cde    | same   |
+            | a    | f  | abc,cde,ef | same   |
+            | f    | a  | ef,cde,abc | same   |
+
+    Scenario: Binary - Via points
+        Given the node map
+            | a | b | c | d |
+
+        And the ways
+            | nodes |
+            | abcd  |
+
+        When I route in binary I should get
+            | waypoints | route     | binary |
+            | a,b,d     | abcd      | same   |
+            | a,d,c     | abcd,abcd | same   |
+
+    Scenario: Binary - Roundabout exits
+        Given the node map
+            |   |   | v |   |   |
+            |   |   | d |   |   |
+            | s | a |   | c | u |
+            |   |   | b |   |   |
+            |   |   | t |   |   |
+
+        And the ways
+            | nodes | junction   |
+            | sa    |            |
+            | tb    |            |
+            | uc    |            |
+            | vd    |            |
+            | abcda | roundabout |
+
+        When I route in binary I should get
+            | from | to | route | binary |
+            | s    | t  | sa,tb | same   |
+            | s    | u  | sa,uc | same   |
+            | s    | v  | sa,vd | same   |
+
+    Scenario: Binary - Without geometry or instructions
+        Given the node map
+            | a | b | c |
+            |   |   | d |
+
+        And the ways
+            | nodes |
+            | abc   |
+            | cd    |
+
+        When I route in binary I should get
+            | from | to | param:geometry | param:instructions | binary |
+            | a    | d  | false          |                    | same   |
+            | a    | d  |                | false              | same   |
+            | a    | d  | false          | false              | same   |
+
+    Scenario: Binary - No route
+        Given the node map
+            | a | b |   | c | d |
+
+        And the ways
+            | nodes | oneway |
+            | ab    | yes    |
+            | cd    |        |
+
+        When I route in binary I should get
+            | from | to | route | binary |
+            | b    | a  |       | same   |
+            | a    | d  |       | same   |
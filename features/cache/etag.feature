@@ -0,0 +1,39 @@
+@cache
+Feature: ETags of cached replies
+
+    Background:
+        Given the profile "testbot"
+
+    Scenario: Repeating a request with its ETag
+        Given the node map
+            | a | b | c |
+
+        And the ways
+            | nodes |
+            | abc   |
+
+        When I route with the response cache I should get
+            | from | to | status | repeated status | repeated body |
+            | a    | c  | 200    | 304             | empty         |
+            | c    | a  | 200    | 304             | empty         |
+
+    Scenario: The ETag depends on the request
+        Given the node map
+            | a | b | c |
+            |   |   | d |
+
+        And the ways
+            | nodes |
+            | abc   |
+            | cd    |
+
+        When I route with the response cache I should get
+            | from | to | param:precision | param:generalize | etag |
+            | a    | d  |                 |                  | A    |
+            | a    | d  |                 |                  | A    |
+            | a    | d  | 6               |                  | A    |
+            | a    | d  | 5               |                  | B    |
+            | a    | d  |                 | false            | A    |
+            | a    | d  |                 | true             | C    |
+            | a    | d  | 5               | true             | D    |
+            | d    | a  |                 |                  | E    |
@@ -0,0 +1,96 @@
+@eta
+Feature: Duration and distance without route geometry
+Testbot speeds:
+Primary road:    36km/h = 36000m/3600s = 100m/10s
+Secondary road:    18km/h = 18000m/3600s = 100m/20s
+Tertiary road:    12km/h = 12000m/3600s = 100m/30s
+
+    Background:
+        Given the profile "testbot"
+        Given a grid size of 100 meters
+
+    Scenario: ETA - Duration and distance along a way
+        Given the node map
+            | a | b | c | d |
+
+        And the ways
+            | nodes | highway   |
+            | ab    | primary   |
+            | bc    | secondary |
+            | cd    | tertiary  |
+
+        When I request eta I should get
+            | from | to | distance  | time    |
+            | a    | b  | 100m +-2  | 10s +-1 |
+            | a    | c  | 200m +-2  | 30s +-1 |
+            | a    | d  | 300m +-2  | 60s +-1 |
+            | d    | a  | 300m +-2  | 60s +-1 |
+            | c    | b  | 100m +-2  | 20s +-1 |
+
+    Scenario: ETA - Same duration and distance as the route
+        Given the node map
+            | a | b | c |
+            |   |   | d |
+            | f |   | e |
+
+        And the ways
+            | nodes | highway   |
+            | abc   | primary   |
+            | cde   | secondary |
+            | ef    | primary   |
+
+        When I route I should get
+            | from | to | route       | distance | time    |
+            | a    | e  | abc,cde     | 400m +-2 | 60s +-1 |
+            | a    | f  | abc,cde,ef  | 600m +-2 | 80s +-1 |
+
+        When I request eta I should get
+            | from | to | distance | time    |
+            | a    | e  | 400m +-2 | 60s +-1 |
+            | a    | f  | 600m +-2 | 80s +-1 |
+
+    Scenario: ETA - Via points
+        Given the node map
+            | a | b | c | d |
+
+        And the ways
+            | nodes |
+            | abcd  |
+
+        When I request eta I should get
+            | waypoints | distance |
+            | a,b,d     | 300m +-2 |
+            | a,d,c     | 400m +-2 |
+
+    Scenario: ETA - No route
+        Given the node map
+            | a | b |   | c | d |
+
+        And the ways
+            | nodes | oneway |
+            | ab    | yes    |
+            | cd    |        |
+
+        When I request eta I should get
+            | from | to | distance | time |
+            | b    | a  |          |      |
+            | a    | d  |          |      |
+
+    Scenario: ETA - Access restriction penalties are not part of the duration
+        Given the profile "car"
+        Given the node map
+            | a | b | c | d |
+
+        And the ways
+            | nodes | highway | access      |
+            | ab    | primary |             |
+            | bc    | primary | destination |
+            | cd    | primary | destination |
+
+        When I route I should get
+            | from | to | route    | time     |
+            | a    | d  | ab,bc,cd | 17s ~20% |
+
+        When I request eta I should get
+            | from | to | distance | time     |
+            | a    | d  | 300m +-2 | 17s ~20% |
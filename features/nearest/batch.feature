@@ -0,0 +1,45 @@
+@nearest
+Feature: Locating Nearest node on a Way - batch requests
+
+    Background:
+        Given the profile "testbot"
+
+    Scenario: Nearest batch - results are in input order
+        Given the node map
+            |   | 0 | c | 1 |   |
+            | 7 |   | n |   | 2 |
+            | a | k | x | m | b |
+            | 6 |   | l |   | 3 |
+            |   | 5 | d | 4 |   |
+
+        And the ways
+            | nodes |
+            | axb   |
+            | cxd   |
+
+        When I request nearest in a batch I should get
+            | in | out |
+            | 0  | c   |
+            | 4  | d   |
+            | 2  | b   |
+            | 6  | a   |
+            | 1  | c   |
+            | 5  | d   |
+            | 3  | b   |
+            | 7  | a   |
+            | k  | k   |
+            | n  | n   |
+
+    Scenario: Nearest batch - too many coordinates
+        Given the node map
+            | a | b |
+
+        And the ways
+            | nodes |
+            | ab    |
+
+        When I request nearest in a batch of repeated coordinates I should get
+            | in | count | status |
+            | a  | 1     | 200    |
+            | a  | 1000  | 200    |
+            | a  | 1001  | 400    |
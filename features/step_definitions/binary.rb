@@ -0,0 +1,69 @@
+When /^I route in binary I should get$/ do |table|
+  reprocess
+  actual = []
+  OSRMLauncher.new("#{@osm_file}.osrm") do
+    table.hashes.each_with_index do |row,ri|
+      waypoints = []
+      if row['from'] and row['to']
+        node = find_node_by_name(row['from'])
+        raise "*** unknown from-node '#{row['from']}" unless node
+        waypoints << node
+
+        node = find_node_by_name(row['to'])
+        raise "*** unknown to-node '#{row['to']}" unless node
+        waypoints << node
+
+        got = {'from' => row['from'], 'to' => row['to'] }
+      elsif row['waypoints']
+        row['waypoints'].split(',').each do |n|
+          node = find_node_by_name(n.strip)
+          raise "*** unknown waypoint node '#{n.strip}" unless node
+          waypoints << node
+        end
+        got = {'waypoints' => row['waypoints'] }
+      else
+        raise "*** no waypoints"
+      end
+
+      params = {}
+      row.each_pair do |k,v|
+        if k =~ /param:(.*)/
+          params[$1]=v if v!=''
+          got[k]=v
+        end
+      end
+
+      response = request_route waypoints, params.merge('compression' => false)
+      binary_response = request_route waypoints, params.merge('output' => 'binary')
+
+      if table.headers.include? 'route'
+        got['route'] = got_route?(response) ? way_list(JSON.parse(response.body)['route_instructions']) : ''
+      end
+      if table.headers.include? 'binary'
+        if response.code != "200" || binary_response.code != "200"
+          got['binary'] = "HTTP #{response.code}/#{binary_response.code}"
+        else
+          differences = binary_route_differences parse_binary_route(binary_response.body), JSON.parse(response.body)
+          got['binary'] = differences.empty? ? 'same' : "differs: #{differences.join(',')}"
+        end
+      end
+
+      ok = true
+      row.keys.each do |key|
+        if FuzzyMatch.match got[key], row[key]
+          got[key] = row[key]
+        else
+          ok = false
+        end
+      end
+
+      unless ok
+        failed = { :attempt => 'binary', :query => @query, :response => binary_response }
+        log_fail row,got,[failed]
+      end
+
+      actual << got
+    end
+  end
+  table.routing_diff! actual
+end
@@ -0,0 +1,64 @@
+When /^I route with the response cache I should get$/ do |table|
+  reprocess
+  actual = []
+  etags = {}
+  OSRMLauncher.new("#{@osm_file}.osrm", "--responsecache #{RESPONSE_CACHE_SIZE}") do
+    table.hashes.each_with_index do |row,ri|
+      waypoints = []
+      node = find_node_by_name(row['from'])
+      raise "*** unknown from-node '#{row['from']}" unless node
+      waypoints << node
+      node = find_node_by_name(row['to'])
+      raise "*** unknown to-node '#{row['to']}" unless node
+      waypoints << node
+      got = {'from' => row['from'], 'to' => row['to'] }
+
+      params = {}
+      row.each_pair do |k,v|
+        if k =~ /param:(.*)/
+          params[$1]=v if v!=''
+          got[k]=v
+        end
+      end
+
+      response = request_cached_route waypoints, params
+      etag = response['ETag']
+      if table.headers.include? 'status'
+        got['status'] = response.code
+      end
+      if table.headers.include? 'etag'
+        # rows with the same label must get the same ETag, other labels another one
+        label = etags.key(etag)
+        if etag && label.nil? && !etags.has_key?(row['etag'])
+          label = row['etag']
+          etags[label] = etag
+        end
+        got['etag'] = label || etag.to_s
+      end
+      if table.headers.include? 'repeated status'
+        repeated = request_cached_route waypoints, params, etag
+        got['repeated status'] = repeated.code
+        if table.headers.include? 'repeated body'
+          got['repeated body'] = (repeated.body.nil? || repeated.body.empty?) ? 'empty' : repeated.body
+        end
+      end
+
+      ok = true
+      row.keys.each do |key|
+        if FuzzyMatch.match got[key], row[key]
+          got[key] = row[key]
+        else
+          ok = false
+        end
+      end
+
+      unless ok
+        failed = { :attempt => 'cached route', :query => @query, :response => response }
+        log_fail row,got,[failed]
+      end
+
+      actual << got
+    end
+  end
+  table.routing_diff! actual
+end
@@ -0,0 +1,68 @@
+When /^I request eta I should get$/ do |table|
+  reprocess
+  actual = []
+  OSRMLauncher.new("#{@osm_file}.osrm") do
+    table.hashes.each_with_index do |row,ri|
+      waypoints = []
+      if row['from'] and row['to']
+        node = find_node_by_name(row['from'])
+        raise "*** unknown from-node '#{row['from']}" unless node
+        waypoints << node
+
+        node = find_node_by_name(row['to'])
+        raise "*** unknown to-node '#{row['to']}" unless node
+        waypoints << node
+
+        got = {'from' => row['from'], 'to' => row['to'] }
+      elsif row['waypoints']
+        row['waypoints'].split(',').each do |n|
+          node = find_node_by_name(n.strip)
+          raise "*** unknown waypoint node '#{n.strip}" unless node
+          waypoints << node
+        end
+        got = {'waypoints' => row['waypoints'] }
+      else
+        raise "*** no waypoints"
+      end
+
+      response = request_eta waypoints
+      summary = nil
+      if response.code == "200" && response.body.empty? == false
+        json = JSON.parse response.body
+        if json['status'] == 0
+          summary = json['route_summary']
+        end
+      end
+
+      if table.headers.include? 'distance'
+        if row['distance']!=''
+          raise "*** Distance must be specied in meters. (ex: 250m)" unless row['distance'] =~ /\d+m/
+        end
+        got['distance'] = summary ? "#{summary['total_distance'].to_s}m" : ''
+      end
+      if table.headers.include? 'time'
+        if row['time']!=''
+          raise "*** Time must be specied in seconds. (ex: 60s)" unless row['time'] =~ /\d+s/
+        end
+        got['time'] = summary ? "#{summary['total_time'].to_s}s" : ''
+      end
+
+      ok = true
+      row.keys.each do |key|
+        if FuzzyMatch.match got[key], row[key]
+          got[key] = row[key]
+        else
+          ok = false
+        end
+      end
+
+      unless ok
+        failed = { :attempt => 'eta', :query => @query, :response => response }
+        log_fail row,got,[failed]
+      end
+
+      actual << got
+    end
+  end
+  table.routing_diff! actual
+end
@@ -0,0 +1,50 @@
+When /^I request the route geometry I should get$/ do |table|
+  reprocess
+  actual = []
+  OSRMLauncher.new("#{@osm_file}.osrm") do
+    table.hashes.each_with_index do |row,ri|
+      waypoints = []
+      node = find_node_by_name(row['from'])
+      raise "*** unknown from-node '#{row['from']}" unless node
+      waypoints << node
+      node = find_node_by_name(row['to'])
+      raise "*** unknown to-node '#{row['to']}" unless node
+      waypoints << node
+      got = {'from' => row['from'], 'to' => row['to'] }
+
+      params = {}
+      row.each_pair do |k,v|
+        if k =~ /param:(.*)/
+          params[$1]=v if v!=''
+          got[k]=v
+        end
+      end
+
+      response = request_route waypoints, params
+      if response.code == "200" && response.body.empty? == false
+        json = JSON.parse response.body
+        precision = (params['precision'] || 6).to_i
+        got['geometry'] = geometry_node_list decode_polyline(json['route_geometry'], precision), precision
+      else
+        got['geometry'] = "HTTP #{response.code}"
+      end
+
+      ok = true
+      row.keys.each do |key|
+        if FuzzyMatch.match got[key], row[key]
+          got[key] = row[key]
+        else
+          ok = false
+        end
+      end
+
+      unless ok
+        failed = { :attempt => 'geometry', :query => @query, :response => response }
+        log_fail row,got,[failed]
+      end
+
+      actual << got
+    end
+  end
+  table.routing_diff! actual
+end
@@ -0,0 +1,54 @@
+When /^I request a GPX route I should get$/ do |table|
+  reprocess
+  actual = []
+  OSRMLauncher.new("#{@osm_file}.osrm") do
+    table.hashes.each_with_index do |row,ri|
+      waypoints = []
+      node = find_node_by_name(row['from'])
+      raise "*** unknown from-node '#{row['from']}" unless node
+      waypoints << node
+      node = find_node_by_name(row['to'])
+      raise "*** unknown to-node '#{row['to']}" unless node
+      waypoints << node
+      got = {'from' => row['from'], 'to' => row['to'] }
+
+      params = {}
+      row.each_pair do |k,v|
+        if k =~ /param:(.*)/
+          params[$1]=v if v!=''
+          got[k]=v
+        end
+      end
+
+      response = request_gpx_route waypoints, params
+      points = response.code == "200" ? parse_gpx_points(response.body) : []
+      if table.headers.include? 'points'
+        got['points'] = response.code == "200" ? geometry_node_list(points) : "HTTP #{response.code}"
+      end
+      if table.headers.include? 'geometry'
+        #the route_geometry of the JSON reply with the same zoom level
+        json = JSON.parse request_route(waypoints, params).body
+        geometry = decode_polyline json['route_geometry']
+        same = points.map { |point| fixed_point point } == geometry.map { |point| fixed_point point }
+        got['geometry'] = same ? 'same' : 'differs'
+      end
+
+      ok = true
+      row.keys.each do |key|
+        if FuzzyMatch.match got[key], row[key]
+          got[key] = row[key]
+        else
+          ok = false
+        end
+      end
+
+      unless ok
+        failed = { :attempt => 'gpx', :query => @query, :response => response }
+        log_fail row,got,[failed]
+      end
+
+      actual << got
+    end
+  end
+  table.routing_diff! actual
+end
@@ -0,0 +1,78 @@
+When /^I route with hints I should get$/ do |table|
+  reprocess
+  actual = []
+  OSRMLauncher.new("#{@osm_file}.osrm") do
+    table.hashes.each_with_index do |row,ri|
+      waypoints = []
+      if row['from'] and row['to']
+        node = find_node_by_name(row['from'])
+        raise "*** unknown from-node '#{row['from']}" unless node
+        waypoints << node
+
+        node = find_node_by_name(row['to'])
+        raise "*** unknown to-node '#{row['to']}" unless node
+        waypoints << node
+
+        got = {'from' => row['from'], 'to' => row['to'] }
+      elsif row['waypoints']
+        row['waypoints'].split(',').each do |n|
+          node = find_node_by_name(n.strip)
+          raise "*** unknown waypoint node '#{n.strip}" unless node
+          waypoints << node
+        end
+        got = {'waypoints' => row['waypoints'] }
+      else
+        raise "*** no waypoints"
+      end
+
+      response = request_route waypoints
+      json = JSON.parse response.body
+      hints = json['hint_data']['locations']
+      checksum = json['hint_data']['checksum']
+
+      if table.headers.include? 'hints'
+        problems = hint_problems json
+        got['hints'] = problems.empty? ? 'compact' : problems.join(',')
+      end
+      if table.headers.include? 'route'
+        got['route'] = got_route?(response) ? way_list(json['route_instructions']) : ''
+      end
+      if table.headers.include? 'start hint'
+        # the hint of another node replaces the one of the first waypoint
+        got['start hint'] = row['start hint']
+        if row['start hint'] != ''
+          node = find_node_by_name(row['start hint'])
+          raise "*** unknown start hint node '#{row['start hint']}" unless node
+          other = JSON.parse request_route([node, waypoints.last]).body
+          hints = [other['hint_data']['locations'].first] + hints.drop(1)
+        end
+      end
+      if table.headers.include? 'hinted route'
+        hinted = request_hinted_route waypoints, hints, checksum
+        got['hinted route'] = got_route?(hinted) ? way_list(JSON.parse(hinted.body)['route_instructions']) : ''
+      end
+      if table.headers.include? 'stale route'
+        # hints of other data are ignored
+        stale = request_hinted_route waypoints, hints, checksum ^ 1
+        got['stale route'] = got_route?(stale) ? way_list(JSON.parse(stale.body)['route_instructions']) : ''
+      end
+
+      ok = true
+      row.keys.each do |key|
+        if FuzzyMatch.match got[key], row[key]
+          got[key] = row[key]
+        else
+          ok = false
+        end
+      end
+
+      unless ok
+        failed = { :attempt => 'hint', :query => @query, :response => response }
+        log_fail row,got,[failed]
+      end
+
+      actual << got
+    end
+  end
+  table.routing_diff! actual
+end
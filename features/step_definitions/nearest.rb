@@ -49,3 +49,74 @@ When /^I request nearest (\d+) times I should get$/ do |n,table|
   end
   ok
 end
+
+When /^I request nearest in a batch I should get$/ do |table|
+  reprocess
+  actual = []
+  OSRMLauncher.new("#{@osm_file}.osrm") do
+    in_nodes = table.hashes.map do |row|
+      in_node = find_node_by_name row['in']
+      raise "*** unknown in-node '#{row['in']}" unless in_node
+      in_node
+    end
+
+    response = request_nearest_batch in_nodes.map { |n| "#{n.lat},#{n.lon}" }
+    results = []
+    if response.code == "200" && response.body.empty? == false
+      json = JSON.parse response.body
+      if json['status'] == 0
+        results = json['results']
+      end
+    end
+
+    table.hashes.each_with_index do |row,ri|
+      out_node = find_node_by_name row['out']
+      raise "*** unknown out-node '#{row['out']}" unless out_node
+
+      coord = nil
+      if results[ri] && results[ri]['status'] == 0
+        coord = results[ri]['mapped_coordinate']
+      end
+
+      got = {'in' => row['in'], 'out' => coord }
+
+      ok = true
+      if FuzzyMatch.match_location coord, out_node
+        got['out'] = row['out']
+      else
+        row['out'] = "#{row['out']} [#{out_node.lat},#{out_node.lon}]"
+        ok = false
+      end
+
+      unless ok
+        failed = { :attempt => 'nearest batch', :query => @query, :response => response }
+        log_fail row,got,[failed]
+      end
+
+      actual << got
+    end
+  end
+  table.routing_diff! actual
+end
+
+When /^I request nearest in a batch of repeated coordinates I should get$/ do |table|
+  reprocess
+  actual = []
+  OSRMLauncher.new("#{@osm_file}.osrm") do
+    table.hashes.each_with_index do |row,ri|
+      in_node = find_node_by_name row['in']
+      raise "*** unknown in-node '#{row['in']}" unless in_node
+
+      response = request_nearest_batch ["#{in_node.lat},#{in_node.lon}"]*row['count'].to_i
+      got = {'in' => row['in'], 'count' => row['count'], 'status' => response.code }
+
+      unless got['status'] == row['status']
+        failed = { :attempt => 'nearest batch', :query => @query, :response => response }
+        log_fail row,got,[failed]
+      end
+
+      actual << got
+    end
+  end
+  table.routing_diff! actual
+end
@@ -0,0 +1,151 @@
+#decodes output=binary viaroute replies, see Library/BinaryRouteFormat.h
+
+BINARY_ROUTE_FOUND       = 1
+BINARY_ALTERNATIVE_FOUND = 2
+BINARY_GEOMETRY          = 4
+BINARY_INSTRUCTIONS      = 8
+
+class BinaryRouteReader
+  def initialize data
+    @data = data.b
+    @offset = 0
+  end
+
+  def uint8
+    value = @data.getbyte(@offset)
+    raise "*** binary route is truncated" unless value
+    @offset += 1
+    value
+  end
+
+  def uint16
+    read(2).unpack('v').first
+  end
+
+  def uint32
+    read(4).unpack('V').first
+  end
+
+  def int32
+    read(4).unpack('l<').first
+  end
+
+  def varint
+    value = 0
+    shift = 0
+    loop do
+      byte = uint8
+      value |= (byte & 0x7f) << shift
+      shift += 7
+      return value if byte < 0x80
+    end
+  end
+
+  def signed_varint
+    value = varint
+    (value >> 1) ^ -(value & 1)
+  end
+
+  def string
+    read(varint).force_encoding('UTF-8')
+  end
+
+  def read length
+    raise "*** binary route is truncated" if @offset+length > @data.size
+    value = @data[@offset,length]
+    @offset += length
+    value
+  end
+
+  def at_end?
+    @offset == @data.size
+  end
+end
+
+#returns the reply as a hash with the fields of the JSON reply, coordinates
+#and names resolved
+def parse_binary_route data
+  reader = BinaryRouteReader.new data
+  raise "*** binary route has no magic" unless reader.read(4) == 'OSRB'
+  raise "*** binary route has an unknown version" unless reader.uint8 == 1
+  flags = reader.uint8
+  reader.uint16
+  reply = { 'checksum' => reader.uint32, 'routes' => [] }
+
+  routes = 0
+  routes += 1 if flags & BINARY_ROUTE_FOUND != 0
+  routes += 1 if flags & BINARY_ALTERNATIVE_FOUND != 0
+  routes.times do
+    route = {}
+    route['summary'] = [reader.uint32, reader.uint32, reader.uint32, reader.uint32]
+    if flags & BINARY_GEOMETRY != 0
+      lat = 0
+      lon = 0
+      route['geometry'] = (1..reader.varint).map do
+        lat += reader.signed_varint
+        lon += reader.signed_varint
+        [lat, lon]
+      end
+    end
+    if flags & BINARY_INSTRUCTIONS != 0
+      route['instructions'] = (1..reader.varint).map do
+        turn = reader.uint8
+        exit = reader.uint8
+        [ exit > 0 ? "#{turn}-#{exit}" : turn.to_s,
+          reader.varint, reader.varint, reader.varint, reader.varint, reader.uint16 ]
+      end
+    end
+    reply['routes'] << route
+  end
+  reply['via_points'] = (1..reader.varint).map { [reader.int32, reader.int32] }
+  reply['hints'] = (1..reader.varint).map { reader.string }
+  names = (1..reader.varint).map { reader.string }
+  raise "*** binary route has trailing data" unless reader.at_end?
+
+  reply['routes'].each do |route|
+    summary = route['summary']
+    route['summary'] = {
+      'total_distance' => summary[0],
+      'total_time' => summary[1],
+      'start_point' => names[summary[2]],
+      'end_point' => names[summary[3]]
+    }
+    if route['instructions']
+      route['instructions'].each { |instruction| instruction[1] = names[instruction[1]] }
+    end
+  end
+  reply
+end
+
+def fixed_point coordinate
+  coordinate.map { |value| (value.to_f*1000000).round }
+end
+
+#lists the fields in which a binary reply differs from the JSON reply of the
+#same route, which must be requested with compression=false. JSON rounds
+#bearings up to 360, binary replies wrap them to 0.
+def binary_route_differences binary, json
+  differences = []
+  differences << 'checksum' unless binary['checksum'] == json['hint_data']['checksum']
+  if json['status'] != 0
+    differences << 'status' unless binary['routes'].empty?
+    return differences
+  end
+  route = binary['routes'].first
+  return ['status'] unless route
+  differences << 'summary' unless route['summary'] == json['route_summary']
+  if route['geometry']
+    geometry = json['route_geometry'].map { |coordinate| fixed_point coordinate }
+    differences << 'geometry' unless route['geometry'] == geometry
+  end
+  if route['instructions']
+    instructions = json['route_instructions'].map do |r|
+      [r[0].to_s, r[1], r[2], r[3], r[4], r[7].to_i % 360]
+    end
+    differences << 'instructions' unless route['instructions'] == instructions
+  end
+  via_points = json['via_points'].map { |coordinate| fixed_point coordinate }
+  differences << 'via points' unless binary['via_points'] == via_points
+  differences << 'hints' unless binary['hints'] == json['hint_data']['locations']
+  differences
+end
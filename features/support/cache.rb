@@ -0,0 +1,19 @@
+require 'net/http'
+
+RESPONSE_CACHE_SIZE = 16      #megabytes
+
+def request_cached_route waypoints, params={}, etag=nil
+  defaults = { 'output' => 'json', 'instructions' => true, 'alt' => false }
+  locs = waypoints.compact.map { |w| "loc=#{w.lat},#{w.lon}" }
+  @query = "viaroute?" + (locs + defaults.merge(params).to_param).join('&')
+  uri = URI.parse "#{HOST}/#{@query}"
+  request = Net::HTTP::Get.new uri.request_uri
+  request['If-None-Match'] = etag if etag
+  Timeout.timeout(REQUEST_TIMEOUT) do
+    Net::HTTP.start(uri.host, uri.port) { |http| http.request request }
+  end
+rescue Errno::ECONNREFUSED => e
+  raise "*** osrm-routed is not running."
+rescue Timeout::Error
+  raise "*** osrm-routed did not respond."
+end
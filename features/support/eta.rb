@@ -0,0 +1,5 @@
+require 'net/http'
+
+def request_eta waypoints, params={}
+  request_path "eta", waypoints, params
+end
@@ -0,0 +1,11 @@
+#reads the route points of output=gpx viaroute replies
+
+def request_gpx_route waypoints, params={}
+  request_route waypoints, params.merge('output' => 'gpx')
+end
+
+def parse_gpx_points body
+  body.scan(/<rtept lat="([-0-9.]+)" lon="([-0-9.]+)">/).map do |lat,lon|
+    [lat.to_f, lon.to_f]
+  end
+end
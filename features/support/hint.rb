@@ -0,0 +1,53 @@
+#decodes the phantom node hints of viaroute replies, see
+#Algorithms/PhantomNodeHint.h
+
+HINT_VERSION = 1
+
+def request_hinted_route waypoints, hints, checksum, params={}
+  defaults = { 'output' => 'json', 'instructions' => true, 'alt' => false, 'checksum' => checksum }
+  locs = waypoints.each_with_index.map do |w,i|
+    ["loc=#{w.lat},#{w.lon}", hints[i] ? "hint=#{hints[i]}" : nil].compact.join('&')
+  end
+  request_path "viaroute?" + (locs + defaults.merge(params).to_param).join('&')
+end
+
+#replies print the checksum signed
+def hint_checksum_tag checksum
+  checksum &= 0xffffffff
+  (checksum ^ (checksum >> 16)) & 0xffff
+end
+
+#returns the fields of the hint, or nil if it is no valid base64url
+def decode_hint hint
+  return nil unless hint =~ /\A[A-Za-z0-9_-]+\z/
+  reader = BinaryRouteReader.new hint.tr('-_','+/').unpack('m').first
+  fields = { 'version' => reader.uint8, 'tag' => reader.uint16 }
+  return fields unless fields['version'] == HINT_VERSION
+  ['node', 'name', 'weight1', 'weight2', 'ratio'].each { |key| fields[key] = reader.varint }
+  fields['location'] = [reader.signed_varint, reader.signed_varint]
+  return nil unless reader.at_end?
+  fields
+rescue RuntimeError
+  nil
+end
+
+#lists what is wrong with the hints of a JSON reply
+def hint_problems json
+  problems = []
+  hints = json['hint_data']['locations']
+  checksum = json['hint_data']['checksum']
+  problems << 'count' if json['status'] == 0 && hints.size != json['via_points'].size
+  hints.zip(json['via_points']).each do |hint,via_point|
+    fields = decode_hint hint
+    if fields.nil?
+      problems << "malformed #{hint}"
+    elsif fields['version'] != HINT_VERSION
+      problems << "version #{fields['version']}"
+    elsif fields['tag'] != hint_checksum_tag(checksum)
+      problems << "tag #{fields['tag']}"
+    elsif via_point && fields['location'] != fixed_point(via_point)
+      problems << "location #{fields['location'].join(',')}"
+    end
+  end
+  problems
+end
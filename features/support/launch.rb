@@ -6,8 +6,9 @@ SHUTDOWN_TIMEOUT = 2
 OSRM_ROUTED_LOG_FILE = 'osrm-routed.log'
 
 class OSRMLauncher
-  def initialize input_file, &block
+  def initialize input_file, arguments=nil, &block
     @input_file = input_file
+    @arguments = arguments
     Dir.chdir TEST_FOLDER do
       begin
         launch
@@ -49,7 +50,7 @@ class OSRMLauncher
 
   def osrm_up
     return if osrm_up?
-    @pid = Process.spawn("#{BIN_PATH}/osrm-routed #{@input_file} --port #{OSRM_PORT}",:out=>OSRM_ROUTED_LOG_FILE, :err=>OSRM_ROUTED_LOG_FILE)
+    @pid = Process.spawn("#{BIN_PATH}/osrm-routed #{@input_file} --port #{OSRM_PORT} #{@arguments}",:out=>OSRM_ROUTED_LOG_FILE, :err=>OSRM_ROUTED_LOG_FILE)
   end
 
   def osrm_down
@@ -15,3 +15,7 @@ end
 def request_nearest a
   request_nearest_url "nearest?loc=#{a}"
 end
+
+def request_nearest_batch locations
+  request_nearest_url "nearestbatch?" + locations.map { |a| "loc=#{a}" }.join('&')
+end
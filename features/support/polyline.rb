@@ -0,0 +1,40 @@
+#decodes route_geometry polylines, see Algorithms/PolylineCompressor.cpp
+
+def decode_polyline encoded, precision=6
+  factor = 10**precision
+  points = []
+  lat = 0
+  lon = 0
+  index = 0
+  while index < encoded.size
+    deltas = [0,0].map do
+      value = 0
+      shift = 0
+      loop do
+        chunk = encoded.getbyte(index) - 63
+        index += 1
+        value |= (chunk & 0x1f) << shift
+        shift += 5
+        break if chunk < 0x20
+      end
+      (value & 1) == 1 ? ~(value >> 1) : (value >> 1)
+    end
+    lat += deltas[0]
+    lon += deltas[1]
+    points << [lat.to_f/factor, lon.to_f/factor]
+  end
+  points
+end
+
+#names the nodes the points are at, points at no node are given by their
+#coordinates. A point may be off by one unit of the precision it was encoded
+#with, plus the rounding of the node location.
+def geometry_node_list points, precision=6
+  tolerance = 1.5/(10**precision)
+  points.map do |lat,lon|
+    name, node = name_node_hash.find do |name,node|
+      (node.lat.to_f-lat).abs <= tolerance && (node.lon.to_f-lon).abs <= tolerance
+    end
+    name || "#{lat} #{lon}"
+  end.join(',')
+end
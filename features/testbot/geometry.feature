@@ -0,0 +1,49 @@
+@routing @testbot @geometry
+Feature: Encoded route geometry
+
+    Background:
+        Given the profile "testbot"
+
+    Scenario: Geometry - Default precision has six digits
+        Given the node map
+            | a | b |   |
+            |   | c | d |
+
+        And the ways
+            | nodes |
+            | abcd  |
+
+        When I request the route geometry I should get
+            | from | to | geometry |
+            | a    | d  | a,b,c,d  |
+            | d    | a  | d,c,b,a  |
+
+    Scenario: Geometry - Five and six digits
+        Given the node map
+            | a | b |   |
+            |   | c | d |
+
+        And the ways
+            | nodes |
+            | abcd  |
+
+        When I request the route geometry I should get
+            | from | to | param:precision | geometry |
+            | a    | d  | 6               | a,b,c,d  |
+            | a    | d  | 5               | a,b,c,d  |
+            | d    | a  | 5               | d,c,b,a  |
+
+    Scenario: Geometry - Five digits near the origin
+        Given the origin 0,0
+        Given the node map
+            | a | b |   |
+            |   | c | d |
+
+        And the ways
+            | nodes |
+            | abcd  |
+
+        When I request the route geometry I should get
+            | from | to | param:precision | geometry |
+            | a    | d  | 5               | a,b,c,d  |
+            | d    | a  | 5               | d,c,b,a  |
@@ -0,0 +1,37 @@
+@routing @testbot @gpx
+Feature: GPX route output
+
+    Background:
+        Given the profile "testbot"
+        Given a grid size of 10 meters
+
+    Scenario: GPX - All points of the route
+        Given the node map
+            | a | b | c |
+            |   |   | d |
+
+        And the ways
+            | nodes |
+            | abcd  |
+
+        When I request a GPX route I should get
+            | from | to | points  |
+            | a    | d  | a,b,c,d |
+            | d    | a  | d,c,b,a |
+
+    Scenario: GPX - Generalized points are those of the route geometry
+        Given the node map
+            | a | b | c |
+            |   |   | d |
+
+        And the ways
+            | nodes |
+            | abcd  |
+
+        When I request a GPX route I should get
+            | from | to | param:generalize | param:z | points  | geometry |
+            | a    | d  | false            | 1       | a,b,c,d | differs  |
+            | a    | d  | true             | 1       | a,d     | same     |
+            | d    | a  | true             | 1       | d,a     | same     |
+            | a    | d  | true             | 17      | a,b,c,d | same     |
+            | a    | d  | true             |         | a,b,c,d | same     |
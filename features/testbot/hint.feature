@@ -0,0 +1,53 @@
+@routing @testbot @hint
+Feature: Phantom node hints
+
+    Background:
+        Given the profile "testbot"
+
+    Scenario: Hint - Hints are compact and name the via points
+        Given the node map
+            | a | b | c |
+            |   |   | d |
+
+        And the ways
+            | nodes |
+            | abc   |
+            | cd    |
+
+        When I route with hints I should get
+            | waypoints | hints   | route         |
+            | a,d       | compact | abc,cd        |
+            | d,a       | compact | cd,abc        |
+            | a,d,b     | compact | abc,cd,cd,abc |
+
+    Scenario: Hint - Routes with hints are the same
+        Given the node map
+            | a | b | c |
+            |   |   | d |
+
+        And the ways
+            | nodes |
+            | abc   |
+            | cd    |
+
+        When I route with hints I should get
+            | from | to | route  | hinted route | stale route |
+            | a    | d  | abc,cd | abc,cd       | abc,cd      |
+            | d    | a  | cd,abc | cd,abc       | cd,abc      |
+            | b    | d  | abc,cd | abc,cd       | abc,cd      |
+
+    Scenario: Hint - A matching hint is used instead of the location
+        Given the node map
+            | a | b | c |
+            |   |   | e |
+            |   |   | d |
+
+        And the ways
+            | nodes |
+            | abc   |
+            | ced   |
+
+        When I route with hints I should get
+            | from | to | start hint | route   | hinted route | stale route |
+            | e    | d  | a          | ced     | abc,ced      | ced         |
+            | e    | d  |            | ced     | ced          | ced         |
@@ -28,11 +28,15 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Algorithms/IteratorBasedCRC32.h"
 #include "Contractor/Contractor.h"
 #include "Contractor/EdgeBasedGraphFactory.h"
+#include "Contractor/SearchGraphLengths.h"
 #include "DataStructures/BinaryHeap.h"
 #include "DataStructures/DeallocatingVector.h"
 #include "DataStructures/QueryEdge.h"
+#include "DataStructures/SearchGraphTrailer.h"
 #include "DataStructures/StaticGraph.h"
+#include "DataStructures/StaticPointIndex.h"
 #include "DataStructures/StaticRTree.h"
+#include "Server/DataStructures/DataContainer.h"
 #include "Util/GitDescription.h"
 #include "Util/GraphLoader.h"
 #include "Util/InputFileUtil.h"
@@ -71,6 +75,7 @@ int main (int argc, char *argv[]) {
         double startupTime = get_timestamp();
         boost::filesystem::path config_file_path, input_path, restrictions_path, profile_path;
         int requested_num_threads;
+        bool write_container;
 
         // declare a group of options that will be allowed only on command line
         boost::program_options::options_description generic_options("Options");
@@ -88,7 +93,9 @@ int main (int argc, char *argv[]) {
             ("profile,p", boost::program_options::value<boost::filesystem::path>(&profile_path)->default_value("profile.lua"),
                 "Path to LUA routing profile")
             ("threads,t", boost::program_options::value<int>(&requested_num_threads)->default_value(8),
-                "Number of threads to use");
+                "Number of threads to use")
+            ("container", boost::program_options::value<bool>(&write_container)->default_value(false),
+                "Also write all data into a single .container file");
 
         // hidden options, will be allowed both on command line and in config file, but will not be shown to the user
         boost::program_options::options_description hidden_options("Hidden options");
@@ -187,6 +194,7 @@ int main (int argc, char *argv[]) {
         std::string graphOut(input_path.c_str());		graphOut += ".hsgr";
         std::string rtree_nodes_path(input_path.c_str());  rtree_nodes_path += ".ramIndex";
         std::string rtree_leafs_path(input_path.c_str());  rtree_leafs_path += ".fileIndex";
+        std::string point_index_path(input_path.c_str());  point_index_path += ".pointIndex";
 
         /*** Setup Scripting Environment ***/
 
@@ -262,6 +270,8 @@ int main (int argc, char *argv[]) {
         edgeBasedGraphFactory->GetEdgeBasedEdges(edgeBasedEdgeList);
         std::vector<EdgeBasedNode> nodeBasedEdgeList;
         edgeBasedGraphFactory->GetEdgeBasedNodes(nodeBasedEdgeList);
+        std::vector<bool> restricted_edge_list;
+        edgeBasedGraphFactory->GetRestrictedEdges(restricted_edge_list);
         delete edgeBasedGraphFactory;
 
         /***
@@ -293,8 +303,28 @@ int main (int argc, char *argv[]) {
                         rtree_leafs_path.c_str()
                 );
         delete rtree;
+
+        SimpleLogger().Write() << "building point index ...";
+        std::vector<FixedPointCoordinate> end_point_list;
+        end_point_list.reserve(2*nodeBasedEdgeList.size());
+        BOOST_FOREACH(const EdgeBasedNode & node, nodeBasedEdgeList) {
+            if( node.isIgnored() ) {
+                continue;
+            }
+            end_point_list.push_back(FixedPointCoordinate(node.lat1, node.lon1));
+            end_point_list.push_back(FixedPointCoordinate(node.lat2, node.lon2));
+        }
+        StaticPointIndex<>::Build(end_point_list, point_index_path);
+        std::vector<FixedPointCoordinate>().swap(end_point_list);
+
         IteratorbasedCRC32<std::vector<EdgeBasedNode> > crc32;
         unsigned crc32OfNodeBasedEdgeList = crc32(nodeBasedEdgeList.begin(), nodeBasedEdgeList.end() );
+        std::vector<unsigned> node_length_list;
+        SearchGraphLengths::ComputeNodeLengths(
+            nodeBasedEdgeList,
+            edgeBasedNodeNumber,
+            node_length_list
+        );
         nodeBasedEdgeList.clear();
         SimpleLogger().Write() << "CRC32: " << crc32OfNodeBasedEdgeList;
 
@@ -398,6 +428,30 @@ int main (int argc, char *argv[]) {
                 ++usedEdgeCounter;
             }
         }
+        //serialize geometric lengths of nodes and edges and the restricted
+        //areas entered along edges, see SearchGraphLengths
+        SimpleLogger().Write() << "computing lengths of shortcuts ...";
+        std::vector<unsigned> edge_length_list;
+        std::vector<unsigned char> edge_restriction_count_list;
+        SearchGraphLengths::ComputeEdgeLengths(
+            _nodes,
+            contractedEdgeList,
+            node_length_list,
+            restricted_edge_list,
+            edge_length_list,
+            edge_restriction_count_list
+        );
+        std::vector<bool>().swap(restricted_edge_list);
+        node_length_list.resize(_nodes.size(), 0);
+        const SearchGraphTrailerHeader trailer_header(edge_length_list.size());
+        hsgr_output_stream.write((char*) &trailer_header, sizeof(SearchGraphTrailerHeader));
+        hsgr_output_stream.write((char*) &node_length_list[0], sizeof(unsigned)*node_length_list.size());
+        hsgr_output_stream.write((char*) &edge_length_list[0], sizeof(unsigned)*edge_length_list.size());
+        hsgr_output_stream.write((char*) &edge_restriction_count_list[0], edge_restriction_count_list.size());
+        std::vector<unsigned>().swap(node_length_list);
+        std::vector<unsigned>().swap(edge_length_list);
+        std::vector<unsigned char>().swap(edge_restriction_count_list);
+
         SimpleLogger().Write() << "Preprocessing : " <<
             (get_timestamp() - startupTime) << " seconds";
         SimpleLogger().Write() << "Expansion  : " <<
@@ -411,6 +465,21 @@ int main (int argc, char *argv[]) {
         hsgr_output_stream.close();
         //cleanedEdgeList.clear();
         _nodes.clear();
+
+        if( write_container ) {
+            SimpleLogger().Write() << "writing data container ...";
+            const std::string base_string(input_path.c_str());
+            ServerPaths container_paths;
+            container_paths["hsgrdata"]   = graphOut;
+            container_paths["nodesdata"]  = nodeOut;
+            container_paths["edgesdata"]  = edgeOut;
+            container_paths["ramindex"]   = rtree_nodes_path;
+            container_paths["fileindex"]  = rtree_leafs_path;
+            container_paths["pointindex"] = point_index_path;
+            container_paths["namesdata"]  = base_string + ".names";
+            container_paths["timestamp"]  = base_string + ".timestamp";
+            DataContainerWriter::Write(container_paths, base_string + ".container");
+        }
         SimpleLogger().Write() << "finished preprocessing";
     } catch(boost::program_options::too_many_positional_options_error& e) {
         SimpleLogger().Write(logWARNING) << "Only one file can be specified";
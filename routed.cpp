@@ -27,13 +27,17 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Library/OSRM.h"
 
+#include "Server/RequestHandler.h"
 #include "Server/ServerFactory.h"
+#include "Server/DataStructures/DataWarmup.h"
 
 #include "Util/GitDescription.h"
 #include "Util/InputFileUtil.h"
+#include "Util/NUMATopology.h"
 #include "Util/OpenMPWrapper.h"
 #include "Util/ProgramOptions.h"
 #include "Util/SimpleLogger.h"
+#include "Util/TimingUtil.h"
 #include "Util/UUID.h"
 
 #ifdef __linux__
@@ -45,6 +49,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/bind.hpp>
 #include <boost/date_time.hpp>
+#include <boost/filesystem/fstream.hpp>
 #include <boost/thread.hpp>
 
 #include <iostream>
@@ -68,17 +73,62 @@ BOOL WINAPI console_ctrl_handler(DWORD ctrl_type)
 }
 #endif
 
+// answers the request URIs of a query log before the server accepts requests
+void ReplayWarmupQueries(
+    OSRM & routing_machine,
+    const boost::filesystem::path & query_log_path
+) {
+    if( !boost::filesystem::is_regular_file(query_log_path) ) {
+        throw OSRMException(
+            "warm-up query log not found: " + query_log_path.string()
+        );
+    }
+    boost::filesystem::ifstream query_log(query_log_path);
+    RequestHandler request_handler;
+    request_handler.RegisterRoutingMachine(&routing_machine);
+
+    const double time_stamp = get_timestamp();
+    unsigned number_of_queries = 0;
+    unsigned number_of_failed_queries = 0;
+    std::string line;
+    LogPolicy::GetInstance().Mute();
+    while( std::getline(query_log, line) ) {
+        boost::algorithm::trim(line);
+        const std::string::size_type scheme_end = line.find("://");
+        if( std::string::npos != scheme_end ) {
+            line.erase(0, line.find('/', scheme_end+3));
+        }
+        if( line.empty() ) {
+            continue;
+        }
+        http::Request request;
+        request.uri = line;
+        http::Reply reply;
+        request_handler.handle_request(request, reply);
+        ++number_of_queries;
+        if( http::Reply::ok != reply.status ) {
+            ++number_of_failed_queries;
+        }
+    }
+    LogPolicy::GetInstance().Unmute();
+    SimpleLogger().Write() <<
+        "replayed " << number_of_queries << " warm-up queries in " <<
+        unsigned(1000*(get_timestamp() - time_stamp)) << " ms, " <<
+        number_of_failed_queries << " failed";
+}
+
 int main (int argc, const char * argv[]) {
     try {
         LogPolicy::GetInstance().Unmute();
 #ifdef __linux__
-        if( -1 == mlockall(MCL_CURRENT | MCL_FUTURE) ) {
-            SimpleLogger().Write(logWARNING) <<
-                "Process " << argv[0] << " could not be locked to RAM";
-        }
         installCrashHandler(argv[0]);
 #endif
         bool use_shared_memory = false;
+        bool use_mapped_files = false;
+        bool replicate_per_numa_node = false;
+        bool warm_up_data = true;
+        std::string locked_structures;
+        unsigned response_cache_size = 0;
         std::string ip_address;
         int ip_port, requested_num_threads;
 
@@ -90,12 +140,30 @@ int main (int argc, const char * argv[]) {
                 ip_address,
                 ip_port,
                 requested_num_threads,
-                use_shared_memory
+                use_shared_memory,
+                use_mapped_files,
+                replicate_per_numa_node,
+                warm_up_data,
+                locked_structures,
+                response_cache_size
              )
         ) {
             return 0;
         }
 
+        DataWarmupPolicy warmup_policy;
+        warmup_policy.prefault = warm_up_data;
+        if( "all" == locked_structures ) {
+#ifdef __linux__
+            if( -1 == mlockall(MCL_CURRENT | MCL_FUTURE) ) {
+                SimpleLogger().Write(logWARNING) <<
+                    "Process " << argv[0] << " could not be locked to RAM";
+            }
+#endif
+        } else {
+            warmup_policy.SetLockedStructures(locked_structures);
+        }
+
         SimpleLogger().Write() <<
             "starting up engines, " << g_GIT_DESCRIPTION << ", " <<
             "compiled at " << __DATE__ << ", " __TIME__;
@@ -103,6 +171,9 @@ int main (int argc, const char * argv[]) {
         if( use_shared_memory ) {
             SimpleLogger().Write(logDEBUG) << "Loading from shared memory";
         } else {
+            if( use_mapped_files ) {
+                SimpleLogger().Write(logDEBUG) << "Mapping data files";
+            }
             SimpleLogger().Write() <<
                 "HSGR file:\t" << server_paths["hsgrdata"];
             SimpleLogger().Write(logDEBUG) <<
@@ -113,12 +184,22 @@ int main (int argc, const char * argv[]) {
                 "RAM file:\t" << server_paths["ramindex"];
             SimpleLogger().Write(logDEBUG) <<
                 "Index file:\t" << server_paths["fileindex"];
+            SimpleLogger().Write(logDEBUG) <<
+                "Point index:\t" << server_paths["pointindex"];
             SimpleLogger().Write(logDEBUG) <<
                 "Names file:\t" << server_paths["namesdata"];
             SimpleLogger().Write(logDEBUG) <<
                 "Timestamp file:\t" << server_paths["timestamp"];
+            SimpleLogger().Write(logDEBUG) <<
+                "Container:\t" << server_paths["container"];
+            SimpleLogger().Write(logDEBUG) <<
+                "Warm-up queries:\t" << server_paths["warmupqueries"];
+            SimpleLogger().Write(logDEBUG) <<
+                "Response cache:\t" << response_cache_size << " MB";
             SimpleLogger().Write(logDEBUG) <<
                 "Threads:\t" << requested_num_threads;
+            SimpleLogger().Write(logDEBUG) <<
+                "NUMA nodes:\t" << NUMATopology::GetInstance().GetNumberOfNodes();
             SimpleLogger().Write(logDEBUG) <<
                 "IP address:\t" << ip_address;
             SimpleLogger().Write(logDEBUG) <<
@@ -132,11 +213,22 @@ int main (int argc, const char * argv[]) {
         pthread_sigmask(SIG_BLOCK, &new_mask, &old_mask);
 #endif
 
-        OSRM routing_machine(server_paths, use_shared_memory);
+        OSRM routing_machine(
+            server_paths,
+            use_shared_memory,
+            use_mapped_files,
+            replicate_per_numa_node,
+            warmup_policy,
+            response_cache_size
+        );
+        if( !server_paths["warmupqueries"].empty() ) {
+            ReplayWarmupQueries(routing_machine, server_paths["warmupqueries"]);
+        }
         Server * s = ServerFactory::CreateServer(
                         ip_address,
                         ip_port,
-                        requested_num_threads
+                        requested_num_threads,
+                        replicate_per_numa_node
                      );
 
         s->GetRequestHandlerPtr().RegisterRoutingMachine(&routing_machine);
@@ -150,9 +242,27 @@ int main (int argc, const char * argv[]) {
         sigaddset(&wait_mask, SIGINT);
         sigaddset(&wait_mask, SIGQUIT);
         sigaddset(&wait_mask, SIGTERM);
+        sigaddset(&wait_mask, SIGHUP);
         pthread_sigmask(SIG_BLOCK, &wait_mask, 0);
         std::cout << "[server] running and waiting for requests" << std::endl;
-        sigwait(&wait_mask, &sig);
+        // SIGHUP reloads the data files in the background
+        boost::thread reload_thread;
+        while( 0 == sigwait(&wait_mask, &sig) && SIGHUP == sig ) {
+            if(
+                reload_thread.joinable() &&
+                !reload_thread.timed_join(boost::posix_time::seconds(0))
+            ) {
+                SimpleLogger().Write(logWARNING) << "data reload already in progress";
+                continue;
+            }
+            reload_thread = boost::thread(
+                boost::bind(&OSRM::ReloadData, &routing_machine)
+            );
+        }
+        if( reload_thread.joinable() ) {
+            std::cout << "[server] waiting for data reload to finish" << std::endl;
+            reload_thread.join();
+        }
 #else
         // Set console control handler to allow server to be stopped.
         console_ctrl_function = boost::bind(&Server::Stop, s);